@@ -0,0 +1,169 @@
+#include "arena.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/myclib.h"
+
+/* - DEFINITIONS - */
+
+#define align_up(n) \
+  (((n) + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1))
+
+/*
+ * A chunk's contents begin this far past its start so that offsets aligned
+ * within a chunk are also aligned in memory.
+ */
+#define CHUNK_HEADER_SIZE align_up(sizeof(arena_chunk))
+
+/* The largest single allocation whose chunk size does not overflow. */
+#define MAX_ALLOCATION ((size_t)-1 - CHUNK_HEADER_SIZE - ARENA_ALIGNMENT)
+
+#define chunk_data(chunk) ((byte *)(chunk) + CHUNK_HEADER_SIZE)
+
+#define chunk_offset(chunk, ptr) ((size_t)((byte *)(ptr) - chunk_data(chunk)))
+
+/* - INTERNAL - */
+
+static inline arena_chunk *chunk_new(const size_t size) {
+  arena_chunk *const chunk = malloc(CHUNK_HEADER_SIZE + size);
+  if (chunk == NULL) return NULL;
+  chunk->next = NULL;
+  chunk->size = size;
+  chunk->used = 0;
+  return chunk;
+}
+
+/*
+ * Advances `ar->current` to a chunk with at least `size` free bytes,
+ * reusing the following chunk if it is large enough.
+ */
+static bool next_chunk(arena *const ar, const size_t size) {
+  arena_chunk *const current = ar->current;
+  arena_chunk *next = current == NULL ? ar->first : current->next;
+  if (next != NULL && next->size >= size) {
+    next->used = 0;
+  } else {
+    const size_t CHUNK_SIZE =
+        size > ar->chunk_size ? align_up(size) : ar->chunk_size;
+    arena_chunk *const chunk = chunk_new(CHUNK_SIZE);
+    if (chunk == NULL) return false;
+    chunk->next = next;
+    if (current == NULL)
+      ar->first = chunk;
+    else
+      current->next = chunk;
+    next = chunk;
+  }
+  ar->current = next;
+  return true;
+}
+
+/* - ALLOCATOR INTERFACE - */
+
+static void *allocator_alloc(void *const ctx, const size_t size) {
+  return arena_alloc(ctx, size);
+}
+
+static void *allocator_realloc(void *const ctx, void *const ptr,
+                               const size_t old_size, const size_t new_size) {
+  return arena_realloc(ctx, ptr, old_size, new_size);
+}
+
+static void allocator_free(void *const ctx, void *const ptr, const size_t size) {
+  arena_free(ctx, ptr, size);
+}
+
+/* - LIBRARY FUNCTIONS - */
+
+void *arena_alloc(arena *const ar, size_t size) {
+  arena_chunk *chunk = ar->current;
+  size_t offset;
+  if (size > MAX_ALLOCATION) return NULL;
+  /* Zero-sized blocks still take up space so that every block is distinct. */
+  if (size == 0) size = 1;
+  if (chunk == NULL || chunk->size - chunk->used < size) {
+    if (!next_chunk(ar, size)) return NULL;
+    chunk = ar->current;
+  }
+  offset = chunk->used;
+  chunk->used = align_up(offset + size);
+  ar->tip = chunk_data(chunk) + offset;
+  return ar->tip;
+}
+
+void arena_destroy(arena *const ar) {
+  arena_chunk *chunk = ar->first;
+  while (chunk != NULL) {
+    arena_chunk *const next = chunk->next;
+    free(chunk);
+    chunk = next;
+  }
+  ar->first = NULL;
+  ar->current = NULL;
+  ar->tip = NULL;
+}
+
+void arena_free(arena *const ar, void *const ptr, const size_t size) {
+  (void)size;
+  if (ptr != NULL && ptr == ar->tip) {
+    ar->current->used = chunk_offset(ar->current, ptr);
+    ar->tip = NULL;
+  }
+}
+
+arena_mark arena_get_mark(const arena *const ar) {
+  arena_mark mark;
+  mark.chunk = ar->current;
+  mark.used = ar->current == NULL ? 0 : ar->current->used;
+  return mark;
+}
+
+void arena_init(arena *const ar, const size_t chunk_size) {
+  ar->first = NULL;
+  ar->current = NULL;
+  ar->tip = NULL;
+  ar->chunk_size =
+      align_up(chunk_size == 0 ? ARENA_DEFAULT_CHUNK_SIZE : chunk_size);
+  ar->allocator.alloc = allocator_alloc;
+  ar->allocator.realloc = allocator_realloc;
+  ar->allocator.free = allocator_free;
+  ar->allocator.ctx = ar;
+}
+
+void *arena_realloc(arena *const ar, void *const ptr, const size_t old_size,
+                    const size_t new_size) {
+  void *block;
+  if (ptr == NULL) return arena_alloc(ar, new_size);
+  if (ptr == ar->tip) {
+    arena_chunk *const chunk = ar->current;
+    const size_t OFFSET = chunk_offset(chunk, ptr);
+    if (new_size <= chunk->size - OFFSET) {
+      chunk->used = align_up(OFFSET + (new_size == 0 ? 1 : new_size));
+      return ptr;
+    }
+  } else if (new_size <= old_size) {
+    return ptr;
+  }
+  block = arena_alloc(ar, new_size);
+  if (block == NULL) return NULL;
+  memcpy(block, ptr, old_size < new_size ? old_size : new_size);
+  return block;
+}
+
+void arena_reset(arena *const ar) {
+  ar->current = ar->first;
+  if (ar->current != NULL) ar->current->used = 0;
+  ar->tip = NULL;
+}
+
+void arena_rewind(arena *const ar, const arena_mark mark) {
+  if (mark.chunk == NULL) {
+    arena_reset(ar);
+    return;
+  }
+  ar->current = mark.chunk;
+  ar->current->used = mark.used;
+  ar->tip = NULL;
+}
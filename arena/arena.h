@@ -0,0 +1,140 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+#include "../include/myclib.h"
+
+/* - DEFINITIONS - */
+
+/* Every allocation made from an arena is aligned to this many bytes. */
+#define ARENA_ALIGNMENT ((size_t)16)
+
+#define ARENA_DEFAULT_CHUNK_SIZE ((size_t)1 << 16)
+
+/*
+ *  `next` - The chunk following this one, which may hold stale allocations
+ *           left over from before a reset or rewind.
+ *  `size` - The number of bytes the chunk can hand out.
+ *  `used` - The number of bytes handed out so far.
+ */
+typedef struct arena_chunk {
+  struct arena_chunk *next;
+  size_t size;
+  size_t used;
+} arena_chunk;
+
+/*
+ * A chunked bump allocator. Allocations are carved sequentially out of large
+ * chunks and are released all at once by `arena_reset()` or `arena_rewind()`,
+ * which keep the chunks around for reuse.
+ *
+ *    `first`    - The oldest chunk, or `NULL` if nothing was allocated yet.
+ *   `current`   - The chunk allocations are currently carved from.
+ *     `tip`     - The most recent allocation, which is the only one able to
+ *                 grow or shrink in place, or `NULL`.
+ *  `chunk_size` - The minimum size of a newly allocated chunk.
+ *  `allocator`  - An allocator interface over the arena, for containers.
+ *
+ * Since `allocator` refers back to the arena, an arena must not be moved
+ * once initialized.
+ */
+typedef struct arena {
+  arena_chunk *first;
+  arena_chunk *current;
+  void *tip;
+  size_t chunk_size;
+  myclib_allocator allocator;
+} arena;
+
+/* A position within an arena which it may later be rewound to. */
+typedef struct arena_mark {
+  arena_chunk *chunk;
+  size_t used;
+} arena_mark;
+
+/* - CONVENIENCE MACROS - */
+
+/*
+ * Returns an allocator which carves memory out of `arena`, e.g.
+ *
+ * `vector(int) vec = vector_new_with(arena_allocator(&arena), int, 8);`
+ *
+ * Containers using it need not be deleted individually; resetting or
+ * destroying the arena releases them.
+ */
+#define arena_allocator(arena) ((const myclib_allocator *)&(arena)->allocator)
+
+/* - FUNCTIONS - */
+
+/**
+ * @brief Allocates a block from an arena.
+ *
+ * @param ar The arena to allocate from.
+ * @param size The size of the block in bytes.
+ * @return A block aligned to `ARENA_ALIGNMENT`, or `NULL` if a new chunk was
+ * needed and could not be allocated.
+ */
+void *arena_alloc(arena *ar, size_t size);
+
+/**
+ * @brief Frees every chunk owned by an arena.
+ *
+ * All memory allocated from the arena becomes invalid. The arena may be used
+ * again afterwards as though it were newly initialized.
+ */
+void arena_destroy(arena *ar);
+
+/**
+ * @brief Releases a block allocated from an arena.
+ *
+ * The block's memory is only reclaimed if it is the arena's most recent
+ * allocation. Otherwise, this does nothing and the memory is reclaimed upon
+ * the next reset or rewind.
+ */
+void arena_free(arena *ar, void *ptr, size_t size);
+
+/**
+ * @brief Returns the current position of an arena.
+ *
+ * Passing the returned mark to `arena_rewind()` releases everything allocated
+ * after this call.
+ */
+arena_mark arena_get_mark(const arena *ar);
+
+/**
+ * @brief Initializes an arena.
+ *
+ * No memory is allocated until the first allocation is made.
+ *
+ * @param ar The arena to initialize.
+ * @param chunk_size The minimum size of each chunk the arena allocates, or `0`
+ * for `ARENA_DEFAULT_CHUNK_SIZE`.
+ */
+void arena_init(arena *ar, size_t chunk_size);
+
+/**
+ * @brief Resizes a block allocated from an arena.
+ *
+ * If `ptr` is the arena's most recent allocation and its chunk has enough
+ * room, the block is resized in place. Otherwise, a new block is allocated
+ * and the contents of the old block are copied into it.
+ *
+ * @return The resized block, or `NULL` on failure, in which case `ptr` remains
+ * valid.
+ */
+void *arena_realloc(arena *ar, void *ptr, size_t old_size, size_t new_size);
+
+/**
+ * @brief Releases every allocation made from an arena in O(1).
+ *
+ * The arena's chunks are kept and reused by subsequent allocations.
+ */
+void arena_reset(arena *ar);
+
+/**
+ * @brief Releases every allocation made from an arena after `mark` was taken.
+ */
+void arena_rewind(arena *ar, arena_mark mark);
+
+#endif
@@ -0,0 +1,114 @@
+#include "dequebench.h"
+
+#include <stddef.h>
+
+#include "../../deque/deque.h"
+#include "../../include/myclib.h"
+#include "../../vector/vector.h"
+#include "../framework.h"
+
+/* Dequeuing from a vector is linear, so it is only timed up to here. */
+#define SHIFT_MAX_N ((size_t)10000)
+
+/* The number of elements moved by each bulk enqueue and dequeue. */
+#define BATCH ((size_t)64)
+
+/* - INTERNAL - */
+
+/*
+ * Keeps `n` elements queued while enqueuing and dequeuing one element
+ * `ops` times, as a work queue in a steady state does.
+ */
+static double time_deque_queue(const size_t n, const size_t ops) {
+  deque(size_t) queue = deque_new(size_t, n + 1);
+  double start;
+  size_t sum = 0;
+  size_t i;
+  for (i = 0; i < n; i++) deque_push_back(queue, i);
+  start = bench_now();
+  for (i = 0; i < ops; i++) {
+    deque_push_back(queue, i);
+    sum += deque_pop_front(queue);
+  }
+  start = bench_now() - start;
+  bench_sink += sum;
+  deque_delete(queue);
+  return start;
+}
+
+/* The same, dequeuing with `vector_remove()` at index zero. */
+static double time_vector_queue(const size_t n, const size_t ops) {
+  vector(size_t) queue = vector_new(size_t, n + 1);
+  double start;
+  size_t sum = 0;
+  size_t i;
+  for (i = 0; i < n; i++) vector_push(queue, i);
+  start = bench_now();
+  for (i = 0; i < ops; i++) {
+    vector_push(queue, i);
+    sum += queue[0];
+    vector_remove(queue, 0);
+  }
+  start = bench_now() - start;
+  bench_sink += sum;
+  vector_delete(queue);
+  return start;
+}
+
+/* Moves `n` elements through a deque, `BATCH` at a time or one at a time. */
+static double time_batches(const bool bulk, const size_t n,
+                           const size_t reps) {
+  deque(size_t) queue = deque_new(size_t, BATCH * 2);
+  size_t batch[BATCH];
+  const double START = bench_now();
+  size_t rep;
+  size_t i;
+  size_t j;
+  for (i = 0; i < BATCH; i++) batch[i] = i;
+  for (rep = 0; rep < reps; rep++) {
+    /* Keeps part of a batch queued, so that the copies wrap around the ring. */
+    deque_push_back_n(queue, batch, BATCH / 3);
+    for (i = 0; i + BATCH <= n; i += BATCH) {
+      if (bulk) {
+        deque_push_back_n(queue, batch, BATCH);
+        bench_sink += deque_pop_front_n(queue, batch, BATCH);
+      } else {
+        for (j = 0; j < BATCH; j++) deque_push_back(queue, batch[j]);
+        for (j = 0; j < BATCH; j++) batch[j] = deque_pop_front(queue);
+        bench_sink += BATCH;
+      }
+    }
+    deque_clear(queue);
+  }
+  deque_delete(queue);
+  return bench_now() - START;
+}
+
+/* - BENCHMARKS - */
+
+void bench_deque_bulk(void) {
+  size_t exponent;
+  for (exponent = 3; exponent <= BENCH_MAX_EXPONENT; exponent++) {
+    const size_t N = bench_pow10(exponent);
+    const size_t REPS = bench_repetitions(N);
+    const size_t OPS = N / BATCH * BATCH * REPS;
+    bench_report("push_back_n/pop_front_n", N, OPS,
+                 time_batches(true, N, REPS));
+    bench_report("push_back/pop_front", N, OPS, time_batches(false, N, REPS));
+  }
+}
+
+void bench_deque_queue(void) {
+  size_t exponent;
+  for (exponent = 1; exponent <= BENCH_MAX_EXPONENT; exponent++) {
+    const size_t N = bench_pow10(exponent);
+    const size_t REPS = bench_repetitions(N);
+    bench_report("deque", N, N * REPS, time_deque_queue(N, N * REPS));
+    /* The vector shifts every element on every dequeue. */
+    if (N <= SHIFT_MAX_N) {
+      const size_t SHIFTS = N * (REPS / N + 1);
+      bench_report("vector_remove at 0", N, SHIFTS,
+                   time_vector_queue(N, SHIFTS));
+    }
+  }
+}
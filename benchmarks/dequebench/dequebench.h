@@ -0,0 +1,10 @@
+#ifndef BENCH_DEQUE_H
+#define BENCH_DEQUE_H
+
+#include "../../include/myclib.h"
+
+void bench_deque_bulk(void);
+
+void bench_deque_queue(void);
+
+#endif
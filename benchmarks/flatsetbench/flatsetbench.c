@@ -0,0 +1,143 @@
+#include "flatsetbench.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+
+#include "../../flatset/flatset.h"
+#include "../../include/myclib.h"
+#include "../../vector/vector.h"
+#include "../framework.h"
+
+/* The number of lookups timed per repetition of a search benchmark. */
+#define LOOKUPS ((size_t)4096)
+
+/* - INTERNAL - */
+
+#define scramble(n) (((n) * (size_t)2654435761U + 1) ^ ((n) >> 7))
+
+/* Not a built-in comparator, so it selects the generic kernels. */
+static int compare_keys(const void *const a, const void *const b) {
+  return flat_set_compare_u32(a, b);
+}
+
+/* Returns a flat set of `n` distinct keys spaced `stride` apart. */
+static vec_u32 *strided_set(const size_t n, const size_t stride,
+                            const size_t offset) {
+  vector(vec_u32) set = flat_set_new(vec_u32, n);
+  size_t i;
+  if (set == NULL) return NULL;
+  for (i = 0; i < n; i++) vector_push(set, (vec_u32)((i * stride) + offset));
+  return set;
+}
+
+typedef enum search_kind {
+  SEARCH_BRANCHLESS,
+  SEARCH_COMPARATOR,
+  SEARCH_BSEARCH
+} search_kind;
+
+static double time_searches(const vec_u32 *const set, const vec_u32 *const keys,
+                            const search_kind kind, const size_t reps) {
+  const double START = bench_now();
+  size_t rep;
+  for (rep = 0; rep < reps; rep++) {
+    size_t i;
+    for (i = 0; i < LOOKUPS; i++) {
+      switch (kind) {
+        case SEARCH_BRANCHLESS:
+          bench_sink += flat_set_lower_bound(set, keys[i],
+                                             flat_set_compare_u32);
+          break;
+        case SEARCH_COMPARATOR:
+          bench_sink += flat_set_lower_bound(set, keys[i], compare_keys);
+          break;
+        default:
+          bench_sink += bsearch(&keys[i], set, vector_length(set),
+                                sizeof *set, compare_keys) != NULL;
+          break;
+      }
+    }
+  }
+  return bench_now() - START;
+}
+
+/* - BENCHMARKS - */
+
+void bench_flat_set_lower_bound(void) {
+  vec_u32 *const keys = malloc(LOOKUPS * sizeof *keys);
+  size_t exponent;
+  if (keys == NULL) return;
+  for (exponent = 1; exponent <= BENCH_MAX_EXPONENT; exponent++) {
+    const size_t N = bench_pow10(exponent);
+    const size_t REPS = bench_repetitions(LOOKUPS);
+    vec_u32 *const set = strided_set(N, 2, 0);
+    size_t state = N;
+    size_t i;
+    if (set == NULL) break;
+    /* Half of the keys are absent, and the order of outcomes is random. */
+    for (i = 0; i < LOOKUPS; i++) {
+      state = scramble(state);
+      keys[i] = (vec_u32)(state % (N * 2));
+    }
+    bench_report("branchless (built-in cmp)", N, LOOKUPS * REPS,
+                 time_searches(set, keys, SEARCH_BRANCHLESS, REPS));
+    bench_report("branchless (other cmp)", N, LOOKUPS * REPS,
+                 time_searches(set, keys, SEARCH_COMPARATOR, REPS));
+    bench_report("bsearch", N, LOOKUPS * REPS,
+                 time_searches(set, keys, SEARCH_BSEARCH, REPS));
+    vector_delete(set);
+  }
+  free(keys);
+}
+
+void bench_flat_set_ops(void) {
+  static const char *const LABELS[][2] = {
+      {"union (built-in cmp)", "union (other cmp)"},
+      {"intersection (built-in cmp)", "intersection (other cmp)"},
+      {"difference (built-in cmp)", "difference (other cmp)"},
+  };
+  size_t exponent;
+  for (exponent = 3; exponent <= BENCH_MAX_EXPONENT; exponent++) {
+    const size_t N = bench_pow10(exponent);
+    const size_t REPS = bench_repetitions(N * 2);
+    /* Even keys against multiples of three, interleaving unpredictably. */
+    vec_u32 *a = strided_set(N, 2, 0);
+    vec_u32 *b = strided_set(N, 3, 0);
+    vec_u32 *dst = flat_set_new(vec_u32, N * 2);
+    size_t op;
+    if (a == NULL || b == NULL || dst == NULL) {
+      if (a != NULL) vector_delete(a);
+      if (b != NULL) vector_delete(b);
+      if (dst != NULL) vector_delete(dst);
+      break;
+    }
+    for (op = 0; op < ARR_LEN(LABELS); op++) {
+      size_t generic;
+      for (generic = 0; generic < 2; generic++) {
+        const vec_comparator CMP =
+            generic ? compare_keys : flat_set_compare_u32;
+        const double START = bench_now();
+        size_t rep;
+        for (rep = 0; rep < REPS; rep++) {
+          switch (op) {
+            case 0:
+              flat_set_union(dst, a, b, CMP);
+              break;
+            case 1:
+              flat_set_intersection(dst, a, b, CMP);
+              break;
+            default:
+              flat_set_difference(dst, a, b, CMP);
+              break;
+          }
+          bench_sink += vector_length(dst);
+        }
+        bench_report(LABELS[op][generic], N, N * 2 * REPS,
+                     bench_now() - START);
+      }
+    }
+    vector_delete(a);
+    vector_delete(b);
+    vector_delete(dst);
+  }
+}
@@ -0,0 +1,10 @@
+#ifndef BENCH_FLAT_SET_H
+#define BENCH_FLAT_SET_H
+
+#include "../../include/myclib.h"
+
+void bench_flat_set_lower_bound(void);
+
+void bench_flat_set_ops(void);
+
+#endif
@@ -0,0 +1,184 @@
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE (199309L)
+#endif
+
+#include "framework.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "../include/myclib.h"
+
+/* - BENCHMARK HEADERS - */
+
+#include "dequebench/dequebench.h"
+#include "flatsetbench/flatsetbench.h"
+#include "hashmapbench/hashmapbench.h"
+#include "queuebench/queuebench.h"
+#include "schedbench/schedbench.h"
+#include "segmentedvectorbench/segmentedvectorbench.h"
+#include "stackbench/stackbench.h"
+#include "vectorbench/vectorbench.h"
+
+/* - FUNCTION MACROS - */
+
+#define CONSTRUCT_SUITE(benches) \
+  {STRINGIFY(benches), benches, ARR_LEN(benches)}
+
+#define CONSTRUCT_BENCH(bench_func) {STRINGIFY(bench_func), bench_func}
+
+/* - BENCHMARKS - */
+
+static const benchmark deque_benches[] = {
+    CONSTRUCT_BENCH(bench_deque_bulk),
+    CONSTRUCT_BENCH(bench_deque_queue),
+};
+
+static const benchmark flat_set_benches[] = {
+    CONSTRUCT_BENCH(bench_flat_set_lower_bound),
+    CONSTRUCT_BENCH(bench_flat_set_ops),
+};
+
+static const benchmark hashmap_benches[] = {
+    CONSTRUCT_BENCH(bench_concurrent_hashmap_mix),
+    CONSTRUCT_BENCH(bench_hashmap_erase),
+    CONSTRUCT_BENCH(bench_hashmap_insert),
+    CONSTRUCT_BENCH(bench_hashmap_lookup),
+};
+
+static const benchmark queue_benches[] = {
+    CONSTRUCT_BENCH(bench_queue_latency),
+    CONSTRUCT_BENCH(bench_queue_throughput),
+};
+
+static const benchmark sched_benches[] = {
+    CONSTRUCT_BENCH(bench_scheduler_fib),
+    CONSTRUCT_BENCH(bench_scheduler_parallel_for),
+};
+
+static const benchmark segmented_vector_benches[] = {
+    CONSTRUCT_BENCH(bench_concurrent_vector_push),
+};
+
+static const benchmark stack_benches[] = {
+    CONSTRUCT_BENCH(bench_concurrent_stack_contention),
+    CONSTRUCT_BENCH(bench_stack_define),
+};
+
+static const benchmark vector_benches[] = {
+    CONSTRUCT_BENCH(bench_vector_define),
+    CONSTRUCT_BENCH(bench_vector_index_of),
+    CONSTRUCT_BENCH(bench_vector_parallel_for_each),
+    CONSTRUCT_BENCH(bench_vector_parallel_scan),
+    CONSTRUCT_BENCH(bench_vector_parallel_sort),
+    CONSTRUCT_BENCH(bench_vector_push),
+    CONSTRUCT_BENCH(bench_vector_radix_sort),
+    CONSTRUCT_BENCH(bench_vector_small),
+    CONSTRUCT_BENCH(bench_vector_soa),
+    CONSTRUCT_BENCH(bench_vector_sort),
+};
+
+/* - EXTERNAL DEFINITIONS - */
+
+const bench_suite bench_suites[] = {
+    CONSTRUCT_SUITE(deque_benches),
+    CONSTRUCT_SUITE(flat_set_benches),
+    CONSTRUCT_SUITE(hashmap_benches),
+    CONSTRUCT_SUITE(queue_benches),
+    CONSTRUCT_SUITE(sched_benches),
+    CONSTRUCT_SUITE(segmented_vector_benches),
+    CONSTRUCT_SUITE(stack_benches),
+    CONSTRUCT_SUITE(vector_benches),
+};
+
+const size_t NUM_BENCH_SUITES = ARR_LEN(bench_suites);
+
+volatile size_t bench_sink;
+
+/* - INTERNAL - */
+
+static void run_benchmark(const benchmark *const bench) {
+  bench_header(bench->NAME);
+  bench->BENCH();
+  (void)fflush(stdout);
+}
+
+static void run_suite(const bench_suite *const suite) {
+  size_t i;
+  for (i = 0; i < suite->num_benchmarks; i++)
+    run_benchmark(suite->benchmarks + i);
+}
+
+/* - TIMING - */
+
+double bench_now(void) {
+#if defined(_POSIX_TIMERS) && defined(CLOCK_MONOTONIC)
+  struct timespec now;
+  (void)clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + ((double)now.tv_nsec / 1e9);
+#else
+  return (double)clock() / (double)CLOCKS_PER_SEC;
+#endif
+}
+
+size_t bench_repetitions(const size_t n) {
+  return n >= BENCH_WORK_TARGET ? 1 : BENCH_WORK_TARGET / n;
+}
+
+size_t bench_pow10(size_t exponent) {
+  size_t n = 1;
+  while (exponent-- != 0) n *= 10;
+  return n;
+}
+
+/* - OUTPUT - */
+
+void bench_header(const char *const title) {
+  printf("\n - %s -\n%-28s %12s %14s %12s\n", title, "case", "n", "ns/op",
+         "Mop/s");
+}
+
+void bench_report(const char *const label, const size_t n, const size_t ops,
+                  const double seconds) {
+  const double NS_PER_OP = ops == 0 ? 0 : (seconds * 1e9) / (double)ops;
+  const double MOPS = seconds <= 0 ? 0 : ((double)ops / seconds) / 1e6;
+  printf("%-28s %12lu %14.3f %12.2f\n", label, (unsigned long)n, NS_PER_OP,
+         MOPS);
+  (void)fflush(stdout);
+}
+
+void bench_report_value(const char *const label, const size_t n,
+                        const double value, const char *const unit) {
+  printf("%-28s %12lu %14.3f %s\n", label, (unsigned long)n, value, unit);
+  (void)fflush(stdout);
+}
+
+/* - RUNNERS - */
+
+void run_all_benchmarks(void) {
+  size_t i;
+  for (i = 0; i < NUM_BENCH_SUITES; i++) run_suite(bench_suites + i);
+}
+
+bool run_benchmarks_named(const char *const name) {
+  bool found = false;
+  size_t i;
+  for (i = 0; i < NUM_BENCH_SUITES; i++) {
+    const bench_suite *const SUITE = bench_suites + i;
+    size_t j;
+    if (strcmp(SUITE->NAME, name) == 0) {
+      run_suite(SUITE);
+      found = true;
+      continue;
+    }
+    for (j = 0; j < SUITE->num_benchmarks; j++) {
+      if (strcmp(SUITE->benchmarks[j].NAME, name) == 0) {
+        run_benchmark(SUITE->benchmarks + j);
+        found = true;
+      }
+    }
+  }
+  return found;
+}
@@ -0,0 +1,87 @@
+#ifndef BENCH_FRAMEWORK
+#define BENCH_FRAMEWORK
+
+#include <stddef.h>
+
+#include "../include/myclib.h"
+
+/* - DEFINITIONS - */
+
+/*
+ * The largest power of ten used as a problem size by the benchmarks. Lowering
+ * this shortens a full benchmark run considerably.
+ */
+#ifndef BENCH_MAX_EXPONENT
+#define BENCH_MAX_EXPONENT (8)
+#endif
+
+/*
+ * The number of elements a benchmark should process per measurement before
+ * the measurement is considered long enough to be meaningful.
+ */
+#define BENCH_WORK_TARGET ((size_t)10000000)
+
+typedef void (*bench_func_t)(void);
+
+typedef struct benchmark {
+  const char *const NAME;
+  const bench_func_t BENCH;
+} benchmark;
+
+typedef struct bench_suite {
+  const char *const NAME;
+  const benchmark *benchmarks;
+  size_t num_benchmarks;
+} bench_suite;
+
+extern const bench_suite bench_suites[];
+
+extern const size_t NUM_BENCH_SUITES;
+
+/*
+ * Benchmarks write results they compute here so that the compiler cannot
+ * discard the work being measured.
+ */
+extern volatile size_t bench_sink;
+
+/* - FUNCTIONS - */
+
+/* - TIMING - */
+
+/* Returns a monotonic wall-clock timestamp in seconds. */
+double bench_now(void);
+
+/*
+ * Returns the number of repetitions needed for a problem of size `n` to
+ * process roughly `BENCH_WORK_TARGET` elements in total.
+ */
+size_t bench_repetitions(size_t n);
+
+/* Returns `10` raised to `exponent`. */
+size_t bench_pow10(size_t exponent);
+
+/* - OUTPUT - */
+
+void bench_header(const char *title);
+
+/*
+ * Prints one result row: a label, the problem size, the number of operations
+ * performed and the time they took.
+ */
+void bench_report(const char *label, size_t n, size_t ops, double seconds);
+
+/*
+ * Prints a row reporting some quantity other than time per operation, such as
+ * the number of allocations made, in the given `unit`.
+ */
+void bench_report_value(const char *label, size_t n, double value,
+                        const char *unit);
+
+/* - RUNNERS - */
+
+void run_all_benchmarks(void);
+
+/* Runs every suite or benchmark whose name matches `name`. */
+bool run_benchmarks_named(const char *name);
+
+#endif
@@ -0,0 +1,259 @@
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE (200112L)
+#endif
+
+#include "hashmapbench.h"
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "../../hashmap/concurrenthashmap.h"
+#include "../../hashmap/hashmap.h"
+#include "../../include/myclib.h"
+#include "../../threadpool/threadpool.h"
+#include "../../vector/vector.h"
+#include "../framework.h"
+
+/*
+ * The load factors measured, in eighths of the capacity, from half full to
+ * the most a map holds before growing.
+ */
+#define MIN_LOAD_EIGHTHS (4)
+#define MAX_LOAD_EIGHTHS (7)
+
+/* Linear scans are quadratic overall, so they are only timed up to here. */
+#define SCAN_MAX_N ((size_t)5000)
+
+/* Contention is measured up to this many threads, whatever the CPU count. */
+#define MAX_MIX_THREADS ((size_t)64)
+
+/* - INTERNAL - */
+
+DEFINE_HASHMAP(vec_u64, vec_u64, u64map);
+
+/* Distinct keys in no particular order, as the multiplier is odd. */
+#define bench_key(i) ((vec_u64)(i) * (vec_u64)2654435761U)
+
+/* The capacities measured, which are powers of two from a few groups up. */
+#define for_each_capacity(capacity)                           \
+  for ((capacity) = (size_t)1 << 10;                          \
+       (capacity) <= bench_pow10(BENCH_MAX_EXPONENT) * 2;     \
+       (capacity) *= 16)
+
+static void fill(u64map *const map, const size_t n) {
+  size_t i;
+  hashmap_clear(*map);
+  for (i = 0; i < n; i++) u64map_put(map, bench_key(i), (vec_u64)i);
+}
+
+static void report_load(const char *const operation, const size_t eighths,
+                        const size_t n, const size_t ops,
+                        const double seconds) {
+  char label[32];
+  sprintf(label, "%s (load %.3f)", operation, (double)eighths / 8);
+  bench_report(label, n, ops, seconds);
+}
+
+/*
+ * Every task performs `per_task` operations on keys drawn from twice as many
+ * as were inserted up front, of which `write_percent` in a hundred are puts
+ * and the rest lookups, on either a concurrent map or a map guarded by `lock`.
+ */
+typedef struct mix_ctx {
+  concurrent_hashmap *shared;
+  u64map guarded;
+  pthread_mutex_t lock;
+  size_t n;
+  size_t per_task;
+  size_t write_percent;
+  size_t hits[MAX_MIX_THREADS];
+} mix_ctx;
+
+static void mix_concurrent(void *const ctx, const size_t index) {
+  mix_ctx *const mix = ctx;
+  size_t hits = 0;
+  size_t i;
+  for (i = 0; i < mix->per_task; i++) {
+    const vec_u64 KEY = bench_key((index * mix->per_task + i) % (mix->n * 2));
+    if (i % 100 < mix->write_percent)
+      concurrent_hashmap_put(mix->shared, &KEY, &i);
+    else
+      hits += concurrent_hashmap_get(mix->shared, &KEY, NULL);
+  }
+  mix->hits[index] = hits;
+}
+
+static void mix_guarded(void *const ctx, const size_t index) {
+  mix_ctx *const mix = ctx;
+  size_t hits = 0;
+  size_t i;
+  for (i = 0; i < mix->per_task; i++) {
+    const vec_u64 KEY = bench_key((index * mix->per_task + i) % (mix->n * 2));
+    pthread_mutex_lock(&mix->lock);
+    if (i % 100 < mix->write_percent)
+      u64map_put(&mix->guarded, KEY, (vec_u64)i);
+    else
+      hits += u64map_get(mix->guarded, KEY) != NULL;
+    pthread_mutex_unlock(&mix->lock);
+  }
+  mix->hits[index] = hits;
+}
+
+static double time_mix(const bool concurrent, threadpool *const pool,
+                       mix_ctx *const mix, const size_t reps) {
+  const size_t THREADS = threadpool_size(pool);
+  double start;
+  size_t rep;
+  size_t i;
+  mix->per_task = mix->n / THREADS;
+  if (concurrent) {
+    mix->shared = concurrent_hashmap_new(sizeof(vec_u64), sizeof(size_t), 0);
+    for (i = 0; i < mix->n; i++) {
+      const vec_u64 KEY = bench_key(i);
+      concurrent_hashmap_put(mix->shared, &KEY, &i);
+    }
+  } else {
+    mix->guarded = u64map_new(mix->n);
+    fill(&mix->guarded, mix->n);
+  }
+  start = bench_now();
+  for (rep = 0; rep < reps; rep++) {
+    threadpool_run(pool, concurrent ? mix_concurrent : mix_guarded, mix,
+                   THREADS);
+    for (i = 0; i < THREADS; i++) bench_sink += mix->hits[i];
+  }
+  start = bench_now() - start;
+  if (concurrent)
+    concurrent_hashmap_delete(mix->shared);
+  else
+    u64map_delete(&mix->guarded);
+  return start;
+}
+
+/* - BENCHMARKS - */
+
+void bench_concurrent_hashmap_mix(void) {
+  static const size_t WRITE_PERCENTS[] = {1, 10, 50};
+  static mix_ctx mix;
+  size_t exponent;
+  pthread_mutex_init(&mix.lock, NULL);
+  for (exponent = 4; exponent <= BENCH_MAX_EXPONENT; exponent++) {
+    const size_t REPS = bench_repetitions(bench_pow10(exponent));
+    size_t threads;
+    mix.n = bench_pow10(exponent);
+    /* Doubles the thread count, oversubscribing the CPU past its core count. */
+    for (threads = 1; threads <= MAX_MIX_THREADS; threads *= 2) {
+      threadpool *const pool = threadpool_new(threads);
+      const size_t OPS = mix.n / threads * threads * REPS;
+      size_t w;
+      if (pool == NULL) break;
+      for (w = 0; w < ARR_LEN(WRITE_PERCENTS); w++) {
+        char label[32];
+        mix.write_percent = WRITE_PERCENTS[w];
+        sprintf(label, "mutex %lu%% put, %lu threads",
+                (unsigned long)mix.write_percent, (unsigned long)threads);
+        bench_report(label, mix.n, OPS, time_mix(false, pool, &mix, REPS));
+        sprintf(label, "sharded %lu%% put, %lu threads",
+                (unsigned long)mix.write_percent, (unsigned long)threads);
+        bench_report(label, mix.n, OPS, time_mix(true, pool, &mix, REPS));
+      }
+      threadpool_delete(pool);
+    }
+  }
+  pthread_mutex_destroy(&mix.lock);
+}
+
+
+void bench_hashmap_erase(void) {
+  size_t capacity;
+  for_each_capacity(capacity) {
+    size_t eighths;
+    for (eighths = MIN_LOAD_EIGHTHS; eighths <= MAX_LOAD_EIGHTHS; eighths++) {
+      const size_t N = capacity * eighths / 8;
+      const size_t REPS = bench_repetitions(N);
+      u64map map = u64map_new(HASHMAP_MAX_LOAD(capacity));
+      double seconds = 0;
+      size_t rep;
+      if (map == NULL) return;
+      for (rep = 0; rep < REPS; rep++) {
+        double start;
+        size_t i;
+        fill(&map, N);
+        start = bench_now();
+        for (i = 0; i < N; i++) bench_sink += u64map_erase(map, bench_key(i));
+        seconds += bench_now() - start;
+      }
+      report_load("erase", eighths, N, N * REPS, seconds);
+      u64map_delete(&map);
+    }
+  }
+}
+
+void bench_hashmap_insert(void) {
+  size_t capacity;
+  for_each_capacity(capacity) {
+    size_t eighths;
+    for (eighths = MIN_LOAD_EIGHTHS; eighths <= MAX_LOAD_EIGHTHS; eighths++) {
+      const size_t N = capacity * eighths / 8;
+      const size_t REPS = bench_repetitions(N);
+      /* Reserved up front, so no insertion grows the map. */
+      u64map map = u64map_new(HASHMAP_MAX_LOAD(capacity));
+      double start;
+      size_t rep;
+      if (map == NULL) return;
+      start = bench_now();
+      for (rep = 0; rep < REPS; rep++) {
+        fill(&map, N);
+        bench_sink += hashmap_length(map);
+      }
+      report_load("insert", eighths, N, N * REPS, bench_now() - start);
+      u64map_delete(&map);
+    }
+  }
+}
+
+void bench_hashmap_lookup(void) {
+  size_t capacity;
+  for_each_capacity(capacity) {
+    size_t eighths;
+    for (eighths = MIN_LOAD_EIGHTHS; eighths <= MAX_LOAD_EIGHTHS; eighths++) {
+      const size_t N = capacity * eighths / 8;
+      const size_t REPS = bench_repetitions(N);
+      u64map map = u64map_new(HASHMAP_MAX_LOAD(capacity));
+      double start;
+      size_t rep;
+      size_t i;
+      if (map == NULL) return;
+      fill(&map, N);
+      start = bench_now();
+      for (rep = 0; rep < REPS; rep++)
+        for (i = 0; i < N; i++)
+          bench_sink += *u64map_get(map, bench_key(i));
+      report_load("hit", eighths, N, N * REPS, bench_now() - start);
+      /* Misses stop at the first group nothing overflowed from. */
+      start = bench_now();
+      for (rep = 0; rep < REPS; rep++)
+        for (i = 0; i < N; i++)
+          bench_sink += u64map_get(map, bench_key(N + i)) != NULL;
+      report_load("miss", eighths, N, N * REPS, bench_now() - start);
+
+      /* The linear scan which was the only lookup before hash maps. */
+      if (eighths == MAX_LOAD_EIGHTHS && N <= SCAN_MAX_N) {
+        vector(vec_u64) keys = vector_new(vec_u64, N);
+        for (i = 0; i < N; i++) vector_push(keys, bench_key(i));
+        start = bench_now();
+        for (rep = 0; rep < REPS / N + 1; rep++) {
+          for (i = 0; i < N; i++) {
+            const vec_u64 KEY = bench_key(i);
+            bench_sink += vector_index_of(keys, KEY);
+          }
+        }
+        bench_report("hit (vector_index_of)", N, N * (REPS / N + 1),
+                     bench_now() - start);
+        vector_delete(keys);
+      }
+      u64map_delete(&map);
+    }
+  }
+}
@@ -0,0 +1,14 @@
+#ifndef BENCH_HASHMAP_H
+#define BENCH_HASHMAP_H
+
+#include "../../include/myclib.h"
+
+void bench_concurrent_hashmap_mix(void);
+
+void bench_hashmap_erase(void);
+
+void bench_hashmap_insert(void);
+
+void bench_hashmap_lookup(void);
+
+#endif
@@ -0,0 +1,21 @@
+#include <stdio.h>
+
+#include "framework.h"
+
+/*
+ * With no arguments, every benchmark is run. Otherwise, each argument names a
+ * suite (e.g. `vector_benches`) or a single benchmark to run.
+ */
+int main(int argc, char *argv[]) {
+  int i;
+  setvbuf(stdout, NULL, _IOFBF, BUFSIZ);
+  if (argc < 2) {
+    run_all_benchmarks();
+    return 0;
+  }
+  for (i = 1; i < argc; i++) {
+    if (!run_benchmarks_named(argv[i]))
+      (void)fprintf(stderr, "No benchmark or suite named \"%s\".\n", argv[i]);
+  }
+  return 0;
+}
@@ -0,0 +1,291 @@
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE (200112L)
+#endif
+
+#include "queuebench.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "../../deque/deque.h"
+#include "../../include/myclib.h"
+#include "../../queue/mpmcqueue.h"
+#include "../../queue/spscqueue.h"
+#include "../framework.h"
+
+/* The capacity of every queue, which bounds how far producers run ahead. */
+#define QUEUE_CAPACITY ((size_t)1024)
+
+/* The most producer/consumer pairs sharing an MPMC queue. */
+#define MAX_PAIRS ((size_t)4)
+
+/* The largest batch moved at once. */
+#define MAX_BATCH ((size_t)32)
+
+/* Round trips take a context switch each on a single core, so are capped. */
+#define LATENCY_MAX_EXPONENT ((size_t)5)
+
+/* - INTERNAL - */
+
+typedef enum channel_kind {
+  CHANNEL_MUTEX,
+  CHANNEL_MPMC,
+  CHANNEL_SPSC
+} channel_kind;
+
+/*
+ * A bounded queue of one of the kinds measured. `CHANNEL_MUTEX` is the
+ * baseline: a deque behind a mutex, bounded to the same capacity.
+ */
+typedef struct channel {
+  channel_kind kind;
+  spsc_queue(size_t) spsc;
+  mpmc_queue(size_t) mpmc;
+  deque(size_t) guarded;
+  pthread_mutex_t lock;
+} channel;
+
+static const char *const CHANNEL_NAMES[] = {"mutex", "mpmc", "spsc"};
+
+static bool channel_init(channel *const ch, const channel_kind kind) {
+  ch->kind = kind;
+  ch->spsc = NULL;
+  ch->mpmc = NULL;
+  ch->guarded = NULL;
+  switch (kind) {
+    case CHANNEL_MUTEX:
+      pthread_mutex_init(&ch->lock, NULL);
+      ch->guarded = deque_new(size_t, QUEUE_CAPACITY);
+      return ch->guarded != NULL;
+    case CHANNEL_MPMC:
+      ch->mpmc = mpmc_queue_new(size_t, QUEUE_CAPACITY);
+      return ch->mpmc != NULL;
+    case CHANNEL_SPSC:
+      ch->spsc = spsc_queue_new(size_t, QUEUE_CAPACITY);
+      return ch->spsc != NULL;
+    default:
+      return false;
+  }
+}
+
+static void channel_destroy(channel *const ch) {
+  if (ch->guarded != NULL) {
+    deque_delete(ch->guarded);
+    pthread_mutex_destroy(&ch->lock);
+  }
+  if (ch->mpmc != NULL) mpmc_queue_delete(ch->mpmc);
+  if (ch->spsc != NULL) spsc_queue_delete(ch->spsc);
+}
+
+/* Moves up to `count` values in, returning the number moved. */
+static size_t channel_send(channel *const ch, const size_t *const src,
+                           const size_t count) {
+  size_t sent;
+  switch (ch->kind) {
+    case CHANNEL_MUTEX:
+      pthread_mutex_lock(&ch->lock);
+      sent = QUEUE_CAPACITY - deque_length(ch->guarded);
+      if (sent > count) sent = count;
+      deque_push_back_n(ch->guarded, src, sent);
+      pthread_mutex_unlock(&ch->lock);
+      return sent;
+    case CHANNEL_MPMC:
+      return mpmc_queue_push_n(ch->mpmc, src, count);
+    case CHANNEL_SPSC:
+      return spsc_queue_push_n(ch->spsc, src, count);
+    default:
+      return 0;
+  }
+}
+
+static size_t channel_receive(channel *const ch, size_t *const dst,
+                              const size_t count) {
+  size_t received;
+  switch (ch->kind) {
+    case CHANNEL_MUTEX:
+      pthread_mutex_lock(&ch->lock);
+      received = deque_pop_front_n(ch->guarded, dst, count);
+      pthread_mutex_unlock(&ch->lock);
+      return received;
+    case CHANNEL_MPMC:
+      return mpmc_queue_pop_n(ch->mpmc, dst, count);
+    case CHANNEL_SPSC:
+      return spsc_queue_pop_n(ch->spsc, dst, count);
+    default:
+      return 0;
+  }
+}
+
+/*
+ * Sends or receives exactly `count` values, yielding whenever the queue is
+ * full or empty, which keeps single-core machines moving.
+ */
+static void send_all(channel *const ch, const size_t *const src,
+                     const size_t count) {
+  size_t sent = 0;
+  while (sent < count) {
+    const size_t SENT = channel_send(ch, src + sent, count - sent);
+    if (SENT == 0) sched_yield();
+    sent += SENT;
+  }
+}
+
+static void receive_all(channel *const ch, size_t *const dst,
+                        const size_t count) {
+  size_t received = 0;
+  while (received < count) {
+    const size_t RECEIVED =
+        channel_receive(ch, dst + received, count - received);
+    if (RECEIVED == 0) sched_yield();
+    received += RECEIVED;
+  }
+}
+
+/* Every producer sends, and every consumer receives, `per_thread` values. */
+typedef struct stream_ctx {
+  channel *ch;
+  size_t per_thread;
+  size_t batch;
+} stream_ctx;
+
+static void *produce(void *const ctx) {
+  const stream_ctx *const STREAM = ctx;
+  size_t values[MAX_BATCH];
+  size_t sent;
+  size_t i;
+  for (i = 0; i < STREAM->batch; i++) values[i] = i;
+  for (sent = 0; sent < STREAM->per_thread; sent += STREAM->batch)
+    send_all(STREAM->ch, values, STREAM->batch);
+  return NULL;
+}
+
+static void *consume(void *const ctx) {
+  const stream_ctx *const STREAM = ctx;
+  size_t values[MAX_BATCH];
+  size_t sum = 0;
+  size_t received;
+  for (received = 0; received < STREAM->per_thread;
+       received += STREAM->batch) {
+    receive_all(STREAM->ch, values, STREAM->batch);
+    sum += values[0];
+  }
+  return (void *)sum;
+}
+
+/* Streams `n` values through `pairs` producers and as many consumers. */
+static double time_stream(const channel_kind kind, const size_t pairs,
+                          const size_t batch, const size_t n) {
+  pthread_t producers[MAX_PAIRS];
+  pthread_t consumers[MAX_PAIRS];
+  stream_ctx stream;
+  channel ch;
+  double start;
+  size_t i;
+  if (!channel_init(&ch, kind)) return 0;
+  stream.ch = &ch;
+  stream.batch = batch;
+  stream.per_thread = n / pairs / batch * batch;
+  start = bench_now();
+  for (i = 0; i < pairs; i++) {
+    pthread_create(&consumers[i], NULL, consume, &stream);
+    pthread_create(&producers[i], NULL, produce, &stream);
+  }
+  for (i = 0; i < pairs; i++) {
+    void *sum;
+    pthread_join(producers[i], NULL);
+    pthread_join(consumers[i], &sum);
+    bench_sink += (size_t)sum;
+  }
+  start = bench_now() - start;
+  channel_destroy(&ch);
+  return start;
+}
+
+/* Sends each value back over `replies`, until it has echoed `count`. */
+typedef struct echo_ctx {
+  channel requests;
+  channel replies;
+  size_t count;
+} echo_ctx;
+
+static void *echo(void *const ctx) {
+  echo_ctx *const ECHO = ctx;
+  size_t i;
+  for (i = 0; i < ECHO->count; i++) {
+    size_t value;
+    receive_all(&ECHO->requests, &value, 1);
+    send_all(&ECHO->replies, &value, 1);
+  }
+  return NULL;
+}
+
+/* Times `n` round trips of a single value to another thread and back. */
+static double time_round_trips(const channel_kind kind, const size_t n) {
+  static echo_ctx ping;
+  pthread_t echoer;
+  double start;
+  size_t i;
+  if (!channel_init(&ping.requests, kind)) return 0;
+  if (!channel_init(&ping.replies, kind)) {
+    channel_destroy(&ping.requests);
+    return 0;
+  }
+  ping.count = n;
+  start = bench_now();
+  pthread_create(&echoer, NULL, echo, &ping);
+  for (i = 0; i < n; i++) {
+    size_t value = i;
+    send_all(&ping.requests, &value, 1);
+    receive_all(&ping.replies, &value, 1);
+    bench_sink += value;
+  }
+  pthread_join(echoer, NULL);
+  start = bench_now() - start;
+  channel_destroy(&ping.requests);
+  channel_destroy(&ping.replies);
+  return start;
+}
+
+/* - BENCHMARKS - */
+
+void bench_queue_latency(void) {
+  size_t exponent;
+  for (exponent = 3;
+       exponent <= BENCH_MAX_EXPONENT && exponent <= LATENCY_MAX_EXPONENT;
+       exponent++) {
+    const size_t N = bench_pow10(exponent);
+    size_t kind;
+    for (kind = 0; kind < ARR_LEN(CHANNEL_NAMES); kind++) {
+      char label[32];
+      sprintf(label, "%s round trip", CHANNEL_NAMES[kind]);
+      bench_report(label, N, N, time_round_trips((channel_kind)kind, N));
+    }
+  }
+}
+
+void bench_queue_throughput(void) {
+  static const size_t BATCHES[] = {1, MAX_BATCH};
+  size_t exponent;
+  for (exponent = 4; exponent <= BENCH_MAX_EXPONENT; exponent++) {
+    const size_t N = bench_pow10(exponent);
+    size_t pairs;
+    for (pairs = 1; pairs <= MAX_PAIRS; pairs *= 2) {
+      size_t b;
+      for (b = 0; b < ARR_LEN(BATCHES); b++) {
+        const size_t OPS = N / pairs / BATCHES[b] * BATCHES[b] * pairs;
+        size_t kind;
+        for (kind = 0; kind < ARR_LEN(CHANNEL_NAMES); kind++) {
+          char label[32];
+          /* Only a single pair may share an SPSC queue. */
+          if (kind == CHANNEL_SPSC && pairs != 1) continue;
+          sprintf(label, "%s, %lu pairs, batch %lu", CHANNEL_NAMES[kind],
+                  (unsigned long)pairs, (unsigned long)BATCHES[b]);
+          bench_report(label, N, OPS,
+                       time_stream((channel_kind)kind, pairs, BATCHES[b], N));
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,10 @@
+#ifndef BENCH_QUEUE_H
+#define BENCH_QUEUE_H
+
+#include "../../include/myclib.h"
+
+void bench_queue_latency(void);
+
+void bench_queue_throughput(void);
+
+#endif
@@ -0,0 +1,184 @@
+#include "schedbench.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../../include/myclib.h"
+#include "../../sched/scheduler.h"
+#include "../../threadpool/threadpool.h"
+#include "../framework.h"
+
+/* Each step of five multiplies the number of calls by about eleven. */
+#define FIB_MIN_N ((size_t)10)
+
+#define FIB_MAX_N (FIB_MIN_N + (size_t)(BENCH_MAX_EXPONENT) * 2)
+
+/* The threadpool baseline hands out this many chunks per thread. */
+#define POOL_CHUNKS_PER_THREAD ((size_t)4)
+
+/* - INTERNAL - */
+
+typedef struct fib_ctx {
+  size_t n;
+  size_t result;
+} fib_ctx;
+
+static size_t fib_serial(const size_t n) {
+  return n < 2 ? n : fib_serial(n - 1) + fib_serial(n - 2);
+}
+
+/* Spawns one of the two halves of every call, down to the leaves. */
+static void fib_task(scheduler_worker *const worker, void *const arg) {
+  fib_ctx *const ctx = arg;
+  fib_ctx left;
+  fib_ctx right;
+  scheduler_group group;
+  scheduler_job job;
+  if (ctx->n < 2) {
+    ctx->result = ctx->n;
+    return;
+  }
+  left.n = ctx->n - 1;
+  right.n = ctx->n - 2;
+  scheduler_group_init(&group);
+  scheduler_spawn(worker, &group, &job, fib_task, &left);
+  fib_task(worker, &right);
+  scheduler_wait(worker, &group);
+  ctx->result = left.result + right.result;
+}
+
+/* The number of calls computing the `n`th Fibonacci number recursively. */
+static size_t fib_calls(const size_t n) {
+  return (2 * fib_serial(n + 1)) - 1;
+}
+
+static double time_fib(scheduler *const sched, const size_t n,
+                       const size_t reps) {
+  const double START = bench_now();
+  size_t rep;
+  for (rep = 0; rep < reps; rep++) {
+    fib_ctx ctx;
+    ctx.n = n;
+    if (sched == NULL) {
+      ctx.result = fib_serial(n);
+    } else {
+      scheduler_run(sched, fib_task, &ctx);
+    }
+    bench_sink += ctx.result;
+  }
+  return bench_now() - START;
+}
+
+/* A loop body cheap enough that scheduling dominates. */
+static void scramble_range(void *const ctx, const size_t begin,
+                           const size_t end) {
+  size_t *const values = ctx;
+  size_t i;
+  for (i = begin; i < end; i++) values[i] = (values[i] * 31) + i;
+}
+
+typedef struct pool_loop {
+  size_t *values;
+  size_t length;
+  size_t chunk;
+} pool_loop;
+
+static void scramble_chunk(void *const arg, const size_t index) {
+  const pool_loop *const loop = arg;
+  const size_t BEGIN = index * loop->chunk;
+  const size_t END =
+      loop->length - BEGIN < loop->chunk ? loop->length : BEGIN + loop->chunk;
+  scramble_range(loop->values, BEGIN, END);
+}
+
+/*
+ * Times `reps` loops over `values` on `sched` if it is not `NULL`, else on
+ * `pool` if it is not `NULL`, else serially.
+ */
+static double time_loop(scheduler *const sched, threadpool *const pool,
+                        size_t *const values, const size_t n,
+                        const size_t reps) {
+  const size_t CHUNKS = POOL_CHUNKS_PER_THREAD * threadpool_size(pool);
+  const double START = bench_now();
+  pool_loop loop;
+  size_t rep;
+  loop.values = values;
+  loop.length = n;
+  loop.chunk = (n + CHUNKS - 1) / CHUNKS;
+  for (rep = 0; rep < reps; rep++) {
+    if (sched != NULL) {
+      scheduler_run_for(sched, 0, n, 0, scramble_range, values);
+    } else if (pool != NULL) {
+      threadpool_run(pool, scramble_chunk, &loop,
+                     (n + loop.chunk - 1) / loop.chunk);
+    } else {
+      scramble_range(values, 0, n);
+    }
+  }
+  bench_sink += values[n - 1];
+  return bench_now() - START;
+}
+
+/* - BENCHMARKS - */
+
+void bench_scheduler_fib(void) {
+  const size_t CPU_COUNT = threadpool_cpu_count();
+  size_t n;
+  for (n = FIB_MIN_N; n <= FIB_MAX_N; n += 5) {
+    const size_t CALLS = fib_calls(n);
+    const size_t REPS = bench_repetitions(CALLS);
+    size_t threads;
+    bench_report("serial recursion", CALLS, CALLS * REPS,
+                 time_fib(NULL, n, REPS));
+    /* Doubles the thread count until every core is in use. */
+    for (threads = 1;; threads *= 2) {
+      scheduler *sched;
+      char label[32];
+      if (threads > CPU_COUNT) threads = CPU_COUNT;
+      sched = scheduler_new(threads);
+      if (sched == NULL) break;
+      sprintf(label, "fork/join, %lu threads", (unsigned long)threads);
+      bench_report(label, CALLS, CALLS * REPS, time_fib(sched, n, REPS));
+      scheduler_delete(sched);
+      if (threads == CPU_COUNT) break;
+    }
+  }
+}
+
+void bench_scheduler_parallel_for(void) {
+  const size_t CPU_COUNT = threadpool_cpu_count();
+  size_t exponent;
+  for (exponent = 2; exponent <= BENCH_MAX_EXPONENT; exponent++) {
+    const size_t N = bench_pow10(exponent);
+    const size_t REPS = bench_repetitions(N);
+    size_t *const values = calloc(N, sizeof *values);
+    size_t threads;
+    if (values == NULL) break;
+    bench_report("serial loop", N, N * REPS,
+                 time_loop(NULL, NULL, values, N, REPS));
+    /* Doubles the thread count until every core is in use. */
+    for (threads = 1;; threads *= 2) {
+      scheduler *sched;
+      threadpool *pool;
+      char label[32];
+      if (threads > CPU_COUNT) threads = CPU_COUNT;
+      sched = scheduler_new(threads);
+      pool = threadpool_new(threads);
+      if (sched == NULL || pool == NULL) {
+        scheduler_delete(sched);
+        threadpool_delete(pool);
+        break;
+      }
+      sprintf(label, "parallel_for, %lu threads", (unsigned long)threads);
+      bench_report(label, N, N * REPS,
+                   time_loop(sched, NULL, values, N, REPS));
+      sprintf(label, "threadpool, %lu threads", (unsigned long)threads);
+      bench_report(label, N, N * REPS, time_loop(NULL, pool, values, N, REPS));
+      scheduler_delete(sched);
+      threadpool_delete(pool);
+      if (threads == CPU_COUNT) break;
+    }
+    free(values);
+  }
+}
@@ -0,0 +1,10 @@
+#ifndef BENCH_SCHED_H
+#define BENCH_SCHED_H
+
+#include "../../include/myclib.h"
+
+void bench_scheduler_fib(void);
+
+void bench_scheduler_parallel_for(void);
+
+#endif
@@ -0,0 +1,96 @@
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE (200112L)
+#endif
+
+#include "segmentedvectorbench.h"
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "../../include/myclib.h"
+#include "../../segmentedvector/concurrentvector.h"
+#include "../../threadpool/threadpool.h"
+#include "../../vector/vector.h"
+#include "../framework.h"
+
+/* Contention is measured up to this many threads, whatever the CPU count. */
+#define MAX_PUSH_THREADS ((size_t)64)
+
+/* - INTERNAL - */
+
+/*
+ * Every task pushes `per_task` elements, either to a concurrent vector or to a
+ * vector guarded by `lock`.
+ */
+typedef struct push_ctx {
+  concurrent_vector(size_t) shared;
+  vector(size_t) guarded;
+  pthread_mutex_t lock;
+  size_t per_task;
+} push_ctx;
+
+static void push_concurrent(void *const ctx, const size_t index) {
+  push_ctx *const push = ctx;
+  size_t i;
+  for (i = index * push->per_task; i < (index + 1) * push->per_task; i++)
+    concurrent_vector_push(push->shared, i);
+}
+
+static void push_guarded(void *const ctx, const size_t index) {
+  push_ctx *const push = ctx;
+  size_t i;
+  for (i = index * push->per_task; i < (index + 1) * push->per_task; i++) {
+    pthread_mutex_lock(&push->lock);
+    vector_push_s(push->guarded, i);
+    pthread_mutex_unlock(&push->lock);
+  }
+}
+
+static double time_pushes(const bool concurrent, threadpool *const pool,
+                          const size_t n, const size_t reps) {
+  const size_t THREADS = threadpool_size(pool);
+  const double START = bench_now();
+  push_ctx push;
+  size_t rep;
+  pthread_mutex_init(&push.lock, NULL);
+  push.per_task = n / THREADS;
+  for (rep = 0; rep < reps; rep++) {
+    if (concurrent) {
+      push.shared = concurrent_vector_new(size_t);
+      threadpool_run(pool, push_concurrent, &push, THREADS);
+      bench_sink += concurrent_vector_snapshot(push.shared);
+      concurrent_vector_delete(push.shared);
+    } else {
+      push.guarded = vector_new(size_t, 0);
+      threadpool_run(pool, push_guarded, &push, THREADS);
+      bench_sink += vector_length(push.guarded);
+      vector_delete(push.guarded);
+    }
+  }
+  pthread_mutex_destroy(&push.lock);
+  return bench_now() - START;
+}
+
+/* - BENCHMARKS - */
+
+void bench_concurrent_vector_push(void) {
+  size_t exponent;
+  for (exponent = 4; exponent <= BENCH_MAX_EXPONENT; exponent++) {
+    const size_t N = bench_pow10(exponent);
+    const size_t REPS = bench_repetitions(N);
+    size_t threads;
+    /* Doubles the thread count, oversubscribing the CPU past its core count. */
+    for (threads = 1; threads <= MAX_PUSH_THREADS; threads *= 2) {
+      threadpool *const pool = threadpool_new(threads);
+      const size_t OPS = N / threads * threads * REPS;
+      char label[32];
+      if (pool == NULL) break;
+      sprintf(label, "mutex+push_s, %lu threads", (unsigned long)threads);
+      bench_report(label, N, OPS, time_pushes(false, pool, N, REPS));
+      sprintf(label, "concurrent, %lu threads", (unsigned long)threads);
+      bench_report(label, N, OPS, time_pushes(true, pool, N, REPS));
+      threadpool_delete(pool);
+    }
+  }
+}
@@ -0,0 +1,8 @@
+#ifndef BENCH_SEGMENTED_VECTOR_H
+#define BENCH_SEGMENTED_VECTOR_H
+
+#include "../../include/myclib.h"
+
+void bench_concurrent_vector_push(void);
+
+#endif
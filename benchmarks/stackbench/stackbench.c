@@ -0,0 +1,201 @@
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE (200112L)
+#endif
+
+#include "stackbench.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "../../include/myclib.h"
+#include "../../stack/concurrentstack.h"
+#include "../../stack/stack.h"
+#include "../../threadpool/threadpool.h"
+#include "../framework.h"
+
+/* The most threads contending on one stack. */
+#define MAX_THREADS ((size_t)8)
+
+/* The number of nodes each thread moves at once in the batched cases. */
+#define BATCH ((size_t)16)
+
+/* - INTERNAL - */
+
+DEFINE_STACK(size_t, sstack);
+
+typedef enum contention_mode {
+  CONTENTION_MUTEX,
+  CONTENTION_MUTEX_BATCH,
+  CONTENTION_TREIBER,
+  CONTENTION_TREIBER_CHAIN
+} contention_mode;
+
+static const char *const CONTENTION_NAMES[] = {"mutex", "mutex batch",
+                                               "treiber", "treiber chain"};
+
+/*
+ * The shared state of one measurement. Each thread owns `BATCH` nodes, which
+ * get mixed up with the other threads' as they are popped.
+ */
+typedef struct contention_ctx {
+  contention_mode mode;
+  size_t rounds;
+  stack(size_t) guarded;
+  pthread_mutex_t lock;
+  concurrent_stack *lock_free;
+  concurrent_stack_node nodes[MAX_THREADS][BATCH];
+} contention_ctx;
+
+/*
+ * Pushes and pops one value or node per round, or `BATCH` of them. Batched
+ * mutex rounds take the lock once per direction; batched Treiber rounds push
+ * one chain and pop the nodes singly.
+ */
+static void contend(void *const arg, const size_t index) {
+  contention_ctx *const ctx = arg;
+  concurrent_stack_node *chain[BATCH];
+  concurrent_stack_node *node = &ctx->nodes[index][0];
+  size_t round;
+  size_t i;
+  for (i = 0; i < BATCH; i++) chain[i] = &ctx->nodes[index][i];
+  for (round = 0; round < ctx->rounds; round++) {
+    switch (ctx->mode) {
+      case CONTENTION_MUTEX:
+        pthread_mutex_lock(&ctx->lock);
+        stack_push_s(ctx->guarded, round);
+        pthread_mutex_unlock(&ctx->lock);
+        pthread_mutex_lock(&ctx->lock);
+        bench_sink += *(size_t *)stack_pop_s(ctx->guarded);
+        pthread_mutex_unlock(&ctx->lock);
+        break;
+      case CONTENTION_MUTEX_BATCH:
+        pthread_mutex_lock(&ctx->lock);
+        for (i = 0; i < BATCH; i++) stack_push_s(ctx->guarded, i);
+        pthread_mutex_unlock(&ctx->lock);
+        pthread_mutex_lock(&ctx->lock);
+        for (i = 0; i < BATCH; i++) stack_pop_s(ctx->guarded);
+        pthread_mutex_unlock(&ctx->lock);
+        break;
+      case CONTENTION_TREIBER:
+        concurrent_stack_push(ctx->lock_free, node);
+        node = concurrent_stack_pop(ctx->lock_free);
+        break;
+      case CONTENTION_TREIBER_CHAIN:
+        for (i = 0; i + 1 < BATCH; i++)
+          concurrent_stack_link(chain[i], chain[i + 1]);
+        concurrent_stack_push_chain(ctx->lock_free, chain[0],
+                                    chain[BATCH - 1]);
+        /* Other threads may briefly hold every node left. */
+        for (i = 0; i < BATCH; i++) {
+          while ((chain[i] = concurrent_stack_pop(ctx->lock_free)) == NULL)
+            sched_yield();
+        }
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+static double time_contention(threadpool *const pool,
+                              contention_ctx *const ctx,
+                              const contention_mode mode, const size_t n,
+                              const size_t reps) {
+  const size_t THREADS = threadpool_size(pool);
+  const size_t PER_ROUND =
+      mode == CONTENTION_MUTEX || mode == CONTENTION_TREIBER ? 1 : BATCH;
+  const double START = bench_now();
+  size_t rep;
+  ctx->mode = mode;
+  ctx->rounds = n / (THREADS * PER_ROUND);
+  for (rep = 0; rep < reps; rep++)
+    threadpool_run(pool, contend, ctx, THREADS);
+  return bench_now() - START;
+}
+
+typedef enum access_api { API_GENERATED, API_MACRO, API_UNTYPED } access_api;
+
+/* Pushes `n` values, then pops all of them. */
+static double time_push_pop(const access_api api, const size_t n,
+                            const size_t reps) {
+  const double START = bench_now();
+  size_t rep;
+  for (rep = 0; rep < reps; rep++) {
+    sstack stk = sstack_new(0);
+    size_t sum = 0;
+    size_t i;
+    switch (api) {
+      case API_GENERATED:
+        for (i = 0; i < n; i++) sstack_push(&stk, i);
+        for (i = 0; i < n; i++) sum += sstack_pop(stk);
+        break;
+      case API_MACRO:
+        for (i = 0; i < n; i++) stack_push(stk, i);
+        for (i = 0; i < n; i++) sum += stack_pop(stk);
+        break;
+      case API_UNTYPED:
+        for (i = 0; i < n; i++) stack_push_s(stk, i);
+        for (i = 0; i < n; i++) sum += *(size_t *)stack_pop_s(stk);
+        break;
+      default:
+        break;
+    }
+    bench_sink += sum;
+    sstack_delete(stk);
+  }
+  return bench_now() - START;
+}
+
+/* - BENCHMARKS - */
+
+void bench_concurrent_stack_contention(void) {
+  static contention_ctx ctx;
+  size_t exponent;
+  ctx.guarded = stack_new(size_t, MAX_THREADS * BATCH);
+  ctx.lock_free = concurrent_stack_new();
+  if (ctx.guarded == NULL || ctx.lock_free == NULL) {
+    if (ctx.guarded != NULL) stack_delete_s(ctx.guarded);
+    concurrent_stack_delete(ctx.lock_free);
+    return;
+  }
+  pthread_mutex_init(&ctx.lock, NULL);
+  for (exponent = 4; exponent <= BENCH_MAX_EXPONENT; exponent++) {
+    const size_t N = bench_pow10(exponent);
+    const size_t REPS = bench_repetitions(N);
+    size_t threads;
+    for (threads = 1; threads <= MAX_THREADS; threads *= 2) {
+      threadpool *const pool = threadpool_new(threads);
+      size_t mode;
+      if (pool == NULL) break;
+      for (mode = 0; mode < ARR_LEN(CONTENTION_NAMES); mode++) {
+        char label[32];
+        sprintf(label, "%s, %lu threads", CONTENTION_NAMES[mode],
+                (unsigned long)threads);
+        /* Each round is a push and a pop of every value moved. */
+        bench_report(label, N, 2 * N * REPS,
+                     time_contention(pool, &ctx, (contention_mode)mode, N,
+                                     REPS));
+      }
+      threadpool_delete(pool);
+    }
+  }
+  pthread_mutex_destroy(&ctx.lock);
+  concurrent_stack_delete(ctx.lock_free);
+  stack_delete_s(ctx.guarded);
+}
+
+void bench_stack_define(void) {
+  size_t exponent;
+  for (exponent = 3; exponent <= BENCH_MAX_EXPONENT; exponent++) {
+    const size_t N = bench_pow10(exponent);
+    const size_t REPS = bench_repetitions(N);
+    bench_report("DEFINE_STACK functions", N, N * REPS,
+                 time_push_pop(API_GENERATED, N, REPS));
+    bench_report("typed macros", N, N * REPS,
+                 time_push_pop(API_MACRO, N, REPS));
+    bench_report("_s macros", N, N * REPS,
+                 time_push_pop(API_UNTYPED, N, REPS));
+  }
+}
@@ -0,0 +1,10 @@
+#ifndef BENCH_STACK_H
+#define BENCH_STACK_H
+
+#include "../../include/myclib.h"
+
+void bench_concurrent_stack_contention(void);
+
+void bench_stack_define(void);
+
+#endif
@@ -0,0 +1,735 @@
+#include "vectorbench.h"
+
+#include <limits.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../include/myclib.h"
+#include "../../sched/scheduler.h"
+#include "../../threadpool/threadpool.h"
+#include "../../vector/soavector.h"
+#include "../../vector/vector.h"
+#include "../framework.h"
+
+/*
+ * Growing one element at a time is quadratic, so that baseline is only
+ * measured up to this size.
+ */
+#define EXACT_GROWTH_MAX_N ((size_t)100000)
+
+/*
+ * Each repetition of a sort copies its input back first, so the largest inputs
+ * are left out to keep a run short.
+ */
+#define SORT_MAX_EXPONENT (BENCH_MAX_EXPONENT < 7 ? BENCH_MAX_EXPONENT : 7)
+
+/* - INTERNAL - */
+
+DEFINE_VECTOR(size_t, svec);
+
+typedef enum push_mode {
+  PUSH_TYPED,
+  PUSH_UNTYPED,
+  PUSH_RESERVED,
+  PUSH_EXACT_GROWTH
+} push_mode;
+
+static double time_pushes(const push_mode mode, const size_t n,
+                          const size_t reps) {
+  const double START = bench_now();
+  size_t rep;
+  for (rep = 0; rep < reps; rep++) {
+    vector(size_t) vec = vector_new(size_t, 0);
+    size_t i;
+    switch (mode) {
+      case PUSH_TYPED:
+        for (i = 0; i < n; i++) vector_push(vec, i);
+        break;
+      case PUSH_UNTYPED:
+        for (i = 0; i < n; i++) vector_push_s(vec, i);
+        break;
+      case PUSH_RESERVED:
+        vector_reserve_exact(vec, n);
+        for (i = 0; i < n; i++) vector_push(vec, i);
+        break;
+      case PUSH_EXACT_GROWTH:
+        /* Mimics a vector whose capacity only ever matches its length. */
+        for (i = 0; i < n; i++) {
+          vector_reserve_exact(vec, i + 1);
+          vector_push(vec, i);
+        }
+        break;
+      default:
+        break;
+    }
+    bench_sink += vec[n - 1];
+    vector_delete(vec);
+  }
+  return bench_now() - START;
+}
+
+/*
+ * The element-by-element comparison `vector_index_of` performed before the
+ * search engine was introduced.
+ */
+static size_t naive_index_of(const void *const data, const size_t length,
+                             const void *const elem, const size_t elem_size) {
+  const unsigned char *const BYTES = data;
+  size_t i;
+  for (i = 0; i < length; i++)
+    if (memcmp(BYTES + i * elem_size, elem, elem_size) == 0) return i;
+  return length;
+}
+
+/*
+ * Searches `vec` for a value absent from it, so that each lookup scans every
+ * element.
+ */
+static double time_searches(const void *const vec, const void *const missing,
+                            const size_t elem_size, const bool naive,
+                            const size_t reps) {
+  const size_t LENGTH = vector_length(vec);
+  const double START = bench_now();
+  size_t rep;
+  for (rep = 0; rep < reps; rep++) {
+    if (naive)
+      bench_sink += naive_index_of(vec, LENGTH, missing, elem_size);
+    else
+      bench_sink += vector_untyped_index_of(vec, missing, elem_size);
+  }
+  return bench_now() - START;
+}
+
+static void report_searches(const char *const type_name,
+                            const void *const vec, const void *const missing,
+                            const size_t elem_size, const size_t n) {
+  const size_t REPS = bench_repetitions(n);
+  char label[32];
+  char naive_label[32];
+  sprintf(label, "vector_index_of (%s)", type_name);
+  sprintf(naive_label, "memcmp loop (%s)", type_name);
+  bench_report(label, n, n * REPS,
+               time_searches(vec, missing, elem_size, false, REPS));
+  bench_report(naive_label, n, n * REPS,
+               time_searches(vec, missing, elem_size, true, REPS));
+}
+
+/* A few multiply-adds, standing in for real per-element work. */
+#define scramble(n) (((n) * (size_t)2654435761U + 1) ^ ((n) >> 7))
+
+static void scramble_elem(void *args[]) {
+  size_t *const elem = args[1];
+  *elem = scramble(*elem);
+}
+
+static void scramble_chunk(void *const chunk, const size_t count,
+                           void *const args) {
+  size_t *const elems = chunk;
+  size_t i;
+  (void)args;
+  for (i = 0; i < count; i++) elems[i] = scramble(elems[i]);
+}
+
+typedef enum for_each_mode {
+  FOR_EACH_SERIAL,
+  FOR_EACH_PARALLEL,
+  FOR_EACH_PARALLEL_CHUNK
+} for_each_mode;
+
+static double time_for_each(size_t *const vec, const for_each_mode mode,
+                            scheduler *const sched, const size_t reps) {
+  const double START = bench_now();
+  size_t rep;
+  for (rep = 0; rep < reps; rep++) {
+    switch (mode) {
+      case FOR_EACH_SERIAL:
+        vector_for_each_s(vec, scramble_elem, NULL);
+        break;
+      case FOR_EACH_PARALLEL:
+        vector_parallel_for_each(vec, scramble_elem, NULL, sched, 0);
+        break;
+      case FOR_EACH_PARALLEL_CHUNK:
+        vector_parallel_for_each_chunk(vec, scramble_chunk, NULL, sched, 0);
+        break;
+      default:
+        break;
+    }
+  }
+  bench_sink += vec[0];
+  return bench_now() - START;
+}
+
+typedef enum access_api { API_GENERATED, API_MACRO, API_UNTYPED } access_api;
+
+/* Pushes `n` elements, then reads each one back and looks up the last. */
+static double time_accesses(const access_api api, const size_t n,
+                            const size_t reps) {
+  const double START = bench_now();
+  size_t rep;
+  for (rep = 0; rep < reps; rep++) {
+    svec vec = svec_new(0);
+    size_t sum = 0;
+    size_t i;
+    switch (api) {
+      case API_GENERATED:
+        for (i = 0; i < n; i++) svec_push(&vec, i);
+        for (i = 0; i < n; i++) sum += svec_get(vec, i);
+        sum += svec_index_of(vec, n - 1);
+        break;
+      case API_MACRO:
+        for (i = 0; i < n; i++) vector_push(vec, i);
+        for (i = 0; i < n; i++) sum += vector_get(vec, i);
+        sum += vector_index_of(vec, vec[n - 1]);
+        break;
+      case API_UNTYPED:
+        for (i = 0; i < n; i++) vector_push_s(vec, i);
+        for (i = 0; i < n; i++) sum += *(size_t *)vector_get_s(vec, i);
+        sum += vector_index_of(vec, vec[n - 1]);
+        break;
+      default:
+        break;
+    }
+    bench_sink += sum;
+    svec_delete(&vec);
+  }
+  return bench_now() - START;
+}
+
+/* The inline capacity of the small vectors being measured. */
+#define SMALL_CAPACITY 16
+
+/* Counts the blocks allocated through it, which come from `malloc()`. */
+static void *counted_alloc(void *const ctx, const size_t size) {
+  (*(size_t *)ctx)++;
+  return malloc(size);
+}
+
+static void *counted_realloc(void *const ctx, void *const ptr,
+                             const size_t old_size, const size_t new_size) {
+  (void)old_size;
+  (*(size_t *)ctx)++;
+  return realloc(ptr, new_size);
+}
+
+static void counted_free(void *const ctx, void *const ptr, const size_t size) {
+  (void)ctx;
+  (void)size;
+  free(ptr);
+}
+
+/*
+ * Builds and discards a vector of `n` elements `reps` times, adding the number
+ * of allocations made to `*allocations`.
+ */
+static double time_small_workload(const bool small, const size_t n,
+                                  const size_t reps,
+                                  size_t *const allocations) {
+  myclib_allocator allocator;
+  const double START = bench_now();
+  size_t rep;
+  allocator.alloc = counted_alloc;
+  allocator.realloc = counted_realloc;
+  allocator.free = counted_free;
+  allocator.ctx = allocations;
+  for (rep = 0; rep < reps; rep++) {
+    small_vector(size_t, SMALL_CAPACITY) storage;
+    vector(size_t) vec = small ? small_vector_init_with(&storage, &allocator)
+                               : vector_new_with(&allocator, size_t, 0);
+    size_t i;
+    for (i = 0; i < n; i++) vector_push(vec, i);
+    bench_sink += vec[n - 1];
+    vector_delete(vec);
+  }
+  return bench_now() - START;
+}
+
+/* A record whose scanned field shares each cache line with seven others. */
+typedef struct particle {
+  double x, y, z;
+  double vx, vy, vz;
+  double mass;
+  size_t id;
+} particle;
+
+#define PARTICLE_FIELDS(X)                                           \
+  X(double, x) X(double, y) X(double, z) X(double, vx) X(double, vy) \
+  X(double, vz) X(double, mass) X(size_t, id)
+
+DEFINE_SOA_VECTOR(particles, particle, PARTICLE_FIELDS);
+
+typedef enum scan_mode { SCAN_AOS_MACRO, SCAN_AOS_CALLBACK, SCAN_SOA } scan_mode;
+
+static void add_mass(void *args[]) {
+  *(double *)args[2] += ((const particle *)args[1])->mass;
+}
+
+/* Sums the `mass` of every particle, `reps` times. */
+static double time_scans(const particle *const records,
+                         const particles columns, const scan_mode mode,
+                         const size_t reps) {
+  const double START = bench_now();
+  size_t rep;
+  for (rep = 0; rep < reps; rep++) {
+    double total = 0;
+    switch (mode) {
+      case SCAN_AOS_MACRO:
+        vector_for_each(const particle p, records, total += p.mass);
+        break;
+      case SCAN_AOS_CALLBACK:
+        vector_for_each_s((particle *)records, add_mass, &total);
+        break;
+      case SCAN_SOA: {
+        const double *const masses = particles_columns_of(columns).mass;
+        const size_t LENGTH = soa_vector_length(columns);
+        size_t i;
+        for (i = 0; i < LENGTH; i++) total += masses[i];
+        break;
+      }
+      default:
+        break;
+    }
+    bench_sink += (size_t)total;
+  }
+  return bench_now() - START;
+}
+
+typedef enum sort_input {
+  INPUT_RANDOM,
+  INPUT_SORTED,
+  INPUT_REVERSED,
+  INPUT_ORGAN_PIPE,
+  INPUT_FEW_DISTINCT,
+  INPUT_COUNT
+} sort_input;
+
+static const char *const SORT_INPUT_NAMES[INPUT_COUNT] = {
+    "random", "sorted", "reversed", "organ pipe", "few distinct"};
+
+typedef enum sort_mode { SORT_QSORT, SORT_PDQSORT, SORT_STABLE } sort_mode;
+
+static int compare_ints(const void *const a, const void *const b) {
+  const int A = *(const int *)a;
+  const int B = *(const int *)b;
+  return (A > B) - (A < B);
+}
+
+static int compare_u32s(const void *const a, const void *const b) {
+  const vec_u32 A = *(const vec_u32 *)a;
+  const vec_u32 B = *(const vec_u32 *)b;
+  return (A > B) - (A < B);
+}
+
+static int compare_u64s(const void *const a, const void *const b) {
+  const vec_u64 A = *(const vec_u64 *)a;
+  const vec_u64 B = *(const vec_u64 *)b;
+  return (A > B) - (A < B);
+}
+
+static int compare_doubles(const void *const a, const void *const b) {
+  const double A = *(const double *)a;
+  const double B = *(const double *)b;
+  return (A > B) - (A < B);
+}
+
+/* Fills `input` with `n` values arranged as `kind` describes. */
+static void fill_sort_input(int *const input, const size_t n,
+                            const sort_input kind) {
+  size_t state = n;
+  size_t i;
+  for (i = 0; i < n; i++) {
+    state = scramble(state);
+    switch (kind) {
+      case INPUT_SORTED:
+        input[i] = (int)i;
+        break;
+      case INPUT_REVERSED:
+        input[i] = (int)(n - i);
+        break;
+      case INPUT_ORGAN_PIPE:
+        input[i] = (int)(i < n / 2 ? i : n - i);
+        break;
+      case INPUT_FEW_DISTINCT:
+        input[i] = (int)(state % 16);
+        break;
+      default:
+        input[i] = (int)(state % INT_MAX);
+        break;
+    }
+  }
+}
+
+/* Copies `input` into `scratch` then sorts it, `reps` times. */
+static double time_sorts(const int *const input, int *const scratch,
+                         const size_t n, const sort_mode mode,
+                         const size_t reps) {
+  const double START = bench_now();
+  size_t rep;
+  for (rep = 0; rep < reps; rep++) {
+    memcpy(scratch, input, n * sizeof *scratch);
+    switch (mode) {
+      case SORT_QSORT:
+        qsort(scratch, n, sizeof *scratch, compare_ints);
+        break;
+      case SORT_PDQSORT:
+        vector_sort(scratch, n, sizeof *scratch, compare_ints);
+        break;
+      case SORT_STABLE:
+        bench_sink += vector_sort_stable(scratch, n, sizeof *scratch,
+                                         compare_ints);
+        break;
+      default:
+        break;
+    }
+    bench_sink += (size_t)scratch[n / 2];
+  }
+  return bench_now() - START;
+}
+
+typedef enum radix_key { KEY_U32, KEY_U64, KEY_F64 } radix_key;
+
+/*
+ * Copies `input` into `scratch` then sorts it `reps` times, by radix if `radix`
+ * is set and with `qsort()` otherwise.
+ */
+static double time_radix_sorts(const void *const input, void *const scratch,
+                               const size_t n, const radix_key key,
+                               const bool radix, const size_t reps) {
+  static const size_t KEY_SIZES[] = {sizeof(vec_u32), sizeof(vec_u64),
+                                     sizeof(double)};
+  static const vec_comparator COMPARATORS[] = {compare_u32s, compare_u64s,
+                                               compare_doubles};
+  const double START = bench_now();
+  size_t rep;
+  for (rep = 0; rep < reps; rep++) {
+    memcpy(scratch, input, n * KEY_SIZES[key]);
+    if (!radix)
+      qsort(scratch, n, KEY_SIZES[key], COMPARATORS[key]);
+    else if (key == KEY_U32)
+      bench_sink += vector_radix_sort_u32(scratch, n);
+    else if (key == KEY_U64)
+      bench_sink += vector_radix_sort_u64(scratch, n);
+    else
+      bench_sink += vector_radix_sort_f64(scratch, n);
+    bench_sink += *(const unsigned char *)scratch;
+  }
+  return bench_now() - START;
+}
+
+/* Copies `input` into `scratch` then sorts it across `sched`, `reps` times. */
+static double time_parallel_sorts(const int *const input, int *const scratch,
+                                  const size_t n, scheduler *const sched,
+                                  const size_t reps) {
+  const double START = bench_now();
+  size_t rep;
+  for (rep = 0; rep < reps; rep++) {
+    memcpy(scratch, input, n * sizeof *scratch);
+    bench_sink += vector_parallel_sort(scratch, n, sizeof *scratch,
+                                       compare_ints, sched);
+    bench_sink += (size_t)scratch[n / 2];
+  }
+  return bench_now() - START;
+}
+
+/*
+ * Scans `values` in place `reps` times, across `sched` if `parallel` is set and
+ * with a plain loop otherwise. Repeated scans of the same values grow without
+ * overflowing, being floating-point.
+ */
+static double time_scans_of(double *const values, const size_t n,
+                            const bool parallel, scheduler *const sched,
+                            const size_t reps) {
+  const double START = bench_now();
+  size_t rep;
+  for (rep = 0; rep < reps; rep++) {
+    if (parallel) {
+      bench_sink +=
+          vector_parallel_scan_f64(values, n, VEC_SCAN_INCLUSIVE, sched);
+    } else {
+      double running = 0;
+      size_t i;
+      for (i = 0; i < n; i++) {
+        running += values[i];
+        values[i] = running;
+      }
+    }
+    bench_sink += (size_t)(values[n - 1] != 0);
+  }
+  return bench_now() - START;
+}
+
+/* - BENCHMARKS - */
+
+void bench_vector_define(void) {
+  size_t exponent;
+  for (exponent = 3; exponent <= BENCH_MAX_EXPONENT; exponent++) {
+    const size_t N = bench_pow10(exponent);
+    const size_t REPS = bench_repetitions(N);
+    bench_report("DEFINE_VECTOR functions", N, N * REPS,
+                 time_accesses(API_GENERATED, N, REPS));
+    bench_report("typed macros", N, N * REPS,
+                 time_accesses(API_MACRO, N, REPS));
+    bench_report("_s macros", N, N * REPS,
+                 time_accesses(API_UNTYPED, N, REPS));
+  }
+}
+
+void bench_vector_index_of(void) {
+  size_t exponent;
+  for (exponent = 3; exponent <= BENCH_MAX_EXPONENT; exponent++) {
+    const size_t N = bench_pow10(exponent);
+    vector(unsigned char) bytes = vector_new(unsigned char, N);
+    vector(int) ints = vector_new(int, N);
+    vector(long) longs = vector_new(long, N);
+    const unsigned char MISSING_BYTE = UCHAR_MAX;
+    const int MISSING_INT = -1;
+    const long MISSING_LONG = -1;
+    size_t i;
+    for (i = 0; i < N; i++) {
+      vector_push(bytes, (unsigned char)(i % UCHAR_MAX));
+      vector_push(ints, (int)(i % INT_MAX));
+      vector_push(longs, (long)(i % LONG_MAX));
+    }
+    report_searches("char", bytes, &MISSING_BYTE, sizeof *bytes, N);
+    report_searches("int", ints, &MISSING_INT, sizeof *ints, N);
+    report_searches("long", longs, &MISSING_LONG, sizeof *longs, N);
+    vector_delete(bytes);
+    vector_delete(ints);
+    vector_delete(longs);
+  }
+}
+
+void bench_vector_parallel_for_each(void) {
+  const size_t CPU_COUNT = threadpool_cpu_count();
+  size_t exponent;
+  for (exponent = 4; exponent <= BENCH_MAX_EXPONENT; exponent++) {
+    const size_t N = bench_pow10(exponent);
+    const size_t REPS = bench_repetitions(N);
+    vector(size_t) vec = vector_new(size_t, N);
+    size_t threads;
+    vector_resize(vec, N);
+    bench_report("vector_for_each_s", N, N * REPS,
+                 time_for_each(vec, FOR_EACH_SERIAL, NULL, REPS));
+    /* Doubles the thread count until every core is in use. */
+    for (threads = 1;; threads *= 2) {
+      scheduler *sched;
+      char label[32];
+      if (threads > CPU_COUNT) threads = CPU_COUNT;
+      sched = scheduler_new(threads);
+      if (sched == NULL) break;
+      sprintf(label, "parallel, %lu threads", (unsigned long)threads);
+      bench_report(label, N, N * REPS,
+                   time_for_each(vec, FOR_EACH_PARALLEL, sched, REPS));
+      sprintf(label, "parallel chunk, %lu threads", (unsigned long)threads);
+      bench_report(label, N, N * REPS,
+                   time_for_each(vec, FOR_EACH_PARALLEL_CHUNK, sched, REPS));
+      scheduler_delete(sched);
+      if (threads == CPU_COUNT) break;
+    }
+    vector_delete(vec);
+  }
+}
+
+void bench_vector_parallel_scan(void) {
+  const size_t CPU_COUNT = threadpool_cpu_count();
+  size_t exponent;
+  for (exponent = 5; exponent <= BENCH_MAX_EXPONENT; exponent++) {
+    const size_t N = bench_pow10(exponent);
+    const size_t REPS = bench_repetitions(N);
+    vector(double) values = vector_new(double, N);
+    size_t threads;
+    size_t i;
+    for (i = 0; i < N; i++) vector_push(values, 1.0 / (double)(i + 1));
+    bench_report("serial loop", N, N * REPS,
+                 time_scans_of(values, N, false, NULL, REPS));
+    /* Doubles the thread count until every core is in use. */
+    for (threads = 1;; threads *= 2) {
+      scheduler *sched;
+      char label[32];
+      if (threads > CPU_COUNT) threads = CPU_COUNT;
+      sched = scheduler_new(threads);
+      if (sched == NULL) break;
+      sprintf(label, "scan, %lu threads", (unsigned long)threads);
+      bench_report(label, N, N * REPS,
+                   time_scans_of(values, N, true, sched, REPS));
+      scheduler_delete(sched);
+      if (threads == CPU_COUNT) break;
+    }
+    vector_delete(values);
+  }
+}
+
+void bench_vector_parallel_sort(void) {
+  const size_t CPU_COUNT = threadpool_cpu_count();
+  size_t exponent;
+  for (exponent = 5; exponent <= SORT_MAX_EXPONENT; exponent++) {
+    const size_t N = bench_pow10(exponent);
+    const size_t REPS = bench_repetitions(N);
+    int *const input = malloc(N * sizeof *input);
+    int *const scratch = malloc(N * sizeof *scratch);
+    size_t threads;
+    if (input == NULL || scratch == NULL) {
+      free(input);
+      free(scratch);
+      return;
+    }
+    fill_sort_input(input, N, INPUT_RANDOM);
+    bench_report("vector_sort", N, N * REPS,
+                 time_sorts(input, scratch, N, SORT_PDQSORT, REPS));
+    bench_report("vector_sort_stable", N, N * REPS,
+                 time_sorts(input, scratch, N, SORT_STABLE, REPS));
+    /* Doubles the thread count until every core is in use. */
+    for (threads = 1;; threads *= 2) {
+      scheduler *sched;
+      char label[32];
+      if (threads > CPU_COUNT) threads = CPU_COUNT;
+      sched = scheduler_new(threads);
+      if (sched == NULL) break;
+      sprintf(label, "parallel sort, %lu threads", (unsigned long)threads);
+      bench_report(label, N, N * REPS,
+                   time_parallel_sorts(input, scratch, N, sched, REPS));
+      scheduler_delete(sched);
+      if (threads == CPU_COUNT) break;
+    }
+    free(input);
+    free(scratch);
+  }
+}
+
+void bench_vector_push(void) {
+  size_t exponent;
+  for (exponent = 3; exponent <= BENCH_MAX_EXPONENT; exponent++) {
+    const size_t N = bench_pow10(exponent);
+    const size_t REPS = bench_repetitions(N);
+    bench_report("vector_push", N, N * REPS, time_pushes(PUSH_TYPED, N, REPS));
+    bench_report("vector_push_s", N, N * REPS,
+                 time_pushes(PUSH_UNTYPED, N, REPS));
+    bench_report("vector_reserve_exact + push", N, N * REPS,
+                 time_pushes(PUSH_RESERVED, N, REPS));
+    if (N <= EXACT_GROWTH_MAX_N)
+      bench_report("exact growth (no policy)", N, N,
+                   time_pushes(PUSH_EXACT_GROWTH, N, 1));
+  }
+}
+
+void bench_vector_small(void) {
+  size_t n;
+  for (n = SMALL_CAPACITY / 4; n <= SMALL_CAPACITY * 4; n *= 2) {
+    const size_t REPS = bench_repetitions(n);
+    size_t allocations = 0;
+    bench_report("vector_new", n, REPS,
+                 time_small_workload(false, n, REPS, &allocations));
+    bench_report_value("  allocations", n, (double)allocations / (double)REPS,
+                       "per vector");
+    allocations = 0;
+    bench_report("small_vector(16)", n, REPS,
+                 time_small_workload(true, n, REPS, &allocations));
+    bench_report_value("  allocations", n, (double)allocations / (double)REPS,
+                       "per vector");
+  }
+}
+
+void bench_vector_soa(void) {
+  size_t exponent;
+  for (exponent = 3; exponent <= BENCH_MAX_EXPONENT; exponent++) {
+    const size_t N = bench_pow10(exponent);
+    const size_t REPS = bench_repetitions(N);
+    vector(particle) records = vector_new(particle, N);
+    particles columns;
+    size_t i;
+    for (i = 0; i < N; i++) {
+      particle record;
+      memset(&record, 0, sizeof record);
+      record.mass = (double)(i % 64);
+      record.id = i;
+      vector_push(records, record);
+    }
+    columns = particles_from_vector(records);
+    bench_report("AoS vector_for_each", N, N * REPS,
+                 time_scans(records, columns, SCAN_AOS_MACRO, REPS));
+    bench_report("AoS vector_for_each_s", N, N * REPS,
+                 time_scans(records, columns, SCAN_AOS_CALLBACK, REPS));
+    bench_report("SoA column scan", N, N * REPS,
+                 time_scans(records, columns, SCAN_SOA, REPS));
+    particles_delete(&columns);
+    vector_delete(records);
+  }
+}
+
+void bench_vector_radix_sort(void) {
+  static const char *const KEY_NAMES[] = {"u32", "u64", "f64"};
+  size_t exponent;
+  for (exponent = 3; exponent <= SORT_MAX_EXPONENT; exponent++) {
+    const size_t N = bench_pow10(exponent);
+    const size_t REPS = bench_repetitions(N);
+    vec_u64 *const input = malloc(N * sizeof *input);
+    vec_u64 *const scratch = malloc(N * sizeof *scratch);
+    size_t key;
+    size_t i;
+    if (input == NULL || scratch == NULL) {
+      free(input);
+      free(scratch);
+      return;
+    }
+    for (key = KEY_U32; key <= KEY_F64; key++) {
+      char label[32];
+      size_t state = N;
+      for (i = 0; i < N; i++) {
+        state = scramble(state);
+        switch (key) {
+          case KEY_U32:
+            ((vec_u32 *)input)[i] = (vec_u32)state;
+            break;
+          case KEY_U64:
+            input[i] = (vec_u64)state * (vec_u64)2654435761U;
+            break;
+          default:
+            ((double *)input)[i] = (double)state / 3.0 - 1e9;
+            break;
+        }
+      }
+      sprintf(label, "radix sort (%s)", KEY_NAMES[key]);
+      bench_report(label, N, N * REPS,
+                   time_radix_sorts(input, scratch, N, (radix_key)key, true,
+                                    REPS));
+      sprintf(label, "qsort (%s)", KEY_NAMES[key]);
+      bench_report(label, N, N * REPS,
+                   time_radix_sorts(input, scratch, N, (radix_key)key, false,
+                                    REPS));
+    }
+    free(input);
+    free(scratch);
+  }
+}
+
+void bench_vector_sort(void) {
+  size_t exponent;
+  for (exponent = 3; exponent <= SORT_MAX_EXPONENT; exponent++) {
+    const size_t N = bench_pow10(exponent);
+    const size_t REPS = bench_repetitions(N);
+    int *const input = malloc(N * sizeof *input);
+    int *const scratch = malloc(N * sizeof *scratch);
+    size_t kind;
+    if (input == NULL || scratch == NULL) {
+      free(input);
+      free(scratch);
+      return;
+    }
+    for (kind = 0; kind < INPUT_COUNT; kind++) {
+      char label[32];
+      fill_sort_input(input, N, (sort_input)kind);
+      sprintf(label, "qsort (%s)", SORT_INPUT_NAMES[kind]);
+      bench_report(label, N, N * REPS,
+                   time_sorts(input, scratch, N, SORT_QSORT, REPS));
+      sprintf(label, "vector_sort (%s)", SORT_INPUT_NAMES[kind]);
+      bench_report(label, N, N * REPS,
+                   time_sorts(input, scratch, N, SORT_PDQSORT, REPS));
+      sprintf(label, "stable sort (%s)", SORT_INPUT_NAMES[kind]);
+      bench_report(label, N, N * REPS,
+                   time_sorts(input, scratch, N, SORT_STABLE, REPS));
+    }
+    free(input);
+    free(scratch);
+  }
+}
@@ -0,0 +1,26 @@
+#ifndef BENCH_VECTOR_H
+#define BENCH_VECTOR_H
+
+#include "../../include/myclib.h"
+
+void bench_vector_define(void);
+
+void bench_vector_index_of(void);
+
+void bench_vector_parallel_for_each(void);
+
+void bench_vector_parallel_scan(void);
+
+void bench_vector_parallel_sort(void);
+
+void bench_vector_push(void);
+
+void bench_vector_radix_sort(void);
+
+void bench_vector_small(void);
+
+void bench_vector_soa(void);
+
+void bench_vector_sort(void);
+
+#endif
@@ -0,0 +1,412 @@
+#include "bitvec.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "../cpu/cpu.h"
+#include "../include/myclib.h"
+#include "../vector/vector.h"
+
+/* - SIMD AVAILABILITY - */
+
+#define TARGET_DEFAULT
+
+/* - DEFINITIONS - */
+
+typedef enum bitwise_op { OP_AND, OP_OR, OP_XOR, OP_NOT, OP_COUNT } bitwise_op;
+
+/*
+ * Applies an operation to `count` words of `dst`, taking the other operand
+ * from `src`, which is `NULL` for `OP_NOT`.
+ */
+typedef void (*bitwise_kernel)(bitvec_word *dst, const bitvec_word *src,
+                               size_t count);
+
+/*
+ * `counts`  - The number of set bits before each rank block, starting with the
+ *             first. Every full block whose bits are unmodified since the
+ *             index was last brought up to date has its following entry.
+ * `samples` - The rank block holding every `BITVEC_SELECT_SAMPLE`th set bit,
+ *             for as long as the entries of `counts` around it are kept.
+ */
+struct bitvec_rank_index {
+  vector(size_t) counts;
+  vector(size_t) samples;
+};
+
+#define WORDS_PER_BLOCK (BITVEC_RANK_BLOCK_BITS / BITVEC_WORD_BITS)
+
+/* The largest number of words whose allocation size does not overflow. */
+#define MAX_WORDS \
+  (((size_t)-1 - sizeof(bitvec_header)) / sizeof(bitvec_word))
+
+#define allocation_size(words) \
+  (sizeof(bitvec_header) + ((words) * sizeof(bitvec_word)))
+
+/* - BIT MANIPULATION - */
+
+static inline size_t word_popcount(const bitvec_word word) {
+#if (defined(__GNUC__) || defined(__clang__)) && (BITVEC_WORD_IS_LONG)
+  return (size_t)__builtin_popcountl(word);
+#elif defined(__GNUC__) || defined(__clang__)
+  return (size_t)__builtin_popcountll(word);
+#else
+  bitvec_word rest = word;
+  size_t cnt = 0;
+  for (; rest != 0; rest &= rest - 1) cnt++;
+  return cnt;
+#endif
+}
+
+static inline size_t lowest_bit(const bitvec_word word) {
+#if (defined(__GNUC__) || defined(__clang__)) && (BITVEC_WORD_IS_LONG)
+  return (size_t)__builtin_ctzl(word);
+#elif defined(__GNUC__) || defined(__clang__)
+  return (size_t)__builtin_ctzll(word);
+#else
+  size_t i = 0;
+  while (((word >> i) & 1) == 0) i++;
+  return i;
+#endif
+}
+
+/* The position of the set bit of `word` preceded by `rank` others. */
+static size_t select_in_word(bitvec_word word, size_t rank) {
+  for (; rank > 0; rank--) word &= word - 1;
+  return lowest_bit(word);
+}
+
+/* - KERNELS - */
+
+#define DEFINE_SCALAR_KERNEL(name, expr)                                \
+  static void name(bitvec_word *const dst, const bitvec_word *const src, \
+                   const size_t count) {                                \
+    size_t i;                                                           \
+    (void)src;                                                          \
+    for (i = 0; i < count; i++) dst[i] = (expr);                        \
+  }
+
+DEFINE_SCALAR_KERNEL(scalar_and, dst[i] & src[i])
+DEFINE_SCALAR_KERNEL(scalar_or, dst[i] | src[i])
+DEFINE_SCALAR_KERNEL(scalar_xor, dst[i] ^ src[i])
+DEFINE_SCALAR_KERNEL(scalar_not, ~dst[i])
+
+/*
+ * Defines a kernel applying `op_fn` to whole SIMD blocks, with `operand` as
+ * its second argument, deferring any trailing words to `scalar_fn`.
+ */
+#define DEFINE_SIMD_KERNEL(name, attributes, simd_type, load_fn, store_fn,  \
+                           op_fn, operand, scalar_fn)                       \
+  static attributes void name(bitvec_word *const dst,                       \
+                              const bitvec_word *const src,                 \
+                              const size_t count) {                         \
+    const size_t PER_BLOCK = sizeof(simd_type) / sizeof(bitvec_word);       \
+    const size_t TAIL = count / PER_BLOCK * PER_BLOCK;                      \
+    size_t i;                                                               \
+    for (i = 0; i < TAIL; i += PER_BLOCK)                                   \
+      store_fn((simd_type *)(dst + i),                                      \
+               op_fn(load_fn((const simd_type *)(dst + i)), operand));      \
+    scalar_fn(dst + TAIL, src == NULL ? NULL : src + TAIL, count - TAIL);   \
+  }
+
+#if (MYCLIB_HAS_SSE2)
+#define SSE2_OPERAND _mm_loadu_si128((const __m128i *)(src + i))
+#define SSE2_ONES _mm_set1_epi32(-1)
+
+DEFINE_SIMD_KERNEL(sse2_and, TARGET_DEFAULT, __m128i, _mm_loadu_si128,
+                   _mm_storeu_si128, _mm_and_si128, SSE2_OPERAND, scalar_and)
+DEFINE_SIMD_KERNEL(sse2_or, TARGET_DEFAULT, __m128i, _mm_loadu_si128,
+                   _mm_storeu_si128, _mm_or_si128, SSE2_OPERAND, scalar_or)
+DEFINE_SIMD_KERNEL(sse2_xor, TARGET_DEFAULT, __m128i, _mm_loadu_si128,
+                   _mm_storeu_si128, _mm_xor_si128, SSE2_OPERAND, scalar_xor)
+DEFINE_SIMD_KERNEL(sse2_not, TARGET_DEFAULT, __m128i, _mm_loadu_si128,
+                   _mm_storeu_si128, _mm_xor_si128, SSE2_ONES, scalar_not)
+#endif
+
+#if (MYCLIB_HAS_AVX2)
+#define AVX2_OPERAND _mm256_loadu_si256((const __m256i *)(src + i))
+#define AVX2_ONES _mm256_set1_epi32(-1)
+
+DEFINE_SIMD_KERNEL(avx2_and, MYCLIB_TARGET_AVX2, __m256i, _mm256_loadu_si256,
+                   _mm256_storeu_si256, _mm256_and_si256, AVX2_OPERAND,
+                   scalar_and)
+DEFINE_SIMD_KERNEL(avx2_or, MYCLIB_TARGET_AVX2, __m256i, _mm256_loadu_si256,
+                   _mm256_storeu_si256, _mm256_or_si256, AVX2_OPERAND,
+                   scalar_or)
+DEFINE_SIMD_KERNEL(avx2_xor, MYCLIB_TARGET_AVX2, __m256i, _mm256_loadu_si256,
+                   _mm256_storeu_si256, _mm256_xor_si256, AVX2_OPERAND,
+                   scalar_xor)
+DEFINE_SIMD_KERNEL(avx2_not, MYCLIB_TARGET_AVX2, __m256i, _mm256_loadu_si256,
+                   _mm256_storeu_si256, _mm256_xor_si256, AVX2_ONES,
+                   scalar_not)
+#endif
+
+static bitwise_kernel select_kernel(const bitwise_op op) {
+  static const bitwise_kernel SCALAR[OP_COUNT] = {scalar_and, scalar_or,
+                                                  scalar_xor, scalar_not};
+#if (MYCLIB_HAS_SSE2)
+  static const bitwise_kernel SSE2[OP_COUNT] = {sse2_and, sse2_or, sse2_xor,
+                                                sse2_not};
+#endif
+#if (MYCLIB_HAS_AVX2)
+  static const bitwise_kernel AVX2[OP_COUNT] = {avx2_and, avx2_or, avx2_xor,
+                                                avx2_not};
+#endif
+  switch (cpu_simd_support()) {
+#if (MYCLIB_HAS_AVX2)
+    case CPU_SIMD_AVX2:
+      return AVX2[op];
+#endif
+#if (MYCLIB_HAS_SSE2)
+    case CPU_SIMD_SSE2:
+      return SSE2[op];
+#endif
+    default:
+      return SCALAR[op];
+  }
+}
+
+#define DEFINE_POPCOUNT_KERNEL(name, attributes)                      \
+  static attributes size_t name(const bitvec_word *const words,       \
+                                const size_t count) {                 \
+    size_t total = 0;                                                 \
+    size_t i;                                                         \
+    for (i = 0; i < count; i++) total += word_popcount(words[i]);     \
+    return total;                                                     \
+  }
+
+DEFINE_POPCOUNT_KERNEL(scalar_popcount, TARGET_DEFAULT)
+
+/*
+ * Without `-mpopcnt`, compilers expand `__builtin_popcount()` to a sequence of
+ * shifts and masks, so a kernel targeting the instruction is picked when the
+ * CPU has it.
+ */
+#if (MYCLIB_HAS_POPCNT)
+DEFINE_POPCOUNT_KERNEL(hardware_popcount, MYCLIB_TARGET_POPCNT)
+#endif
+
+static inline size_t count_ones(const bitvec_word *const words,
+                                const size_t count) {
+#if (MYCLIB_HAS_POPCNT)
+  if (cpu_has_popcnt()) return hardware_popcount(words, count);
+#endif
+  return scalar_popcount(words, count);
+}
+
+/* - INTERNAL - */
+
+/*
+ * Discards the parts of the index describing rank block `block` and those
+ * after it, which a modification of that block made stale.
+ */
+static void invalidate_from(bitvec_header *const header, const size_t block) {
+  struct bitvec_rank_index *const index = header->index;
+  if (index == NULL) return;
+  if (vector_length(index->counts) > block + 1)
+    vector_header(index->counts)->length = block + 1;
+  while (!vector_is_empty(index->samples) &&
+         index->samples[vector_length(index->samples) - 1] >= block)
+    vector_header(index->samples)->length--;
+}
+
+static void combine(bitvec dst, const bitvec_word *const src,
+                    const bitwise_op op) {
+  const size_t WORDS = bitvec_word_count(dst);
+  util_assert(src == NULL || bitvec_length(src) == bitvec_length(dst));
+  select_kernel(op)(dst, src, WORDS);
+  invalidate_from(bitvec_header(dst), 0);
+}
+
+/*
+ * Counts the set bits of `vec` from rank block `block` onwards, stopping at
+ * bit `end`.
+ */
+static size_t count_from_block(const bitvec vec, const size_t block,
+                               const size_t end) {
+  const size_t FIRST = block * WORDS_PER_BLOCK;
+  const size_t LAST = end / BITVEC_WORD_BITS;
+  size_t total = count_ones(vec + FIRST, LAST - FIRST);
+  if (end % BITVEC_WORD_BITS != 0)
+    total += word_popcount(vec[LAST] & (bitvec_bit_mask(end) - 1));
+  return total;
+}
+
+/*
+ * Allocates the empty index of `header`, returning `false` if it could not
+ * be.
+ */
+static bool create_index(bitvec_header *const header) {
+  struct bitvec_rank_index *index =
+      myclib_alloc(header->allocator, sizeof *index);
+  const size_t NO_BITS = 0;
+  if (index == NULL) return false;
+  index->counts = vector_new_with(header->allocator, size_t, 1);
+  index->samples = vector_new_with(header->allocator, size_t, 0);
+  if (index->counts == NULL || index->samples == NULL) {
+    if (index->counts != NULL) vector_delete(index->counts);
+    if (index->samples != NULL) vector_delete(index->samples);
+    myclib_free(header->allocator, index, sizeof *index);
+    return false;
+  }
+  vector_push_s(index->counts, NO_BITS);
+  header->index = index;
+  return true;
+}
+
+/* - FUNCTIONS - */
+
+void bitvec_and(bitvec dst, const bitvec_word *const src) {
+  combine(dst, src, OP_AND);
+}
+
+void bitvec_clear(bitvec vec) {
+  memset(vec, 0, bitvec_word_count(vec) * sizeof *vec);
+  invalidate_from(bitvec_header(vec), 0);
+}
+
+bool bitvec_index(bitvec vec) {
+  bitvec_header *const header = bitvec_header(vec);
+  const size_t FULL_BLOCKS = header->length / BITVEC_RANK_BLOCK_BITS;
+  struct bitvec_rank_index *index;
+  size_t block;
+  if (header->index == NULL && !create_index(header)) return false;
+  index = header->index;
+  for (block = vector_length(index->counts) - 1; block < FULL_BLOCKS;
+       block++) {
+    const size_t BEFORE = index->counts[block];
+    const size_t AFTER =
+        BEFORE + count_ones(vec + (block * WORDS_PER_BLOCK), WORDS_PER_BLOCK);
+    /*
+     * Samples are only taken from full blocks, which appending cannot modify,
+     * and always before the entry following their block is added.
+     */
+    while (vector_length(index->samples) * BITVEC_SELECT_SAMPLE < AFTER)
+      if (vector_push_s(index->samples, block) == NULL) return false;
+    if (vector_push_s(index->counts, AFTER) == NULL) return false;
+  }
+  return true;
+}
+
+bitvec bitvec_new_with(const myclib_allocator *const allocator,
+                       const size_t bits) {
+  const size_t WORDS = bits / BITVEC_WORD_BITS + (bits % BITVEC_WORD_BITS != 0);
+  bitvec_header *header;
+  if (WORDS > MAX_WORDS) return NULL;
+  header = myclib_alloc(allocator, allocation_size(WORDS));
+  if (header == NULL) return NULL;
+  header->length = 0;
+  header->capacity = WORDS;
+  header->allocator = allocator;
+  header->index = NULL;
+  return (bitvec)(header + 1);
+}
+
+void bitvec_not(bitvec vec) {
+  const size_t LENGTH = bitvec_length(vec);
+  combine(vec, NULL, OP_NOT);
+  if (LENGTH % BITVEC_WORD_BITS != 0)
+    vec[LENGTH / BITVEC_WORD_BITS] &= bitvec_bit_mask(LENGTH) - 1;
+}
+
+void bitvec_or(bitvec dst, const bitvec_word *const src) {
+  combine(dst, src, OP_OR);
+}
+
+size_t bitvec_popcount(const bitvec vec) {
+  return count_ones(vec, bitvec_word_count(vec));
+}
+
+size_t bitvec_rank(bitvec vec, const size_t index) {
+  const bitvec_header *const header = bitvec_header_const(vec);
+  const size_t BLOCK = index / BITVEC_RANK_BLOCK_BITS;
+  util_assert(index <= header->length);
+  if (!bitvec_index(vec) || vector_length(header->index->counts) <= BLOCK)
+    return count_from_block(vec, 0, index);
+  return header->index->counts[BLOCK] + count_from_block(vec, BLOCK, index);
+}
+
+size_t bitvec_select(bitvec vec, const size_t rank) {
+  const bitvec_header *const header = bitvec_header_const(vec);
+  const size_t WORDS = bitvec_word_count(vec);
+  size_t remaining = rank;
+  size_t word = 0;
+  if (bitvec_index(vec)) {
+    const vector(size_t) counts = header->index->counts;
+    const vector(size_t) samples = header->index->samples;
+    const size_t SAMPLE = rank / BITVEC_SELECT_SAMPLE;
+    const size_t SAMPLES = vector_length(samples);
+    size_t low = SAMPLES == 0 ? 0 : samples[SAMPLE < SAMPLES ? SAMPLE
+                                                             : SAMPLES - 1];
+    size_t high = SAMPLE + 1 < SAMPLES ? samples[SAMPLE + 1]
+                                       : vector_length(counts) - 1;
+    /* Finds the last block with no more than `rank` set bits before it. */
+    while (low < high) {
+      const size_t MIDDLE = low + ((high - low + 1) / 2);
+      if (counts[MIDDLE] <= rank)
+        low = MIDDLE;
+      else
+        high = MIDDLE - 1;
+    }
+    remaining -= counts[low];
+    word = low * WORDS_PER_BLOCK;
+  }
+  for (; word < WORDS; word++) {
+    const size_t ONES = word_popcount(vec[word]);
+    if (remaining < ONES)
+      return (word * BITVEC_WORD_BITS) + select_in_word(vec[word], remaining);
+    remaining -= ONES;
+  }
+  return BITVEC_BAD_INDEX;
+}
+
+void bitvec_set(bitvec vec, const size_t index, const bool bit) {
+  const bitvec_word MASK = bitvec_bit_mask(index);
+  bitvec_word *const word = &vec[index / BITVEC_WORD_BITS];
+  util_assert(index < bitvec_length(vec));
+  if (((*word & MASK) != 0) == (bit != 0)) return;
+  *word ^= MASK;
+  invalidate_from(bitvec_header(vec), index / BITVEC_RANK_BLOCK_BITS);
+}
+
+void bitvec_untyped_delete(bitvec vec) {
+  bitvec_header *const header = bitvec_header(vec);
+  struct bitvec_rank_index *const index = header->index;
+  if (index != NULL) {
+    vector_delete(index->counts);
+    vector_delete(index->samples);
+    myclib_free(header->allocator, index, sizeof *index);
+  }
+  myclib_free(header->allocator, header, allocation_size(header->capacity));
+}
+
+bitvec bitvec_untyped_push(bitvec *const vec, const bool bit) {
+  const size_t LENGTH = bitvec_length(*vec);
+  if (bitvec_untyped_reserve(vec, LENGTH + 1) == NULL) return NULL;
+  if (LENGTH % BITVEC_WORD_BITS == 0) (*vec)[LENGTH / BITVEC_WORD_BITS] = 0;
+  if (bit) (*vec)[LENGTH / BITVEC_WORD_BITS] |= bitvec_bit_mask(LENGTH);
+  bitvec_header(*vec)->length++;
+  return *vec;
+}
+
+bitvec bitvec_untyped_reserve(bitvec *const vec, const size_t bits) {
+  bitvec_header *header = bitvec_header(*vec);
+  const size_t WORDS = bits / BITVEC_WORD_BITS + (bits % BITVEC_WORD_BITS != 0);
+  size_t grown;
+  if (WORDS <= header->capacity) return *vec;
+  if (WORDS > MAX_WORDS) return NULL;
+  grown = vector_untyped_grow_capacity(header->capacity, WORDS,
+                                       sizeof(bitvec_word));
+  if (grown > MAX_WORDS) grown = MAX_WORDS;
+  header = myclib_realloc(header->allocator, header,
+                          allocation_size(header->capacity),
+                          allocation_size(grown));
+  if (header == NULL) return NULL;
+  header->capacity = grown;
+  *vec = (bitvec)(header + 1);
+  return *vec;
+}
+
+void bitvec_xor(bitvec dst, const bitvec_word *const src) {
+  combine(dst, src, OP_XOR);
+}
@@ -0,0 +1,173 @@
+#ifndef BITVEC_H
+#define BITVEC_H
+
+#include <limits.h>
+#include <stddef.h>
+
+#include "../include/myclib.h"
+
+/* - DEFINITIONS - */
+
+/*
+ * A bit vector packs its bits into words, with bit `i` held by bit
+ * `i % BITVEC_WORD_BITS` of word `i / BITVEC_WORD_BITS`. As with `vector`, a
+ * header precedes the data, so a `bitvec` points at its first word and the
+ * words may be read directly. Bits past the length in the last word are always
+ * clear.
+ *
+ * Words are 64 bits wide wherever the compiler provides such a type.
+ */
+#if ULONG_MAX / 4294967295UL > 4294967295UL
+typedef unsigned long bitvec_word;
+#define BITVEC_WORD_IS_LONG (1)
+#elif (IS_STDC99) || defined(__GNUC__) || defined(__clang__)
+#if defined(__GNUC__) || defined(__clang__)
+__extension__ typedef unsigned long long bitvec_word;
+#else
+typedef unsigned long long bitvec_word;
+#endif
+#define BITVEC_WORD_IS_LONG (0)
+#else
+typedef unsigned long bitvec_word;
+#define BITVEC_WORD_IS_LONG (1)
+#endif
+
+typedef bitvec_word *bitvec;
+
+#define BITVEC_WORD_BITS (sizeof(bitvec_word) * CHAR_BIT)
+
+/* Returned by `bitvec_select()` when there are not enough set bits. */
+#define BITVEC_BAD_INDEX ((size_t)-1)
+
+/*
+ * The number of bits summarized by each entry of the rank index. A query scans
+ * at most this many bits beyond the entry it starts from.
+ */
+#define BITVEC_RANK_BLOCK_BITS ((size_t)512)
+
+/*
+ * The number of set bits between consecutive select samples, each of which
+ * records the rank block holding one set bit so that `bitvec_select()` only
+ * searches the blocks between two samples.
+ */
+#define BITVEC_SELECT_SAMPLE ((size_t)4096)
+
+/* - INTERNAL USE ONLY - */
+
+struct bitvec_rank_index;
+
+/*
+ *   `length`   - The number of bits currently held.
+ *  `capacity`  - The number of words allocated for.
+ * `allocator`  - The allocator owning the bit vector's memory, or `NULL` if
+ *                the standard library's allocation functions are used.
+ *   `index`    - The rank and select index, or `NULL` if none has been built.
+ *                Only the part of it describing unmodified bits is kept.
+ */
+typedef struct {
+  size_t length;
+  size_t capacity;
+  const myclib_allocator *allocator;
+  struct bitvec_rank_index *index;
+} bitvec_header;
+
+#define bitvec_header(vec) ((bitvec_header *)(vec) - 1)
+
+#define bitvec_header_const(vec) ((const bitvec_header *)(vec) - 1)
+
+#define bitvec_words_for(bits) \
+  (((bits) + BITVEC_WORD_BITS - 1) / BITVEC_WORD_BITS)
+
+#define bitvec_bit_mask(index) \
+  ((bitvec_word)1 << ((size_t)(index) % BITVEC_WORD_BITS))
+
+/* - CONVENIENCE MACROS - */
+
+#define bitvec_allocator(vec) (bitvec_header_const(vec)->allocator)
+
+/* The number of bits `vec` can hold without reallocating. */
+#define bitvec_capacity(vec) \
+  (bitvec_header_const(vec)->capacity * BITVEC_WORD_BITS)
+
+#define bitvec_delete(vec) ((void)(bitvec_untyped_delete(vec), (vec) = NULL))
+
+#define bitvec_get(vec, index)                        \
+  (util_assert((size_t)(index) < bitvec_length(vec)), \
+   ((vec)[(size_t)(index) / BITVEC_WORD_BITS] &       \
+    bitvec_bit_mask(index)) != 0)
+
+#define bitvec_is_empty(vec) (bitvec_length(vec) == 0)
+
+#define bitvec_length(vec) (+bitvec_header_const(vec)->length)
+
+#define bitvec_new(bits) bitvec_new_with(NULL, bits)
+
+#define bitvec_push(vec, bit) bitvec_untyped_push(&(vec), bit)
+
+#define bitvec_reserve(vec, bits) bitvec_untyped_reserve(&(vec), bits)
+
+/* The number of words in use by `vec`. */
+#define bitvec_word_count(vec) bitvec_words_for(bitvec_length(vec))
+
+/* - FUNCTIONS - */
+
+/*
+ * Combines every bit of `dst` with the matching bit of `src`, which must be
+ * as long as `dst`. Whole words are processed with the widest SIMD
+ * instructions the CPU supports.
+ */
+void bitvec_and(bitvec dst, const bitvec_word *src);
+
+void bitvec_or(bitvec dst, const bitvec_word *src);
+
+void bitvec_xor(bitvec dst, const bitvec_word *src);
+
+/* Clears every bit. The length is unchanged. */
+void bitvec_clear(bitvec vec);
+
+/*
+ * Brings the rank and select index of `vec` up to date, returning `false` if
+ * it could not be allocated, in which case queries fall back to scanning.
+ * Queries do this themselves, so it only needs to be called before querying
+ * from several threads at once.
+ */
+bool bitvec_index(bitvec vec);
+
+bitvec bitvec_new_with(const myclib_allocator *allocator, size_t bits);
+
+/* Inverts every bit. */
+void bitvec_not(bitvec vec);
+
+/*
+ * Returns the number of set bits, counted a word at a time with the CPU's
+ * population count instruction where it has one.
+ */
+size_t bitvec_popcount(const bitvec vec);
+
+/*
+ * Returns the number of set bits before bit `index`, which may equal the
+ * length, in O(1) time once the index is up to date.
+ */
+size_t bitvec_rank(bitvec vec, size_t index);
+
+/*
+ * Returns the position of the set bit preceded by `rank` others, or
+ * `BITVEC_BAD_INDEX` if there is none. Sampling bounds the search to the rank
+ * blocks between two samples, which is a handful for any reasonably dense bit
+ * vector.
+ */
+size_t bitvec_select(bitvec vec, size_t rank);
+
+void bitvec_set(bitvec vec, size_t index, bool bit);
+
+void bitvec_untyped_delete(bitvec vec);
+
+/*
+ * Appends `bit`, returning the bit vector, or `NULL` if it could not be grown.
+ * Appending never invalidates the index.
+ */
+bitvec bitvec_untyped_push(bitvec *vec, bool bit);
+
+bitvec bitvec_untyped_reserve(bitvec *vec, size_t bits);
+
+#endif
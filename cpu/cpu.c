@@ -0,0 +1,88 @@
+#include "cpu.h"
+
+#include "../include/myclib.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/* - DEFINITIONS - */
+
+/*
+ * The set of features detected is cached as a combination of these flags.
+ * `FEATURES_DETECTED` is always part of it, so that the cache only reads as
+ * `0` before detection.
+ */
+#define FEATURES_DETECTED (1U << 0)
+#define FEATURE_SSE2 (1U << 1)
+#define FEATURE_AVX2 (1U << 2)
+#define FEATURE_POPCNT (1U << 3)
+
+/*
+ * Threads detecting the features at the same time all store the same value,
+ * so the cache only needs its accesses to be atomic, not ordered.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define load_relaxed(ptr) __atomic_load_n(ptr, __ATOMIC_RELAXED)
+#define store_relaxed(ptr, value) __atomic_store_n(ptr, value, __ATOMIC_RELAXED)
+#else
+/* Aligned accesses to an `unsigned` are atomic on every target MSVC has. */
+#define load_relaxed(ptr) (*(volatile unsigned *)(ptr))
+#define store_relaxed(ptr, value) \
+  ((void)(*(volatile unsigned *)(ptr) = (value)))
+#endif
+
+static unsigned features = 0;
+
+/* - INTERNAL - */
+
+static unsigned detect_features(void) {
+  unsigned detected = FEATURES_DETECTED;
+#if (MYCLIB_HAS_SSE2)
+  detected |= FEATURE_SSE2;
+#endif
+#if (MYCLIB_HAS_AVX2) && (defined(__GNUC__) || defined(__clang__))
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) detected |= FEATURE_AVX2;
+#if (MYCLIB_HAS_POPCNT)
+  if (__builtin_cpu_supports("popcnt")) detected |= FEATURE_POPCNT;
+#endif
+#elif (MYCLIB_HAS_AVX2) && defined(_MSC_VER)
+  {
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] >= 7) {
+      const int OSXSAVE = 1 << 27;
+      const int AVX2 = 1 << 5;
+      __cpuid(info, 1);
+      if ((info[2] & OSXSAVE) != 0 && (_xgetbv(0) & 6) == 6) {
+        __cpuidex(info, 7, 0);
+        if ((info[1] & AVX2) != 0) detected |= FEATURE_AVX2;
+      }
+    }
+  }
+#endif
+  return detected;
+}
+
+static unsigned get_features(void) {
+  unsigned detected = load_relaxed(&features);
+  if (detected == 0) {
+    detected = detect_features();
+    store_relaxed(&features, detected);
+  }
+  return detected;
+}
+
+/* - LIBRARY FUNCTIONS - */
+
+bool cpu_has_popcnt(void) {
+  return (get_features() & FEATURE_POPCNT) != 0;
+}
+
+cpu_simd_level cpu_simd_support(void) {
+  const unsigned DETECTED = get_features();
+  if ((DETECTED & FEATURE_AVX2) != 0) return CPU_SIMD_AVX2;
+  if ((DETECTED & FEATURE_SSE2) != 0) return CPU_SIMD_SSE2;
+  return CPU_SIMD_NONE;
+}
@@ -0,0 +1,78 @@
+#ifndef CPU_H
+#define CPU_H
+
+#include "../include/myclib.h"
+
+/* - SIMD AVAILABILITY - */
+
+/*
+ * Every x86-64 CPU has SSE2, so SSE2 kernels are compiled wherever the target
+ * guarantees it and need no runtime check.
+ */
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64) || \
+    (defined(__i386__) && defined(__SSE2__)) ||                     \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MYCLIB_HAS_SSE2 (1)
+#include <emmintrin.h>
+#else
+#define MYCLIB_HAS_SSE2 (0)
+#endif
+
+/*
+ * AVX2 and POPCNT kernels are compiled regardless of the flags the library is
+ * built with and are only used if `cpu_simd_support()` and `cpu_has_popcnt()`
+ * report support for them at runtime.
+ */
+#if (MYCLIB_HAS_SSE2) &&                                           \
+    (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5) || \
+     defined(_MSC_VER))
+#define MYCLIB_HAS_AVX2 (1)
+#include <immintrin.h>
+#else
+#define MYCLIB_HAS_AVX2 (0)
+#endif
+
+#if (MYCLIB_HAS_AVX2) && !defined(_MSC_VER)
+#define MYCLIB_HAS_POPCNT (1)
+#else
+#define MYCLIB_HAS_POPCNT (0)
+#endif
+
+/* Marks a function as using instructions beyond those the build targets. */
+#if defined(__GNUC__) || defined(__clang__)
+#define MYCLIB_TARGET_AVX2 __attribute__((target("avx2")))
+#define MYCLIB_TARGET_POPCNT __attribute__((target("popcnt")))
+#else
+#define MYCLIB_TARGET_AVX2
+#define MYCLIB_TARGET_POPCNT
+#endif
+
+/* - DEFINITIONS - */
+
+/* The widest SIMD instruction set usable, in increasing order of width. */
+typedef enum cpu_simd_level {
+  CPU_SIMD_NONE,
+  CPU_SIMD_SSE2,
+  CPU_SIMD_AVX2
+} cpu_simd_level;
+
+/* - FUNCTIONS - */
+
+/*
+ * The features below are detected on first use and cached, and may be queried
+ * from any number of threads at once.
+ */
+
+/**
+ * @brief Determines whether both the CPU and the library support the POPCNT
+ * instruction.
+ */
+bool cpu_has_popcnt(void);
+
+/**
+ * @brief Determines the widest SIMD instruction set supported by both the CPU
+ * and the library.
+ */
+cpu_simd_level cpu_simd_support(void);
+
+#endif
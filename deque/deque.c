@@ -0,0 +1,176 @@
+#include "deque.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "../include/myclib.h"
+
+/* - INTERNAL - */
+
+#define DEQUE_EXPANSION_FACTOR ((size_t)2)
+
+/* The largest capacity whose block size is representable, or `0` if none. */
+#define max_capacity(elem_size) \
+  (((size_t)-1 - sizeof(deque_header)) / (elem_size))
+
+/*
+ * Returns the smallest power of two at least `count`, or `0` if there is no
+ * such capacity for elements of `elem_size` bytes.
+ */
+static size_t capacity_for(const size_t count, const size_t elem_size) {
+  size_t capacity = 1;
+  while (capacity < count) {
+    if (capacity > max_capacity(elem_size) / DEQUE_EXPANSION_FACTOR) return 0;
+    capacity *= DEQUE_EXPANSION_FACTOR;
+  }
+  return capacity <= max_capacity(elem_size) ? capacity : 0;
+}
+
+/* - FUNCTIONS - */
+
+void *deque_untyped_at(void *const dq, const size_t index,
+                       const size_t elem_size) {
+  if (index >= deque_length(dq)) return NULL;
+  return (byte *)dq + (deque_position(dq, index) * elem_size);
+}
+
+void deque_untyped_delete(void *const dq, const size_t elem_size) {
+  myclib_free(deque_allocator(dq), deque_header(dq),
+              deque_allocation_size(elem_size, deque_capacity(dq)));
+}
+
+void *deque_untyped_expand(void **const dq, const size_t elem_size) {
+  const size_t CAPACITY = deque_capacity(*dq);
+  return deque_untyped_reserve(
+      dq, CAPACITY == 0 ? 1 : CAPACITY * DEQUE_EXPANSION_FACTOR, elem_size);
+}
+
+void *deque_untyped_new(const size_t elem_size, const size_t capacity) {
+  return deque_untyped_new_with(NULL, elem_size, capacity);
+}
+
+void *deque_untyped_new_with(const myclib_allocator *const allocator,
+                             const size_t elem_size, const size_t capacity) {
+  const size_t ROUNDED =
+      capacity == 0 ? 0 : capacity_for(capacity, elem_size);
+  deque_header *dq;
+  if (capacity != 0 && ROUNDED == 0) return NULL;
+  dq = myclib_alloc(allocator, deque_allocation_size(elem_size, ROUNDED));
+  if (dq == NULL) return NULL;
+  dq->head = 0;
+  dq->length = 0;
+  dq->capacity = ROUNDED;
+  dq->allocator = allocator;
+  return dq + 1;
+}
+
+void *deque_untyped_pop_back(void *const dq, const size_t elem_size) {
+  deque_header *const header = deque_header(dq);
+  if (header->length == 0) return NULL;
+  header->length--;
+  return (byte *)dq + (deque_position(dq, header->length) * elem_size);
+}
+
+void *deque_untyped_pop_front(void *const dq, const size_t elem_size) {
+  deque_header *const header = deque_header(dq);
+  const size_t HEAD = header->head;
+  if (header->length == 0) return NULL;
+  header->head = deque_position(dq, 1);
+  header->length--;
+  return (byte *)dq + (HEAD * elem_size);
+}
+
+size_t deque_untyped_pop_front_n(void *const dq, void *const dst,
+                                 const size_t count, const size_t elem_size) {
+  deque_header *const header = deque_header(dq);
+  const size_t MOVED = count < header->length ? count : header->length;
+  const size_t TO_END = header->capacity - header->head;
+  const size_t FIRST = MOVED < TO_END ? MOVED : TO_END;
+  if (MOVED == 0) return 0;
+  if (dst != NULL) {
+    memcpy(dst, (byte *)dq + (header->head * elem_size), FIRST * elem_size);
+    memcpy((byte *)dst + (FIRST * elem_size), dq,
+           (MOVED - FIRST) * elem_size);
+  }
+  header->head = deque_position(dq, MOVED);
+  header->length -= MOVED;
+  return MOVED;
+}
+
+void *deque_untyped_push_back(void **const dq, const void *const elem,
+                              const size_t elem_size) {
+  byte *slot;
+  if (deque_is_full(*dq) && deque_untyped_expand(dq, elem_size) == NULL)
+    return NULL;
+  slot = (byte *)*dq + (deque_position(*dq, deque_length(*dq)) * elem_size);
+  memcpy(slot, elem, elem_size);
+  deque_header(*dq)->length++;
+  return slot;
+}
+
+void *deque_untyped_push_back_n(void **const dq, const void *const src,
+                                const size_t count, const size_t elem_size) {
+  size_t tail;
+  size_t first;
+  if (count > (size_t)-1 - deque_length(*dq)) return NULL;
+  if (deque_untyped_reserve(dq, deque_length(*dq) + count, elem_size) == NULL)
+    return NULL;
+  if (count == 0) return *dq;
+  tail = deque_position(*dq, deque_length(*dq));
+  first = deque_capacity(*dq) - tail;
+  if (first > count) first = count;
+  memcpy((byte *)*dq + (tail * elem_size), src, first * elem_size);
+  memcpy(*dq, (const byte *)src + (first * elem_size),
+         (count - first) * elem_size);
+  deque_header(*dq)->length += count;
+  return *dq;
+}
+
+void *deque_untyped_push_front(void **const dq, const void *const elem,
+                               const size_t elem_size) {
+  deque_header *header;
+  byte *slot;
+  if (deque_is_full(*dq) && deque_untyped_expand(dq, elem_size) == NULL)
+    return NULL;
+  header = deque_header(*dq);
+  header->head = deque_position(*dq, header->capacity - 1);
+  header->length++;
+  slot = (byte *)*dq + (header->head * elem_size);
+  memcpy(slot, elem, elem_size);
+  return slot;
+}
+
+void *deque_untyped_reserve(void **const dq, const size_t count,
+                            const size_t elem_size) {
+  const size_t CAPACITY = deque_capacity(*dq);
+  size_t new_capacity;
+  deque_header *header;
+  byte *ring;
+  if (count <= CAPACITY) return *dq;
+  new_capacity = capacity_for(count, elem_size);
+  if (new_capacity == 0) return NULL;
+  header = myclib_realloc(deque_allocator(*dq), deque_header(*dq),
+                          deque_allocation_size(elem_size, CAPACITY),
+                          deque_allocation_size(elem_size, new_capacity));
+  if (header == NULL) return NULL;
+  ring = (byte *)(header + 1);
+  /*
+   * A wrapped ring is unwrapped once, by moving whichever of its two parts is
+   * shorter: the part at the start of the block goes after the old end, or the
+   * part before the old end goes to the end of the new block.
+   */
+  if (header->head + header->length > CAPACITY) {
+    const size_t WRAPPED = header->head + header->length - CAPACITY;
+    const size_t UNWRAPPED = CAPACITY - header->head;
+    if (WRAPPED <= UNWRAPPED) {
+      memcpy(ring + (CAPACITY * elem_size), ring, WRAPPED * elem_size);
+    } else {
+      memcpy(ring + ((new_capacity - UNWRAPPED) * elem_size),
+             ring + (header->head * elem_size), UNWRAPPED * elem_size);
+      header->head = new_capacity - UNWRAPPED;
+    }
+  }
+  header->capacity = new_capacity;
+  *dq = ring;
+  return ring;
+}
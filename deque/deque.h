@@ -0,0 +1,288 @@
+#ifndef DEQUE_H
+#define DEQUE_H
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/myclib.h"
+
+/* - DEFINITIONS - */
+
+/*
+ * A deque is a ring buffer whose capacity is always a power of two, so that
+ * an element's position in the ring is its index plus the position of the
+ * front, masked by the capacity. Elements are pushed and popped at either end
+ * in constant time, with nothing moved, which makes a deque a FIFO queue
+ * which, unlike a `vector`, does not shift its elements on every dequeue.
+ *
+ * As with `vector`, a header precedes the data, so a `deque(type)` points at
+ * the start of the ring, which is not necessarily the front of the deque.
+ */
+#define deque(type) type *
+
+/* - INTERNAL USE ONLY - */
+
+/*
+ *   `head`    - The position of the front element in the ring.
+ *  `length`   - The number of elements held.
+ * `capacity`  - The size of the ring, which is zero or a power of two.
+ * `allocator` - The allocator owning the deque's memory, or `NULL` if the
+ *               standard library's allocation functions are used.
+ *
+ * The header's size is a multiple of 16 bytes so that elements are as aligned
+ * as the block holding them.
+ */
+typedef struct {
+  size_t head;
+  size_t length;
+  size_t capacity;
+  const myclib_allocator *allocator;
+} deque_header;
+
+#define deque_header(dq) ((deque_header *)(dq) - 1)
+
+#define deque_header_const(dq) ((const deque_header *)(dq) - 1)
+
+/* The size of the block holding a deque of `capacity` elements. */
+#define deque_allocation_size(elem_size, capacity) \
+  (((elem_size) * (capacity)) + sizeof(deque_header))
+
+/* The position in the ring of the element at `index` from the front. */
+#define deque_position(dq, index)             \
+  ((deque_header_const(dq)->head + (index)) & \
+   (deque_header_const(dq)->capacity - 1))
+
+/* - CONVENIENCE MACROS - */
+
+/*
+ * All "_s" variants of the below macros do not evaluate their arguments more
+ * than once.
+ */
+
+#define deque_allocator(dq) (deque_header_const(dq)->allocator)
+
+/*
+ * The element at `index` from the front, as an lvalue. `index` must be less
+ * than the length.
+ */
+#define deque_at(dq, index) ((dq)[deque_position(dq, index)])
+
+/* Returns a pointer to the element at `index`, or `NULL` if there is none. */
+#define deque_at_s(dq, index) deque_untyped_at(dq, index, sizeof *(dq))
+
+#define deque_back(dq) \
+  (util_assert(!deque_is_empty(dq)), deque_at(dq, deque_length(dq) - 1))
+
+#define deque_capacity(dq) (+deque_header_const(dq)->capacity)
+
+#define deque_clear(dq) \
+  ((void)(deque_header(dq)->head = 0, deque_header(dq)->length = 0))
+
+#define deque_delete(dq) \
+  ((void)(deque_untyped_delete(dq, sizeof *(dq)), (dq) = NULL))
+
+#define deque_front(dq) (util_assert(!deque_is_empty(dq)), deque_at(dq, 0))
+
+#define deque_is_empty(dq) (deque_length(dq) == 0)
+
+#define deque_is_full(dq) (deque_length(dq) == deque_capacity(dq))
+
+#define deque_length(dq) (+deque_header_const(dq)->length)
+
+#define deque_new(type, capacity) \
+  ((type *)deque_untyped_new(sizeof(type), capacity))
+
+#define deque_new_with(allocator, type, capacity) \
+  ((type *)deque_untyped_new_with(allocator, sizeof(type), capacity))
+
+#define deque_pop_back(dq)           \
+  (util_assert(!deque_is_empty(dq)), \
+   (void)deque_header(dq)->length--, \
+   deque_at(dq, deque_length(dq)))
+
+#define deque_pop_back_s(dq) deque_untyped_pop_back(dq, sizeof *(dq))
+
+#define deque_pop_front(dq)                        \
+  (util_assert(!deque_is_empty(dq)),               \
+   (void)deque_header(dq)->length--,               \
+   deque_header(dq)->head = deque_position(dq, 1), \
+   (dq)[(deque_header_const(dq)->head - 1) & (deque_capacity(dq) - 1)])
+
+#define deque_pop_front_s(dq) deque_untyped_pop_front(dq, sizeof *(dq))
+
+/*
+ * Moves up to `count` elements from the front to `dst`, which may be `NULL`
+ * to discard them, in at most two copies. Returns the number moved.
+ */
+#define deque_pop_front_n(dq, dst, count) \
+  deque_untyped_pop_front_n(dq, dst, count, sizeof *(dq))
+
+#define deque_push_back(dq, elem)                                     \
+  (inline_if(deque_is_full(dq),                                       \
+             util_assert(deque_untyped_expand((void **)&(dq),         \
+                                              sizeof *(dq)) != NULL), \
+             NULL),                                                   \
+   (void)deque_header(dq)->length++,                                  \
+   deque_at(dq, deque_length(dq) - 1) = (elem))
+
+#define deque_push_back_s(dq, elem) \
+  deque_untyped_push_back((void **)&(dq), (const void *)&(elem), sizeof *(dq))
+
+/*
+ * Appends the `count` elements at `src`, which must not overlap `dq`, growing
+ * the deque at most once and copying them in at most two spans.
+ */
+#define deque_push_back_n(dq, src, count) \
+  deque_untyped_push_back_n((void **)&(dq), src, count, sizeof *(dq))
+
+#define deque_push_front(dq, elem)                                      \
+  (inline_if(deque_is_full(dq),                                         \
+             util_assert(deque_untyped_expand((void **)&(dq),           \
+                                              sizeof *(dq)) != NULL),   \
+             NULL),                                                     \
+   (void)deque_header(dq)->length++,                                    \
+   deque_header(dq)->head = deque_position(dq, deque_capacity(dq) - 1), \
+   deque_at(dq, 0) = (elem))
+
+#define deque_push_front_s(dq, elem) \
+  deque_untyped_push_front((void **)&(dq), (const void *)&(elem), sizeof *(dq))
+
+/* Grows the deque so that it holds `count` elements without growing again. */
+#define deque_reserve(dq, count) \
+  deque_untyped_reserve((void **)&(dq), count, sizeof *(dq))
+
+/* - TYPED GENERATORS - */
+
+/*
+ * `DEFINE_DEQUE(type, name)` defines `name` as a `deque(type)` along with the
+ * following functions, each of which evaluates its arguments once and works
+ * on `type` directly instead of through `memcpy()` and `void *`:
+ *
+ * `name name_new(size_t capacity)`
+ * `name name_new_with(const myclib_allocator *allocator, size_t capacity)`
+ * `void name_delete(name *dq)`
+ * `type *name_push_back(name *dq, type elem)`
+ * `type *name_push_front(name *dq, type elem)`
+ * `type name_pop_back(name dq)`
+ * `type name_pop_front(name dq)`
+ * `type *name_at(name dq, size_t index)`
+ *
+ * They behave as the macros of the same name do, except that the pushes return
+ * `NULL` if the deque could not be grown. Deques created either way share the
+ * same layout, so a `name` may be passed to any other deque macro and vice
+ * versa.
+ */
+#define DEFINE_DEQUE(type, name)                                              \
+  typedef type *name;                                                         \
+                                                                              \
+  static inline name name##_new_with(const myclib_allocator *const allocator, \
+                                     const size_t capacity) {                 \
+    return (name)deque_untyped_new_with(allocator, sizeof(type), capacity);   \
+  }                                                                           \
+                                                                              \
+  static inline name name##_new(const size_t capacity) {                      \
+    return name##_new_with(NULL, capacity);                                   \
+  }                                                                           \
+                                                                              \
+  static inline void name##_delete(name *const dq) {                          \
+    deque_untyped_delete(*dq, sizeof(type));                                  \
+    *dq = NULL;                                                               \
+  }                                                                           \
+                                                                              \
+  static inline type *name##_grow_for_push(name *const dq) {                  \
+    if (deque_is_full(*dq)) {                                                 \
+      void *dq_actual = *dq;                                                  \
+      if (deque_untyped_expand(&dq_actual, sizeof(type)) == NULL)             \
+        return NULL;                                                          \
+      *dq = (name)dq_actual;                                                  \
+    }                                                                         \
+    return *dq;                                                               \
+  }                                                                           \
+                                                                              \
+  static inline type *name##_push_back(name *const dq, const type elem) {     \
+    type *slot;                                                               \
+    if (name##_grow_for_push(dq) == NULL) return NULL;                        \
+    slot = *dq + deque_position(*dq, deque_length(*dq));                      \
+    *slot = elem;                                                             \
+    deque_header(*dq)->length++;                                              \
+    return slot;                                                              \
+  }                                                                           \
+                                                                              \
+  static inline type *name##_push_front(name *const dq, const type elem) {    \
+    if (name##_grow_for_push(dq) == NULL) return NULL;                        \
+    deque_header(*dq)->head = deque_position(*dq, deque_capacity(*dq) - 1);   \
+    deque_header(*dq)->length++;                                              \
+    (*dq)[deque_header(*dq)->head] = elem;                                    \
+    return *dq + deque_header(*dq)->head;                                     \
+  }                                                                           \
+                                                                              \
+  static inline type name##_pop_back(const name dq) {                         \
+    util_assert(!deque_is_empty(dq));                                         \
+    return dq[deque_position(dq, --deque_header(dq)->length)];                \
+  }                                                                           \
+                                                                              \
+  static inline type name##_pop_front(const name dq) {                        \
+    const size_t HEAD = deque_header(dq)->head;                               \
+    util_assert(!deque_is_empty(dq));                                         \
+    deque_header(dq)->head = deque_position(dq, 1);                           \
+    deque_header(dq)->length--;                                               \
+    return dq[HEAD];                                                          \
+  }                                                                           \
+                                                                              \
+  static inline type *name##_at(const name dq, const size_t index) {          \
+    util_assert(index < deque_length(dq));                                    \
+    return dq + deque_position(dq, index);                                    \
+  }                                                                           \
+                                                                              \
+  typedef int name##_require_semicolon
+
+/* - FUNCTIONS - */
+
+void *deque_untyped_at(deque(void) dq, size_t index, size_t elem_size);
+
+void deque_untyped_delete(deque(void) dq, size_t elem_size);
+
+/*
+ * Doubles the capacity, moving whichever part of a wrapped ring is shorter so
+ * that the elements stay contiguous modulo the new capacity. Returns `NULL` if
+ * the deque could not be grown, in which case it is unchanged.
+ */
+deque(void) deque_untyped_expand(deque(void) * dq, size_t elem_size);
+
+deque(void) deque_untyped_new(size_t elem_size, size_t capacity);
+
+/*
+ * Returns a deque with room for `capacity` elements, rounded up to a power of
+ * two, or `NULL` if it could not be allocated.
+ */
+deque(void) deque_untyped_new_with(const myclib_allocator *allocator,
+                                   size_t elem_size, size_t capacity);
+
+/*
+ * Returns a pointer to the popped element, which stays valid until the next
+ * push, or `NULL` if the deque is empty.
+ */
+void *deque_untyped_pop_back(deque(void) dq, size_t elem_size);
+
+void *deque_untyped_pop_front(deque(void) dq, size_t elem_size);
+
+size_t deque_untyped_pop_front_n(deque(void) dq, void *dst, size_t count,
+                                 size_t elem_size);
+
+/* Returns a pointer to the pushed element, or `NULL` if it could not grow. */
+void *deque_untyped_push_back(deque(void) * dq, const void *elem,
+                              size_t elem_size);
+
+/* Returns `*dq`, or `NULL` if the deque could not be grown. */
+deque(void) deque_untyped_push_back_n(deque(void) * dq, const void *src,
+                                      size_t count, size_t elem_size);
+
+void *deque_untyped_push_front(deque(void) * dq, const void *elem,
+                               size_t elem_size);
+
+/* Returns `*dq`, or `NULL` if the deque could not be grown. */
+deque(void) deque_untyped_reserve(deque(void) * dq, size_t count,
+                                  size_t elem_size);
+
+#endif
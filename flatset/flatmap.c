@@ -0,0 +1,105 @@
+#include "flatmap.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "../include/myclib.h"
+#include "../vector/vector.h"
+#include "flatset.h"
+
+/* - INTERNAL - */
+
+#define value_at(map, index) \
+  ((byte *)(map)->values + ((index) * (map)->value_size))
+
+/* - FUNCTIONS - */
+
+bool flat_map_build(flat_map *const map, const void *const keys,
+                    const void *const values, const size_t count) {
+  const size_t LENGTH = flat_map_length(map);
+  vector_header(map->keys)->length = 0;
+  vector_header(map->values)->length = 0;
+  if (flat_untyped_insert_batch(&map->keys, &map->values, keys, values, count,
+                                map->key_size, map->value_size,
+                                map->cmp) == VEC_BAD_INDEX) {
+    /* Nothing was written, so the previous contents are intact. */
+    vector_header(map->keys)->length = LENGTH;
+    vector_header(map->values)->length = LENGTH;
+    return false;
+  }
+  return true;
+}
+
+void flat_map_destroy(flat_map *const map) {
+  vector_untyped_delete(&map->keys, map->key_size);
+  vector_untyped_delete(&map->values, map->value_size);
+}
+
+bool flat_map_erase(flat_map *const map, const void *const key) {
+  const size_t INDEX =
+      flat_set_untyped_find(map->keys, key, map->key_size, map->cmp);
+  if (INDEX == VEC_BAD_INDEX) return false;
+  util_assert(vector_untyped_splice(&map->keys, INDEX, 1, NULL, 0,
+                                    map->key_size) != NULL);
+  util_assert(vector_untyped_splice(&map->values, INDEX, 1, NULL, 0,
+                                    map->value_size) != NULL);
+  return true;
+}
+
+void *flat_map_get(const flat_map *const map, const void *const key) {
+  const size_t INDEX =
+      flat_set_untyped_find(map->keys, key, map->key_size, map->cmp);
+  return INDEX != VEC_BAD_INDEX ? value_at(map, INDEX) : NULL;
+}
+
+bool flat_map_init(flat_map *const map, const size_t key_size,
+                   const size_t value_size, const vec_comparator cmp) {
+  return flat_map_init_with(map, NULL, key_size, value_size, cmp);
+}
+
+bool flat_map_init_with(flat_map *const map,
+                        const myclib_allocator *const allocator,
+                        const size_t key_size, const size_t value_size,
+                        const vec_comparator cmp) {
+  map->keys = vector_untyped_new_with(allocator, key_size, 0);
+  map->values = vector_untyped_new_with(allocator, value_size, 0);
+  map->key_size = key_size;
+  map->value_size = value_size;
+  map->cmp = cmp;
+  if (map->keys != NULL && map->values != NULL) return true;
+  if (map->keys != NULL) vector_untyped_delete(&map->keys, key_size);
+  if (map->values != NULL) vector_untyped_delete(&map->values, value_size);
+  return false;
+}
+
+size_t flat_map_insert_n(flat_map *const map, const void *const keys,
+                         const void *const values, const size_t count) {
+  return flat_untyped_insert_batch(&map->keys, &map->values, keys, values,
+                                   count, map->key_size, map->value_size,
+                                   map->cmp);
+}
+
+size_t flat_map_lower_bound(const flat_map *const map, const void *const key) {
+  return flat_set_untyped_lower_bound(map->keys, key, map->key_size, map->cmp);
+}
+
+void *flat_map_put(flat_map *const map, const void *const key,
+                   const void *const value) {
+  const size_t LENGTH = flat_map_length(map);
+  const size_t INDEX = flat_map_lower_bound(map, key);
+  if (INDEX == LENGTH ||
+      map->cmp((const byte *)map->keys + (INDEX * map->key_size), key) != 0) {
+    /* Both vectors are grown first, so that neither changes if one cannot. */
+    if (vector_untyped_reserve(&map->keys, LENGTH + 1, map->key_size) ==
+            NULL ||
+        vector_untyped_reserve(&map->values, LENGTH + 1, map->value_size) ==
+            NULL)
+      return NULL;
+    util_assert(vector_untyped_splice(&map->keys, INDEX, 0, key, 1,
+                                      map->key_size) != NULL);
+    util_assert(vector_untyped_splice(&map->values, INDEX, 0, value, 1,
+                                      map->value_size) != NULL);
+    return value_at(map, INDEX);
+  }
+  return memcpy(value_at(map, INDEX), value, map->value_size);
+}
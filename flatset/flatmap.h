@@ -0,0 +1,94 @@
+#ifndef FLAT_MAP_H
+#define FLAT_MAP_H
+
+#include <stddef.h>
+
+#include "../include/myclib.h"
+#include "../vector/vector.h"
+#include "flatset.h"
+
+/* - DEFINITIONS - */
+
+/*
+ * A flat map keeps its keys in a `flat_set` and its values in a parallel
+ * `vector`, with the value of key `i` at index `i`. Searches only touch the
+ * densely packed keys, and a key's value is found by its index. Both vectors
+ * may be read directly, but only modified through the functions below.
+ *
+ * As with flat sets, single insertions and removals shift everything after
+ * them, and one of the `flat_set_compare_*` comparators selects the
+ * branchless search for integer keys.
+ *
+ *    `keys`    - The map's keys, sorted and distinct.
+ *   `values`   - The value of each key, in the same order.
+ *  `key_size`  - The size of the keys.
+ * `value_size` - The size of the values.
+ *    `cmp`     - The comparator ordering the keys.
+ */
+typedef struct flat_map {
+  flat_set(void) keys;
+  vector(void) values;
+  size_t key_size;
+  size_t value_size;
+  vec_comparator cmp;
+} flat_map;
+
+/* - CONVENIENCE MACROS - */
+
+/* The keys of `map` as a `flat_set(type)`. */
+#define flat_map_keys(map, type) ((type *)(map)->keys)
+
+#define flat_map_length(map) vector_length((map)->keys)
+
+/* The values of `map` as a `vector(type)`. */
+#define flat_map_values(map, type) ((type *)(map)->values)
+
+/* - FUNCTIONS - */
+
+/*
+ * Replaces the contents of `map` with the `count` pairs whose keys are at
+ * `keys` and values at `values`. The pairs are sorted once, and only the first
+ * of several pairs with equal keys is kept. Returns `false` if memory could
+ * not be allocated, in which case `map` is unchanged.
+ */
+bool flat_map_build(flat_map *map, const void *keys, const void *values,
+                    size_t count);
+
+void flat_map_destroy(flat_map *map);
+
+/* Returns `false` if `key` was not in the map. */
+bool flat_map_erase(flat_map *map, const void *key);
+
+/*
+ * Returns a pointer to the value of `key`, or `NULL` if it is not in the map.
+ * The pointer is invalidated by any change to the map.
+ */
+void *flat_map_get(const flat_map *map, const void *key);
+
+/* Returns `false` if the map's vectors could not be allocated. */
+bool flat_map_init(flat_map *map, size_t key_size, size_t value_size,
+                   vec_comparator cmp);
+
+bool flat_map_init_with(flat_map *map, const myclib_allocator *allocator,
+                        size_t key_size, size_t value_size,
+                        vec_comparator cmp);
+
+/*
+ * Sorts the `count` pairs given as for `flat_map_build()` and merges them into
+ * `map` in linear time. Keys already in the map keep their values. Returns the
+ * number of pairs inserted, or `VEC_BAD_INDEX` if memory could not be
+ * allocated, in which case `map` is unchanged.
+ */
+size_t flat_map_insert_n(flat_map *map, const void *keys, const void *values,
+                         size_t count);
+
+/* Returns the index of the first key not less than `key`. */
+size_t flat_map_lower_bound(const flat_map *map, const void *key);
+
+/*
+ * Sets the value of `key`, inserting it if needed, and returns a pointer to
+ * the stored value, or `NULL` if the map could not be grown.
+ */
+void *flat_map_put(flat_map *map, const void *key, const void *value);
+
+#endif
@@ -0,0 +1,599 @@
+#include "flatset.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../cpu/cpu.h"
+#include "../include/myclib.h"
+#include "../vector/vector.h"
+
+/* - DEFINITIONS - */
+
+/* The number of keys the set operation kernels match against each other. */
+#define BLOCK_KEYS (4)
+
+typedef enum key_type {
+  KEY_GENERIC,
+  KEY_U32,
+  KEY_U64,
+  KEY_I32,
+  KEY_I64
+} key_type;
+
+typedef enum set_op { OP_UNION, OP_INTERSECTION, OP_DIFFERENCE } set_op;
+
+#define key_at(keys, index, key_size) ((byte *)(keys) + ((index) * (key_size)))
+
+#define key_at_const(keys, index, key_size) \
+  ((const byte *)(keys) + ((index) * (key_size)))
+
+/* - INTERNAL - */
+
+/* Determines whether the keys are integers ordered by a built-in comparator. */
+static key_type key_type_of(const vec_comparator cmp, const size_t key_size) {
+  if (cmp == flat_set_compare_u32 && key_size == sizeof(vec_u32))
+    return KEY_U32;
+  if (cmp == flat_set_compare_u64 && key_size == sizeof(vec_u64))
+    return KEY_U64;
+  if (cmp == flat_set_compare_i32 && key_size == sizeof(vec_i32))
+    return KEY_I32;
+  if (cmp == flat_set_compare_i64 && key_size == sizeof(vec_i64))
+    return KEY_I64;
+  return KEY_GENERIC;
+}
+
+/*
+ * Keeps the first of each run of equal keys among the `count` sorted records
+ * at `records`, each `stride` bytes long, returning the number kept.
+ */
+static size_t dedup_sorted(byte *const records, const size_t count,
+                           const size_t stride, const vec_comparator cmp) {
+  size_t kept = 1;
+  size_t i;
+  if (count == 0) return 0;
+  for (i = 1; i < count; i++) {
+    const byte *const record = key_at_const(records, i, stride);
+    if (cmp(key_at_const(records, kept - 1, stride), record) == 0) continue;
+    if (kept != i) memcpy(key_at(records, kept, stride), record, stride);
+    kept++;
+  }
+  return kept;
+}
+
+/* - BRANCHLESS SEARCH - */
+
+/*
+ * Defines a lower bound search over `length` sorted keys of type `word`. Each
+ * step picks the half holding the bound with a conditional move rather than a
+ * branch, so a search takes the same path whatever the keys.
+ */
+#define DEFINE_LOWER_BOUND(name, word)                                        \
+  static size_t name(const word *const keys, size_t length, const word key) { \
+    const word *base = keys;                                                  \
+    if (length == 0) return 0;                                                \
+    while (length > 1) {                                                      \
+      const size_t HALF = length / 2;                                         \
+      base = base[HALF] < key ? base + HALF : base;                           \
+      length -= HALF;                                                         \
+    }                                                                         \
+    return (size_t)(base - keys) + (size_t)(*base < key);                     \
+  }
+
+DEFINE_LOWER_BOUND(lower_bound_u32, vec_u32)
+DEFINE_LOWER_BOUND(lower_bound_u64, vec_u64)
+DEFINE_LOWER_BOUND(lower_bound_i32, vec_i32)
+DEFINE_LOWER_BOUND(lower_bound_i64, vec_i64)
+
+/* As above, with the comparison's result scaling the step taken. */
+static size_t lower_bound_generic(const byte *const keys, size_t length,
+                                  const void *const key,
+                                  const size_t key_size,
+                                  const vec_comparator cmp) {
+  const byte *base = keys;
+  if (length == 0) return 0;
+  while (length > 1) {
+    const size_t HALF = length / 2;
+    base += (size_t)(cmp(base + (HALF * key_size), key) < 0) * HALF * key_size;
+    length -= HALF;
+  }
+  return (size_t)(base - keys) / key_size + (size_t)(cmp(base, key) < 0);
+}
+
+/* - BLOCK MATCHING - */
+
+/*
+ * Returns a mask whose bit `k` is set if the `k`th of `BLOCK_KEYS` keys at `a`
+ * equals any of the `BLOCK_KEYS` keys at `b`. Only equality is tested, so
+ * signed keys are matched through their unsigned counterparts.
+ */
+#if (MYCLIB_HAS_SSE2)
+
+static inline unsigned match_block_32(const vec_u32 *const a,
+                                      const vec_u32 *const b) {
+  const __m128i A = _mm_loadu_si128((const __m128i *)a);
+  const __m128i B = _mm_loadu_si128((const __m128i *)b);
+  /* Compares `a` against every rotation of `b`. */
+  const __m128i B_1 = _mm_shuffle_epi32(B, _MM_SHUFFLE(0, 3, 2, 1));
+  const __m128i B_2 = _mm_shuffle_epi32(B, _MM_SHUFFLE(1, 0, 3, 2));
+  const __m128i B_3 = _mm_shuffle_epi32(B, _MM_SHUFFLE(2, 1, 0, 3));
+  const __m128i LOW =
+      _mm_or_si128(_mm_cmpeq_epi32(A, B), _mm_cmpeq_epi32(A, B_1));
+  const __m128i HIGH =
+      _mm_or_si128(_mm_cmpeq_epi32(A, B_2), _mm_cmpeq_epi32(A, B_3));
+  const __m128i MATCHES = _mm_or_si128(LOW, HIGH);
+  return (unsigned)_mm_movemask_ps(_mm_castsi128_ps(MATCHES));
+}
+
+/* SSE2 lacks a 64-bit comparison, so both halves must compare equal. */
+static inline __m128i cmpeq_64(const __m128i a, const __m128i b) {
+  const __m128i HALVES = _mm_cmpeq_epi32(a, b);
+  return _mm_and_si128(HALVES,
+                       _mm_shuffle_epi32(HALVES, _MM_SHUFFLE(2, 3, 0, 1)));
+}
+
+/*
+ * Swaps the 64-bit halves of a register through `_mm_shuffle_epi32()`, whose
+ * operand must be a constant expression even without optimizations.
+ */
+#define SWAP_HALVES _MM_SHUFFLE(1, 0, 3, 2)
+
+static inline __m128i match_pair_64(const __m128i a, const __m128i b_low,
+                                    const __m128i b_high) {
+  __m128i matches = cmpeq_64(a, b_low);
+  matches = _mm_or_si128(matches,
+                         cmpeq_64(a, _mm_shuffle_epi32(b_low, SWAP_HALVES)));
+  matches = _mm_or_si128(matches, cmpeq_64(a, b_high));
+  return _mm_or_si128(matches,
+                      cmpeq_64(a, _mm_shuffle_epi32(b_high, SWAP_HALVES)));
+}
+
+static inline unsigned match_block_64(const vec_u64 *const a,
+                                      const vec_u64 *const b) {
+  const __m128i B_LOW = _mm_loadu_si128((const __m128i *)b);
+  const __m128i B_HIGH = _mm_loadu_si128((const __m128i *)(b + 2));
+  const __m128i LOW =
+      match_pair_64(_mm_loadu_si128((const __m128i *)a), B_LOW, B_HIGH);
+  const __m128i HIGH =
+      match_pair_64(_mm_loadu_si128((const __m128i *)(a + 2)), B_LOW, B_HIGH);
+  return (unsigned)_mm_movemask_pd(_mm_castsi128_pd(LOW)) |
+         ((unsigned)_mm_movemask_pd(_mm_castsi128_pd(HIGH)) << 2);
+}
+
+#else
+
+static inline unsigned match_block_32(const vec_u32 *const a,
+                                      const vec_u32 *const b) {
+  unsigned mask = 0;
+  size_t k;
+  size_t l;
+  for (k = 0; k < BLOCK_KEYS; k++)
+    for (l = 0; l < BLOCK_KEYS; l++) mask |= (unsigned)(a[k] == b[l]) << k;
+  return mask;
+}
+
+static inline unsigned match_block_64(const vec_u64 *const a,
+                                      const vec_u64 *const b) {
+  unsigned mask = 0;
+  size_t k;
+  size_t l;
+  for (k = 0; k < BLOCK_KEYS; k++)
+    for (l = 0; l < BLOCK_KEYS; l++) mask |= (unsigned)(a[k] == b[l]) << k;
+  return mask;
+}
+
+#endif
+
+/* - SET OPERATION KERNELS - */
+
+/*
+ * Defines the set operations over sorted keys of type `word`, which are
+ * `bits` wide. Intersections and differences match a block of keys from each
+ * input at once, then advance past whichever block ends lower, or both.
+ * Unions copy whole blocks while one input runs ahead of the other. Each
+ * writes its result to `out` and returns the number of keys written.
+ */
+#define DEFINE_SET_OPS(prefix, word, bits)                                 \
+  static size_t prefix##_union(const word *const a, const size_t a_length, \
+                               const word *const b, const size_t b_length, \
+                               word *const out) {                          \
+    size_t i = 0;                                                          \
+    size_t j = 0;                                                          \
+    size_t count = 0;                                                      \
+    while (i < a_length && j < b_length) {                                 \
+      if (a_length - i >= BLOCK_KEYS && a[i + BLOCK_KEYS - 1] < b[j]) {    \
+        memcpy(out + count, a + i, BLOCK_KEYS * sizeof(word));             \
+        count += BLOCK_KEYS;                                               \
+        i += BLOCK_KEYS;                                                   \
+      } else if (b_length - j >= BLOCK_KEYS &&                             \
+                 b[j + BLOCK_KEYS - 1] < a[i]) {                           \
+        memcpy(out + count, b + j, BLOCK_KEYS * sizeof(word));             \
+        count += BLOCK_KEYS;                                               \
+        j += BLOCK_KEYS;                                                   \
+      } else if (a[i] < b[j]) {                                            \
+        out[count++] = a[i++];                                             \
+      } else if (b[j] < a[i]) {                                            \
+        out[count++] = b[j++];                                             \
+      } else {                                                             \
+        out[count++] = a[i++];                                             \
+        j++;                                                               \
+      }                                                                    \
+    }                                                                      \
+    memcpy(out + count, a + i, (a_length - i) * sizeof(word));             \
+    count += a_length - i;                                                 \
+    memcpy(out + count, b + j, (b_length - j) * sizeof(word));             \
+    return count + (b_length - j);                                         \
+  }                                                                        \
+                                                                           \
+  static size_t prefix##_intersection(                                     \
+      const word *const a, const size_t a_length, const word *const b,     \
+      const size_t b_length, word *const out) {                            \
+    size_t i = 0;                                                          \
+    size_t j = 0;                                                          \
+    size_t count = 0;                                                      \
+    while (a_length - i >= BLOCK_KEYS && b_length - j >= BLOCK_KEYS) {     \
+      const unsigned MATCHES = match_block_##bits(                         \
+          (const vec_u##bits *)(a + i), (const vec_u##bits *)(b + j));     \
+      const word A_LAST = a[i + BLOCK_KEYS - 1];                           \
+      const word B_LAST = b[j + BLOCK_KEYS - 1];                           \
+      size_t k;                                                            \
+      for (k = 0; k < BLOCK_KEYS; k++)                                     \
+        if ((MATCHES >> k) & 1) out[count++] = a[i + k];                   \
+      if (A_LAST <= B_LAST) i += BLOCK_KEYS;                               \
+      if (B_LAST <= A_LAST) j += BLOCK_KEYS;                               \
+    }                                                                      \
+    /* Keys matched above lie below every key left in the other input. */  \
+    while (i < a_length && j < b_length) {                                 \
+      if (a[i] < b[j]) {                                                   \
+        i++;                                                               \
+      } else if (b[j] < a[i]) {                                            \
+        j++;                                                               \
+      } else {                                                             \
+        out[count++] = a[i++];                                             \
+        j++;                                                               \
+      }                                                                    \
+    }                                                                      \
+    return count;                                                          \
+  }                                                                        \
+                                                                           \
+  static size_t prefix##_difference(                                       \
+      const word *const a, const size_t a_length, const word *const b,     \
+      const size_t b_length, word *const out) {                            \
+    size_t i = 0;                                                          \
+    size_t j = 0;                                                          \
+    size_t count = 0;                                                      \
+    size_t k;                                                              \
+    /* The keys of the current block of `a` matched so far. */             \
+    unsigned found = 0;                                                    \
+    while (a_length - i >= BLOCK_KEYS && b_length - j >= BLOCK_KEYS) {     \
+      const word A_LAST = a[i + BLOCK_KEYS - 1];                           \
+      const word B_LAST = b[j + BLOCK_KEYS - 1];                           \
+      found |= match_block_##bits((const vec_u##bits *)(a + i),            \
+                                  (const vec_u##bits *)(b + j));           \
+      if (A_LAST <= B_LAST) {                                              \
+        for (k = 0; k < BLOCK_KEYS; k++)                                   \
+          if (((found >> k) & 1) == 0) out[count++] = a[i + k];            \
+        found = 0;                                                         \
+        i += BLOCK_KEYS;                                                   \
+      }                                                                    \
+      if (B_LAST <= A_LAST) j += BLOCK_KEYS;                               \
+    }                                                                      \
+    for (k = 0; i < a_length; i++, k++) {                                  \
+      if (k < BLOCK_KEYS && ((found >> k) & 1) != 0) continue;             \
+      while (j < b_length && b[j] < a[i]) j++;                             \
+      if (j < b_length && !(a[i] < b[j])) continue;                        \
+      out[count++] = a[i];                                                 \
+    }                                                                      \
+    return count;                                                          \
+  }
+
+DEFINE_SET_OPS(u32, vec_u32, 32)
+DEFINE_SET_OPS(u64, vec_u64, 64)
+DEFINE_SET_OPS(i32, vec_i32, 32)
+DEFINE_SET_OPS(i64, vec_i64, 64)
+
+/* The set operations for keys only ordered by a comparator. */
+static size_t generic_set_op(const set_op op, const byte *const a,
+                             const size_t a_length, const byte *const b,
+                             const size_t b_length, byte *const out,
+                             const size_t key_size, const vec_comparator cmp) {
+  size_t i = 0;
+  size_t j = 0;
+  size_t count = 0;
+  while (i < a_length && j < b_length) {
+    const int ORDER =
+        cmp(key_at_const(a, i, key_size), key_at_const(b, j, key_size));
+    if (ORDER < 0) {
+      if (op != OP_INTERSECTION)
+        memcpy(key_at(out, count++, key_size), key_at_const(a, i, key_size),
+               key_size);
+      i++;
+    } else if (ORDER > 0) {
+      if (op == OP_UNION)
+        memcpy(key_at(out, count++, key_size), key_at_const(b, j, key_size),
+               key_size);
+      j++;
+    } else {
+      if (op != OP_DIFFERENCE)
+        memcpy(key_at(out, count++, key_size), key_at_const(a, i, key_size),
+               key_size);
+      i++;
+      j++;
+    }
+  }
+  if (op != OP_INTERSECTION) {
+    memcpy(key_at(out, count, key_size), key_at_const(a, i, key_size),
+           (a_length - i) * key_size);
+    count += a_length - i;
+  }
+  if (op == OP_UNION) {
+    memcpy(key_at(out, count, key_size), key_at_const(b, j, key_size),
+           (b_length - j) * key_size);
+    count += b_length - j;
+  }
+  return count;
+}
+
+#define DISPATCH_SET_OP(prefix, word, op, a, a_length, b, b_length, out)   \
+  ((op) == OP_UNION                                                        \
+       ? prefix##_union((const word *)(a), a_length, (const word *)(b),    \
+                        b_length, (word *)(out))                           \
+   : (op) == OP_INTERSECTION                                               \
+       ? prefix##_intersection((const word *)(a), a_length,                \
+                               (const word *)(b), b_length, (word *)(out)) \
+       : prefix##_difference((const word *)(a), a_length,                  \
+                             (const word *)(b), b_length, (word *)(out)))
+
+static void *apply_set_op(const set_op op, void **const dst,
+                          const void *const a, const void *const b,
+                          const size_t key_size, const vec_comparator cmp) {
+  const size_t A_LENGTH = vector_length(a);
+  const size_t B_LENGTH = vector_length(b);
+  size_t bound = A_LENGTH;
+  size_t count;
+  util_assert(*dst != a && *dst != b);
+  if (op == OP_UNION) {
+    if (B_LENGTH > (size_t)-1 - A_LENGTH) return NULL;
+    bound += B_LENGTH;
+  } else if (op == OP_INTERSECTION && B_LENGTH < bound) {
+    bound = B_LENGTH;
+  }
+  if (vector_untyped_reserve(dst, bound, key_size) == NULL ||
+      vector_untyped_unshare(dst, key_size) == NULL)
+    return NULL;
+  /* Only now that it is private may `*dst` be emptied. */
+  vector_header(*dst)->length = 0;
+  switch (key_type_of(cmp, key_size)) {
+    case KEY_U32:
+      count =
+          DISPATCH_SET_OP(u32, vec_u32, op, a, A_LENGTH, b, B_LENGTH, *dst);
+      break;
+    case KEY_U64:
+      count =
+          DISPATCH_SET_OP(u64, vec_u64, op, a, A_LENGTH, b, B_LENGTH, *dst);
+      break;
+    case KEY_I32:
+      count =
+          DISPATCH_SET_OP(i32, vec_i32, op, a, A_LENGTH, b, B_LENGTH, *dst);
+      break;
+    case KEY_I64:
+      count =
+          DISPATCH_SET_OP(i64, vec_i64, op, a, A_LENGTH, b, B_LENGTH, *dst);
+      break;
+    default:
+      count = generic_set_op(op, a, A_LENGTH, b, B_LENGTH, *dst, key_size, cmp);
+      break;
+  }
+  vector_header(*dst)->length = count;
+  return *dst;
+}
+
+/* - FUNCTIONS - */
+
+int flat_set_compare_u32(const void *const a, const void *const b) {
+  const vec_u32 A = *(const vec_u32 *)a;
+  const vec_u32 B = *(const vec_u32 *)b;
+  return (A > B) - (A < B);
+}
+
+int flat_set_compare_u64(const void *const a, const void *const b) {
+  const vec_u64 A = *(const vec_u64 *)a;
+  const vec_u64 B = *(const vec_u64 *)b;
+  return (A > B) - (A < B);
+}
+
+int flat_set_compare_i32(const void *const a, const void *const b) {
+  const vec_i32 A = *(const vec_i32 *)a;
+  const vec_i32 B = *(const vec_i32 *)b;
+  return (A > B) - (A < B);
+}
+
+int flat_set_compare_i64(const void *const a, const void *const b) {
+  const vec_i64 A = *(const vec_i64 *)a;
+  const vec_i64 B = *(const vec_i64 *)b;
+  return (A > B) - (A < B);
+}
+
+bool flat_set_untyped_build(void **const set, const size_t elem_size,
+                            const vec_comparator cmp) {
+  const size_t LENGTH = vector_length(*set);
+  bool sorted;
+  if (vector_untyped_unshare(set, elem_size) == NULL) return false;
+  /* Integer keys are indistinguishable when equal, so need not sort stably. */
+  switch (key_type_of(cmp, elem_size)) {
+    case KEY_U32:
+      sorted = vector_radix_sort_u32(*set, LENGTH);
+      break;
+    case KEY_U64:
+      sorted = vector_radix_sort_u64(*set, LENGTH);
+      break;
+    case KEY_I32:
+      sorted = vector_radix_sort_i32(*set, LENGTH);
+      break;
+    case KEY_I64:
+      sorted = vector_radix_sort_i64(*set, LENGTH);
+      break;
+    default:
+      sorted = vector_sort_stable(*set, LENGTH, elem_size, cmp);
+      break;
+  }
+  if (!sorted) return false;
+  vector_header(*set)->length = dedup_sorted(*set, LENGTH, elem_size, cmp);
+  return true;
+}
+
+void *flat_set_untyped_difference(void **const dst, const void *const a,
+                                  const void *const b, const size_t elem_size,
+                                  const vec_comparator cmp) {
+  return apply_set_op(OP_DIFFERENCE, dst, a, b, elem_size, cmp);
+}
+
+bool flat_set_untyped_erase(void **const set, const void *const key,
+                            const size_t elem_size, const vec_comparator cmp) {
+  const size_t INDEX = flat_set_untyped_find(*set, key, elem_size, cmp);
+  if (INDEX == VEC_BAD_INDEX) return false;
+  util_assert(vector_untyped_splice(set, INDEX, 1, NULL, 0, elem_size) !=
+              NULL);
+  return true;
+}
+
+size_t flat_set_untyped_find(const void *const set, const void *const key,
+                             const size_t elem_size,
+                             const vec_comparator cmp) {
+  const size_t INDEX =
+      flat_set_untyped_lower_bound(set, key, elem_size, cmp);
+  if (INDEX == vector_length(set) ||
+      cmp(key_at_const(set, INDEX, elem_size), key) != 0)
+    return VEC_BAD_INDEX;
+  return INDEX;
+}
+
+size_t flat_set_untyped_insert(void **const set, const void *const key,
+                               const size_t elem_size,
+                               const vec_comparator cmp) {
+  const size_t INDEX =
+      flat_set_untyped_lower_bound(*set, key, elem_size, cmp);
+  if (INDEX < vector_length(*set) &&
+      cmp(key_at_const(*set, INDEX, elem_size), key) == 0)
+    return INDEX;
+  if (vector_untyped_splice(set, INDEX, 0, key, 1, elem_size) == NULL)
+    return VEC_BAD_INDEX;
+  return INDEX;
+}
+
+void *flat_set_untyped_intersection(void **const dst, const void *const a,
+                                    const void *const b,
+                                    const size_t elem_size,
+                                    const vec_comparator cmp) {
+  return apply_set_op(OP_INTERSECTION, dst, a, b, elem_size, cmp);
+}
+
+size_t flat_set_untyped_lower_bound(const void *const set,
+                                    const void *const key,
+                                    const size_t elem_size,
+                                    const vec_comparator cmp) {
+  const size_t LENGTH = vector_length(set);
+  switch (key_type_of(cmp, elem_size)) {
+    case KEY_U32:
+      return lower_bound_u32(set, LENGTH, *(const vec_u32 *)key);
+    case KEY_U64:
+      return lower_bound_u64(set, LENGTH, *(const vec_u64 *)key);
+    case KEY_I32:
+      return lower_bound_i32(set, LENGTH, *(const vec_i32 *)key);
+    case KEY_I64:
+      return lower_bound_i64(set, LENGTH, *(const vec_i64 *)key);
+    default:
+      return lower_bound_generic(set, LENGTH, key, elem_size, cmp);
+  }
+}
+
+void *flat_set_untyped_union(void **const dst, const void *const a,
+                             const void *const b, const size_t elem_size,
+                             const vec_comparator cmp) {
+  return apply_set_op(OP_UNION, dst, a, b, elem_size, cmp);
+}
+
+size_t flat_untyped_insert_batch(void **const keys, void **const values,
+                                 const void *const batch_keys,
+                                 const void *const batch_values,
+                                 const size_t count, const size_t key_size,
+                                 const size_t value_size,
+                                 const vec_comparator cmp) {
+  const size_t LENGTH = vector_length(*keys);
+  /* Records are padded so that every key is as aligned as its size allows. */
+  const size_t ALIGNMENT = key_size & (~key_size + 1);
+  const size_t RECORD_SIZE = key_size + (values != NULL ? value_size : 0);
+  const size_t STRIDE =
+      (RECORD_SIZE + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+  byte *records;
+  size_t unique;
+  size_t i;
+  size_t j;
+  size_t end;
+  size_t duplicates = 0;
+  if (count == 0) return 0;
+  if (count > (size_t)-1 / STRIDE || count > (size_t)-1 - LENGTH)
+    return VEC_BAD_INDEX;
+  records = malloc(count * STRIDE);
+  if (records == NULL) return VEC_BAD_INDEX;
+  for (i = 0; i < count; i++) {
+    memcpy(key_at(records, i, STRIDE), key_at_const(batch_keys, i, key_size),
+           key_size);
+    if (values != NULL)
+      memcpy(key_at(records, i, STRIDE) + key_size,
+             key_at_const(batch_values, i, value_size), value_size);
+  }
+  /* Stability keeps the first of several equal keys in the batch. */
+  if (!vector_sort_stable(records, count, STRIDE, cmp) ||
+      vector_untyped_reserve(keys, LENGTH + count, key_size) == NULL ||
+      vector_untyped_unshare(keys, key_size) == NULL ||
+      (values != NULL &&
+       (vector_untyped_reserve(values, LENGTH + count, value_size) == NULL ||
+        vector_untyped_unshare(values, value_size) == NULL))) {
+    free(records);
+    return VEC_BAD_INDEX;
+  }
+  unique = dedup_sorted(records, count, STRIDE, cmp);
+  /*
+   * Merges from the back, so that no key is overwritten before it is moved.
+   * A key already present keeps its place and value, leaving a gap which is
+   * closed once the merge is done.
+   */
+  i = LENGTH;
+  j = unique;
+  for (end = LENGTH + unique; j > 0; end--) {
+    const byte *const incoming = key_at_const(records, j - 1, STRIDE);
+    const int ORDER =
+        i > 0 ? cmp(key_at_const(*keys, i - 1, key_size), incoming) : -1;
+    if (ORDER >= 0) {
+      i--;
+      memmove(key_at(*keys, end - 1, key_size), key_at(*keys, i, key_size),
+              key_size);
+      if (values != NULL)
+        memmove(key_at(*values, end - 1, value_size),
+                key_at(*values, i, value_size), value_size);
+      if (ORDER == 0) {
+        j--;
+        duplicates++;
+      }
+    } else {
+      j--;
+      memcpy(key_at(*keys, end - 1, key_size), incoming, key_size);
+      if (values != NULL)
+        memcpy(key_at(*values, end - 1, value_size), incoming + key_size,
+               value_size);
+    }
+  }
+  if (duplicates != 0) {
+    memmove(key_at(*keys, i, key_size), key_at(*keys, end, key_size),
+            (LENGTH + unique - end) * key_size);
+    if (values != NULL)
+      memmove(key_at(*values, i, value_size), key_at(*values, end, value_size),
+              (LENGTH + unique - end) * value_size);
+  }
+  vector_header(*keys)->length = LENGTH + unique - duplicates;
+  if (values != NULL)
+    vector_header(*values)->length = LENGTH + unique - duplicates;
+  free(records);
+  return unique - duplicates;
+}
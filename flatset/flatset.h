@@ -0,0 +1,146 @@
+#ifndef FLAT_SET_H
+#define FLAT_SET_H
+
+#include <stddef.h>
+
+#include "../include/myclib.h"
+#include "../vector/vector.h"
+
+/* - DEFINITIONS - */
+
+/*
+ * A flat set is a `vector` whose elements are kept sorted and distinct under a
+ * comparator, so that lookups are binary searches over contiguous memory and
+ * the set costs no more than its elements. Every vector macro which does not
+ * modify the elements works on a flat set, and `vec[i]` is its `i`th smallest
+ * key.
+ *
+ * The comparator is passed to every operation, as it is to `vector_sort()`,
+ * and must be the same each time. Passing one of the `flat_set_compare_*`
+ * comparators below for keys of that type selects kernels which compare keys
+ * directly rather than through the comparator: branchless binary searches,
+ * and set operations which match blocks of keys with SIMD instructions where
+ * the CPU has them.
+ *
+ * Single insertions and removals shift the keys after them, so sets built up
+ * all at once should be built with `flat_set_build()` or
+ * `flat_set_insert_n()`, which sort the new keys once and merge them in
+ * linear time.
+ */
+#define flat_set(type) vector(type)
+
+/* - INTERNAL USE ONLY - */
+
+/*
+ * Sorts the `count` keys at `batch_keys` and discards all but the first of
+ * each run of equal ones, then merges the keys not already in `*keys` into it.
+ * If `values` is not `NULL`, the values at `batch_values` follow their keys
+ * into `*values`, which must be as long as `*keys`. Returns the number of keys
+ * inserted, or `VEC_BAD_INDEX` if memory could not be allocated, in which case
+ * neither vector is changed.
+ */
+size_t flat_untyped_insert_batch(void **keys, void **values,
+                                 const void *batch_keys,
+                                 const void *batch_values, size_t count,
+                                 size_t key_size, size_t value_size,
+                                 vec_comparator cmp);
+
+/* - CONVENIENCE MACROS - */
+
+#define flat_set_build(set, cmp) \
+  flat_set_untyped_build((void **)&(set), sizeof *(set), cmp)
+
+#define flat_set_contains(set, key, cmp) \
+  (flat_set_find(set, key, cmp) != VEC_BAD_INDEX)
+
+/* The set operations write their result to `dst`, which is overwritten. */
+#define flat_set_difference(dst, a, b, cmp) \
+  flat_set_untyped_difference((void **)&(dst), a, b, sizeof *(dst), cmp)
+
+/* `key` must be an lvalue. */
+#define flat_set_erase(set, key, cmp) \
+  flat_set_untyped_erase((void **)&(set), &(key), sizeof *(set), cmp)
+
+/* `key` must be an lvalue. */
+#define flat_set_find(set, key, cmp) \
+  flat_set_untyped_find(set, &(key), sizeof *(set), cmp)
+
+/* `key` must be an lvalue. */
+#define flat_set_insert(set, key, cmp) \
+  flat_set_untyped_insert((void **)&(set), &(key), sizeof *(set), cmp)
+
+#define flat_set_insert_n(set, src, count, cmp)                       \
+  flat_untyped_insert_batch((void **)&(set), NULL, src, NULL, count, \
+                            sizeof *(set), 0, cmp)
+
+#define flat_set_intersection(dst, a, b, cmp) \
+  flat_set_untyped_intersection((void **)&(dst), a, b, sizeof *(dst), cmp)
+
+/* `key` must be an lvalue. */
+#define flat_set_lower_bound(set, key, cmp) \
+  flat_set_untyped_lower_bound(set, &(key), sizeof *(set), cmp)
+
+#define flat_set_new(type, capacity) vector_new(type, capacity)
+
+#define flat_set_new_with(allocator, type, capacity) \
+  vector_new_with(allocator, type, capacity)
+
+#define flat_set_union(dst, a, b, cmp) \
+  flat_set_untyped_union((void **)&(dst), a, b, sizeof *(dst), cmp)
+
+/* - FUNCTIONS - */
+
+/*
+ * Comparators for integer keys, which `qsort()` and `vector_sort()` also
+ * accept.
+ */
+int flat_set_compare_u32(const void *a, const void *b);
+int flat_set_compare_u64(const void *a, const void *b);
+int flat_set_compare_i32(const void *a, const void *b);
+int flat_set_compare_i64(const void *a, const void *b);
+
+/*
+ * Turns the vector `*set` into a flat set by sorting it once and discarding
+ * all but the first of each run of equal keys. Returns `false` if the sort
+ * could not allocate its buffer, in which case the vector is unchanged.
+ */
+bool flat_set_untyped_build(void **set, size_t elem_size, vec_comparator cmp);
+
+/*
+ * The set operations write the keys in `a` or `b`, in both, or in `a` but not
+ * `b` to `*dst`, which must be a vector distinct from both, returning `*dst`,
+ * or `NULL` if it could not be grown, in which case it is left empty.
+ */
+void *flat_set_untyped_difference(void **dst, const void *a, const void *b,
+                                  size_t elem_size, vec_comparator cmp);
+
+/* Returns `false` if `key` was not in the set. */
+bool flat_set_untyped_erase(void **set, const void *key, size_t elem_size,
+                            vec_comparator cmp);
+
+/* Returns the index of `key`, or `VEC_BAD_INDEX` if it is not in the set. */
+size_t flat_set_untyped_find(const void *set, const void *key,
+                             size_t elem_size, vec_comparator cmp);
+
+/*
+ * Inserts `key` unless the set holds it already, returning its index either
+ * way, or `VEC_BAD_INDEX` if the set could not be grown.
+ */
+size_t flat_set_untyped_insert(void **set, const void *key, size_t elem_size,
+                               vec_comparator cmp);
+
+void *flat_set_untyped_intersection(void **dst, const void *a, const void *b,
+                                    size_t elem_size, vec_comparator cmp);
+
+/*
+ * Returns the index of the first key not less than `key`, or the length of the
+ * set if there is none. The search halves the range without branching on the
+ * comparisons, so its time does not depend on how predictable they are.
+ */
+size_t flat_set_untyped_lower_bound(const void *set, const void *key,
+                                    size_t elem_size, vec_comparator cmp);
+
+void *flat_set_untyped_union(void **dst, const void *a, const void *b,
+                             size_t elem_size, vec_comparator cmp);
+
+#endif
@@ -0,0 +1,591 @@
+#include "concurrenthashmap.h"
+
+#include <limits.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "../include/myclib.h"
+#include "hashmap.h"
+
+#if !defined(__GNUC__) && !defined(__clang__)
+#error "Concurrent hash maps require the GCC or Clang atomic builtins."
+#endif
+
+/* - DEFINITIONS - */
+
+/*
+ * Everything readers see is accessed a word at a time with atomic loads and
+ * stores, so that a read racing a write is merely retried rather than a data
+ * race.
+ */
+typedef size_t word;
+
+#define WORD_SIZE sizeof(word)
+
+/* There is a control byte per slot, so a group's control bytes fill a word. */
+#define GROUP_WIDTH WORD_SIZE
+
+/* The words at the start of a group, which are followed by its slots. */
+#define GROUP_VERSION 0
+#define GROUP_CTRL 1
+#define GROUP_OVERFLOW 2
+#define GROUP_SLOTS 3
+
+/* A word with each byte set to `1`, and one with each byte's top bit set. */
+#define LANE_ONES ((word)-1 / UCHAR_MAX)
+#define LANE_HIGHS (LANE_ONES * 0x80)
+
+/* The number of groups a write moves out of a table being replaced. */
+#define MIGRATE_GROUPS ((size_t)4)
+
+#define MIN_GROUPS ((size_t)2)
+
+#define CACHE_LINE ((size_t)64)
+
+/*
+ *    `groups`     - The number of groups, a power of two.
+ *   `migrated`    - The number of groups moved out of the table since it was
+ *                   replaced.
+ *    `length`     - The number of keys held.
+ * `next_retired`  - The table retired before this one, once it is retired.
+ *
+ * The groups follow the header.
+ */
+typedef struct table {
+  size_t groups;
+  size_t migrated;
+  size_t length;
+  struct table *next_retired;
+} table;
+
+/*
+ *   `lock`    - Taken by writers to the shard.
+ *  `current`  - The table new keys are inserted into.
+ * `previous`  - The table being moved into `current`, or `NULL`.
+ *  `resizes`  - Odd while the tables are being swapped, and incremented twice
+ *               each time, so that readers can tell they raced a swap.
+ *  `length`   - The number of keys held in both tables.
+ *  `retired`  - The tables replaced so far, which readers may still search.
+ */
+typedef struct shard {
+  pthread_mutex_t lock;
+  table *current;
+  table *previous;
+  size_t resizes;
+  size_t length;
+  table *retired;
+} shard;
+
+/* Keeps each shard's lock and pointers off its neighbours' cache lines. */
+typedef union padded_shard {
+  shard shard;
+  byte padding[((sizeof(shard) + CACHE_LINE - 1) / CACHE_LINE) * CACHE_LINE];
+} padded_shard;
+
+/*
+ *  `key_words`  - The number of words holding a key.
+ * `slot_words`  - The number of words holding a key and its value.
+ * `group_words` - The number of words in a group, slots included.
+ *
+ * The shards follow the map.
+ */
+struct concurrent_hashmap {
+  const myclib_allocator *allocator;
+  hashmap_hash hash;
+  size_t key_size;
+  size_t value_size;
+  size_t key_words;
+  size_t slot_words;
+  size_t group_words;
+  size_t shard_count;
+};
+
+/* - INTERNAL - */
+
+#define words_for(size) (((size) + WORD_SIZE - 1) / WORD_SIZE)
+
+#define shards_of(map) ((padded_shard *)((map) + 1))
+
+#define shards_of_const(map) ((const padded_shard *)((map) + 1))
+
+#define group_at(map, tbl, index) \
+  ((word *)((tbl) + 1) + ((index) * (map)->group_words))
+
+#define group_at_const(map, tbl, index) \
+  ((const word *)((tbl) + 1) + ((index) * (map)->group_words))
+
+#define slot_at(map, group, lane) \
+  ((group) + GROUP_SLOTS + ((lane) * (map)->slot_words))
+
+#define capacity_of(tbl) ((tbl)->groups * GROUP_WIDTH)
+
+/* The seven bits of `hash` kept in control bytes, from its top end. */
+#define hash_tag(hash) \
+  ((word)(((hash) >> ((sizeof(size_t) * CHAR_BIT) - 7)) & 0x7F))
+
+#define load_word(ptr) __atomic_load_n(ptr, __ATOMIC_RELAXED)
+
+#define store_word(ptr, value) __atomic_store_n(ptr, value, __ATOMIC_RELAXED)
+
+static inline size_t lowest_lane(const word mask) {
+  if (sizeof(word) <= sizeof(unsigned long))
+    return (size_t)__builtin_ctzl((unsigned long)mask) / CHAR_BIT;
+  {
+    size_t lane = 0;
+    while (((mask >> (lane * CHAR_BIT)) & 0x80) == 0) lane++;
+    return lane;
+  }
+}
+
+/*
+ * The full lanes of `ctrl` holding `tag`. Lanes above a match may be reported
+ * spuriously, which the comparison of keys catches.
+ */
+static inline word match_tag(const word ctrl, const word tag) {
+  const word DIFFERENCE = ctrl ^ (LANE_ONES * tag);
+  return (DIFFERENCE - LANE_ONES) & ~DIFFERENCE & ~ctrl & LANE_HIGHS;
+}
+
+static inline word with_lane(const word ctrl, const size_t lane,
+                             const word value) {
+  const size_t SHIFT = lane * CHAR_BIT;
+  return (ctrl & ~((word)UCHAR_MAX << SHIFT)) | (value << SHIFT);
+}
+
+/* Brackets the writes to a group, so that readers can tell they raced one. */
+static inline void begin_write(word *const group) {
+  store_word(&group[GROUP_VERSION], group[GROUP_VERSION] + 1);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static inline void end_write(word *const group) {
+  __atomic_store_n(&group[GROUP_VERSION], group[GROUP_VERSION] + 1,
+                   __ATOMIC_RELEASE);
+}
+
+/* Stores `size` bytes into the words at `dst`, zeroing the last one's rest. */
+static void store_bytes(word *dst, const void *const src, size_t size) {
+  const byte *bytes = src;
+  word value;
+  for (; size >= WORD_SIZE; size -= WORD_SIZE, bytes += WORD_SIZE, dst++) {
+    memcpy(&value, bytes, WORD_SIZE);
+    store_word(dst, value);
+  }
+  if (size != 0) {
+    value = 0;
+    memcpy(&value, bytes, size);
+    store_word(dst, value);
+  }
+}
+
+static void load_bytes(void *const dst, const word *src, size_t size) {
+  byte *bytes = dst;
+  word value;
+  for (; size >= WORD_SIZE; size -= WORD_SIZE, bytes += WORD_SIZE, src++) {
+    value = load_word(src);
+    memcpy(bytes, &value, WORD_SIZE);
+  }
+  if (size != 0) {
+    value = load_word(src);
+    memcpy(bytes, &value, size);
+  }
+}
+
+static bool equals_bytes(const word *stored, const void *const key,
+                         size_t size) {
+  const byte *bytes = key;
+  word value;
+  for (; size >= WORD_SIZE; size -= WORD_SIZE, bytes += WORD_SIZE, stored++) {
+    memcpy(&value, bytes, WORD_SIZE);
+    if (load_word(stored) != value) return false;
+  }
+  if (size != 0) {
+    value = 0;
+    memcpy(&value, bytes, size);
+    if (load_word(stored) != value) return false;
+  }
+  return true;
+}
+
+/* The size of a table of `groups` groups, or `0` if it is unrepresentable. */
+static size_t table_size(const concurrent_hashmap *const map,
+                         const size_t groups) {
+  const size_t GROUP_BYTES = map->group_words * WORD_SIZE;
+  if (groups > ((size_t)-1 - sizeof(table)) / GROUP_BYTES) return 0;
+  return sizeof(table) + (groups * GROUP_BYTES);
+}
+
+static table *table_new(const concurrent_hashmap *const map,
+                        const size_t groups) {
+  const size_t SIZE = table_size(map, groups);
+  table *const tbl = SIZE != 0 ? myclib_alloc(map->allocator, SIZE) : NULL;
+  size_t index;
+  if (tbl == NULL) return NULL;
+  tbl->groups = groups;
+  tbl->migrated = 0;
+  tbl->length = 0;
+  tbl->next_retired = NULL;
+  for (index = 0; index < groups; index++) {
+    word *const group = group_at(map, tbl, index);
+    group[GROUP_VERSION] = 0;
+    group[GROUP_CTRL] = LANE_HIGHS;
+    group[GROUP_OVERFLOW] = 0;
+  }
+  return tbl;
+}
+
+static void table_free(const concurrent_hashmap *const map, table *const tbl) {
+  myclib_free(map->allocator, tbl, table_size(map, tbl->groups));
+}
+
+/*
+ * Searches `tbl` for `key` as a reader, copying its value to `value` unless it
+ * is `NULL`. Each group is read between two loads of its version, and read
+ * again if a writer changed it in between.
+ */
+static bool table_get(const concurrent_hashmap *const map,
+                      const table *const tbl, const size_t hash,
+                      const void *const key, void *const value) {
+  const size_t GROUPS = tbl->groups;
+  const word TAG = hash_tag(hash);
+  size_t index = hash & (GROUPS - 1);
+  size_t step;
+  for (step = 1; step <= GROUPS; step++) {
+    const word *const group = group_at_const(map, tbl, index);
+    word overflow;
+    bool found;
+    for (;;) {
+      const word VERSION =
+          __atomic_load_n(&group[GROUP_VERSION], __ATOMIC_ACQUIRE);
+      word matches;
+      /* A writer is partway through the group. */
+      if ((VERSION & 1) != 0) continue;
+      matches = match_tag(load_word(&group[GROUP_CTRL]), TAG);
+      overflow = load_word(&group[GROUP_OVERFLOW]);
+      found = false;
+      for (; matches != 0 && !found; matches &= matches - 1) {
+        const word *const SLOT = slot_at(map, group, lowest_lane(matches));
+        found = equals_bytes(SLOT, key, map->key_size);
+        if (found && value != NULL)
+          load_bytes(value, SLOT + map->key_words, map->value_size);
+      }
+      __atomic_thread_fence(__ATOMIC_ACQUIRE);
+      if (load_word(&group[GROUP_VERSION]) == VERSION) break;
+    }
+    if (found) return true;
+    /* No key probed past this group, so the key would have been within it. */
+    if (overflow == 0) break;
+    index = (index + step) & (GROUPS - 1);
+  }
+  return false;
+}
+
+/*
+ * Searches `tbl` for `key` as its shard's writer, returning its slot and
+ * setting `*group_index`, or returning `NULL` if it is not there.
+ */
+static word *table_find(const concurrent_hashmap *const map, table *const tbl,
+                        const size_t hash, const void *const key,
+                        size_t *const group_index) {
+  const size_t GROUPS = tbl->groups;
+  const word TAG = hash_tag(hash);
+  size_t index = hash & (GROUPS - 1);
+  size_t step;
+  for (step = 1; step <= GROUPS; step++) {
+    word *const group = group_at(map, tbl, index);
+    word matches = match_tag(group[GROUP_CTRL], TAG);
+    for (; matches != 0; matches &= matches - 1) {
+      word *const slot = slot_at(map, group, lowest_lane(matches));
+      if (equals_bytes(slot, key, map->key_size)) {
+        *group_index = index;
+        return slot;
+      }
+    }
+    if (group[GROUP_OVERFLOW] == 0) break;
+    index = (index + step) & (GROUPS - 1);
+  }
+  return NULL;
+}
+
+/*
+ * Inserts `key`, which must not be in `tbl`, with the value at `value`, or a
+ * zeroed one if it is `NULL`. Every full group passed on the way counts the
+ * overflow before the key is published. `tbl` must have an empty slot.
+ */
+static void table_insert(const concurrent_hashmap *const map, table *const tbl,
+                         const size_t hash, const void *const key,
+                         const void *const value) {
+  const size_t GROUPS = tbl->groups;
+  size_t index = hash & (GROUPS - 1);
+  size_t step;
+  for (step = 1;; step++) {
+    word *const group = group_at(map, tbl, index);
+    const word EMPTY = group[GROUP_CTRL] & LANE_HIGHS;
+    if (EMPTY != 0) {
+      const size_t LANE = lowest_lane(EMPTY);
+      word *const slot = slot_at(map, group, LANE);
+      begin_write(group);
+      store_bytes(slot, key, map->key_size);
+      if (value != NULL) {
+        store_bytes(slot + map->key_words, value, map->value_size);
+      } else {
+        size_t i;
+        for (i = map->key_words; i < map->slot_words; i++)
+          store_word(&slot[i], 0);
+      }
+      store_word(&group[GROUP_CTRL],
+                 with_lane(group[GROUP_CTRL], LANE, hash_tag(hash)));
+      end_write(group);
+      tbl->length++;
+      return;
+    }
+    begin_write(group);
+    store_word(&group[GROUP_OVERFLOW], group[GROUP_OVERFLOW] + 1);
+    end_write(group);
+    index = (index + step) & (GROUPS - 1);
+  }
+}
+
+static bool table_erase(const concurrent_hashmap *const map, table *const tbl,
+                        const size_t hash, const void *const key) {
+  const size_t GROUPS = tbl->groups;
+  size_t target;
+  word *const slot = table_find(map, tbl, hash, key, &target);
+  word *group;
+  size_t index = hash & (GROUPS - 1);
+  size_t step;
+  if (slot == NULL) return false;
+  group = group_at(map, tbl, target);
+  begin_write(group);
+  store_word(&group[GROUP_CTRL],
+             with_lane(group[GROUP_CTRL],
+                       (size_t)(slot - (group + GROUP_SLOTS)) /
+                           map->slot_words,
+                       0x80));
+  end_write(group);
+  /* Every group the key probed past counted it when it was inserted. */
+  for (step = 1; index != target; step++) {
+    group = group_at(map, tbl, index);
+    begin_write(group);
+    store_word(&group[GROUP_OVERFLOW], group[GROUP_OVERFLOW] - 1);
+    end_write(group);
+    index = (index + step) & (GROUPS - 1);
+  }
+  tbl->length--;
+  return true;
+}
+
+/*
+ * Moves up to `budget` groups of keys out of the shard's previous table, then
+ * retires it once it is empty. Keys are inserted into the current table before
+ * they are removed from the previous one, which readers search first, so a
+ * reader always finds a key in one or the other.
+ */
+static void migrate(const concurrent_hashmap *const map, shard *const shd,
+                    size_t budget) {
+  table *const previous = shd->previous;
+  if (previous == NULL) return;
+  for (; budget > 0 && previous->migrated < previous->groups; budget--) {
+    word *const group = group_at(map, previous, previous->migrated++);
+    word full = ~group[GROUP_CTRL] & LANE_HIGHS;
+    if (full == 0) continue;
+    for (; full != 0; full &= full - 1) {
+      const word *const SLOT = slot_at(map, group, lowest_lane(full));
+      table_insert(map, shd->current, map->hash(SLOT, map->key_size), SLOT,
+                   SLOT + map->key_words);
+      previous->length--;
+    }
+    /* Overflow counts are kept, as readers may still probe past the group. */
+    begin_write(group);
+    store_word(&group[GROUP_CTRL], LANE_HIGHS);
+    end_write(group);
+  }
+  if (previous->migrated == previous->groups) {
+    __atomic_store_n(&shd->previous, NULL, __ATOMIC_RELEASE);
+    previous->next_retired = shd->retired;
+    shd->retired = previous;
+  }
+}
+
+/* Starts moving the shard's keys into a table twice the size. */
+static bool grow(const concurrent_hashmap *const map, shard *const shd) {
+  table *replacement;
+  /* Tables are replaced one at a time, which is rare enough to wait for. */
+  migrate(map, shd, (size_t)-1);
+  replacement = table_new(map, shd->current->groups * 2);
+  if (replacement == NULL) return false;
+  store_word(&shd->resizes, shd->resizes + 1);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  __atomic_store_n(&shd->previous, shd->current, __ATOMIC_RELEASE);
+  __atomic_store_n(&shd->current, replacement, __ATOMIC_RELEASE);
+  __atomic_store_n(&shd->resizes, shd->resizes + 1, __ATOMIC_RELEASE);
+  return true;
+}
+
+/* The shard of a key is picked by bits of its hash which tables don't use. */
+#define shard_index(map, hash) \
+  (((hash) >> (sizeof(size_t) * CHAR_BIT / 2)) & ((map)->shard_count - 1))
+
+static void free_retired(const concurrent_hashmap *const map,
+                         shard *const shd) {
+  while (shd->retired != NULL) {
+    table *const next = shd->retired->next_retired;
+    table_free(map, shd->retired);
+    shd->retired = next;
+  }
+}
+
+/* - FUNCTIONS - */
+
+void concurrent_hashmap_delete(concurrent_hashmap *const map) {
+  size_t i;
+  for (i = 0; i < map->shard_count; i++) {
+    shard *const shd = &shards_of(map)[i].shard;
+    free_retired(map, shd);
+    if (shd->previous != NULL) table_free(map, shd->previous);
+    table_free(map, shd->current);
+    pthread_mutex_destroy(&shd->lock);
+  }
+  myclib_free(map->allocator, map,
+              sizeof *map + (map->shard_count * sizeof(padded_shard)));
+}
+
+bool concurrent_hashmap_erase(concurrent_hashmap *const map,
+                              const void *const key) {
+  const size_t HASH = map->hash(key, map->key_size);
+  shard *const shd = &shards_of(map)[shard_index(map, HASH)].shard;
+  bool erased;
+  pthread_mutex_lock(&shd->lock);
+  erased = (shd->previous != NULL &&
+            table_erase(map, shd->previous, HASH, key)) ||
+           table_erase(map, shd->current, HASH, key);
+  if (erased) store_word(&shd->length, shd->length - 1);
+  migrate(map, shd, MIGRATE_GROUPS);
+  pthread_mutex_unlock(&shd->lock);
+  return erased;
+}
+
+bool concurrent_hashmap_get(const concurrent_hashmap *const map,
+                            const void *const key, void *const value) {
+  const size_t HASH = map->hash(key, map->key_size);
+  const shard *const SHARD =
+      &shards_of_const(map)[shard_index(map, HASH)].shard;
+  for (;;) {
+    const size_t RESIZES = __atomic_load_n(&SHARD->resizes, __ATOMIC_ACQUIRE);
+    const table *previous;
+    const table *current;
+    if ((RESIZES & 1) != 0) continue;
+    previous = __atomic_load_n(&SHARD->previous, __ATOMIC_ACQUIRE);
+    current = __atomic_load_n(&SHARD->current, __ATOMIC_ACQUIRE);
+    if (previous != NULL && table_get(map, previous, HASH, key, value))
+      return true;
+    if (table_get(map, current, HASH, key, value)) return true;
+    /* A miss only counts if the tables searched were the shard's all along. */
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (load_word(&SHARD->resizes) == RESIZES) return false;
+  }
+}
+
+size_t concurrent_hashmap_length(const concurrent_hashmap *const map) {
+  size_t length = 0;
+  size_t i;
+  for (i = 0; i < map->shard_count; i++)
+    length += load_word(&shards_of_const(map)[i].shard.length);
+  return length;
+}
+
+concurrent_hashmap *concurrent_hashmap_new(const size_t key_size,
+                                           const size_t value_size,
+                                           const size_t shard_count) {
+  return concurrent_hashmap_new_with(NULL, key_size, value_size, shard_count,
+                                     NULL);
+}
+
+concurrent_hashmap *concurrent_hashmap_new_with(
+    const myclib_allocator *const allocator, const size_t key_size,
+    const size_t value_size, const size_t shard_count,
+    const hashmap_hash hash) {
+  concurrent_hashmap *map;
+  size_t shards = 1;
+  size_t i;
+  util_assert(key_size != 0);
+  while (shards < (shard_count != 0 ? shard_count
+                                    : CONCURRENT_HASHMAP_DEFAULT_SHARDS))
+    shards *= 2;
+  map = myclib_alloc(allocator, sizeof *map + (shards * sizeof(padded_shard)));
+  if (map == NULL) return NULL;
+  map->allocator = allocator;
+  map->hash = hash != NULL ? hash : hashmap_hash_bytes;
+  map->key_size = key_size;
+  map->value_size = value_size;
+  map->key_words = words_for(key_size);
+  map->slot_words = map->key_words + words_for(value_size);
+  map->group_words = GROUP_SLOTS + (GROUP_WIDTH * map->slot_words);
+  map->shard_count = shards;
+  for (i = 0; i < shards; i++) {
+    shard *const shd = &shards_of(map)[i].shard;
+    shd->current = table_new(map, MIN_GROUPS);
+    if (shd->current == NULL) {
+      /* The shards set up so far have yet to retire or migrate a table. */
+      while (i-- != 0) {
+        shard *const created = &shards_of(map)[i].shard;
+        table_free(map, created->current);
+        pthread_mutex_destroy(&created->lock);
+      }
+      myclib_free(allocator, map,
+                  sizeof *map + (shards * sizeof(padded_shard)));
+      return NULL;
+    }
+    shd->previous = NULL;
+    shd->resizes = 0;
+    shd->length = 0;
+    shd->retired = NULL;
+    pthread_mutex_init(&shd->lock, NULL);
+  }
+  return map;
+}
+
+bool concurrent_hashmap_put(concurrent_hashmap *const map,
+                            const void *const key, const void *const value) {
+  const size_t HASH = map->hash(key, map->key_size);
+  shard *const shd = &shards_of(map)[shard_index(map, HASH)].shard;
+  size_t group_index;
+  word *slot = NULL;
+  table *holder;
+  bool done = true;
+  pthread_mutex_lock(&shd->lock);
+  holder = shd->previous;
+  if (holder != NULL) slot = table_find(map, holder, HASH, key, &group_index);
+  if (slot == NULL) {
+    holder = shd->current;
+    slot = table_find(map, holder, HASH, key, &group_index);
+  }
+  if (slot != NULL) {
+    word *const group = group_at(map, holder, group_index);
+    if (value != NULL) {
+      begin_write(group);
+      store_bytes(slot + map->key_words, value, map->value_size);
+      end_write(group);
+    }
+  } else if (shd->length == HASHMAP_MAX_LOAD(capacity_of(shd->current)) &&
+             !grow(map, shd)) {
+    done = false;
+  } else {
+    table_insert(map, shd->current, HASH, key, value);
+    store_word(&shd->length, shd->length + 1);
+  }
+  if (done) migrate(map, shd, MIGRATE_GROUPS);
+  pthread_mutex_unlock(&shd->lock);
+  return done;
+}
+
+void concurrent_hashmap_reclaim(concurrent_hashmap *const map) {
+  size_t i;
+  for (i = 0; i < map->shard_count; i++) {
+    shard *const shd = &shards_of(map)[i].shard;
+    pthread_mutex_lock(&shd->lock);
+    free_retired(map, shd);
+    pthread_mutex_unlock(&shd->lock);
+  }
+}
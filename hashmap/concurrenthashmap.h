@@ -0,0 +1,87 @@
+#ifndef CONCURRENT_HASHMAP_H
+#define CONCURRENT_HASHMAP_H
+
+#include <stddef.h>
+
+#include "../include/myclib.h"
+#include "hashmap.h"
+
+/* - DEFINITIONS - */
+
+/*
+ * A concurrent hash map may be read and written by any number of threads at
+ * once. Keys are spread over shards by their hash, and each shard has its own
+ * lock, taken only by writers, so writers to different shards never wait on
+ * one another.
+ *
+ * Readers take no locks and write no shared memory, so any number of them
+ * scale without contending. Each group of slots carries a version which a
+ * writer makes odd while changing the group, and a reader retries a group only
+ * if its version changed while it was being read.
+ *
+ * A shard which fills up allocates a table twice the size and moves its keys
+ * over a few groups per write, with readers searching both tables until it is
+ * done, so no operation ever waits on a full rehash. Replaced tables are kept
+ * until `concurrent_hashmap_reclaim()` or `concurrent_hashmap_delete()`, as
+ * readers may still be searching them; since tables double, they never total
+ * more than the live ones.
+ *
+ * As with `hashmap`, keys are compared bytewise. The allocator must be safe to
+ * call from several threads at once.
+ */
+typedef struct concurrent_hashmap concurrent_hashmap;
+
+/* The number of shards used when `0` is requested. */
+#define CONCURRENT_HASHMAP_DEFAULT_SHARDS ((size_t)64)
+
+/* - FUNCTIONS - */
+
+/* Must not be called while any other thread is using `map`. */
+void concurrent_hashmap_delete(concurrent_hashmap *map);
+
+/* Returns `false` if `key` was not in the map. */
+bool concurrent_hashmap_erase(concurrent_hashmap *map, const void *key);
+
+/*
+ * Copies the value of `key` to `value`, unless it is `NULL`. Returns `false`
+ * if `key` is not in the map, in which case `value` may still have been
+ * written to if the key was erased during the call.
+ */
+bool concurrent_hashmap_get(const concurrent_hashmap *map, const void *key,
+                            void *value);
+
+/*
+ * Returns the number of keys in the map, which is only exact while no thread
+ * is writing to it.
+ */
+size_t concurrent_hashmap_length(const concurrent_hashmap *map);
+
+concurrent_hashmap *concurrent_hashmap_new(size_t key_size, size_t value_size,
+                                           size_t shard_count);
+
+/*
+ * Returns a map of `key_size` byte keys and `value_size` byte values, spread
+ * over `shard_count` shards rounded up to a power of two, and hashed with
+ * `hash`, or `hashmap_hash_bytes()` if it is `NULL`. Returns `NULL` if the map
+ * could not be allocated.
+ */
+concurrent_hashmap *concurrent_hashmap_new_with(
+    const myclib_allocator *allocator, size_t key_size, size_t value_size,
+    size_t shard_count, hashmap_hash hash);
+
+/*
+ * Sets the value of `key` to the one at `value`, inserting `key` if needed. If
+ * `value` is `NULL`, an existing value is kept and a new one zeroed. Returns
+ * `false` if the key's shard could not be grown, in which case the map is
+ * unchanged.
+ */
+bool concurrent_hashmap_put(concurrent_hashmap *map, const void *key,
+                            const void *value);
+
+/*
+ * Frees the tables replaced by resizing. Must not be called while any other
+ * thread is reading from `map`.
+ */
+void concurrent_hashmap_reclaim(concurrent_hashmap *map);
+
+#endif
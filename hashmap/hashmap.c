@@ -0,0 +1,326 @@
+#include "hashmap.h"
+
+#include <limits.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "../cpu/cpu.h"
+#include "../include/myclib.h"
+#include "../vector/vector.h"
+
+/* - DEFINITIONS - */
+
+/* An overflow count which has saturated, and is never decremented again. */
+#define OVERFLOW_SATURATED ((byte)UCHAR_MAX)
+
+/* The fewest slots a map has, which is one group. */
+#define MIN_CAPACITY HASHMAP_GROUP_WIDTH
+
+/* A mask over the slots of a group, where bit `i` stands for slot `i`. */
+typedef unsigned group_mask;
+
+#define FULL_GROUP_MASK ((group_mask)((1U << HASHMAP_GROUP_WIDTH) - 1))
+
+#define u64_constant(high, low) (((vec_u64)(high) << 32) | (vec_u64)(low))
+
+/* - INTERNAL - */
+
+#define group_count(capacity) ((capacity) / HASHMAP_GROUP_WIDTH)
+
+#define overflow_counts(map) ((map) + hashmap_capacity(map))
+
+#define slot_at(map, slot) ((byte *)hashmap_key_at(map, slot))
+
+/* The seven bits of `hash` kept in control bytes, from its top end. */
+#define hash_tag(hash) \
+  ((byte)(((hash) >> ((sizeof(size_t) * CHAR_BIT) - 7)) & 0x7F))
+
+static inline size_t lowest_bit(const group_mask mask) {
+#if defined(__GNUC__) || defined(__clang__)
+  return (size_t)__builtin_ctz(mask);
+#else
+  size_t i = 0;
+  while (((mask >> i) & 1) == 0) i++;
+  return i;
+#endif
+}
+
+/* The slots of the group at `ctrl` whose control bytes equal `tag`. */
+static inline group_mask match_tag(const byte *const ctrl, const byte tag) {
+#if (MYCLIB_HAS_SSE2)
+  const __m128i GROUP = _mm_loadu_si128((const __m128i *)ctrl);
+  return (group_mask)_mm_movemask_epi8(
+      _mm_cmpeq_epi8(GROUP, _mm_set1_epi8((char)tag)));
+#else
+  group_mask mask = 0;
+  size_t i;
+  for (i = 0; i < HASHMAP_GROUP_WIDTH; i++)
+    mask |= (group_mask)(ctrl[i] == tag) << i;
+  return mask;
+#endif
+}
+
+/* The empty slots of the group at `ctrl`, the only ones with the top bit. */
+static inline group_mask match_empty(const byte *const ctrl) {
+#if (MYCLIB_HAS_SSE2)
+  return (group_mask)_mm_movemask_epi8(
+      _mm_loadu_si128((const __m128i *)ctrl));
+#else
+  group_mask mask = 0;
+  size_t i;
+  for (i = 0; i < HASHMAP_GROUP_WIDTH; i++)
+    mask |= (group_mask)((ctrl[i] & HASHMAP_CTRL_EMPTY) != 0) << i;
+  return mask;
+#endif
+}
+
+/*
+ * Groups are probed in triangular steps from the one chosen by the low bits
+ * of a key's hash, which visits every group once as their count is a power of
+ * two.
+ */
+#define probe_next(group, step, groups) \
+  (((group) + (step)) & ((groups) - 1))
+
+static inline vec_u64 finalize(vec_u64 hash) {
+  hash ^= hash >> 33;
+  hash *= u64_constant(0xFF51AFD7UL, 0xED558CCDUL);
+  hash ^= hash >> 33;
+  hash *= u64_constant(0xC4CEB9FEUL, 0x1A85EC53UL);
+  return hash ^ (hash >> 33);
+}
+
+/* The smallest capacity holding `count` keys, or `0` if none is possible. */
+static size_t capacity_for(const size_t count, const size_t slot_size) {
+  const size_t MAX_CAPACITY =
+      ((size_t)-1 - sizeof(hashmap_header)) / (slot_size + 2) / 2;
+  size_t capacity = MIN_CAPACITY;
+  while (HASHMAP_MAX_LOAD(capacity) < count) {
+    if (capacity > MAX_CAPACITY) return 0;
+    capacity *= 2;
+  }
+  return capacity;
+}
+
+static size_t block_size(const size_t capacity, const size_t slot_size) {
+  return sizeof(hashmap_header) + hashmap_slots_offset(capacity) +
+         (capacity * slot_size);
+}
+
+/* The largest power of two dividing `n`, up to 16, or `1` if `n` is zero. */
+static size_t size_alignment(const size_t n) {
+  const size_t LOWEST = n & (~n + 1);
+  return LOWEST == 0 ? 1 : LOWEST < 16 ? LOWEST : 16;
+}
+
+static size_t round_up(const size_t n, const size_t alignment) {
+  return (n + alignment - 1) & ~(alignment - 1);
+}
+
+static hashmap allocate(const myclib_allocator *const allocator,
+                        const size_t capacity,
+                        const hashmap_header *const like) {
+  hashmap_header *const header =
+      myclib_alloc(allocator, block_size(capacity, like->slot_size));
+  hashmap map;
+  if (header == NULL) return NULL;
+  *header = *like;
+  header->capacity = capacity;
+  header->length = 0;
+  header->allocator = allocator;
+  map = (hashmap)(header + 1);
+  hashmap_clear(map);
+  return map;
+}
+
+static size_t find_slot(const hashmap map, const void *const key,
+                        const size_t hash) {
+  const hashmap_header *const HEADER = hashmap_header_const(map);
+  const size_t GROUPS = group_count(HEADER->capacity);
+  const byte TAG = hash_tag(hash);
+  size_t group = hash & (GROUPS - 1);
+  size_t step;
+  for (step = 1; step <= GROUPS; step++) {
+    const byte *const CTRL = map + (group * HASHMAP_GROUP_WIDTH);
+    group_mask matches = match_tag(CTRL, TAG);
+    for (; matches != 0; matches &= matches - 1) {
+      const size_t SLOT = (group * HASHMAP_GROUP_WIDTH) + lowest_bit(matches);
+      if (memcmp(slot_at(map, SLOT), key, HEADER->key_size) == 0) return SLOT;
+    }
+    /* No key probed past this group, so the key would have been within it. */
+    if (overflow_counts(map)[group] == 0) break;
+    group = probe_next(group, step, GROUPS);
+  }
+  return HASHMAP_BAD_INDEX;
+}
+
+/*
+ * Claims an empty slot for a key hashing to `hash` which is not in the map,
+ * counting the overflow of every full group passed on the way. The map must
+ * have an empty slot.
+ */
+static size_t claim_slot(const hashmap map, const size_t hash) {
+  const size_t GROUPS = group_count(hashmap_capacity(map));
+  byte *const overflow = overflow_counts(map);
+  size_t group = hash & (GROUPS - 1);
+  size_t step;
+  for (step = 1;; step++) {
+    byte *const ctrl = map + (group * HASHMAP_GROUP_WIDTH);
+    const group_mask EMPTY = match_empty(ctrl);
+    if (EMPTY != 0) {
+      const size_t INDEX = lowest_bit(EMPTY);
+      ctrl[INDEX] = hash_tag(hash);
+      return (group * HASHMAP_GROUP_WIDTH) + INDEX;
+    }
+    if (overflow[group] != OVERFLOW_SATURATED) overflow[group]++;
+    group = probe_next(group, step, GROUPS);
+  }
+}
+
+/* Moves every key of `*map` into a new table of `capacity` slots. */
+static hashmap rehash(hashmap *const map, const size_t capacity) {
+  const hashmap OLD = *map;
+  const hashmap_header *const HEADER = hashmap_header_const(OLD);
+  const hashmap map_new = allocate(HEADER->allocator, capacity, HEADER);
+  size_t slot;
+  if (map_new == NULL) return NULL;
+  for (slot = hashmap_next(OLD, 0); slot != HASHMAP_BAD_INDEX;
+       slot = hashmap_next(OLD, slot + 1)) {
+    const byte *const SRC = slot_at(OLD, slot);
+    const size_t NEW_SLOT =
+        claim_slot(map_new, HEADER->hash(SRC, HEADER->key_size));
+    memcpy(slot_at(map_new, NEW_SLOT), SRC, HEADER->slot_size);
+  }
+  hashmap_header(map_new)->length = HEADER->length;
+  hashmap_untyped_delete(OLD);
+  *map = map_new;
+  return map_new;
+}
+
+/* - FUNCTIONS - */
+
+void hashmap_clear(const hashmap map) {
+  const size_t CAPACITY = hashmap_capacity(map);
+  memset(map, HASHMAP_CTRL_EMPTY, CAPACITY);
+  memset(overflow_counts(map), 0, group_count(CAPACITY));
+  hashmap_header(map)->length = 0;
+}
+
+size_t hashmap_hash_bytes(const void *const key, const size_t key_size) {
+  const vec_u64 MULTIPLIER = u64_constant(0x9E3779B9UL, 0x7F4A7C15UL);
+  const byte *bytes = key;
+  size_t rest = key_size;
+  vec_u64 hash = (vec_u64)key_size * MULTIPLIER;
+  vec_u64 word;
+  for (; rest >= sizeof word; rest -= sizeof word, bytes += sizeof word) {
+    memcpy(&word, bytes, sizeof word);
+    hash = (hash ^ finalize(word)) * MULTIPLIER;
+  }
+  if (rest != 0) {
+    word = 0;
+    memcpy(&word, bytes, rest);
+    hash = (hash ^ finalize(word)) * MULTIPLIER;
+  }
+  return (size_t)finalize(hash);
+}
+
+size_t hashmap_next(const hashmap map, size_t slot) {
+  const size_t CAPACITY = hashmap_capacity(map);
+  while (slot < CAPACITY) {
+    const size_t GROUP_START = slot & ~(HASHMAP_GROUP_WIDTH - 1);
+    const group_mask FULL = ~match_empty(map + GROUP_START) & FULL_GROUP_MASK &
+                            (FULL_GROUP_MASK << (slot - GROUP_START));
+    if (FULL != 0) return GROUP_START + lowest_bit(FULL);
+    slot = GROUP_START + HASHMAP_GROUP_WIDTH;
+  }
+  return HASHMAP_BAD_INDEX;
+}
+
+void hashmap_untyped_delete(const hashmap map) {
+  const hashmap_header *const HEADER = hashmap_header_const(map);
+  myclib_free(HEADER->allocator, hashmap_header(map),
+              block_size(HEADER->capacity, HEADER->slot_size));
+}
+
+bool hashmap_untyped_erase(const hashmap map, const void *const key) {
+  hashmap_header *const header = hashmap_header(map);
+  const size_t HASH = header->hash(key, header->key_size);
+  const size_t SLOT = find_slot(map, key, HASH);
+  const size_t GROUPS = group_count(header->capacity);
+  byte *const overflow = overflow_counts(map);
+  size_t group = HASH & (GROUPS - 1);
+  size_t step;
+  if (SLOT == HASHMAP_BAD_INDEX) return false;
+  /* Every group the key probed past counted it when it was inserted. */
+  for (step = 1; group != SLOT / HASHMAP_GROUP_WIDTH; step++) {
+    if (overflow[group] != OVERFLOW_SATURATED) overflow[group]--;
+    group = probe_next(group, step, GROUPS);
+  }
+  map[SLOT] = HASHMAP_CTRL_EMPTY;
+  header->length--;
+  return true;
+}
+
+void *hashmap_untyped_get(const hashmap map, const void *const key) {
+  const hashmap_header *const HEADER = hashmap_header_const(map);
+  const size_t SLOT = find_slot(map, key, HEADER->hash(key, HEADER->key_size));
+  return SLOT != HASHMAP_BAD_INDEX ? hashmap_value_at(map, SLOT) : NULL;
+}
+
+hashmap hashmap_untyped_new_with(const myclib_allocator *const allocator,
+                                 const size_t key_size,
+                                 const size_t value_size, const size_t count,
+                                 const hashmap_hash hash) {
+  hashmap_header like;
+  const size_t VALUE_ALIGNMENT = size_alignment(value_size);
+  const size_t KEY_ALIGNMENT = size_alignment(key_size);
+  size_t capacity;
+  util_assert(key_size != 0);
+  like.key_size = key_size;
+  like.value_size = value_size;
+  like.value_offset = round_up(key_size, VALUE_ALIGNMENT);
+  like.slot_size =
+      round_up(like.value_offset + value_size,
+               KEY_ALIGNMENT > VALUE_ALIGNMENT ? KEY_ALIGNMENT
+                                               : VALUE_ALIGNMENT);
+  like.hash = hash != NULL ? hash : hashmap_hash_bytes;
+  capacity = capacity_for(count, like.slot_size);
+  return capacity != 0 ? allocate(allocator, capacity, &like) : NULL;
+}
+
+void *hashmap_untyped_put(hashmap *const map, const void *const key,
+                          const void *const value) {
+  const hashmap_header *header = hashmap_header_const(*map);
+  const size_t HASH = header->hash(key, header->key_size);
+  size_t slot = find_slot(*map, key, HASH);
+  byte *slot_data;
+  if (slot == HASHMAP_BAD_INDEX) {
+    if (header->length == HASHMAP_MAX_LOAD(header->capacity)) {
+      if (hashmap_untyped_reserve(map, header->length + 1) == NULL)
+        return NULL;
+      header = hashmap_header_const(*map);
+    }
+    slot = claim_slot(*map, HASH);
+    slot_data = slot_at(*map, slot);
+    memcpy(slot_data, key, header->key_size);
+    if (value == NULL)
+      memset(slot_data + header->value_offset, 0, header->value_size);
+    hashmap_header(*map)->length++;
+  } else {
+    slot_data = slot_at(*map, slot);
+  }
+  if (value != NULL)
+    memcpy(slot_data + header->value_offset, value, header->value_size);
+  return slot_data + header->value_offset;
+}
+
+hashmap hashmap_untyped_reserve(hashmap *const map, const size_t count) {
+  const hashmap_header *const HEADER = hashmap_header_const(*map);
+  size_t capacity;
+  if (count <= HASHMAP_MAX_LOAD(HEADER->capacity)) return *map;
+  capacity = capacity_for(count, HEADER->slot_size);
+  /* Growing by at least double keeps a run of insertions amortized O(1). */
+  if (capacity != 0 && capacity < HEADER->capacity * 2)
+    capacity = HEADER->capacity * 2;
+  return capacity != 0 ? rehash(map, capacity) : NULL;
+}
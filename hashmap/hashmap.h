@@ -0,0 +1,272 @@
+#ifndef HASHMAP_H
+#define HASHMAP_H
+
+#include <stddef.h>
+#include <string.h>
+
+#include "../include/myclib.h"
+
+/* - DEFINITIONS - */
+
+/*
+ * A hash map stores `key_size` byte keys and `value_size` byte values in one
+ * open-addressed table. Slots are arranged in groups of `HASHMAP_GROUP_WIDTH`,
+ * each described by one control byte per slot: either `HASHMAP_CTRL_EMPTY` or
+ * seven bits of the hash of the slot's key. A lookup compares the control
+ * bytes of a whole group against its key's seven bits at once, with SSE2
+ * where the CPU has it, and only compares the keys of matching slots.
+ *
+ * Each group also counts the keys which probed past it because it was full. A
+ * lookup stops at the first group whose count is zero, and erasing a key
+ * decrements the counts along its probe sequence, so slots are emptied outright
+ * and no tombstones accumulate however many keys are erased.
+ *
+ * As with `vector`, a header precedes the data, so a `hashmap` points at the
+ * control bytes of its first group. Keys are compared bytewise, so any padding
+ * within them must be zeroed. A `value_size` of zero turns the map into a set.
+ */
+typedef byte *hashmap;
+
+/*
+ * Hashes the `key_size` byte key at `key`. Every bit of the result should
+ * depend on every bit of the key, as both the lowest and the highest bits are
+ * used.
+ */
+typedef size_t (*hashmap_hash)(const void *key, size_t key_size);
+
+/* Returned by slot lookups when there is no such slot. */
+#define HASHMAP_BAD_INDEX ((size_t)-1)
+
+#define HASHMAP_GROUP_WIDTH ((size_t)16)
+
+/*
+ * The most keys a table of `capacity` slots holds before growing. Groups keep
+ * working well up to seven eighths full.
+ */
+#define HASHMAP_MAX_LOAD(capacity) ((capacity) - ((capacity) / 8))
+
+/* - INTERNAL USE ONLY - */
+
+#define HASHMAP_CTRL_EMPTY ((byte)0x80)
+
+/*
+ *   `capacity`   - The number of slots, a power of two and a multiple of
+ *                  `HASHMAP_GROUP_WIDTH`.
+ *    `length`    - The number of keys held.
+ *   `key_size`   - The size of the keys.
+ *  `value_size`  - The size of the values.
+ * `value_offset` - The offset of a slot's value from its key.
+ *  `slot_size`   - The distance between consecutive slots, which keeps both
+ *                  keys and values as aligned as their sizes allow.
+ *     `hash`     - The hash function applied to keys.
+ *  `allocator`   - The allocator owning the map's memory, or `NULL` if the
+ *                  standard library's allocation functions are used.
+ *
+ * The header's size is a multiple of 16 bytes, so that each group of control
+ * bytes is as aligned as the block holding it. After the control bytes come
+ * the overflow counts of the groups, and then the slots.
+ */
+typedef struct {
+  size_t capacity;
+  size_t length;
+  size_t key_size;
+  size_t value_size;
+  size_t value_offset;
+  size_t slot_size;
+  hashmap_hash hash;
+  const myclib_allocator *allocator;
+} hashmap_header;
+
+#define hashmap_header(map) ((hashmap_header *)(map) - 1)
+
+#define hashmap_header_const(map) ((const hashmap_header *)(map) - 1)
+
+/* The offset of the slots from the control bytes of `capacity` slots. */
+#define hashmap_slots_offset(capacity) \
+  (((capacity) + ((capacity) / HASHMAP_GROUP_WIDTH) + 15) & ~(size_t)15)
+
+/* - CONVENIENCE MACROS - */
+
+#define hashmap_allocator(map) (hashmap_header_const(map)->allocator)
+
+/* The number of slots, some of which are always empty. */
+#define hashmap_capacity(map) (+hashmap_header_const(map)->capacity)
+
+/* `key` must be an lvalue. */
+#define hashmap_contains(map, key) (hashmap_get(map, key) != NULL)
+
+#define hashmap_delete(map) ((void)(hashmap_untyped_delete(map), (map) = NULL))
+
+/* `key` must be an lvalue. */
+#define hashmap_erase(map, key) hashmap_untyped_erase(map, &(key))
+
+/*
+ * Visits every full slot, with `slot` naming a `size_t` which holds each in
+ * turn. The map must not be grown by `body`, though the key in `slot` may be
+ * erased.
+ */
+#define hashmap_for_each_slot(map, slot, body)                     \
+  for ((slot) = hashmap_next(map, 0); (slot) != HASHMAP_BAD_INDEX; \
+       (slot) = hashmap_next(map, (slot) + 1)) {                   \
+    body;                                                          \
+  }                                                                \
+  (void)0
+
+/* `key` must be an lvalue. */
+#define hashmap_get(map, key) hashmap_untyped_get(map, &(key))
+
+#define hashmap_is_empty(map) (hashmap_length(map) == 0)
+
+/* The key in the full slot `slot`, as found by `hashmap_next()`. */
+#define hashmap_key_at(map, slot)                                 \
+  ((void *)((map) + hashmap_slots_offset(hashmap_capacity(map)) + \
+            ((slot) * hashmap_header_const(map)->slot_size)))
+
+#define hashmap_length(map) (+hashmap_header_const(map)->length)
+
+#define hashmap_new(key_type, value_type, count) \
+  hashmap_new_with(NULL, key_type, value_type, count, NULL)
+
+/*
+ * Creates a map with room for `count` keys, hashing them with `hash`, or with
+ * `hashmap_hash_bytes()` if it is `NULL`.
+ */
+#define hashmap_new_with(allocator, key_type, value_type, count, hash) \
+  hashmap_untyped_new_with(allocator, sizeof(key_type),                \
+                           sizeof(value_type), count, hash)
+
+/* `key` and `value` must be lvalues. */
+#define hashmap_put(map, key, value) \
+  hashmap_untyped_put(&(map), &(key), &(value))
+
+#define hashmap_reserve(map, count) hashmap_untyped_reserve(&(map), count)
+
+/* The value in the full slot `slot`, as found by `hashmap_next()`. */
+#define hashmap_value_at(map, slot)             \
+  ((void *)((byte *)hashmap_key_at(map, slot) + \
+            hashmap_header_const(map)->value_offset))
+
+/* - FUNCTIONS - */
+
+/* Removes every key, keeping the capacity. */
+void hashmap_clear(hashmap map);
+
+/*
+ * The default hash function, which mixes the key a word at a time and then
+ * finalizes the result so that all of its bits are usable.
+ */
+size_t hashmap_hash_bytes(const void *key, size_t key_size);
+
+/*
+ * Returns the first full slot at or after `slot`, or `HASHMAP_BAD_INDEX` if
+ * there is none. Slots are visited in no particular order, and erasing the
+ * key in a slot does not disturb the others.
+ */
+size_t hashmap_next(const hashmap map, size_t slot);
+
+void hashmap_untyped_delete(hashmap map);
+
+/* Returns `false` if `key` was not in the map. */
+bool hashmap_untyped_erase(hashmap map, const void *key);
+
+/*
+ * Returns a pointer to the value of `key`, or `NULL` if it is not in the map.
+ * The pointer is invalidated by any insertion.
+ */
+void *hashmap_untyped_get(const hashmap map, const void *key);
+
+/*
+ * Returns a map with room for `count` keys of `key_size` bytes and their
+ * `value_size` byte values, or `NULL` if it could not be allocated.
+ */
+hashmap hashmap_untyped_new_with(const myclib_allocator *allocator,
+                                 size_t key_size, size_t value_size,
+                                 size_t count, hashmap_hash hash);
+
+/*
+ * Sets the value of `key` to the one at `value`, inserting `key` if needed,
+ * and returns a pointer to the stored value. If `value` is `NULL`, an existing
+ * value is kept and a new one zeroed. Returns `NULL` if the map could not be
+ * grown, in which case it is unchanged.
+ */
+void *hashmap_untyped_put(hashmap *map, const void *key, const void *value);
+
+/*
+ * Grows `*map` so that it holds `count` keys without growing again, returning
+ * the map, or `NULL` if it could not be grown.
+ */
+hashmap hashmap_untyped_reserve(hashmap *map, size_t count);
+
+/* - TYPED GENERATORS - */
+
+/*
+ * `DEFINE_HASHMAP(key_type, value_type, name)` defines `name` as a `hashmap`
+ * from `key_type` to `value_type` along with the following functions, each of
+ * which evaluates its arguments once and takes keys and values by value:
+ *
+ * `name name_new(size_t count)`
+ * `name name_new_with(const myclib_allocator *allocator, size_t count,
+ *                     hashmap_hash hash)`
+ * `void name_delete(name *map)`
+ * `name name_reserve(name *map, size_t count)`
+ * `value_type *name_get(const name map, key_type key)`
+ * `value_type *name_put(name *map, key_type key, value_type value)`
+ * `bool name_erase(name map, key_type key)`
+ * `key_type *name_key_at(const name map, size_t slot)`
+ * `value_type *name_value_at(const name map, size_t slot)`
+ *
+ * They behave as the macros and functions of the same name do. Maps created
+ * either way share the same layout, so a `name` may be passed to any other
+ * hash map function and vice versa.
+ *
+ * For example, `DEFINE_HASHMAP(int, double, idmap)` at file scope defines
+ * `idmap_put()` and so on.
+ */
+#define DEFINE_HASHMAP(key_type, value_type, name)                            \
+  typedef hashmap name;                                                       \
+                                                                              \
+  static inline name name##_new_with(const myclib_allocator *const allocator, \
+                                     const size_t count,                      \
+                                     const hashmap_hash hash) {               \
+    return hashmap_untyped_new_with(allocator, sizeof(key_type),              \
+                                    sizeof(value_type), count, hash);         \
+  }                                                                           \
+                                                                              \
+  static inline name name##_new(const size_t count) {                         \
+    return name##_new_with(NULL, count, NULL);                                \
+  }                                                                           \
+                                                                              \
+  static inline void name##_delete(name *const map) {                         \
+    hashmap_untyped_delete(*map);                                             \
+    *map = NULL;                                                              \
+  }                                                                           \
+                                                                              \
+  static inline name name##_reserve(name *const map, const size_t count) {    \
+    return hashmap_untyped_reserve(map, count);                               \
+  }                                                                           \
+                                                                              \
+  static inline value_type *name##_get(const name map, const key_type key) {  \
+    return (value_type *)hashmap_untyped_get(map, &key);                      \
+  }                                                                           \
+                                                                              \
+  static inline value_type *name##_put(name *const map, const key_type key,   \
+                                       const value_type value) {              \
+    return (value_type *)hashmap_untyped_put(map, &key, &value);              \
+  }                                                                           \
+                                                                              \
+  static inline bool name##_erase(const name map, const key_type key) {       \
+    return hashmap_untyped_erase(map, &key);                                  \
+  }                                                                           \
+                                                                              \
+  static inline key_type *name##_key_at(const name map, const size_t slot) {  \
+    return (key_type *)hashmap_key_at(map, slot);                             \
+  }                                                                           \
+                                                                              \
+  static inline value_type *name##_value_at(const name map,                   \
+                                            const size_t slot) {              \
+    return (value_type *)hashmap_value_at(map, slot);                         \
+  }                                                                           \
+                                                                              \
+  typedef int name##_require_semicolon
+
+#endif
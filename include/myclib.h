@@ -4,7 +4,7 @@
 #include <limits.h> /* LONG_MAX, LONG_MIN, ULONG_MAX, LLONG_MAX, LLONG_MIN, ULLONG_MAX */
 #include <stddef.h> /* NULL, size_t */
 #include <stdio.h>  /* fputs(), stderr */
-#include <stdlib.h> /* abort() */
+#include <stdlib.h> /* abort(), free(), malloc(), realloc() */
 
 /* - COMPATIBILITY - */
 
@@ -94,6 +94,45 @@ typedef byte bool; /* Boolean type for standards prior to C99. */
 #define util_assert(expr) \
   inline_if(expr, NULL, (util_assert_msg(expr), abort()))
 
+/* - ALLOCATORS - */
+
+/*
+ * An interface through which containers obtain and release memory.
+ *
+ *  `alloc`   - Returns a block of at least `size` bytes, or `NULL` on failure.
+ * `realloc`  - Resizes the `old_size` byte block at `ptr` to `new_size` bytes,
+ *              returning the (possibly moved) block. On failure, `NULL` is
+ *              returned and `ptr` remains valid.
+ *  `free`    - Releases the `size` byte block at `ptr`.
+ *   `ctx`    - Passed as the first argument to each of the above.
+ *
+ * Block sizes are passed back to the allocator so that arenas and pools need
+ * not record them. A container only references its allocator, so the
+ * allocator must outlive every container using it.
+ *
+ * Wherever an allocator is expected, `NULL` may be passed to use `malloc()`,
+ * `realloc()` and `free()`.
+ */
+typedef struct myclib_allocator {
+  void *(*alloc)(void *ctx, size_t size);
+  void *(*realloc)(void *ctx, void *ptr, size_t old_size, size_t new_size);
+  void (*free)(void *ctx, void *ptr, size_t size);
+  void *ctx;
+} myclib_allocator;
+
+#define myclib_alloc(allocator, size) \
+  ((allocator) == NULL ? malloc(size) \
+                       : (allocator)->alloc((allocator)->ctx, size))
+
+#define myclib_realloc(allocator, ptr, old_size, new_size) \
+  ((allocator) == NULL                                     \
+       ? realloc(ptr, new_size)                            \
+       : (allocator)->realloc((allocator)->ctx, ptr, old_size, new_size))
+
+#define myclib_free(allocator, ptr, size)   \
+  inline_if((allocator) == NULL, free(ptr), \
+            (allocator)->free((allocator)->ctx, ptr, size))
+
 /* - MISCELLANEOUS - */
 
 #ifndef ARR_LEN
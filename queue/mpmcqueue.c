@@ -0,0 +1,159 @@
+#include "mpmcqueue.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "../include/myclib.h"
+
+#if !defined(__GNUC__) && !defined(__clang__)
+#error "Concurrent queues require the GCC or Clang atomic builtins."
+#endif
+
+/* - INTERNAL - */
+
+#define CACHE_LINE ((size_t)64)
+
+/*
+ * `enqueue_pos` - The next position producers claim.
+ * `dequeue_pos` - The next position consumers claim.
+ *  `capacity`   - The number of slots, a power of two.
+ *  `allocator`  - The allocator owning the queue's memory, or `NULL` if the
+ *                 standard library's allocation functions are used.
+ *
+ * Producers and consumers each get a cache line for their position, so that
+ * they do not contend with each other over it.
+ */
+typedef struct mpmc_header {
+  size_t enqueue_pos;
+  byte producer_padding[CACHE_LINE - sizeof(size_t)];
+  size_t dequeue_pos;
+  byte consumer_padding[CACHE_LINE - sizeof(size_t)];
+  size_t capacity;
+  const myclib_allocator *allocator;
+  byte shared_padding[CACHE_LINE - sizeof(size_t) - sizeof(void *)];
+} mpmc_header;
+
+#define mpmc_header(q) ((mpmc_header *)(q) - 1)
+
+#define mpmc_header_const(q) ((const mpmc_header *)(q) - 1)
+
+/*
+ * Each slot is its sequence number followed by its element, padded to a whole
+ * number of words so that the next sequence number is aligned.
+ *
+ * Position `p` is empty and ready for a producer while its slot's sequence
+ * number is `p`, and full and ready for a consumer while it is `p + 1`. Once
+ * consumed it becomes `p + capacity`, ready for the producer of the next lap.
+ */
+#define slot_size(elem_size) \
+  (sizeof(size_t) * (2 + (((elem_size) - 1) / sizeof(size_t))))
+
+#define slot_at(q, position, elem_size)                        \
+  ((size_t *)((byte *)(q) +                                    \
+              (((position) & (mpmc_header(q)->capacity - 1)) * \
+               slot_size(elem_size))))
+
+#define allocation_size(elem_size, capacity) \
+  (sizeof(mpmc_header) + (slot_size(elem_size) * (capacity)))
+
+#define load_sequence(slot) __atomic_load_n(&(slot)[0], __ATOMIC_ACQUIRE)
+
+/*
+ * Claims up to `count` consecutive positions from `*position_ptr` whose slots'
+ * sequence numbers are `offset` past them, storing the first in `*first`.
+ * Returns the number claimed, or `0` if the first slot is not yet ready.
+ */
+static size_t claim(void *const q, size_t *const position_ptr,
+                    const size_t offset, const size_t count,
+                    const size_t elem_size, size_t *const first) {
+  size_t position = __atomic_load_n(position_ptr, __ATOMIC_RELAXED);
+  size_t claimed;
+  for (;;) {
+    const size_t SEQUENCE = load_sequence(slot_at(q, position, elem_size));
+    const ptrdiff_t LAG = (ptrdiff_t)(SEQUENCE - (position + offset));
+    /* The slot is still waiting on the other end from the previous lap. */
+    if (LAG < 0) return 0;
+    if (LAG > 0) {
+      /* Another thread at this end claimed the position first. */
+      position = __atomic_load_n(position_ptr, __ATOMIC_RELAXED);
+      continue;
+    }
+    for (claimed = 1; claimed < count; claimed++) {
+      const size_t NEXT = position + claimed;
+      if (load_sequence(slot_at(q, NEXT, elem_size)) != NEXT + offset) break;
+    }
+    if (__atomic_compare_exchange_n(position_ptr, &position,
+                                    position + claimed, true,
+                                    __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+      break;
+  }
+  *first = position;
+  return claimed;
+}
+
+/* - FUNCTIONS - */
+
+size_t mpmc_queue_untyped_capacity(const void *const q) {
+  return mpmc_header_const(q)->capacity;
+}
+
+void mpmc_queue_untyped_delete(void *const q, const size_t elem_size) {
+  mpmc_header *const header = mpmc_header(q);
+  myclib_free(header->allocator, header,
+              allocation_size(elem_size, header->capacity));
+}
+
+void *mpmc_queue_untyped_new_with(const myclib_allocator *const allocator,
+                                  const size_t elem_size,
+                                  const size_t capacity) {
+  const size_t MAX_CAPACITY =
+      ((size_t)-1 - sizeof(mpmc_header)) / slot_size(elem_size);
+  mpmc_header *header;
+  size_t rounded = 1;
+  size_t i;
+  util_assert(elem_size != 0);
+  while (rounded < capacity) {
+    if (rounded > MAX_CAPACITY / 2) return NULL;
+    rounded *= 2;
+  }
+  header = myclib_alloc(allocator, allocation_size(elem_size, rounded));
+  if (header == NULL) return NULL;
+  memset(header, 0, sizeof *header);
+  header->capacity = rounded;
+  header->allocator = allocator;
+  for (i = 0; i < rounded; i++) *slot_at(header + 1, i, elem_size) = i;
+  return header + 1;
+}
+
+size_t mpmc_queue_untyped_pop_n(void *const q, void *const dst,
+                                const size_t count, const size_t elem_size) {
+  const size_t CAPACITY = mpmc_header(q)->capacity;
+  size_t first;
+  size_t popped;
+  size_t i;
+  if (count == 0) return 0;
+  popped = claim(q, &mpmc_header(q)->dequeue_pos, 1, count, elem_size, &first);
+  for (i = 0; i < popped; i++) {
+    size_t *const slot = slot_at(q, first + i, elem_size);
+    memcpy((byte *)dst + (i * elem_size), slot + 1, elem_size);
+    /* Hands the slot to the producer of the next lap. */
+    __atomic_store_n(&slot[0], first + i + CAPACITY, __ATOMIC_RELEASE);
+  }
+  return popped;
+}
+
+size_t mpmc_queue_untyped_push_n(void *const q, const void *const src,
+                                 const size_t count, const size_t elem_size) {
+  size_t first;
+  size_t pushed;
+  size_t i;
+  if (count == 0) return 0;
+  pushed = claim(q, &mpmc_header(q)->enqueue_pos, 0, count, elem_size, &first);
+  for (i = 0; i < pushed; i++) {
+    size_t *const slot = slot_at(q, first + i, elem_size);
+    memcpy(slot + 1, (const byte *)src + (i * elem_size), elem_size);
+    /* Hands the slot to consumers. */
+    __atomic_store_n(&slot[0], first + i + 1, __ATOMIC_RELEASE);
+  }
+  return pushed;
+}
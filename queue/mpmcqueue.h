@@ -0,0 +1,126 @@
+#ifndef MPMC_QUEUE_H
+#define MPMC_QUEUE_H
+
+#include <stddef.h>
+
+#include "../include/myclib.h"
+
+/* - DEFINITIONS - */
+
+/*
+ * A multi-producer, multi-consumer queue is a bounded ring which any number of
+ * threads may push to and pop from at once without locking. Every slot carries
+ * a sequence number saying which lap of the ring it is ready for and whether
+ * it is empty or full. A producer claims the next position with a
+ * compare-and-swap once its slot reads empty for that lap, copies its element
+ * in, then advances the sequence number to hand the slot to consumers, who do
+ * the reverse. Threads therefore only contend on the index at their own end,
+ * and never wait on one another except when the queue is full or empty.
+ *
+ * As with `spsc_queue`, the header is private and capacities are rounded up
+ * to powers of two. Slots hold their sequence numbers alongside their
+ * elements, so a `mpmc_queue(type)` must not be indexed.
+ */
+#define mpmc_queue(type) type *
+
+/* - CONVENIENCE MACROS - */
+
+#define mpmc_queue_capacity(q) mpmc_queue_untyped_capacity((const void *)(q))
+
+#define mpmc_queue_delete(q) \
+  ((void)(mpmc_queue_untyped_delete((void *)(q), sizeof *(q)), (q) = NULL))
+
+#define mpmc_queue_new(type, capacity) \
+  ((type *)mpmc_queue_untyped_new_with(NULL, sizeof(type), capacity))
+
+#define mpmc_queue_new_with(allocator, type, capacity) \
+  ((type *)mpmc_queue_untyped_new_with(allocator, sizeof(type), capacity))
+
+/* `elem` must be an lvalue. */
+#define mpmc_queue_pop(q, elem) \
+  (mpmc_queue_untyped_pop_n((void *)(q), &(elem), 1, sizeof *(q)) == 1)
+
+#define mpmc_queue_pop_n(q, dst, count) \
+  mpmc_queue_untyped_pop_n((void *)(q), dst, count, sizeof *(q))
+
+/* `elem` must be an lvalue. */
+#define mpmc_queue_push(q, elem) \
+  (mpmc_queue_untyped_push_n((void *)(q), &(elem), 1, sizeof *(q)) == 1)
+
+#define mpmc_queue_push_n(q, src, count) \
+  mpmc_queue_untyped_push_n((void *)(q), src, count, sizeof *(q))
+
+/* - TYPED GENERATORS - */
+
+/*
+ * `DEFINE_MPMC_QUEUE(type, name)` defines `name` as a `mpmc_queue(type)` along
+ * with the following functions, each of which evaluates its arguments once:
+ *
+ * `name name_new(size_t capacity)`
+ * `name name_new_with(const myclib_allocator *allocator, size_t capacity)`
+ * `void name_delete(name *q)`
+ * `bool name_push(name q, type elem)`
+ * `bool name_pop(name q, type *elem)`
+ *
+ * They behave as the macros of the same name do.
+ */
+#define DEFINE_MPMC_QUEUE(type, name)                                         \
+  typedef type *name;                                                         \
+                                                                              \
+  static inline name name##_new_with(const myclib_allocator *const allocator, \
+                                     const size_t capacity) {                 \
+    return (name)mpmc_queue_untyped_new_with(allocator, sizeof(type),         \
+                                             capacity);                       \
+  }                                                                           \
+                                                                              \
+  static inline name name##_new(const size_t capacity) {                      \
+    return name##_new_with(NULL, capacity);                                   \
+  }                                                                           \
+                                                                              \
+  static inline void name##_delete(name *const q) {                           \
+    mpmc_queue_untyped_delete(*q, sizeof(type));                              \
+    *q = NULL;                                                                \
+  }                                                                           \
+                                                                              \
+  static inline bool name##_push(const name q, const type elem) {             \
+    return mpmc_queue_untyped_push_n(q, &elem, 1, sizeof(type)) == 1;         \
+  }                                                                           \
+                                                                              \
+  static inline bool name##_pop(const name q, type *const elem) {             \
+    return mpmc_queue_untyped_pop_n(q, elem, 1, sizeof(type)) == 1;           \
+  }                                                                           \
+                                                                              \
+  typedef int name##_require_semicolon
+
+/* - FUNCTIONS - */
+
+size_t mpmc_queue_untyped_capacity(const void *q);
+
+/* Must not be called while any other thread is using `q`. */
+void mpmc_queue_untyped_delete(void *q, size_t elem_size);
+
+/*
+ * Returns a queue holding up to `capacity` elements, rounded up to a power of
+ * two, or `NULL` if it could not be allocated.
+ */
+void *mpmc_queue_untyped_new_with(const myclib_allocator *allocator,
+                                  size_t elem_size, size_t capacity);
+
+/*
+ * Claims up to `count` consecutive full slots at once and moves their elements
+ * to `dst`, returning the number moved, which is `0` if the queue is empty.
+ * Fewer than `count` are moved if the queue runs out, or if a producer is
+ * still filling a slot within the range.
+ */
+size_t mpmc_queue_untyped_pop_n(void *q, void *dst, size_t count,
+                                size_t elem_size);
+
+/*
+ * Claims up to `count` consecutive empty slots at once and copies as many of
+ * the elements at `src` into them, returning the number pushed, which is `0`
+ * if the queue is full.
+ */
+size_t mpmc_queue_untyped_push_n(void *q, const void *src, size_t count,
+                                 size_t elem_size);
+
+#endif
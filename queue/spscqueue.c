@@ -0,0 +1,138 @@
+#include "spscqueue.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "../include/myclib.h"
+
+#if !defined(__GNUC__) && !defined(__clang__)
+#error "Concurrent queues require the GCC or Clang atomic builtins."
+#endif
+
+/* - INTERNAL - */
+
+#define CACHE_LINE ((size_t)64)
+
+/*
+ *      `tail`      - The number of elements pushed so far, written by the
+ *                    producer.
+ *  `cached_head`   - The producer's copy of `head`, which lags behind it.
+ *      `head`      - The number of elements popped so far, written by the
+ *                    consumer.
+ *  `cached_tail`   - The consumer's copy of `tail`, which lags behind it.
+ *    `capacity`    - The number of slots, a power of two.
+ *   `allocator`    - The allocator owning the queue's memory, or `NULL` if the
+ *                    standard library's allocation functions are used.
+ *
+ * Each group of fields has a cache line to itself, so that the producer and
+ * the consumer only share a line when one reads the other's index.
+ */
+typedef struct spsc_header {
+  size_t tail;
+  size_t cached_head;
+  byte producer_padding[CACHE_LINE - (2 * sizeof(size_t))];
+  size_t head;
+  size_t cached_tail;
+  byte consumer_padding[CACHE_LINE - (2 * sizeof(size_t))];
+  size_t capacity;
+  const myclib_allocator *allocator;
+  byte shared_padding[CACHE_LINE - sizeof(size_t) - sizeof(void *)];
+} spsc_header;
+
+#define spsc_header(q) ((spsc_header *)(q) - 1)
+
+#define spsc_header_const(q) ((const spsc_header *)(q) - 1)
+
+#define allocation_size(elem_size, capacity) \
+  (sizeof(spsc_header) + ((elem_size) * (capacity)))
+
+/*
+ * Copies `count` elements between the ring at `ring` and `elems`, starting at
+ * position `position`, wrapping around at most once.
+ */
+static void copy_in(byte *const ring, const size_t capacity,
+                    const size_t position, const void *const elems,
+                    const size_t count, const size_t elem_size) {
+  const size_t FIRST =
+      count < capacity - position ? count : capacity - position;
+  memcpy(ring + (position * elem_size), elems, FIRST * elem_size);
+  memcpy(ring, (const byte *)elems + (FIRST * elem_size),
+         (count - FIRST) * elem_size);
+}
+
+static void copy_out(const byte *const ring, const size_t capacity,
+                     const size_t position, void *const elems,
+                     const size_t count, const size_t elem_size) {
+  const size_t FIRST =
+      count < capacity - position ? count : capacity - position;
+  memcpy(elems, ring + (position * elem_size), FIRST * elem_size);
+  memcpy((byte *)elems + (FIRST * elem_size), ring,
+         (count - FIRST) * elem_size);
+}
+
+/* - FUNCTIONS - */
+
+size_t spsc_queue_untyped_capacity(const void *const q) {
+  return spsc_header_const(q)->capacity;
+}
+
+void spsc_queue_untyped_delete(void *const q, const size_t elem_size) {
+  spsc_header *const header = spsc_header(q);
+  myclib_free(header->allocator, header,
+              allocation_size(elem_size, header->capacity));
+}
+
+void *spsc_queue_untyped_new_with(const myclib_allocator *const allocator,
+                                  const size_t elem_size,
+                                  const size_t capacity) {
+  const size_t MAX_CAPACITY =
+      ((size_t)-1 - sizeof(spsc_header)) / (elem_size != 0 ? elem_size : 1);
+  spsc_header *header;
+  size_t rounded = 1;
+  while (rounded < capacity) {
+    if (rounded > MAX_CAPACITY / 2) return NULL;
+    rounded *= 2;
+  }
+  header = myclib_alloc(allocator, allocation_size(elem_size, rounded));
+  if (header == NULL) return NULL;
+  memset(header, 0, sizeof *header);
+  header->capacity = rounded;
+  header->allocator = allocator;
+  return header + 1;
+}
+
+size_t spsc_queue_untyped_pop_n(void *const q, void *const dst,
+                                const size_t count, const size_t elem_size) {
+  spsc_header *const header = spsc_header(q);
+  const size_t HEAD = header->head;
+  size_t popped = header->cached_tail - HEAD;
+  if (popped < count) {
+    header->cached_tail = __atomic_load_n(&header->tail, __ATOMIC_ACQUIRE);
+    popped = header->cached_tail - HEAD;
+  }
+  if (popped > count) popped = count;
+  if (popped == 0) return 0;
+  copy_out(q, header->capacity, HEAD & (header->capacity - 1), dst, popped,
+           elem_size);
+  /* Hands the slots back to the producer only once they have been read. */
+  __atomic_store_n(&header->head, HEAD + popped, __ATOMIC_RELEASE);
+  return popped;
+}
+
+size_t spsc_queue_untyped_push_n(void *const q, const void *const src,
+                                 const size_t count, const size_t elem_size) {
+  spsc_header *const header = spsc_header(q);
+  const size_t TAIL = header->tail;
+  size_t pushed = header->capacity - (TAIL - header->cached_head);
+  if (pushed < count) {
+    header->cached_head = __atomic_load_n(&header->head, __ATOMIC_ACQUIRE);
+    pushed = header->capacity - (TAIL - header->cached_head);
+  }
+  if (pushed > count) pushed = count;
+  if (pushed == 0) return 0;
+  copy_in(q, header->capacity, TAIL & (header->capacity - 1), src, pushed,
+          elem_size);
+  /* Publishes the elements only once they have been written. */
+  __atomic_store_n(&header->tail, TAIL + pushed, __ATOMIC_RELEASE);
+  return pushed;
+}
@@ -0,0 +1,124 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <stddef.h>
+
+#include "../include/myclib.h"
+
+/* - DEFINITIONS - */
+
+/*
+ * A single-producer, single-consumer queue is a bounded ring shared by exactly
+ * two threads: one which only pushes and one which only pops. Neither takes a
+ * lock. The producer owns the tail index and the consumer the head, each on a
+ * cache line of its own, and each keeps a private copy of the other's index
+ * which it only refreshes when the ring looks full or empty, so in the steady
+ * state neither touches the other's cache line.
+ *
+ * As with `vector`, a header precedes the ring, so a `spsc_queue(type)` points
+ * at its first slot. The header is private, so the queue is only reached
+ * through the macros and functions below. Capacities are rounded up to powers
+ * of two, and a full queue rejects pushes rather than growing.
+ */
+#define spsc_queue(type) type *
+
+/* - CONVENIENCE MACROS - */
+
+#define spsc_queue_capacity(q) spsc_queue_untyped_capacity((const void *)(q))
+
+#define spsc_queue_delete(q) \
+  ((void)(spsc_queue_untyped_delete((void *)(q), sizeof *(q)), (q) = NULL))
+
+#define spsc_queue_new(type, capacity) \
+  ((type *)spsc_queue_untyped_new_with(NULL, sizeof(type), capacity))
+
+#define spsc_queue_new_with(allocator, type, capacity) \
+  ((type *)spsc_queue_untyped_new_with(allocator, sizeof(type), capacity))
+
+/* Only the consumer may pop. `elem` must be an lvalue. */
+#define spsc_queue_pop(q, elem) \
+  (spsc_queue_untyped_pop_n((void *)(q), &(elem), 1, sizeof *(q)) == 1)
+
+#define spsc_queue_pop_n(q, dst, count) \
+  spsc_queue_untyped_pop_n((void *)(q), dst, count, sizeof *(q))
+
+/* Only the producer may push. `elem` must be an lvalue. */
+#define spsc_queue_push(q, elem) \
+  (spsc_queue_untyped_push_n((void *)(q), &(elem), 1, sizeof *(q)) == 1)
+
+#define spsc_queue_push_n(q, src, count) \
+  spsc_queue_untyped_push_n((void *)(q), src, count, sizeof *(q))
+
+/* - TYPED GENERATORS - */
+
+/*
+ * `DEFINE_SPSC_QUEUE(type, name)` defines `name` as a `spsc_queue(type)` along
+ * with the following functions, each of which evaluates its arguments once:
+ *
+ * `name name_new(size_t capacity)`
+ * `name name_new_with(const myclib_allocator *allocator, size_t capacity)`
+ * `void name_delete(name *q)`
+ * `bool name_push(name q, type elem)`
+ * `bool name_pop(name q, type *elem)`
+ *
+ * They behave as the macros of the same name do.
+ */
+#define DEFINE_SPSC_QUEUE(type, name)                                         \
+  typedef type *name;                                                         \
+                                                                              \
+  static inline name name##_new_with(const myclib_allocator *const allocator, \
+                                     const size_t capacity) {                 \
+    return (name)spsc_queue_untyped_new_with(allocator, sizeof(type),         \
+                                             capacity);                       \
+  }                                                                           \
+                                                                              \
+  static inline name name##_new(const size_t capacity) {                      \
+    return name##_new_with(NULL, capacity);                                   \
+  }                                                                           \
+                                                                              \
+  static inline void name##_delete(name *const q) {                           \
+    spsc_queue_untyped_delete(*q, sizeof(type));                              \
+    *q = NULL;                                                                \
+  }                                                                           \
+                                                                              \
+  static inline bool name##_push(const name q, const type elem) {             \
+    return spsc_queue_untyped_push_n(q, &elem, 1, sizeof(type)) == 1;         \
+  }                                                                           \
+                                                                              \
+  static inline bool name##_pop(const name q, type *const elem) {             \
+    return spsc_queue_untyped_pop_n(q, elem, 1, sizeof(type)) == 1;           \
+  }                                                                           \
+                                                                              \
+  typedef int name##_require_semicolon
+
+/* - FUNCTIONS - */
+
+size_t spsc_queue_untyped_capacity(const void *q);
+
+/* Must not be called while either thread is using `q`. */
+void spsc_queue_untyped_delete(void *q, size_t elem_size);
+
+/*
+ * Returns a queue holding up to `capacity` elements, rounded up to a power of
+ * two, or `NULL` if it could not be allocated.
+ */
+void *spsc_queue_untyped_new_with(const myclib_allocator *allocator,
+                                  size_t elem_size, size_t capacity);
+
+/*
+ * Moves up to `count` elements from the front of the queue to `dst`, in at
+ * most two copies, and returns the number moved, which is `0` if the queue is
+ * empty.
+ */
+size_t spsc_queue_untyped_pop_n(void *q, void *dst, size_t count,
+                                size_t elem_size);
+
+/*
+ * Copies as many of the `count` elements at `src` as fit to the back of the
+ * queue, in at most two copies, and publishes them all at once. Returns the
+ * number pushed, which is `0` if the queue is full.
+ */
+size_t spsc_queue_untyped_push_n(void *q, const void *src, size_t count,
+                                 size_t elem_size);
+
+#endif
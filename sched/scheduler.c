@@ -0,0 +1,501 @@
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE (200112L)
+#endif
+
+#include "scheduler.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#include "../include/myclib.h"
+#include "../threadpool/threadpool.h"
+
+#if !defined(__GNUC__) && !defined(__clang__)
+#error "The scheduler requires the GCC or Clang atomic builtins."
+#endif
+
+/* - DEFINITIONS - */
+
+#define CACHE_LINE ((size_t)64)
+
+#define DEQUE_INITIAL_CAPACITY ((size_t)64)
+
+#define DEQUE_EXPANSION_FACTOR ((size_t)2)
+
+/* The number of fruitless searches for work before a worker sleeps. */
+#define SPIN_ROUNDS (64)
+
+/*
+ * Loop chunks stop growing at this fraction of a thread's share of the loop,
+ * so that a thread never commits to so much that the others run dry.
+ */
+#define CHUNKS_PER_THREAD ((size_t)4)
+
+/*
+ * The block holding a worker's deque, which is followed by `capacity` job
+ * pointers. As with `stack`, the block is reallocated to grow, except that
+ * thieves may still be reading the old one, so it is kept on the `previous`
+ * chain until the scheduler is deleted instead of being freed.
+ */
+typedef struct deque_array {
+  size_t capacity;
+  struct deque_array *previous;
+} deque_array;
+
+#define array_slots(arr) ((scheduler_job **)((arr) + 1))
+
+/*
+ *    `top`     - The position thieves steal from next. Only ever advanced,
+ *                by a successful compare-and-swap.
+ *   `bottom`   - One past the position the owner pops from next. Written
+ *                only by the owner.
+ *   `array`    - The deque's current block, holding positions `top` through
+ *                `bottom - 1` modulo its capacity.
+ *   `sched`    - The scheduler the worker belongs to.
+ *   `index`    - The worker's position in `sched->workers`.
+ *    `seed`    - The state of the worker's victim selection.
+ *   `thread`   - The worker's thread, unless it is worker `0`.
+ *
+ * `top` has a cache line to itself, so that thieves contend with the owner
+ * only when they actually steal.
+ */
+struct scheduler_worker {
+  size_t top;
+  byte thief_padding[CACHE_LINE - sizeof(size_t)];
+  size_t bottom;
+  deque_array *array;
+  scheduler *sched;
+  size_t index;
+  unsigned long seed;
+  pthread_t thread;
+  byte owner_padding[CACHE_LINE];
+};
+
+/*
+ *    `workers`    - The worker of every thread. Worker `0` belongs to
+ *                   whichever thread is inside `scheduler_run()`.
+ * `thread_count`  - The number of workers.
+ *     `idle`      - The number of workers looking for work or asleep.
+ *   `sleepers`    - The number of workers asleep, or about to be.
+ *     `lock`      - Guards `stopping` and sleeping on `wake`.
+ *     `wake`      - Signalled when a task is spawned while workers sleep, or
+ *                   once the workers are to exit.
+ *   `stopping`    - Set once the workers are to exit.
+ *   `run_lock`    - Held by the thread inside `scheduler_run()`.
+ */
+struct scheduler {
+  scheduler_worker *workers;
+  size_t thread_count;
+  size_t idle;
+  size_t sleepers;
+  pthread_mutex_t lock;
+  pthread_cond_t wake;
+  bool stopping;
+  pthread_mutex_t run_lock;
+};
+
+/*
+ * `ctx` - The loop's iterations `begin` through `end - 1`, which a range task
+ *         executes in chunks of `min_grain` to `max_grain` iterations.
+ */
+typedef struct range_ctx {
+  scheduler_range_task body;
+  void *ctx;
+  size_t begin;
+  size_t end;
+  size_t min_grain;
+  size_t max_grain;
+} range_ctx;
+
+/* - INTERNAL - */
+
+/* - DEQUES - */
+
+/*
+ * Each deque is a Chase-Lev deque: the owner pushes and pops at `bottom`
+ * without contention, and only races thieves for the last job with a
+ * compare-and-swap on `top`. Positions grow without bound and are reduced
+ * modulo the capacity, so they are compared through their difference.
+ *
+ * Stores to `bottom` and the loads of `top` and `bottom` which decide whether
+ * a job is taken are sequentially consistent, which orders the owner's store
+ * before its load of `top` and a thief's load of `top` before its load of
+ * `bottom`. `bottom` is also the flag checked against `sleepers` before a
+ * worker sleeps.
+ */
+#define deque_length(top, bottom) ((ptrdiff_t)((bottom) - (top)))
+
+static deque_array *array_new(const size_t capacity) {
+  deque_array *const arr =
+      malloc(sizeof(deque_array) + (capacity * sizeof(scheduler_job *)));
+  if (arr == NULL) return NULL;
+  arr->capacity = capacity;
+  arr->previous = NULL;
+  return arr;
+}
+
+/* Replaces a full deque's block with one twice its size. */
+static deque_array *deque_grow(scheduler_worker *const worker,
+                               const size_t top, const size_t bottom) {
+  deque_array *const old = worker->array;
+  deque_array *arr;
+  size_t i;
+  if (old->capacity > (size_t)-1 / sizeof(scheduler_job *) /
+                          DEQUE_EXPANSION_FACTOR)
+    return NULL;
+  arr = array_new(old->capacity * DEQUE_EXPANSION_FACTOR);
+  if (arr == NULL) return NULL;
+  for (i = top; i != bottom; i++) {
+    array_slots(arr)[i & (arr->capacity - 1)] = __atomic_load_n(
+        &array_slots(old)[i & (old->capacity - 1)], __ATOMIC_RELAXED);
+  }
+  arr->previous = old;
+  __atomic_store_n(&worker->array, arr, __ATOMIC_RELEASE);
+  return arr;
+}
+
+/* Returns `false` if the deque was full and could not grow. */
+static bool deque_push(scheduler_worker *const worker,
+                       scheduler_job *const job) {
+  const size_t BOTTOM = worker->bottom;
+  const size_t TOP = __atomic_load_n(&worker->top, __ATOMIC_ACQUIRE);
+  deque_array *arr = worker->array;
+  if ((size_t)deque_length(TOP, BOTTOM) >= arr->capacity) {
+    arr = deque_grow(worker, TOP, BOTTOM);
+    if (arr == NULL) return false;
+  }
+  __atomic_store_n(&array_slots(arr)[BOTTOM & (arr->capacity - 1)], job,
+                   __ATOMIC_RELAXED);
+  __atomic_store_n(&worker->bottom, BOTTOM + 1, __ATOMIC_SEQ_CST);
+  return true;
+}
+
+static scheduler_job *deque_pop(scheduler_worker *const worker) {
+  const size_t BOTTOM = worker->bottom - 1;
+  deque_array *const arr = worker->array;
+  scheduler_job *job;
+  size_t top;
+  __atomic_store_n(&worker->bottom, BOTTOM, __ATOMIC_SEQ_CST);
+  top = __atomic_load_n(&worker->top, __ATOMIC_SEQ_CST);
+  if (deque_length(top, BOTTOM) < 0) {
+    __atomic_store_n(&worker->bottom, BOTTOM + 1, __ATOMIC_RELEASE);
+    return NULL;
+  }
+  job = __atomic_load_n(&array_slots(arr)[BOTTOM & (arr->capacity - 1)],
+                        __ATOMIC_RELAXED);
+  if (BOTTOM != top) return job;
+  /* The last job goes to whichever of the owner and the thieves gets it. */
+  if (!__atomic_compare_exchange_n(&worker->top, &top, top + 1, false,
+                                   __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+    job = NULL;
+  __atomic_store_n(&worker->bottom, BOTTOM + 1, __ATOMIC_RELEASE);
+  return job;
+}
+
+/* Returns `NULL` if the deque was empty or another thread won the job. */
+static scheduler_job *deque_steal(scheduler_worker *const victim) {
+  size_t top = __atomic_load_n(&victim->top, __ATOMIC_SEQ_CST);
+  const size_t BOTTOM = __atomic_load_n(&victim->bottom, __ATOMIC_SEQ_CST);
+  deque_array *arr;
+  scheduler_job *job;
+  if (deque_length(top, BOTTOM) <= 0) return NULL;
+  arr = __atomic_load_n(&victim->array, __ATOMIC_ACQUIRE);
+  job = __atomic_load_n(&array_slots(arr)[top & (arr->capacity - 1)],
+                        __ATOMIC_RELAXED);
+  if (!__atomic_compare_exchange_n(&victim->top, &top, top + 1, false,
+                                   __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+    return NULL;
+  return job;
+}
+
+static bool deque_is_empty(const scheduler_worker *const worker) {
+  const size_t TOP = __atomic_load_n(&worker->top, __ATOMIC_SEQ_CST);
+  return deque_length(TOP, __atomic_load_n(&worker->bottom,
+                                           __ATOMIC_SEQ_CST)) <= 0;
+}
+
+/* - WORKERS - */
+
+static void execute(scheduler_worker *const worker, scheduler_job *const job) {
+  scheduler_group *const group = job->group;
+  job->task(worker, job->ctx);
+  /* Neither the job nor the group may be touched once this is seen. */
+  __atomic_fetch_sub(&group->pending, 1, __ATOMIC_RELEASE);
+}
+
+/* Tries every other worker once, starting from a random one. */
+static scheduler_job *steal_any(scheduler_worker *const worker) {
+  scheduler *const sched = worker->sched;
+  const size_t COUNT = sched->thread_count;
+  size_t start;
+  size_t i;
+  if (COUNT == 1) return NULL;
+  worker->seed = (worker->seed * 1103515245UL) + 12345UL;
+  start = (size_t)(worker->seed >> 16) % COUNT;
+  for (i = 0; i < COUNT; i++) {
+    scheduler_worker *const victim = &sched->workers[(start + i) % COUNT];
+    scheduler_job *job;
+    if (victim == worker) continue;
+    job = deque_steal(victim);
+    if (job != NULL) return job;
+  }
+  return NULL;
+}
+
+static scheduler_job *find_job(scheduler_worker *const worker) {
+  scheduler_job *const job = deque_pop(worker);
+  return job != NULL ? job : steal_any(worker);
+}
+
+static bool work_available(const scheduler *const sched) {
+  size_t i;
+  for (i = 0; i < sched->thread_count; i++)
+    if (!deque_is_empty(&sched->workers[i])) return true;
+  return false;
+}
+
+/*
+ * Sleeps until a task is spawned or the workers are to exit, returning
+ * `false` in the latter case. A spawning thread stores its deque's `bottom`
+ * before checking `sleepers` and a sleeping one increments `sleepers` before
+ * checking every `bottom`, so at least one of them sees the other.
+ */
+static bool sleep_until_work(scheduler *const sched) {
+  bool stopping;
+  pthread_mutex_lock(&sched->lock);
+  __atomic_fetch_add(&sched->sleepers, 1, __ATOMIC_SEQ_CST);
+  while (!sched->stopping && !work_available(sched))
+    pthread_cond_wait(&sched->wake, &sched->lock);
+  __atomic_fetch_sub(&sched->sleepers, 1, __ATOMIC_RELAXED);
+  stopping = sched->stopping;
+  pthread_mutex_unlock(&sched->lock);
+  return !stopping;
+}
+
+static void *worker_main(void *const arg) {
+  scheduler_worker *const worker = arg;
+  scheduler *const sched = worker->sched;
+  bool idle = true;
+  int failures = 0;
+  for (;;) {
+    scheduler_job *const job = find_job(worker);
+    if (job != NULL) {
+      if (idle) __atomic_fetch_sub(&sched->idle, 1, __ATOMIC_RELAXED);
+      idle = false;
+      failures = 0;
+      execute(worker, job);
+      continue;
+    }
+    if (!idle) __atomic_fetch_add(&sched->idle, 1, __ATOMIC_RELAXED);
+    idle = true;
+    if (++failures < SPIN_ROUNDS) {
+      sched_yield();
+      continue;
+    }
+    failures = 0;
+    if (!sleep_until_work(sched)) break;
+  }
+  return NULL;
+}
+
+/* Stops and joins workers `1` through `count - 1` of `sched`. */
+static void stop_workers(scheduler *const sched, const size_t count) {
+  size_t i;
+  pthread_mutex_lock(&sched->lock);
+  sched->stopping = true;
+  pthread_cond_broadcast(&sched->wake);
+  pthread_mutex_unlock(&sched->lock);
+  for (i = 1; i < count; i++) pthread_join(sched->workers[i].thread, NULL);
+}
+
+/* Frees the deques of the first `count` workers, then `sched` itself. */
+static void destroy_scheduler(scheduler *const sched, const size_t count) {
+  size_t i;
+  for (i = 0; i < count; i++) {
+    deque_array *arr = sched->workers[i].array;
+    while (arr != NULL) {
+      deque_array *const previous = arr->previous;
+      free(arr);
+      arr = previous;
+    }
+  }
+  pthread_mutex_destroy(&sched->run_lock);
+  pthread_cond_destroy(&sched->wake);
+  pthread_mutex_destroy(&sched->lock);
+  free(sched->workers);
+  free(sched);
+}
+
+/* - LOOPS - */
+
+/*
+ * Executes a range in chunks which double in size from `min_grain`, and hands
+ * off the upper half of what remains whenever a worker is idle and this
+ * worker's deque has nothing left for it to steal.
+ */
+static void run_range(scheduler_worker *const worker, void *const arg) {
+  range_ctx *const range = arg;
+  size_t grain = range->min_grain;
+  while (range->end - range->begin > grain) {
+    const size_t REMAINING = range->end - range->begin;
+    if (REMAINING / 2 >= range->min_grain &&
+        __atomic_load_n(&worker->sched->idle, __ATOMIC_RELAXED) != 0 &&
+        deque_is_empty(worker)) {
+      range_ctx upper = *range;
+      scheduler_group group;
+      scheduler_job job;
+      upper.begin = range->begin + (REMAINING / 2);
+      range->end = upper.begin;
+      scheduler_group_init(&group);
+      scheduler_spawn(worker, &group, &job, run_range, &upper);
+      run_range(worker, range);
+      scheduler_wait(worker, &group);
+      return;
+    }
+    range->body(range->ctx, range->begin, range->begin + grain);
+    range->begin += grain;
+    if (grain <= range->max_grain / 2) grain *= 2;
+  }
+  if (range->begin != range->end)
+    range->body(range->ctx, range->begin, range->end);
+}
+
+static void run_loop(scheduler_worker *const worker, void *const arg) {
+  const range_ctx *const loop = arg;
+  scheduler_parallel_for(worker, loop->begin, loop->end, loop->min_grain,
+                         loop->body, loop->ctx);
+}
+
+/* - FUNCTIONS - */
+
+void scheduler_delete(scheduler *const sched) {
+  if (sched == NULL) return;
+  stop_workers(sched, sched->thread_count);
+  destroy_scheduler(sched, sched->thread_count);
+}
+
+void scheduler_group_init(scheduler_group *const group) { group->pending = 0; }
+
+scheduler *scheduler_new(size_t thread_count) {
+  scheduler *const sched = malloc(sizeof *sched);
+  size_t i;
+  if (sched == NULL) return NULL;
+  if (thread_count == 0) thread_count = threadpool_cpu_count();
+  sched->workers = malloc(sizeof *sched->workers * thread_count);
+  if (sched->workers == NULL) {
+    free(sched);
+    return NULL;
+  }
+  sched->thread_count = thread_count;
+  sched->idle = thread_count - 1;
+  sched->sleepers = 0;
+  sched->stopping = false;
+  pthread_mutex_init(&sched->lock, NULL);
+  pthread_cond_init(&sched->wake, NULL);
+  pthread_mutex_init(&sched->run_lock, NULL);
+  for (i = 0; i < thread_count; i++) {
+    scheduler_worker *const worker = &sched->workers[i];
+    worker->top = 0;
+    worker->bottom = 0;
+    worker->array = array_new(DEQUE_INITIAL_CAPACITY);
+    worker->sched = sched;
+    worker->index = i;
+    worker->seed = (unsigned long)i + 1;
+    if (worker->array == NULL) {
+      destroy_scheduler(sched, i);
+      return NULL;
+    }
+  }
+  for (i = 1; i < thread_count; i++) {
+    scheduler_worker *const worker = &sched->workers[i];
+    if (pthread_create(&worker->thread, NULL, worker_main, worker) != 0) {
+      stop_workers(sched, i);
+      destroy_scheduler(sched, thread_count);
+      return NULL;
+    }
+  }
+  return sched;
+}
+
+void scheduler_parallel_for(scheduler_worker *const worker, const size_t begin,
+                            const size_t end, const size_t min_grain,
+                            const scheduler_range_task body, void *const ctx) {
+  const size_t SHARES = CHUNKS_PER_THREAD * worker->sched->thread_count;
+  range_ctx range;
+  if (begin >= end) return;
+  range.body = body;
+  range.ctx = ctx;
+  range.begin = begin;
+  range.end = end;
+  range.min_grain = min_grain == 0 ? 1 : min_grain;
+  range.max_grain = (end - begin) / SHARES;
+  if (range.max_grain < range.min_grain) range.max_grain = range.min_grain;
+  run_range(worker, &range);
+}
+
+void scheduler_run(scheduler *const sched, const scheduler_task task,
+                   void *const ctx) {
+  pthread_mutex_lock(&sched->run_lock);
+  task(&sched->workers[0], ctx);
+  pthread_mutex_unlock(&sched->run_lock);
+}
+
+void scheduler_run_for(scheduler *const sched, const size_t begin,
+                       const size_t end, const size_t min_grain,
+                       const scheduler_range_task body, void *const ctx) {
+  range_ctx loop;
+  if (sched == NULL) {
+    if (begin < end) body(ctx, begin, end);
+    return;
+  }
+  loop.body = body;
+  loop.ctx = ctx;
+  loop.begin = begin;
+  loop.end = end;
+  loop.min_grain = min_grain;
+  loop.max_grain = 0;
+  scheduler_run(sched, run_loop, &loop);
+}
+
+size_t scheduler_size(const scheduler *const sched) {
+  return sched == NULL ? 1 : sched->thread_count;
+}
+
+void scheduler_spawn(scheduler_worker *const worker,
+                     scheduler_group *const group, scheduler_job *const job,
+                     const scheduler_task task, void *const ctx) {
+  scheduler *const sched = worker->sched;
+  job->task = task;
+  job->ctx = ctx;
+  job->group = group;
+  __atomic_fetch_add(&group->pending, 1, __ATOMIC_RELAXED);
+  /* A job which cannot be queued is executed on the spot instead. */
+  if (!deque_push(worker, job)) {
+    execute(worker, job);
+    return;
+  }
+  if (__atomic_load_n(&sched->sleepers, __ATOMIC_SEQ_CST) != 0) {
+    pthread_mutex_lock(&sched->lock);
+    pthread_cond_signal(&sched->wake);
+    pthread_mutex_unlock(&sched->lock);
+  }
+}
+
+void scheduler_wait(scheduler_worker *const worker,
+                    scheduler_group *const group) {
+  while (__atomic_load_n(&group->pending, __ATOMIC_ACQUIRE) != 0) {
+    scheduler_job *const job = find_job(worker);
+    if (job != NULL) {
+      execute(worker, job);
+    } else {
+      /* The rest of the group is running elsewhere. */
+      sched_yield();
+    }
+  }
+}
+
+size_t scheduler_worker_index(const scheduler_worker *const worker) {
+  return worker->index;
+}
@@ -0,0 +1,174 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stddef.h>
+
+#include "../include/myclib.h"
+
+/* - DEFINITIONS - */
+
+/*
+ * A work-stealing scheduler runs fork/join tasks on a fixed set of threads.
+ * Every thread owns a deque of spawned tasks: it pushes and pops at the
+ * bottom like a stack, so it works depth-first on the tasks it spawned most
+ * recently, while idle threads steal from the top, taking the oldest and
+ * usually largest pieces of work. The deques grow as needed, so spawning
+ * never blocks or fails.
+ *
+ * Unlike `threadpool`, tasks may spawn further tasks and wait on them, since
+ * a waiting thread keeps executing tasks instead of blocking. The thread
+ * calling `scheduler_run()` takes part as well, so a scheduler of `n` threads
+ * spawns `n - 1` workers.
+ *
+ * The scheduler is the library's parallel runtime: the parallel vector
+ * algorithms run on it, and so should any new parallel code.
+ */
+typedef struct scheduler scheduler;
+
+/*
+ * The thread executing a task. Tasks spawn and wait through the worker they
+ * are handed, which is only valid for the duration of that call.
+ */
+typedef struct scheduler_worker scheduler_worker;
+
+/* Executes a task. `ctx` is the pointer the task was spawned with. */
+typedef void (*scheduler_task)(scheduler_worker *worker, void *ctx);
+
+/* Executes the iterations `begin` through `end - 1` of a parallel loop. */
+typedef void (*scheduler_range_task)(void *ctx, size_t begin, size_t end);
+
+/*
+ * A set of spawned tasks which can be waited on together. `pending` counts
+ * the tasks which have not completed yet.
+ *
+ * Groups usually live on the spawning task's stack, and must be waited on
+ * before they go out of scope.
+ */
+typedef struct scheduler_group {
+  size_t pending;
+} scheduler_group;
+
+/*
+ * A spawned task. The scheduler refers to jobs instead of copying them, so a
+ * job must outlive the wait on its group, which it does for free when both
+ * are locals of the spawning task.
+ */
+typedef struct scheduler_job {
+  scheduler_task task;
+  void *ctx;
+  scheduler_group *group;
+} scheduler_job;
+
+/* - FUNCTIONS - */
+
+/**
+ * @brief Stops and joins a scheduler's workers, then deallocates it.
+ *
+ * @param sched The scheduler to delete, which must not be running a task.
+ */
+void scheduler_delete(scheduler *sched);
+
+/**
+ * @brief Prepares a group for spawning tasks into.
+ *
+ * @param group The group to initialize.
+ */
+void scheduler_group_init(scheduler_group *group);
+
+/**
+ * @brief Creates a scheduler and starts its workers.
+ *
+ * @param thread_count The number of threads executing tasks, including the
+ * one calling `scheduler_run()`, or `0` for `threadpool_cpu_count()`.
+ * @return The new scheduler, or `NULL` if it or any of its workers could not
+ * be created.
+ */
+scheduler *scheduler_new(size_t thread_count);
+
+/**
+ * @brief Executes a parallel loop over `begin` through `end - 1`, returning
+ * once every iteration has completed.
+ *
+ * The range is split lazily: a thread runs its part in chunks of `min_grain`
+ * iterations, doubling the chunk size each time as long as no other thread is
+ * idle, and only hands off the upper half of what remains once one is. Loops
+ * therefore cost a handful of calls to `body` when the other threads are busy,
+ * and still balance uneven iterations when they are not.
+ *
+ * @param worker The worker executing the calling task.
+ * @param begin The first iteration.
+ * @param end One past the last iteration.
+ * @param min_grain The fewest iterations worth passing to `body` at once, or
+ * `0` for `1`.
+ * @param body The function executing each chunk of iterations.
+ * @param ctx The pointer passed to `body`.
+ */
+void scheduler_parallel_for(scheduler_worker *worker, size_t begin,
+                            size_t end, size_t min_grain,
+                            scheduler_range_task body, void *ctx);
+
+/**
+ * @brief Executes a task on the calling thread with the scheduler's workers
+ * available to it, returning once the task does.
+ *
+ * Only one thread at a time may run tasks on a scheduler; concurrent calls
+ * are serialized, so tasks must not call this on the scheduler running them.
+ *
+ * @param sched The scheduler to execute the task on.
+ * @param task The task to execute.
+ * @param ctx The pointer passed to `task`.
+ */
+void scheduler_run(scheduler *sched, scheduler_task task, void *ctx);
+
+/**
+ * @brief Executes a parallel loop from outside of any task, as
+ * `scheduler_parallel_for()` does within one.
+ *
+ * If `sched` is `NULL`, the whole loop is passed to `body` at once on the
+ * calling thread.
+ */
+void scheduler_run_for(scheduler *sched, size_t begin, size_t end,
+                       size_t min_grain, scheduler_range_task body, void *ctx);
+
+/**
+ * @brief Retrieves the number of threads executing a scheduler's tasks.
+ *
+ * @param sched The scheduler to query, or `NULL`.
+ * @return The scheduler's thread count, or `1` if `sched` is `NULL`.
+ */
+size_t scheduler_size(const scheduler *sched);
+
+/**
+ * @brief Spawns a task into a group, to be executed by the spawning thread or
+ * stolen by another.
+ *
+ * @param worker The worker executing the calling task.
+ * @param group The group to add the task to.
+ * @param job Storage for the task, which must stay valid until `group` has
+ * been waited on.
+ * @param task The task to execute.
+ * @param ctx The pointer passed to `task`.
+ */
+void scheduler_spawn(scheduler_worker *worker, scheduler_group *group,
+                     scheduler_job *job, scheduler_task task, void *ctx);
+
+/**
+ * @brief Waits for every task spawned into a group to complete, executing
+ * other tasks in the meantime.
+ *
+ * @param worker The worker executing the calling task.
+ * @param group The group to wait on.
+ */
+void scheduler_wait(scheduler_worker *worker, scheduler_group *group);
+
+/**
+ * @brief Retrieves the index of a worker, which is below the scheduler's
+ * size, for indexing per-thread data.
+ *
+ * @param worker The worker to query.
+ * @return The worker's index, which is `0` for the thread calling
+ * `scheduler_run()`.
+ */
+size_t scheduler_worker_index(const scheduler_worker *worker);
+
+#endif
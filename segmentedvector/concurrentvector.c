@@ -0,0 +1,157 @@
+#include "concurrentvector.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "../include/myclib.h"
+#include "../vector/vector.h"
+#include "segmentedvector.h"
+
+#if !defined(__GNUC__) && !defined(__clang__)
+#error "Concurrent vectors require the GCC or Clang atomic builtins."
+#endif
+
+/* - INTERNAL - */
+
+/* The size of the block holding a concurrent vector's header and directory. */
+#define DIRECTORY_ALLOCATION_SIZE \
+  (sizeof(convec_header) + (sizeof(void *) * SEGVEC_MAX_CHUNKS))
+
+/* The size of chunk `chunk`, including the ready flags after its elements. */
+#define chunk_bytes(header, chunk) \
+  (((header)->elem_size + 1) * segvec_chunk_capacity(chunk))
+
+#define ready_flags(header, block, chunk) \
+  ((byte *)(block) + ((header)->elem_size * segvec_chunk_capacity(chunk)))
+
+#define ready_flags_const(header, block, chunk) \
+  ((const byte *)(block) +                      \
+   ((header)->elem_size * segvec_chunk_capacity(chunk)))
+
+/* Determines whether chunk `chunk` can be indexed and its size represented. */
+static bool is_allocatable(const convec_header *const header,
+                           const size_t chunk) {
+  return chunk + 1 < SEGVEC_MAX_CHUNKS &&
+         segvec_chunk_capacity(chunk) <= (size_t)-1 / (header->elem_size + 1);
+}
+
+/*
+ * Returns chunk `chunk`, allocating and installing it first if no thread has
+ * yet. A thread losing the race to install it frees its own and uses the
+ * winner's. Returns `NULL` if the chunk could not be allocated.
+ */
+static void *acquire_chunk(void *const vec, const size_t chunk) {
+  void **const directory = vec;
+  const convec_header *const header = convec_header_const(vec);
+  void *block = __atomic_load_n(&directory[chunk], __ATOMIC_ACQUIRE);
+  void *installed = NULL;
+  if (block != NULL) return block;
+  if (!is_allocatable(header, chunk)) return NULL;
+  block = myclib_alloc(header->allocator, chunk_bytes(header, chunk));
+  if (block == NULL) return NULL;
+  memset(ready_flags(header, block, chunk), 0, segvec_chunk_capacity(chunk));
+  if (__atomic_compare_exchange_n(&directory[chunk], &installed, block, false,
+                                  __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+    return block;
+  myclib_free(header->allocator, block, chunk_bytes(header, chunk));
+  return installed;
+}
+
+/* - FUNCTIONS - */
+
+void concurrent_vector_untyped_delete(void *const vec) {
+  void *const *const directory = vec;
+  convec_header *const header = convec_header(vec);
+  const myclib_allocator *const allocator = header->allocator;
+  size_t chunk;
+  for (chunk = 0; chunk < SEGVEC_MAX_CHUNKS; chunk++)
+    if (directory[chunk] != NULL)
+      myclib_free(allocator, directory[chunk], chunk_bytes(header, chunk));
+  myclib_free(allocator, header, DIRECTORY_ALLOCATION_SIZE);
+}
+
+size_t concurrent_vector_untyped_for_each_chunk(void *const vec,
+                                                const vec_chunk_op op,
+                                                void *const args) {
+  void *const *const directory = vec;
+  const size_t LENGTH = concurrent_vector_untyped_snapshot(vec);
+  size_t remaining = LENGTH;
+  size_t chunk;
+  for (chunk = 0; remaining != 0; chunk++) {
+    const size_t CAPACITY = segvec_chunk_capacity(chunk);
+    const size_t COUNT = remaining < CAPACITY ? remaining : CAPACITY;
+    op(directory[chunk], COUNT, args);
+    remaining -= COUNT;
+  }
+  return LENGTH;
+}
+
+void *concurrent_vector_untyped_new_with(
+    const myclib_allocator *const allocator, const size_t elem_size) {
+  convec_header *const header =
+      myclib_alloc(allocator, DIRECTORY_ALLOCATION_SIZE);
+  if (header == NULL) return NULL;
+  header->claimed = 0;
+  header->published = 0;
+  header->allocator = allocator;
+  header->elem_size = elem_size;
+  memset(header + 1, 0, sizeof(void *) * SEGVEC_MAX_CHUNKS);
+  return header + 1;
+}
+
+size_t concurrent_vector_untyped_push(void *const vec, const void *const elem) {
+  convec_header *const header = convec_header(vec);
+  const size_t INDEX =
+      __atomic_fetch_add(&header->claimed, 1, __ATOMIC_RELAXED);
+  const size_t CHUNK = segvec_chunk_of(INDEX);
+  const size_t OFFSET = segvec_offset_of(INDEX);
+  byte *const block = acquire_chunk(vec, CHUNK);
+  if (block == NULL) return VEC_BAD_INDEX;
+  memcpy(block + (OFFSET * header->elem_size), elem, header->elem_size);
+  __atomic_store_n(&ready_flags(header, block, CHUNK)[OFFSET], 1,
+                   __ATOMIC_RELEASE);
+  return INDEX;
+}
+
+void *concurrent_vector_untyped_reserve(void *const vec,
+                                        const size_t capacity) {
+  size_t chunk;
+  if (capacity == 0) return vec;
+  if (capacity > (size_t)-1 - segvec_chunk_capacity(0)) return NULL;
+  for (chunk = 0; chunk <= segvec_chunk_of(capacity - 1); chunk++)
+    if (acquire_chunk(vec, chunk) == NULL) return NULL;
+  return vec;
+}
+
+size_t concurrent_vector_untyped_snapshot(void *const vec) {
+  void **const directory = vec;
+  convec_header *const header = convec_header(vec);
+  const size_t CLAIMED = __atomic_load_n(&header->claimed, __ATOMIC_RELAXED);
+  size_t published = __atomic_load_n(&header->published, __ATOMIC_ACQUIRE);
+  size_t length = published;
+  /* Resumes from the longest snapshot yet, one chunk at a time. */
+  while (length < CLAIMED) {
+    const size_t CHUNK = segvec_chunk_of(length);
+    const size_t START = segvec_total_capacity(CHUNK);
+    const size_t END = segvec_total_capacity(CHUNK + 1) < CLAIMED
+                           ? segvec_total_capacity(CHUNK + 1)
+                           : CLAIMED;
+    const byte *const block =
+        __atomic_load_n(&directory[CHUNK], __ATOMIC_ACQUIRE);
+    const byte *flags;
+    if (block == NULL) break;
+    flags = ready_flags_const(header, block, CHUNK);
+    while (length < END &&
+           __atomic_load_n(&flags[length - START], __ATOMIC_ACQUIRE))
+      length++;
+    if (length < END) break;
+  }
+  /* Other threads may have advanced it further meanwhile. */
+  for (;;) {
+    if (published >= length ||
+        __atomic_compare_exchange_n(&header->published, &published, length,
+                                    true, __ATOMIC_RELEASE, __ATOMIC_ACQUIRE))
+      break;
+  }
+  return length;
+}
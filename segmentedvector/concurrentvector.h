@@ -0,0 +1,122 @@
+#ifndef CONCURRENT_VECTOR_H
+#define CONCURRENT_VECTOR_H
+
+#include <stddef.h>
+
+#include "../include/myclib.h"
+#include "../vector/vector.h"
+#include "segmentedvector.h"
+
+/* - DEFINITIONS - */
+
+/*
+ * A concurrent vector may be pushed to by any number of threads at once
+ * without locking. Each push claims the next slot with an atomic increment,
+ * fills it, then marks it ready, so pushes only contend on that one counter.
+ *
+ * Slots live in chunks laid out as those of a `segmented_vector`, reached
+ * through a directory that follows the header, and never move once written.
+ * A thread needing a chunk nobody has allocated yet allocates it and installs
+ * it with a compare-and-swap, so the allocator must be safe to call from
+ * several threads at once.
+ *
+ * Since slots are filled out of order, readers work on a snapshot: the
+ * longest run of ready slots from the start, every one of which may be read
+ * while pushes carry on. A `concurrent_vector(type)` may be indexed as
+ * `vec[chunk][offset]` like a `segmented_vector(type)`.
+ */
+#define concurrent_vector(type) type **
+
+/* - INTERNAL USE ONLY - */
+
+/*
+ *  `claimed`   - The number of slots handed out to pushes so far, some of
+ *                which may not be ready yet.
+ * `published`  - The length of the longest snapshot taken so far, from which
+ *                the next one resumes scanning.
+ * `allocator`  - The allocator owning the vector's memory, or `NULL` if the
+ *                standard library's allocation functions are used.
+ * `elem_size`  - The size of the vector's elements.
+ *
+ * The directory of `SEGVEC_MAX_CHUNKS` chunk pointers follows the header. Each
+ * chunk holds its elements followed by a ready flag for each of them.
+ */
+typedef struct convec_header {
+  size_t claimed;
+  size_t published;
+  const myclib_allocator *allocator;
+  size_t elem_size;
+} convec_header;
+
+#define convec_header(vec) ((convec_header *)(vec) - 1)
+
+#define convec_header_const(vec) ((const convec_header *)(vec) - 1)
+
+/* - CONVENIENCE MACROS - */
+
+#define concurrent_vector_allocator(vec) (convec_header_const(vec)->allocator)
+
+#define concurrent_vector_delete(vec) \
+  ((void)(concurrent_vector_untyped_delete((void *)(vec)), (vec) = NULL))
+
+#define concurrent_vector_for_each_chunk(vec, op, args) \
+  concurrent_vector_untyped_for_each_chunk((void *)(vec), op, args)
+
+/* `index` must be below the length of a snapshot already taken. */
+#define concurrent_vector_get(vec, index) \
+  ((vec)[segvec_chunk_of((size_t)(index))][segvec_offset_of((size_t)(index))])
+
+#define concurrent_vector_new(type) \
+  ((type **)concurrent_vector_untyped_new_with(NULL, sizeof(type)))
+
+#define concurrent_vector_new_with(allocator, type) \
+  ((type **)concurrent_vector_untyped_new_with(allocator, sizeof(type)))
+
+/* `elem` must be an lvalue. */
+#define concurrent_vector_push(vec, elem) \
+  concurrent_vector_untyped_push((void *)(vec), &(elem))
+
+#define concurrent_vector_reserve(vec, capacity) \
+  concurrent_vector_untyped_reserve((void *)(vec), capacity)
+
+#define concurrent_vector_snapshot(vec) \
+  concurrent_vector_untyped_snapshot((void *)(vec))
+
+/* - FUNCTIONS - */
+
+/* Must not be called while any other thread is using `vec`. */
+void concurrent_vector_untyped_delete(void *vec);
+
+/*
+ * Takes a snapshot, then applies `op` to the elements of each chunk within it
+ * in order. Returns the length of the snapshot.
+ */
+size_t concurrent_vector_untyped_for_each_chunk(void *vec, vec_chunk_op op,
+                                                void *args);
+
+void *concurrent_vector_untyped_new_with(const myclib_allocator *allocator,
+                                         size_t elem_size);
+
+/*
+ * Copies `elem` into a newly claimed slot and marks it ready, returning the
+ * slot's index, or `VEC_BAD_INDEX` if its chunk could not be allocated. The
+ * slot claimed by a failed push is never marked ready, so snapshots never
+ * reach past it; reserving capacity up front avoids this.
+ */
+size_t concurrent_vector_untyped_push(void *vec, const void *elem);
+
+/*
+ * Allocates chunks until `vec` holds at least `capacity` slots, returning
+ * `vec`, or `NULL` if a chunk could not be allocated. This may be called while
+ * other threads push.
+ */
+void *concurrent_vector_untyped_reserve(void *vec, size_t capacity);
+
+/*
+ * Returns the number of slots from the start which are all ready. A push which
+ * completed before the call is included unless an earlier slot is still being
+ * filled. The elements of the snapshot may be read until `vec` is deleted.
+ */
+size_t concurrent_vector_untyped_snapshot(void *vec);
+
+#endif
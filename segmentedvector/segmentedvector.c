@@ -0,0 +1,140 @@
+#include "segmentedvector.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "../include/myclib.h"
+#include "../vector/vector.h"
+
+/* - INTERNAL - */
+
+#define chunk_bytes(header, chunk) \
+  ((header)->elem_size * segvec_chunk_capacity(chunk))
+
+/* The size of the block holding a segmented vector's header and directory. */
+#define DIRECTORY_ALLOCATION_SIZE \
+  (sizeof(segvec_header) + (sizeof(void *) * SEGVEC_MAX_CHUNKS))
+
+static void *element_at(void *const vec, const size_t index) {
+  void *const *const directory = vec;
+  return (byte *)directory[segvec_chunk_of(index)] +
+         (segvec_header(vec)->elem_size * segvec_offset_of(index));
+}
+
+/* Hints that the first lines of chunk `chunk` will be read soon, if any. */
+static void prefetch_chunk(void *const vec, const size_t chunk) {
+  void *const *const directory = vec;
+  const segvec_header *const header = segvec_header_const(vec);
+  size_t line;
+  if (chunk >= header->chunk_count) return;
+  for (line = 0; line < SEGVEC_PREFETCH_LINES; line++) {
+    const size_t OFFSET = line * VEC_CACHE_LINE_SIZE;
+    if (OFFSET >= chunk_bytes(header, chunk)) break;
+    segvec_prefetch((const byte *)directory[chunk] + OFFSET);
+  }
+}
+
+/* - FUNCTIONS - */
+
+void segmented_vector_untyped_delete(void *const vec) {
+  void *const *const directory = vec;
+  segvec_header *const header = segvec_header(vec);
+  const myclib_allocator *const allocator = header->allocator;
+  size_t chunk;
+  for (chunk = 0; chunk < header->chunk_count; chunk++)
+    myclib_free(allocator, directory[chunk], chunk_bytes(header, chunk));
+  myclib_free(allocator, header, DIRECTORY_ALLOCATION_SIZE);
+}
+
+void segmented_vector_untyped_for_each(void *const vec,
+                                       const vec_for_each_op op,
+                                       void *const args) {
+  void *const *const directory = vec;
+  const segvec_header *const header = segvec_header_const(vec);
+  void *arg_list[3];
+  size_t remaining = header->length;
+  size_t chunk;
+  arg_list[0] = vec;
+  arg_list[2] = args;
+  for (chunk = 0; remaining != 0; chunk++) {
+    const size_t CAPACITY = segvec_chunk_capacity(chunk);
+    const size_t COUNT = remaining < CAPACITY ? remaining : CAPACITY;
+    byte *const elems = directory[chunk];
+    size_t i;
+    prefetch_chunk(vec, chunk + 1);
+    for (i = 0; i < COUNT; i++) {
+      arg_list[1] = elems + (i * header->elem_size);
+      op(arg_list);
+    }
+    remaining -= COUNT;
+  }
+}
+
+void segmented_vector_untyped_for_each_chunk(void *const vec,
+                                             const vec_chunk_op op,
+                                             void *const args) {
+  void *const *const directory = vec;
+  size_t remaining = segmented_vector_length(vec);
+  size_t chunk;
+  for (chunk = 0; remaining != 0; chunk++) {
+    const size_t CAPACITY = segvec_chunk_capacity(chunk);
+    const size_t COUNT = remaining < CAPACITY ? remaining : CAPACITY;
+    prefetch_chunk(vec, chunk + 1);
+    op(directory[chunk], COUNT, args);
+    remaining -= COUNT;
+  }
+}
+
+void *segmented_vector_untyped_get(void *const vec, const size_t index) {
+  util_assert(index < segmented_vector_length(vec));
+  return element_at(vec, index);
+}
+
+void *segmented_vector_untyped_new_with(const myclib_allocator *const allocator,
+                                        const size_t elem_size) {
+  segvec_header *const header =
+      myclib_alloc(allocator, DIRECTORY_ALLOCATION_SIZE);
+  if (header == NULL) return NULL;
+  header->length = 0;
+  header->chunk_count = 0;
+  header->allocator = allocator;
+  header->elem_size = elem_size;
+  memset(header + 1, 0, sizeof(void *) * SEGVEC_MAX_CHUNKS);
+  return header + 1;
+}
+
+void *segmented_vector_untyped_pop(void *const vec) {
+  util_assert(!segmented_vector_is_empty(vec));
+  return element_at(vec, --segvec_header(vec)->length);
+}
+
+void *segmented_vector_untyped_push(void *const vec, const void *const elem) {
+  segvec_header *const header = segvec_header(vec);
+  void *slot;
+  if (segmented_vector_untyped_reserve(vec, header->length + 1) == NULL)
+    return NULL;
+  slot = element_at(vec, header->length++);
+  memcpy(slot, elem, header->elem_size);
+  return slot;
+}
+
+void *segmented_vector_untyped_reserve(void *const vec, const size_t capacity) {
+  void **const directory = vec;
+  segvec_header *const header = segvec_header(vec);
+  size_t last_chunk;
+  if (capacity <= segvec_total_capacity(header->chunk_count)) return vec;
+  /* Refuses capacities whose chunks could never be indexed or allocated. */
+  if (capacity > (size_t)-1 - segvec_chunk_capacity(0)) return NULL;
+  last_chunk = segvec_chunk_of(capacity - 1);
+  if (last_chunk + 1 >= SEGVEC_MAX_CHUNKS ||
+      segvec_chunk_capacity(last_chunk) > (size_t)-1 / header->elem_size)
+    return NULL;
+  while (header->chunk_count <= last_chunk) {
+    const size_t CHUNK = header->chunk_count;
+    directory[CHUNK] =
+        myclib_alloc(header->allocator, chunk_bytes(header, CHUNK));
+    if (directory[CHUNK] == NULL) return NULL;
+    header->chunk_count++;
+  }
+  return vec;
+}
@@ -0,0 +1,200 @@
+#ifndef SEGMENTED_VECTOR_H
+#define SEGMENTED_VECTOR_H
+
+#include <limits.h>
+#include <stddef.h>
+
+#include "../include/myclib.h"
+#include "../vector/vector.h"
+
+/* - DEFINITIONS - */
+
+/*
+ * A segmented vector stores its elements in chunks rather than one contiguous
+ * block. The first chunk holds `1 << SEGVEC_FIRST_CHUNK_SHIFT` elements and
+ * each following chunk holds twice as many as the one before it, so the
+ * vector's capacity doubles with every chunk added, as a `vector`'s would.
+ *
+ * Growing never moves existing elements, so pointers to them remain valid
+ * until they are removed or the vector is deleted. Chunks are found through a
+ * fixed-size directory, which lets any element be reached in O(1) time.
+ *
+ * A `segmented_vector(type)` points at that directory and may be indexed as
+ * `vec[chunk][offset]`; `segmented_vector_get()` computes both indices.
+ */
+#define segmented_vector(type) type **
+
+#ifndef SEGVEC_FIRST_CHUNK_SHIFT
+#define SEGVEC_FIRST_CHUNK_SHIFT (4)
+#endif
+
+/* The number of chunks needed for the largest possible segmented vector. */
+#define SEGVEC_MAX_CHUNKS \
+  (sizeof(size_t) * CHAR_BIT - SEGVEC_FIRST_CHUNK_SHIFT)
+
+/* The number of cache lines of the next chunk fetched ahead of iteration. */
+#define SEGVEC_PREFETCH_LINES ((size_t)4)
+
+/* - INTERNAL USE ONLY - */
+
+/*
+ *    `length`     - The number of elements currently held.
+ * `chunk_count`   - The number of chunks allocated, all of which are in use
+ *                   except possibly the last few.
+ *  `allocator`    - The allocator owning the vector's memory, or `NULL` if the
+ *                   standard library's allocation functions are used.
+ *  `elem_size`    - The size of the vector's elements.
+ *
+ * The directory of `SEGVEC_MAX_CHUNKS` chunk pointers follows the header.
+ */
+typedef struct segvec_header {
+  size_t length;
+  size_t chunk_count;
+  const myclib_allocator *allocator;
+  size_t elem_size;
+} segvec_header;
+
+#define segvec_header(vec) ((segvec_header *)(vec) - 1)
+
+#define segvec_header_const(vec) ((const segvec_header *)(vec) - 1)
+
+/* The number of elements held by chunk `chunk`. */
+#define segvec_chunk_capacity(chunk) \
+  ((size_t)1 << (SEGVEC_FIRST_CHUNK_SHIFT + (chunk)))
+
+/* The total number of elements held by the first `chunk_count` chunks. */
+#define segvec_total_capacity(chunk_count) \
+  (segvec_chunk_capacity(chunk_count) - segvec_chunk_capacity(0))
+
+#define segvec_chunk_of(index)                              \
+  (segvec_highest_bit((index) + segvec_chunk_capacity(0)) - \
+   SEGVEC_FIRST_CHUNK_SHIFT)
+
+#define segvec_offset_of(index)         \
+  ((index) + segvec_chunk_capacity(0) - \
+   ((size_t)1 << segvec_highest_bit((index) + segvec_chunk_capacity(0))))
+
+#if defined(__GNUC__) || defined(__clang__)
+#define segvec_prefetch(addr) __builtin_prefetch(addr)
+#else
+#define segvec_prefetch(addr) ((void)(addr))
+#endif
+
+/* Returns the position of the most significant bit set in `n`, if any. */
+static inline size_t segvec_highest_bit(size_t n) {
+#if defined(__GNUC__) || defined(__clang__)
+  return sizeof(unsigned long) >= sizeof(size_t)
+             ? (size_t)(sizeof(unsigned long) * CHAR_BIT - 1 -
+                        (size_t)__builtin_clzl((unsigned long)n))
+             : (size_t)(sizeof(vec_u64) * CHAR_BIT - 1 -
+                        (size_t)__builtin_clzll((vec_u64)n));
+#else
+  size_t position = 0;
+  while (n >>= 1) position++;
+  return position;
+#endif
+}
+
+/* - CONVENIENCE MACROS - */
+
+/*
+ * All "_s" variants of the below macros do not evaluate their arguments more
+ * than once.
+ */
+
+#define segmented_vector_allocator(vec) (segvec_header_const(vec)->allocator)
+
+#define segmented_vector_capacity(vec) \
+  segvec_total_capacity(segvec_header_const(vec)->chunk_count)
+
+#define segmented_vector_delete(vec) \
+  ((void)(segmented_vector_untyped_delete((void *)(vec)), (vec) = NULL))
+
+#define segmented_vector_for_each_s(vec, op, args) \
+  segmented_vector_untyped_for_each((void *)(vec), op, args)
+
+#define segmented_vector_for_each_chunk(vec, op, args) \
+  segmented_vector_untyped_for_each_chunk((void *)(vec), op, args)
+
+#define segmented_vector_get(vec, index)                              \
+  ((vec)[util_assert((size_t)(index) < segmented_vector_length(vec)), \
+         segvec_chunk_of((size_t)(index))][segvec_offset_of((size_t)(index))])
+
+#define segmented_vector_get_s(vec, index) \
+  segmented_vector_untyped_get((void *)(vec), index)
+
+#define segmented_vector_is_empty(vec) (segmented_vector_length(vec) == 0)
+
+#define segmented_vector_length(vec) (+segvec_header_const(vec)->length)
+
+#define segmented_vector_new(type) \
+  ((type **)segmented_vector_untyped_new_with(NULL, sizeof(type)))
+
+#define segmented_vector_new_with(allocator, type) \
+  ((type **)segmented_vector_untyped_new_with(allocator, sizeof(type)))
+
+#define segmented_vector_pop(vec)                       \
+  (util_assert(!segmented_vector_is_empty(vec)),        \
+   (void)segvec_header(vec)->length--,                  \
+   (vec)[segvec_chunk_of(segmented_vector_length(vec))] \
+        [segvec_offset_of(segmented_vector_length(vec))])
+
+#define segmented_vector_pop_s(vec) \
+  segmented_vector_untyped_pop((void *)(vec))
+
+#define segmented_vector_push(vec, elem)                                     \
+  (inline_if(segmented_vector_length(vec) == segmented_vector_capacity(vec), \
+             segmented_vector_untyped_reserve(                               \
+                 (void *)(vec), segmented_vector_length(vec) + 1),           \
+             NULL),                                                          \
+   util_assert(segmented_vector_capacity(vec) >                              \
+               segmented_vector_length(vec)),                                \
+   (void)segvec_header(vec)->length++,                                       \
+   segmented_vector_get(vec, segmented_vector_length(vec) - 1) = (elem))
+
+#define segmented_vector_push_s(vec, elem) \
+  segmented_vector_untyped_push((void *)(vec), &(elem))
+
+#define segmented_vector_reserve(vec, capacity) \
+  segmented_vector_untyped_reserve((void *)(vec), capacity)
+
+/* - FUNCTIONS - */
+
+void segmented_vector_untyped_delete(void *vec);
+
+/*
+ * Applies `op` to every element in order, passing it the same arguments as
+ * `vector_for_each_s()` would with `vec` as the vector. Upcoming chunks are
+ * prefetched while the current one is visited.
+ */
+void segmented_vector_untyped_for_each(void *vec, vec_for_each_op op,
+                                       void *args);
+
+/*
+ * Applies `op` to each chunk's elements in order, which avoids a call per
+ * element.
+ */
+void segmented_vector_untyped_for_each_chunk(void *vec, vec_chunk_op op,
+                                             void *args);
+
+void *segmented_vector_untyped_get(void *vec, size_t index);
+
+void *segmented_vector_untyped_new_with(const myclib_allocator *allocator,
+                                        size_t elem_size);
+
+/* Returns the element removed, which remains valid until the next push. */
+void *segmented_vector_untyped_pop(void *vec);
+
+/*
+ * Returns the element pushed, or `NULL` if a chunk was needed and could not be
+ * allocated.
+ */
+void *segmented_vector_untyped_push(void *vec, const void *elem);
+
+/*
+ * Allocates chunks until `vec` can hold at least `capacity` elements,
+ * returning `vec`, or `NULL` if a chunk could not be allocated.
+ */
+void *segmented_vector_untyped_reserve(void *vec, size_t capacity);
+
+#endif
@@ -0,0 +1,211 @@
+#include "concurrentstack.h"
+
+#include <stddef.h>
+
+#include "../include/myclib.h"
+
+#if !defined(__GNUC__) && !defined(__clang__)
+#error "The concurrent stack requires the GCC or Clang atomic builtins."
+#endif
+
+/* - DEFINITIONS - */
+
+#define CACHE_LINE ((size_t)64)
+
+/* The most slots of the elimination array in use at once. A power of two. */
+#define ELIMINATION_SLOTS ((size_t)8)
+
+/* The number of times a waiting push checks for a pop before withdrawing. */
+#define ELIMINATION_SPINS (128)
+
+/*
+ * `__atomic_compare_exchange()` on a pair of words is left to libatomic, so
+ * the legacy builtin is used instead, which compiles to one instruction.
+ */
+#if defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16) && __SIZEOF_POINTER__ == 8
+__extension__ typedef unsigned __int128 top_word;
+#elif defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_8) && __SIZEOF_POINTER__ == 4
+__extension__ typedef unsigned long long top_word;
+#else
+#error "The concurrent stack requires a double-width compare-and-swap."
+#endif
+
+/*
+ * `node` - The top node, or `NULL` if the stack is empty.
+ * `tag`  - The number of times the top has been replaced.
+ *
+ * The halves are loaded separately, so a pair read while the top changed may
+ * be torn; the compare-and-swap of the whole `word` then simply fails.
+ */
+typedef union tagged_top {
+  struct {
+    concurrent_stack_node *node;
+    size_t tag;
+  } half;
+  top_word word;
+} tagged_top;
+
+/*
+ *     `top`     - The top of the stack and its tag, on a cache line of its
+ *                 own.
+ *    `slots`    - The elimination array. Each slot holds a node a push is
+ *                 waiting to hand to a pop, or `NULL`.
+ *  `allocator`  - The allocator owning the stack's memory, or `NULL` if the
+ *                 standard library's allocation functions are used.
+ * `block_offset` - The offset of the stack within its block, which is
+ *                  allocated a cache line larger than needed so that the
+ *                  stack can be aligned to one.
+ */
+struct concurrent_stack {
+  tagged_top top;
+  byte top_padding[CACHE_LINE - sizeof(tagged_top)];
+  concurrent_stack_node *slots[ELIMINATION_SLOTS];
+  const myclib_allocator *allocator;
+  size_t block_offset;
+};
+
+#define allocation_size() (sizeof(concurrent_stack) + CACHE_LINE)
+
+/* - INTERNAL - */
+
+static tagged_top load_top(concurrent_stack *const stk) {
+  tagged_top top;
+  top.half.tag = __atomic_load_n(&stk->top.half.tag, __ATOMIC_ACQUIRE);
+  top.half.node = __atomic_load_n(&stk->top.half.node, __ATOMIC_ACQUIRE);
+  return top;
+}
+
+/* Replaces the top with `node` if it still is `expected`. */
+static bool replace_top(concurrent_stack *const stk, const tagged_top expected,
+                        concurrent_stack_node *const node) {
+  tagged_top desired;
+  desired.half.node = node;
+  desired.half.tag = expected.half.tag + 1;
+  return __sync_bool_compare_and_swap(&stk->top.word, expected.word,
+                                      desired.word);
+}
+
+/*
+ * The slot used after `attempt` failed compare-and-swaps on a top tagged
+ * `tag`. Threads contending on the same top have read similar tags, so they
+ * start out on the same few slots and only spread over more of them as their
+ * retries mount.
+ */
+static size_t slot_index(const size_t tag, const size_t attempt) {
+  const size_t WIDTH = attempt < ELIMINATION_SLOTS ? attempt + 1
+                                                   : ELIMINATION_SLOTS;
+  return (tag + attempt) % WIDTH;
+}
+
+/*
+ * Offers `node` to a pop in the elimination array, returning `true` if one
+ * took it, in which case the push is complete.
+ */
+static bool eliminate_push(concurrent_stack *const stk,
+                           concurrent_stack_node *const node,
+                           const size_t slot) {
+  concurrent_stack_node **const offer = &stk->slots[slot];
+  concurrent_stack_node *expected = NULL;
+  int spins;
+  if (!__atomic_compare_exchange_n(offer, &expected, node, false,
+                                   __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+    return false;
+  for (spins = 0; spins < ELIMINATION_SPINS; spins++)
+    if (__atomic_load_n(offer, __ATOMIC_RELAXED) != node) return true;
+  /* A pop took the node after all if it is no longer there to withdraw. */
+  expected = node;
+  return !__atomic_compare_exchange_n(offer, &expected, NULL, false,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+}
+
+/* Takes a node offered by a push in the elimination array, if there is one. */
+static concurrent_stack_node *eliminate_pop(concurrent_stack *const stk,
+                                            const size_t slot) {
+  concurrent_stack_node **const offer = &stk->slots[slot];
+  concurrent_stack_node *node = __atomic_load_n(offer, __ATOMIC_RELAXED);
+  if (node == NULL ||
+      !__atomic_compare_exchange_n(offer, &node, NULL, false,
+                                   __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+    return NULL;
+  return node;
+}
+
+/* - FUNCTIONS - */
+
+void concurrent_stack_delete(concurrent_stack *const stk) {
+  if (stk == NULL) return;
+  myclib_free(stk->allocator, (byte *)stk - stk->block_offset,
+              allocation_size());
+}
+
+bool concurrent_stack_is_empty(const concurrent_stack *const stk) {
+  return __atomic_load_n(&stk->top.half.node, __ATOMIC_ACQUIRE) == NULL;
+}
+
+void concurrent_stack_link(concurrent_stack_node *const node,
+                           concurrent_stack_node *const next) {
+  __atomic_store_n(&node->next, next, __ATOMIC_RELAXED);
+}
+
+concurrent_stack *concurrent_stack_new(void) {
+  return concurrent_stack_new_with(NULL);
+}
+
+concurrent_stack *concurrent_stack_new_with(
+    const myclib_allocator *const allocator) {
+  byte *const block = myclib_alloc(allocator, allocation_size());
+  concurrent_stack *stk;
+  size_t offset;
+  size_t i;
+  if (block == NULL) return NULL;
+  offset = (CACHE_LINE - ((size_t)block % CACHE_LINE)) % CACHE_LINE;
+  stk = (concurrent_stack *)(void *)(block + offset);
+  stk->top.half.node = NULL;
+  stk->top.half.tag = 0;
+  for (i = 0; i < ELIMINATION_SLOTS; i++) stk->slots[i] = NULL;
+  stk->allocator = allocator;
+  stk->block_offset = offset;
+  return stk;
+}
+
+concurrent_stack_node *concurrent_stack_pop(concurrent_stack *const stk) {
+  size_t attempt;
+  for (attempt = 0;; attempt++) {
+    const tagged_top TOP = load_top(stk);
+    concurrent_stack_node *node;
+    if (TOP.half.node == NULL) return NULL;
+    /* The node may already have been popped, and even pushed back since. */
+    node = __atomic_load_n(&TOP.half.node->next, __ATOMIC_RELAXED);
+    if (replace_top(stk, TOP, node)) return TOP.half.node;
+    node = eliminate_pop(stk, slot_index(TOP.half.tag, attempt));
+    if (node != NULL) return node;
+  }
+}
+
+concurrent_stack_node *concurrent_stack_pop_all(concurrent_stack *const stk) {
+  for (;;) {
+    const tagged_top TOP = load_top(stk);
+    if (TOP.half.node == NULL) return NULL;
+    if (replace_top(stk, TOP, NULL)) return TOP.half.node;
+  }
+}
+
+void concurrent_stack_push(concurrent_stack *const stk,
+                           concurrent_stack_node *const node) {
+  concurrent_stack_push_chain(stk, node, node);
+}
+
+void concurrent_stack_push_chain(concurrent_stack *const stk,
+                                 concurrent_stack_node *const first,
+                                 concurrent_stack_node *const last) {
+  size_t attempt;
+  for (attempt = 0;; attempt++) {
+    const tagged_top TOP = load_top(stk);
+    concurrent_stack_link(last, TOP.half.node);
+    if (replace_top(stk, TOP, first)) return;
+    /* Only single nodes can be handed straight to a pop. */
+    if (first == last &&
+        eliminate_push(stk, first, slot_index(TOP.half.tag, attempt)))
+      return;
+  }
+}
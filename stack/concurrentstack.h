@@ -0,0 +1,91 @@
+#ifndef CONCURRENT_STACK_H
+#define CONCURRENT_STACK_H
+
+#include <stddef.h>
+
+#include "../include/myclib.h"
+
+/* - DEFINITIONS - */
+
+/*
+ * A concurrent stack may be pushed to and popped from by any number of threads
+ * at once without locking. It is a Treiber stack: a linked list whose top is
+ * replaced with a compare-and-swap.
+ *
+ * Unlike `stack(type)`, it holds no values of its own. Nodes are embedded in
+ * the caller's structures and linked through them, which suits free lists and
+ * other pools of preallocated objects. `concurrent_stack_entry()` recovers the
+ * structure from a popped node.
+ *
+ * The top carries a tag which every successful update increments, and both
+ * are replaced by one double-width compare-and-swap. A pop which read a node
+ * that was popped and pushed back in the meantime therefore fails instead of
+ * installing a stale successor (the ABA problem). On x86-64 this requires
+ * `cmpxchg16b`, enabled with `-mcx16`.
+ *
+ * Under contention, a push or pop whose compare-and-swap fails turns to a
+ * small elimination array, where a push and a pop arriving at the same slot
+ * cancel out without touching the top at all.
+ *
+ * A popper may still read a node's `next` after another thread popped it, so
+ * nodes may be reused freely once popped but must stay allocated for as long
+ * as any thread may be popping from the stack.
+ */
+typedef struct concurrent_stack concurrent_stack;
+
+typedef struct concurrent_stack_node {
+  struct concurrent_stack_node *next;
+} concurrent_stack_node;
+
+/* - CONVENIENCE MACROS - */
+
+/* The `type` structure whose `member` node is `node`. */
+#define concurrent_stack_entry(node, type, member) \
+  ((type *)(void *)((byte *)(node) - offsetof(type, member)))
+
+/* - FUNCTIONS - */
+
+/*
+ * Must not be called while any other thread is using `stk`. The nodes still
+ * on the stack are left untouched.
+ */
+void concurrent_stack_delete(concurrent_stack *stk);
+
+/* Returns `true` if `stk` held no nodes at the moment it was checked. */
+bool concurrent_stack_is_empty(const concurrent_stack *stk);
+
+/*
+ * Sets `node->next` to `next`, for building chains to push. A pop which lost
+ * a race may still be reading the `next` of a node the caller has since
+ * popped, so links written through here keep that read well defined.
+ */
+void concurrent_stack_link(concurrent_stack_node *node,
+                           concurrent_stack_node *next);
+
+concurrent_stack *concurrent_stack_new(void);
+
+/* Returns an empty stack, or `NULL` if it could not be allocated. */
+concurrent_stack *concurrent_stack_new_with(const myclib_allocator *allocator);
+
+/* Returns the top node, or `NULL` if the stack is empty. */
+concurrent_stack_node *concurrent_stack_pop(concurrent_stack *stk);
+
+/*
+ * Empties the stack in one step, returning its former top node, from which
+ * the rest follow through `next`, or `NULL` if it was already empty.
+ */
+concurrent_stack_node *concurrent_stack_pop_all(concurrent_stack *stk);
+
+void concurrent_stack_push(concurrent_stack *stk, concurrent_stack_node *node);
+
+/*
+ * Pushes a chain of nodes built by the caller in one step, leaving `first` on
+ * top. `last` must be reachable from `first` through `next`, and its own
+ * `next` is overwritten. Chains should be linked with
+ * `concurrent_stack_link()`.
+ */
+void concurrent_stack_push_chain(concurrent_stack *stk,
+                                 concurrent_stack_node *first,
+                                 concurrent_stack_node *last);
+
+#endif
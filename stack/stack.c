@@ -8,13 +8,18 @@
 inline void *stack_untyped_copy(const void *const stk,
                                 const size_t value_size) {
   const size_t ALLOCATION =
-      (value_size * stack_capacity(stk)) + sizeof(stack_header);
-  stack_header *const new_stk = malloc(ALLOCATION);
+      stack_allocation_size(value_size, stack_capacity(stk));
+  stack_header *const new_stk = myclib_alloc(stack_allocator(stk), ALLOCATION);
   if (new_stk == NULL) return NULL;
   memcpy(new_stk, const_stack_header(stk), ALLOCATION);
   return new_stk + 1;
 }
 
+inline void stack_untyped_delete(void *const stk, const size_t value_size) {
+  myclib_free(stack_allocator(stk), stack_header(stk),
+              stack_allocation_size(value_size, stack_capacity(stk)));
+}
+
 inline void *stack_untyped_expand(void **const stk, const size_t value_size) {
   const size_t CAPACITY = stack_capacity(*stk);
   void *attempt = NULL;
@@ -31,11 +36,19 @@ inline bool stack_untyped_is_full(const void *const stk) {
 }
 
 inline void *stack_untyped_new(const size_t capacity, const size_t value_size) {
+  return stack_untyped_new_with(NULL, capacity, value_size);
+}
+
+inline void *stack_untyped_new_with(const myclib_allocator *const allocator,
+                                    const size_t capacity,
+                                    const size_t value_size) {
   stack_header *const stk =
-      malloc((value_size * capacity) + sizeof(stack_header));
+      myclib_alloc(allocator, stack_allocation_size(value_size, capacity));
   if (stk == NULL) return NULL;
   stk->height = 0;
   stk->capacity = capacity;
+  stk->allocator = allocator;
+  stk->padding = 0;
   return stk + 1;
 }
 
@@ -62,8 +75,10 @@ inline void *stack_untyped_push(void **const stk, const void *const value,
 
 inline void *stack_untyped_resize(void **const stk, const size_t new_capacity,
                                   const size_t value_size) {
-  const size_t ALLOCATION = (new_capacity * value_size) + sizeof(stack_header);
-  stack_header *const header = realloc(stack_header(*stk), ALLOCATION);
+  stack_header *const header = myclib_realloc(
+      stack_allocator(*stk), stack_header(*stk),
+      stack_allocation_size(value_size, stack_capacity(*stk)),
+      stack_allocation_size(value_size, new_capacity));
   if (header == NULL) return NULL;
   if (new_capacity < header->height) header->height = new_capacity;
   header->capacity = new_capacity;
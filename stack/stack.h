@@ -13,10 +13,16 @@
  *   `height`   - The current height of a stack.
  *  `capacity`  - The maximum number of values a stack can store before
  *                expansion is necessary.
+ * `allocator`  - The allocator owning the stack's memory, or `NULL` if the
+ *                standard library's allocation functions are used.
+ *  `padding`   - Unused. Keeps the header's size a multiple of 16 bytes so
+ *                that values are as aligned as the block holding them.
  */
 typedef struct {
   size_t height;
   size_t capacity;
+  const myclib_allocator *allocator;
+  size_t padding;
 } stack_header;
 
 #define stack(type) type *
@@ -29,19 +35,30 @@ typedef struct {
 
 #define const_stack_header(stk) ((const stack_header *)(stk) - 1)
 
+/* The size of the block holding a stack of `capacity` values. */
+#define stack_allocation_size(value_size, capacity) \
+  (((value_size) * (capacity)) + sizeof(stack_header))
+
+#define stack_allocator(stk) (const_stack_header(stk)->allocator)
+
 #define stack_capacity(stk) (+const_stack_header(stk)->capacity)
 
-#define stack_copy(stk)                                            \
-  ((void *)(1 + (stack_header *)memcpy(                            \
-                    malloc((sizeof *(stk) * stack_capacity(stk)) + \
-                           sizeof(stack_header)),                  \
-                    stack_header(stk),                             \
-                    (sizeof *(stk) * stack_capacity(stk)) +        \
-                        sizeof(stack_header))))
+#define stack_copy(stk)                                                    \
+  ((void *)(1 + (stack_header *)memcpy(                                    \
+                    myclib_alloc(stack_allocator(stk),                     \
+                                 stack_allocation_size(                    \
+                                     sizeof *(stk), stack_capacity(stk))), \
+                    stack_header(stk),                                     \
+                    stack_allocation_size(sizeof *(stk),                   \
+                                          stack_capacity(stk)))))
 
 #define stack_copy_s(stk) stack_untyped_copy((void *)(stk), sizeof *(stk))
 
-#define stack_delete(stk) free(stack_header(stk))
+#define stack_delete(stk)                              \
+  myclib_free(stack_allocator(stk), stack_header(stk), \
+              stack_allocation_size(sizeof *(stk), stack_capacity(stk)))
+
+#define stack_delete_s(stk) stack_untyped_delete((void *)(stk), sizeof *(stk))
 
 #define stack_expand(stk)                    \
   stack_resize(stk, stack_capacity(stk) == 0 \
@@ -61,6 +78,9 @@ typedef struct {
 #define stack_new(type, capacity) \
   ((type *)stack_untyped_new(capacity, sizeof(type)))
 
+#define stack_new_with(allocator, type, capacity) \
+  ((type *)stack_untyped_new_with(allocator, capacity, sizeof(type)))
+
 #define stack_peek(stk) \
   (util_assert(!stack_is_empty(stk)), (stk)[stack_height(stk) - 1])
 
@@ -78,14 +98,16 @@ typedef struct {
 #define stack_push_s(stk, value) \
   stack_untyped_push((void **)&(stk), &(value), sizeof *(stk))
 
-#define stack_resize(stk, new_capacity)                                        \
-  ((stk) =                                                                     \
-       (void *)(1 + (stack_header *)realloc(stack_header(stk),                 \
-                                            (sizeof *(stk) * (new_capacity)) + \
-                                                sizeof(stack_header))),        \
-   util_assert((stk) != NULL),                                                 \
-   inline_if(stack_height(stk) > (new_capacity),                               \
-             stack_header(stk)->height = (new_capacity), NULL),                \
+#define stack_resize(stk, new_capacity)                                 \
+  ((stk) = (void *)(1 + (stack_header *)myclib_realloc(                 \
+                            stack_allocator(stk), stack_header(stk),    \
+                            stack_allocation_size(sizeof *(stk),        \
+                                                  stack_capacity(stk)), \
+                            stack_allocation_size(sizeof *(stk),        \
+                                                  new_capacity))),      \
+   util_assert((stk) != NULL),                                          \
+   inline_if(stack_height(stk) > (new_capacity),                        \
+             stack_header(stk)->height = (new_capacity), NULL),         \
    stack_header(stk)->capacity = (new_capacity), (stk))
 
 #define stack_resize_s(stk, new_capacity) \
@@ -95,16 +117,91 @@ typedef struct {
 
 #define stack_shrink_s(stk) stack_untyped_shrink((void **)&(stk), sizeof *(stk))
 
+/* - TYPED GENERATORS - */
+
+/*
+ * `DEFINE_STACK(type, name)` defines `name` as a `stack(type)` along with the
+ * following functions, each of which evaluates its arguments once and works
+ * on `type` directly instead of through `memcpy()` and `void *`:
+ *
+ * `name name_new(size_t capacity)`
+ * `name name_new_with(const myclib_allocator *allocator, size_t capacity)`
+ * `void name_delete(name stk)`
+ * `type *name_push(name *stk, type value)`
+ * `type name_pop(name stk)`
+ * `type name_peek(const type *stk)`
+ * `void name_for_each(name stk, name_for_each_op op, void *args)`
+ *
+ * They behave as the macros of the same name do, except that `push` returns
+ * `NULL` if the stack could not be expanded. `for_each` visits values from the
+ * bottom of the stack to its top. Stacks created either way share the same
+ * layout, so a `name` may be passed to any other stack macro and vice versa.
+ */
+#define DEFINE_STACK(type, name)                                              \
+  typedef type *name;                                                         \
+                                                                              \
+  typedef void (*name##_for_each_op)(type *value, void *args);                \
+                                                                              \
+  static inline name name##_new_with(const myclib_allocator *const allocator, \
+                                     const size_t capacity) {                 \
+    return (name)stack_untyped_new_with(allocator, capacity, sizeof(type));   \
+  }                                                                           \
+                                                                              \
+  static inline name name##_new(const size_t capacity) {                      \
+    return name##_new_with(NULL, capacity);                                   \
+  }                                                                           \
+                                                                              \
+  static inline void name##_delete(const name stk) {                          \
+    stack_untyped_delete(stk, sizeof(type));                                  \
+  }                                                                           \
+                                                                              \
+  static inline type *name##_push(name *const stk, const type value) {        \
+    const size_t HEIGHT = stack_height(*stk);                                 \
+    if (HEIGHT == stack_capacity(*stk)) {                                     \
+      void *stk_actual = *stk;                                                \
+      if (stack_untyped_expand(&stk_actual, sizeof(type)) == NULL)            \
+        return NULL;                                                          \
+      *stk = (name)stk_actual;                                                \
+    }                                                                         \
+    (*stk)[HEIGHT] = value;                                                   \
+    stack_header(*stk)->height = HEIGHT + 1;                                  \
+    return *stk + HEIGHT;                                                     \
+  }                                                                           \
+                                                                              \
+  static inline type name##_pop(const name stk) {                             \
+    util_assert(!stack_is_empty(stk));                                        \
+    return stk[--stack_header(stk)->height];                                  \
+  }                                                                           \
+                                                                              \
+  static inline type name##_peek(const type *const stk) {                     \
+    util_assert(!stack_is_empty(stk));                                        \
+    return stk[stack_height(stk) - 1];                                        \
+  }                                                                           \
+                                                                              \
+  static inline void name##_for_each(const name stk, name##_for_each_op op,   \
+                                     void *const args) {                      \
+    const size_t HEIGHT = stack_height(stk);                                  \
+    size_t i;                                                                 \
+    for (i = 0; i < HEIGHT; i++) op(stk + i, args);                           \
+  }                                                                           \
+                                                                              \
+  typedef int name##_require_semicolon
+
 /* - FUNCTIONS - */
 
 stack(void) stack_untyped_copy(const stack(void), size_t value_size);
 
+void stack_untyped_delete(stack(void), size_t value_size);
+
 stack(void) stack_untyped_expand(stack(void) *, size_t value_size);
 
 bool stack_untyped_is_full(const stack(void));
 
 stack(void) stack_untyped_new(size_t capacity, size_t value_size);
 
+stack(void) stack_untyped_new_with(const myclib_allocator *allocator,
+                                   size_t capacity, size_t value_size);
+
 void *stack_untyped_peek(stack(void), size_t value_size);
 
 void *stack_untyped_pop(stack(void), size_t value_size);
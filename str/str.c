@@ -15,18 +15,25 @@
 #define EXPANSION_FACTOR (2)
 
 /*
- * `length`   - The number of characters present within the string (disregarding
- *              the null terminator).
- * `capacity` - The number of characters the string can store (disregarding the
- *              null terminator).
+ * `length`    - The number of characters present within the string
+ *               (disregarding the null terminator).
+ * `capacity`  - The number of characters the string can store (disregarding
+ *               the null terminator).
+ * `allocator` - The allocator owning the string's memory, or `NULL` if the
+ *               standard library's allocation functions are used.
  */
 typedef struct {
   size_t length;
   size_t capacity;
+  const myclib_allocator *allocator;
 } string_header;
 
 #define string_header(str) ((string_header *)(str) - 1)
 
+/* Adding one to account for a null terminator. */
+#define string_allocation_size(capacity) \
+  (sizeof(string_header) + (capacity) + 1)
+
 /* - INTERNAL - */
 
 static inline bool append_(string_ref dst, const char *const src,
@@ -133,7 +140,8 @@ inline void string_clear(string str) {
 }
 
 inline string string_copy(const_string str) {
-  string copy = string_init(string_capacity(str));
+  string copy = string_init_with(const_string_header(str)->allocator,
+                                 string_capacity(str));
   if (copy == NULL) return NULL;
   strcpy(copy, str);
   string_header(copy)->length = string_length(str);
@@ -141,7 +149,8 @@ inline string string_copy(const_string str) {
 }
 
 inline void string_delete_(string_ref str) {
-  free(string_header(*str));
+  myclib_free(string_header(*str)->allocator, string_header(*str),
+              string_allocation_size(string_capacity(*str)));
   *str = NULL;
 }
 
@@ -244,12 +253,20 @@ string string_from_stream_delim(FILE *const stream, const char delim) {
 }
 
 inline string string_init(const size_t capacity) {
-  const size_t ALLOCATION = capacity + sizeof(string_header) + 1;
-  string str = (string)(((string_header *)malloc(ALLOCATION)) + 1);
-  if (str == NULL) return NULL;
+  return string_init_with(NULL, capacity);
+}
+
+inline string string_init_with(const myclib_allocator *const allocator,
+                               const size_t capacity) {
+  string_header *const header =
+      myclib_alloc(allocator, string_allocation_size(capacity));
+  string str;
+  if (header == NULL) return NULL;
+  str = (string)(header + 1);
   str[0] = '\0';
-  string_header(str)->length = 0;
-  string_header(str)->capacity = capacity;
+  header->length = 0;
+  header->capacity = capacity;
+  header->allocator = allocator;
   return str;
 }
 
@@ -301,11 +318,13 @@ inline size_t string_length(const_string str) {
 }
 
 inline bool string_resize_(string_ref str, const size_t new_capacity) {
-  /* Adding one to account for a null terminator. */
-  const size_t ALLOCATION = sizeof(string_header) + new_capacity + 1;
-  string new_str =
-      (string)(((string_header *)realloc(string_header(*str), ALLOCATION)) + 1);
-  if (new_str == NULL) return false;
+  string_header *const new_header = myclib_realloc(
+      string_header(*str)->allocator, string_header(*str),
+      string_allocation_size(string_capacity(*str)),
+      string_allocation_size(new_capacity));
+  string new_str;
+  if (new_header == NULL) return false;
+  new_str = (string)(new_header + 1);
   string_header(new_str)->capacity = new_capacity;
   if (new_capacity < string_length(new_str)) {
     string_header(new_str)->length = new_capacity;
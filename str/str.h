@@ -364,6 +364,20 @@ bool string_insert_str_(string_ref dst, const_string src, size_t index);
  */
 string string_init(size_t capacity);
 
+/**
+ * @brief Creates a new string of a specified capacity using an allocator.
+ *
+ * This function behaves like `string_init()`, except that the string's memory,
+ * including any later expansion, is obtained from `allocator`. Copies of the
+ * string share its allocator.
+ *
+ * @param allocator The allocator to use, or `NULL` for the default allocator.
+ * @param capacity The number of characters the string should be able to store,
+ * not including a null terminator.
+ * @return A string capable of containing `capacity` characters.
+ */
+string string_init_with(const myclib_allocator *allocator, size_t capacity);
+
 /**
  * @brief Creates a new string containing a single character.
  *
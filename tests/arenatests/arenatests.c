@@ -0,0 +1,142 @@
+#include "arenatests.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "../../arena/arena.h"
+#include "../../include/myclib.h"
+#include "../../stack/stack.h"
+#include "../../str/str.h"
+#include "../../vector/vector.h"
+#include "../framework.h"
+
+#define TEST_CHUNK_SIZE ((size_t)256)
+
+bool test_arena_alloc(void) {
+  arena arena;
+  byte *blocks[64];
+
+  size_t i;
+  arena_init(&arena, TEST_CHUNK_SIZE);
+  for (i = 0; i < ARR_LEN(blocks); i++) {
+    blocks[i] = arena_alloc(&arena, i + 1);
+    TEST_CASE_ASSERT(blocks[i] != NULL);
+    TEST_CASE_ASSERT((size_t)blocks[i] % ARENA_ALIGNMENT == 0);
+    memset(blocks[i], (int)i, i + 1);
+  }
+  for (i = 0; i < ARR_LEN(blocks); i++) {
+    size_t j;
+    for (j = 0; j <= i; j++) TEST_CASE_ASSERT(blocks[i][j] == (byte)i);
+  }
+  /* Allocations larger than a chunk receive a chunk of their own. */
+  {
+    byte *const large = arena_alloc(&arena, TEST_CHUNK_SIZE * 4);
+    TEST_CASE_ASSERT(large != NULL);
+    memset(large, 0xFF, TEST_CHUNK_SIZE * 4);
+  }
+  arena_destroy(&arena);
+  return true;
+}
+
+bool test_arena_containers(void) {
+  arena arena;
+  vector(int) vec;
+  stack(int) stk;
+  string str;
+
+  size_t i;
+  arena_init(&arena, 0);
+  vec = vector_new_with(arena_allocator(&arena), int, 0);
+  stk = stack_new_with(arena_allocator(&arena), int, 0);
+  str = string_init_with(arena_allocator(&arena), 0);
+  for (i = 0; i < 1000; i++) {
+    vector_push(vec, (int)i);
+    stack_push(stk, (int)i);
+    TEST_CASE_ASSERT(string_append_char(str, 'a'));
+  }
+  for (i = 0; i < 1000; i++) {
+    TEST_CASE_ASSERT(vector_get(vec, i) == (int)i);
+    TEST_CASE_ASSERT(stack_pop(stk) == (int)(999 - i));
+  }
+  TEST_CASE_ASSERT(string_length(str) == 1000);
+  /* Releasing the arena releases every container within it. */
+  arena_destroy(&arena);
+  return true;
+}
+
+bool test_arena_realloc(void) {
+  arena arena;
+  byte *block;
+  byte *moved;
+
+  arena_init(&arena, TEST_CHUNK_SIZE);
+  block = arena_alloc(&arena, 16);
+  memset(block, 1, 16);
+
+  /* The most recent allocation grows in place while its chunk has room. */
+  TEST_CASE_ASSERT(arena_realloc(&arena, block, 16, 64) == block);
+  TEST_CASE_ASSERT(arena_realloc(&arena, block, 64, TEST_CHUNK_SIZE) == block);
+  TEST_CASE_ASSERT(block[15] == 1);
+
+  /* It is copied elsewhere once its chunk runs out of room. */
+  moved = arena_realloc(&arena, block, TEST_CHUNK_SIZE, TEST_CHUNK_SIZE * 2);
+  TEST_CASE_ASSERT(moved != NULL && moved != block);
+  TEST_CASE_ASSERT(moved[0] == 1 && moved[15] == 1);
+
+  /* Older allocations cannot grow in place. */
+  block = arena_alloc(&arena, 16);
+  TEST_CASE_ASSERT(arena_alloc(&arena, 16) != NULL);
+  TEST_CASE_ASSERT(arena_realloc(&arena, block, 16, 32) != block);
+
+  /* A vector at the tip of an arena grows without being copied. */
+  {
+    vector(int) vec = vector_new_with(arena_allocator(&arena), int, 1);
+    const int *const DATA = vec;
+    size_t i;
+    for (i = 0; i < 16; i++) vector_push(vec, (int)i);
+    TEST_CASE_ASSERT(vec == DATA);
+  }
+  arena_destroy(&arena);
+  return true;
+}
+
+bool test_arena_reset(void) {
+  arena arena;
+  void *first;
+
+  size_t i;
+  arena_init(&arena, TEST_CHUNK_SIZE);
+  first = arena_alloc(&arena, 8);
+  for (i = 0; i < 100; i++) TEST_CASE_ASSERT(arena_alloc(&arena, 64) != NULL);
+  arena_reset(&arena);
+  /* Memory is reused from the start of the first chunk. */
+  TEST_CASE_ASSERT(arena_alloc(&arena, 8) == first);
+  for (i = 0; i < 100; i++) TEST_CASE_ASSERT(arena_alloc(&arena, 64) != NULL);
+  arena_destroy(&arena);
+  TEST_CASE_ASSERT(arena.first == NULL);
+  return true;
+}
+
+bool test_arena_rewind(void) {
+  arena arena;
+  arena_mark mark;
+  void *after_mark;
+
+  size_t i;
+  arena_init(&arena, TEST_CHUNK_SIZE);
+  TEST_CASE_ASSERT(arena_alloc(&arena, 32) != NULL);
+  mark = arena_get_mark(&arena);
+  after_mark = arena_alloc(&arena, 32);
+  for (i = 0; i < 50; i++) TEST_CASE_ASSERT(arena_alloc(&arena, 48) != NULL);
+  arena_rewind(&arena, mark);
+  TEST_CASE_ASSERT(arena_alloc(&arena, 32) == after_mark);
+
+  /* Freeing the most recent allocation hands its memory back. */
+  {
+    void *const block = arena_alloc(&arena, 32);
+    arena_free(&arena, block, 32);
+    TEST_CASE_ASSERT(arena_alloc(&arena, 32) == block);
+  }
+  arena_destroy(&arena);
+  return true;
+}
@@ -0,0 +1,16 @@
+#ifndef TEST_ARENA_H
+#define TEST_ARENA_H
+
+#include "../../include/myclib.h"
+
+bool test_arena_alloc(void);
+
+bool test_arena_containers(void);
+
+bool test_arena_realloc(void);
+
+bool test_arena_reset(void);
+
+bool test_arena_rewind(void);
+
+#endif
@@ -0,0 +1,159 @@
+#include "bitvectests.h"
+
+#include <stddef.h>
+
+#include "../../bitvec/bitvec.h"
+#include "../../include/myclib.h"
+#include "../framework.h"
+
+/* Enough bits to span many rank blocks and select samples. */
+#define TEST_LENGTH ((size_t)100003)
+
+/* A pattern which is neither periodic in words nor in rank blocks. */
+#define pattern_bit(i, seed) ((((i) * 2654435761UL + (seed)) >> 7) % 3 == 0)
+
+static bitvec new_patterned(const size_t length, const unsigned long seed) {
+  bitvec vec = bitvec_new(0);
+  size_t i;
+  for (i = 0; i < length; i++) bitvec_push(vec, pattern_bit(i, seed));
+  return vec;
+}
+
+bool test_bitvec_bitwise(void) {
+  bitvec a = new_patterned(TEST_LENGTH, 1);
+  bitvec b = new_patterned(TEST_LENGTH, 2);
+  bitvec expected = bitvec_new(TEST_LENGTH);
+
+  size_t ones = 0;
+  size_t i;
+  for (i = 0; i < TEST_LENGTH; i++)
+    bitvec_push(expected, pattern_bit(i, 1) && pattern_bit(i, 2));
+  bitvec_and(a, b);
+  for (i = 0; i < bitvec_word_count(a); i++)
+    TEST_CASE_ASSERT(a[i] == expected[i]);
+  bitvec_or(a, b);
+  for (i = 0; i < bitvec_word_count(a); i++) TEST_CASE_ASSERT(a[i] == b[i]);
+  bitvec_xor(a, b);
+  TEST_CASE_ASSERT(bitvec_popcount(a) == 0);
+  bitvec_not(a);
+  TEST_CASE_ASSERT(bitvec_popcount(a) == TEST_LENGTH);
+  bitvec_not(b);
+  for (i = 0; i < TEST_LENGTH; i++) {
+    TEST_CASE_ASSERT(bitvec_get(b, i) == !pattern_bit(i, 2));
+    ones += !pattern_bit(i, 2);
+  }
+  TEST_CASE_ASSERT(bitvec_popcount(b) == ones);
+  TEST_CASE_ASSERT(bitvec_rank(b, TEST_LENGTH) == ones);
+  bitvec_clear(b);
+  TEST_CASE_ASSERT(bitvec_popcount(b) == 0);
+  TEST_CASE_ASSERT(bitvec_length(b) == TEST_LENGTH);
+  TEST_CASE_ASSERT(bitvec_select(b, 0) == BITVEC_BAD_INDEX);
+
+  bitvec_delete(a);
+  bitvec_delete(b);
+  bitvec_delete(expected);
+  return true;
+}
+
+bool test_bitvec_new(void) {
+  counting_allocator_stats stats;
+  const myclib_allocator ALLOCATOR = counting_allocator(&stats);
+  bitvec vec = bitvec_new_with(&ALLOCATOR, 100);
+
+  size_t i;
+  TEST_CASE_ASSERT(vec != NULL);
+  TEST_CASE_ASSERT(bitvec_allocator(vec) == &ALLOCATOR);
+  TEST_CASE_ASSERT(bitvec_is_empty(vec));
+  TEST_CASE_ASSERT(bitvec_capacity(vec) >= 100);
+  for (i = 0; i < TEST_LENGTH; i++) bitvec_push(vec, i % 5 == 0);
+  TEST_CASE_ASSERT(bitvec_rank(vec, TEST_LENGTH) == (TEST_LENGTH + 4) / 5);
+  bitvec_delete(vec);
+  TEST_CASE_ASSERT(vec == NULL);
+  TEST_CASE_ASSERT(stats.live_blocks == 0);
+  TEST_CASE_ASSERT(stats.live_bytes == 0);
+  return true;
+}
+
+bool test_bitvec_push(void) {
+  bitvec vec = bitvec_new(0);
+
+  size_t i;
+  for (i = 0; i < TEST_LENGTH; i++) {
+    TEST_CASE_ASSERT(bitvec_push(vec, pattern_bit(i, 3)) != NULL);
+    TEST_CASE_ASSERT(bitvec_length(vec) == i + 1);
+  }
+  TEST_CASE_ASSERT(bitvec_capacity(vec) >= TEST_LENGTH);
+  for (i = 0; i < TEST_LENGTH; i++)
+    TEST_CASE_ASSERT(bitvec_get(vec, i) == pattern_bit(i, 3));
+  /* Bits past the length stay clear. */
+  TEST_CASE_ASSERT((vec[TEST_LENGTH / BITVEC_WORD_BITS] >>
+                    (TEST_LENGTH % BITVEC_WORD_BITS)) == 0);
+
+  bitvec_delete(vec);
+  return true;
+}
+
+bool test_bitvec_rank(void) {
+  bitvec vec = new_patterned(TEST_LENGTH, 4);
+
+  size_t ones = 0;
+  size_t i;
+  for (i = 0; i <= TEST_LENGTH; i++) {
+    TEST_CASE_ASSERT(bitvec_rank(vec, i) == ones);
+    if (i < TEST_LENGTH) ones += bitvec_get(vec, i);
+  }
+  /* Appending keeps the index, which must then cover the new bits too. */
+  for (i = 0; i < TEST_LENGTH; i++) {
+    bitvec_push(vec, true);
+    if (i % 997 == 0)
+      TEST_CASE_ASSERT(bitvec_rank(vec, TEST_LENGTH + i + 1) == ones + i + 1);
+  }
+
+  bitvec_delete(vec);
+  return true;
+}
+
+bool test_bitvec_select(void) {
+  bitvec vec = new_patterned(TEST_LENGTH, 5);
+
+  size_t ones = 0;
+  size_t i;
+  for (i = 0; i < TEST_LENGTH; i++) {
+    if (!bitvec_get(vec, i)) continue;
+    TEST_CASE_ASSERT(bitvec_select(vec, ones) == i);
+    ones++;
+  }
+  TEST_CASE_ASSERT(bitvec_select(vec, ones) == BITVEC_BAD_INDEX);
+  for (i = 0; i < ones; i++)
+    TEST_CASE_ASSERT(bitvec_rank(vec, bitvec_select(vec, i)) == i);
+
+  bitvec_delete(vec);
+  return true;
+}
+
+bool test_bitvec_set(void) {
+  bitvec vec = new_patterned(TEST_LENGTH, 6);
+
+  size_t i;
+  TEST_CASE_ASSERT(bitvec_index(vec));
+  /* Modifications must discard the stale parts of the index. */
+  for (i = TEST_LENGTH; i-- > 0;) {
+    const size_t ONES = bitvec_rank(vec, i);
+    bitvec_set(vec, i, true);
+    TEST_CASE_ASSERT(bitvec_get(vec, i));
+    TEST_CASE_ASSERT(bitvec_rank(vec, TEST_LENGTH) == ONES + TEST_LENGTH - i);
+    if (i % 1009 == 0) {
+      TEST_CASE_ASSERT(bitvec_select(vec, ONES) == i);
+      TEST_CASE_ASSERT(bitvec_select(vec, ONES + TEST_LENGTH - i - 1) ==
+                       TEST_LENGTH - 1);
+    }
+  }
+  TEST_CASE_ASSERT(bitvec_popcount(vec) == TEST_LENGTH);
+  for (i = 0; i < TEST_LENGTH; i += 2) bitvec_set(vec, i, false);
+  TEST_CASE_ASSERT(bitvec_select(vec, 0) == 1);
+  TEST_CASE_ASSERT(bitvec_select(vec, 1000) == 2001);
+  TEST_CASE_ASSERT(bitvec_rank(vec, 2001) == 1000);
+
+  bitvec_delete(vec);
+  return true;
+}
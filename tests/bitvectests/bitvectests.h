@@ -0,0 +1,18 @@
+#ifndef TEST_BITVEC_H
+#define TEST_BITVEC_H
+
+#include "../../include/myclib.h"
+
+bool test_bitvec_bitwise(void);
+
+bool test_bitvec_new(void);
+
+bool test_bitvec_push(void);
+
+bool test_bitvec_rank(void);
+
+bool test_bitvec_select(void);
+
+bool test_bitvec_set(void);
+
+#endif
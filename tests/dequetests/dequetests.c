@@ -0,0 +1,162 @@
+#include "dequetests.h"
+
+#include <stddef.h>
+
+#include "../../deque/deque.h"
+#include "../../include/myclib.h"
+#include "../framework.h"
+
+/* Enough elements to wrap around and grow the ring several times. */
+#define TEST_LENGTH ((size_t)1000)
+
+DEFINE_DEQUE(size_t, sdeque);
+
+/* Checks that `dq` holds `first`, `first + 1` and so on up to `last`. */
+static bool holds_run(deque(size_t) dq, const size_t first, const size_t last) {
+  size_t i;
+  if (deque_length(dq) != last - first + 1) return false;
+  for (i = 0; i < deque_length(dq); i++)
+    if (deque_at(dq, i) != first + i) return false;
+  return true;
+}
+
+bool test_deque_bulk(void) {
+  deque(size_t) dq = deque_new(size_t, 8);
+  size_t src[3 * 8];
+  size_t dst[3 * 8];
+
+  size_t i;
+  TEST_CASE_ASSERT(dq != NULL);
+  for (i = 0; i < ARR_LEN(src); i++) src[i] = i;
+  /* Leaves the front near the end of the ring, so the next append wraps. */
+  TEST_CASE_ASSERT(deque_push_back_n(dq, src, 6) == dq);
+  TEST_CASE_ASSERT(deque_pop_front_n(dq, NULL, 5) == 5);
+  TEST_CASE_ASSERT(deque_push_back_n(dq, src + 6, 6) == dq);
+  TEST_CASE_ASSERT(deque_capacity(dq) == 8);
+  TEST_CASE_ASSERT(holds_run(dq, 5, 11));
+  TEST_CASE_ASSERT(deque_pop_front_n(dq, dst, 4) == 4);
+  for (i = 0; i < 4; i++) TEST_CASE_ASSERT(dst[i] == 5 + i);
+  /* Appending more than fits grows the ring once. */
+  TEST_CASE_ASSERT(deque_push_back_n(dq, src + 12, 12) == dq);
+  TEST_CASE_ASSERT(deque_capacity(dq) == 16);
+  TEST_CASE_ASSERT(holds_run(dq, 9, 23));
+  TEST_CASE_ASSERT(deque_pop_front_n(dq, dst, ARR_LEN(dst)) == 15);
+  for (i = 0; i < 15; i++) TEST_CASE_ASSERT(dst[i] == 9 + i);
+  TEST_CASE_ASSERT(deque_is_empty(dq));
+  TEST_CASE_ASSERT(deque_pop_front_n(dq, dst, 1) == 0);
+  TEST_CASE_ASSERT(deque_push_back_n(dq, src, 0) == dq);
+
+  deque_delete(dq);
+  TEST_CASE_ASSERT(dq == NULL);
+  return true;
+}
+
+bool test_deque_define(void) {
+  counting_allocator_stats stats;
+  const myclib_allocator ALLOCATOR = counting_allocator(&stats);
+  sdeque dq = sdeque_new_with(&ALLOCATOR, 0);
+
+  size_t i;
+  TEST_CASE_ASSERT(dq != NULL);
+  TEST_CASE_ASSERT(deque_allocator(dq) == &ALLOCATOR);
+  for (i = 0; i < TEST_LENGTH; i++) {
+    TEST_CASE_ASSERT(*sdeque_push_back(&dq, i) == i);
+    TEST_CASE_ASSERT(*sdeque_push_front(&dq, i) == i);
+  }
+  TEST_CASE_ASSERT(deque_length(dq) == 2 * TEST_LENGTH);
+  for (i = 0; i < TEST_LENGTH; i++) {
+    TEST_CASE_ASSERT(*sdeque_at(dq, TEST_LENGTH - 1 - i) == i);
+    TEST_CASE_ASSERT(*sdeque_at(dq, TEST_LENGTH + i) == i);
+  }
+  for (i = TEST_LENGTH; i-- > 0;) {
+    TEST_CASE_ASSERT(sdeque_pop_front(dq) == i);
+    TEST_CASE_ASSERT(sdeque_pop_back(dq) == i);
+  }
+  TEST_CASE_ASSERT(deque_is_empty(dq));
+  TEST_CASE_ASSERT(stats.live_blocks == 1);
+  TEST_CASE_ASSERT(stats.live_bytes ==
+                   deque_allocation_size(sizeof *dq, deque_capacity(dq)));
+
+  sdeque_delete(&dq);
+  TEST_CASE_ASSERT(dq == NULL);
+  TEST_CASE_ASSERT(stats.live_blocks == 0 && stats.live_bytes == 0);
+  return true;
+}
+
+bool test_deque_grow(void) {
+  deque(size_t) dq;
+
+  size_t rotation;
+  size_t i;
+  /* Grows a full ring at every rotation, so both parts get moved. */
+  for (rotation = 0; rotation < 8; rotation++) {
+    dq = deque_new(size_t, 8);
+    TEST_CASE_ASSERT(dq != NULL && deque_capacity(dq) == 8);
+    for (i = 0; i < rotation; i++) {
+      deque_push_back(dq, 0);
+      (void)deque_pop_front(dq);
+    }
+    for (i = 0; i < 8; i++) deque_push_back(dq, i);
+    TEST_CASE_ASSERT(deque_is_full(dq));
+    deque_push_back(dq, 8);
+    TEST_CASE_ASSERT(deque_capacity(dq) == 16);
+    TEST_CASE_ASSERT(holds_run(dq, 0, 8));
+    deque_delete(dq);
+  }
+
+  /* Capacities are rounded up to powers of two. */
+  dq = deque_new(size_t, 5);
+  TEST_CASE_ASSERT(dq != NULL && deque_capacity(dq) == 8);
+  TEST_CASE_ASSERT(deque_reserve(dq, 9) == dq);
+  TEST_CASE_ASSERT(deque_capacity(dq) == 16);
+  TEST_CASE_ASSERT(deque_reserve(dq, 3) == dq);
+  TEST_CASE_ASSERT(deque_capacity(dq) == 16);
+  deque_delete(dq);
+
+  dq = deque_new(size_t, 0);
+  TEST_CASE_ASSERT(dq != NULL && deque_capacity(dq) == 0);
+  deque_push_front_s(dq, rotation);
+  TEST_CASE_ASSERT(deque_capacity(dq) == 1);
+  TEST_CASE_ASSERT(deque_front(dq) == rotation);
+  deque_delete(dq);
+  return true;
+}
+
+bool test_deque_push_pop(void) {
+  deque(size_t) dq = deque_new(size_t, 4);
+
+  size_t i;
+  TEST_CASE_ASSERT(dq != NULL);
+  /* Used as a FIFO queue, the deque never holds more than a few elements. */
+  for (i = 0; i < TEST_LENGTH; i++) {
+    deque_push_back(dq, i);
+    deque_push_back_s(dq, i);
+    TEST_CASE_ASSERT(deque_pop_front(dq) == i);
+    TEST_CASE_ASSERT(*(size_t *)deque_pop_front_s(dq) == i);
+  }
+  TEST_CASE_ASSERT(deque_capacity(dq) == 4);
+  TEST_CASE_ASSERT(deque_pop_front_s(dq) == NULL);
+  TEST_CASE_ASSERT(deque_pop_back_s(dq) == NULL);
+
+  for (i = 0; i < TEST_LENGTH; i++) {
+    if (i % 2 == 0)
+      deque_push_front(dq, i);
+    else
+      deque_push_front_s(dq, i);
+  }
+  TEST_CASE_ASSERT(deque_front(dq) == TEST_LENGTH - 1);
+  TEST_CASE_ASSERT(deque_back(dq) == 0);
+  TEST_CASE_ASSERT(*(size_t *)deque_at_s(dq, 1) == TEST_LENGTH - 2);
+  TEST_CASE_ASSERT(deque_at_s(dq, TEST_LENGTH) == NULL);
+  for (i = 0; i < TEST_LENGTH / 2; i++) {
+    TEST_CASE_ASSERT(deque_pop_back(dq) == i * 2);
+    TEST_CASE_ASSERT(*(size_t *)deque_pop_back_s(dq) == i * 2 + 1);
+  }
+  TEST_CASE_ASSERT(deque_is_empty(dq));
+  deque_push_back(dq, 1);
+  deque_clear(dq);
+  TEST_CASE_ASSERT(deque_is_empty(dq));
+
+  deque_delete(dq);
+  return true;
+}
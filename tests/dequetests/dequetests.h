@@ -0,0 +1,21 @@
+#ifndef TEST_DEQUE_H
+#define TEST_DEQUE_H
+
+#include "../../include/myclib.h"
+
+/* - AVAILABLE TEST FUNCTIONS - */
+
+/*
+ * Note: If any tested function has an `_s` variant, that variant will also be
+ * included in the test.
+ */
+
+bool test_deque_bulk(void);
+
+bool test_deque_define(void);
+
+bool test_deque_grow(void);
+
+bool test_deque_push_pop(void);
+
+#endif
@@ -0,0 +1,329 @@
+#include "flatsettests.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "../../flatset/flatmap.h"
+#include "../../flatset/flatset.h"
+#include "../../include/myclib.h"
+#include "../../vector/vector.h"
+#include "../framework.h"
+
+/* Long enough for the block kernels to run well past their first blocks. */
+#define TEST_LENGTH ((size_t)3001)
+
+/* A key ordered by `key` alone, so that equal keys can still be told apart. */
+typedef struct tagged_key {
+  int key;
+  int tag;
+} tagged_key;
+
+static unsigned long next_random(unsigned long *const state) {
+  *state = (*state * 1103515245UL + 12345UL) & 0x7FFFFFFFUL;
+  return *state;
+}
+
+static int compare_tagged(const void *const a, const void *const b) {
+  const int A = ((const tagged_key *)a)->key;
+  const int B = ((const tagged_key *)b)->key;
+  return (A > B) - (A < B);
+}
+
+/* Not a built-in comparator, so it selects the generic kernels. */
+static int compare_ints(const void *const a, const void *const b) {
+  const int A = *(const int *)a;
+  const int B = *(const int *)b;
+  return (A > B) - (A < B);
+}
+
+static int compare_u32s(const void *const a, const void *const b) {
+  return flat_set_compare_u32(a, b);
+}
+
+static int compare_u64s(const void *const a, const void *const b) {
+  return flat_set_compare_u64(a, b);
+}
+
+static int compare_i64s(const void *const a, const void *const b) {
+  return flat_set_compare_i64(a, b);
+}
+
+static bool sets_equal(const void *const a, const void *const b,
+                       const size_t elem_size) {
+  return vector_length(a) == vector_length(b) &&
+         memcmp(a, b, vector_length(a) * elem_size) == 0;
+}
+
+/* Returns a flat set of up to `length` keys in `[base, base + range)`. */
+static vector(vec_i64) random_set(const size_t length,
+                                  const unsigned long range, const long base,
+                                  unsigned long *const state) {
+  vector(vec_i64) set = flat_set_new(vec_i64, length);
+  size_t i;
+  for (i = 0; i < length; i++) {
+    const vec_i64 KEY = (vec_i64)(next_random(state) % range) + base;
+    vector_push(set, KEY);
+  }
+  util_assert(flat_set_build(set, flat_set_compare_i64));
+  return set;
+}
+
+bool test_flat_map_build(void) {
+  flat_map map;
+  const int KEYS[] = {5, 3, 5, 9, 1, 3};
+  const double VALUES[] = {0.5, 0.3, 5.0, 0.9, 0.1, 3.0};
+  const int MORE_KEYS[] = {4, 9, 0};
+  const double MORE_VALUES[] = {0.4, 9.0, 0.0};
+  const int MISSING = 7;
+  const int ERASED = 3;
+  const double NEW_VALUE = 7.5;
+
+  TEST_CASE_ASSERT(flat_map_init(&map, sizeof(int), sizeof(double),
+                                 compare_ints));
+  TEST_CASE_ASSERT(flat_map_build(&map, KEYS, VALUES, ARR_LEN(KEYS)));
+  TEST_CASE_ASSERT(flat_map_length(&map) == 4);
+  TEST_CASE_ASSERT(flat_map_keys(&map, int)[0] == 1);
+  TEST_CASE_ASSERT(flat_map_keys(&map, int)[3] == 9);
+  /* The first of several pairs with equal keys is kept. */
+  TEST_CASE_ASSERT(*(double *)flat_map_get(&map, &KEYS[0]) > 0.4 &&
+                   *(double *)flat_map_get(&map, &KEYS[0]) < 0.6);
+  TEST_CASE_ASSERT(*(double *)flat_map_get(&map, &KEYS[1]) < 1.0);
+  TEST_CASE_ASSERT(flat_map_get(&map, &MISSING) == NULL);
+  TEST_CASE_ASSERT(flat_map_lower_bound(&map, &MISSING) == 3);
+
+  /* Existing keys keep their values. */
+  TEST_CASE_ASSERT(flat_map_insert_n(&map, MORE_KEYS, MORE_VALUES,
+                                     ARR_LEN(MORE_KEYS)) == 2);
+  TEST_CASE_ASSERT(flat_map_length(&map) == 6);
+  TEST_CASE_ASSERT(flat_map_keys(&map, int)[0] == 0);
+  TEST_CASE_ASSERT(flat_map_values(&map, double)[2] < 0.35);
+  TEST_CASE_ASSERT(*(double *)flat_map_get(&map, &MORE_KEYS[0]) > 0.35);
+  TEST_CASE_ASSERT(*(double *)flat_map_get(&map, &MORE_KEYS[1]) < 1.0);
+
+  TEST_CASE_ASSERT(flat_map_put(&map, &MISSING, &NEW_VALUE) != NULL);
+  TEST_CASE_ASSERT(flat_map_keys(&map, int)[5] == MISSING);
+  TEST_CASE_ASSERT(flat_map_put(&map, &KEYS[3], &NEW_VALUE) != NULL);
+  TEST_CASE_ASSERT(flat_map_values(&map, double)[6] > 7.0);
+  TEST_CASE_ASSERT(flat_map_erase(&map, &ERASED));
+  TEST_CASE_ASSERT(!flat_map_erase(&map, &ERASED));
+  TEST_CASE_ASSERT(flat_map_length(&map) == 6);
+  TEST_CASE_ASSERT(vector_length(map.values) == 6);
+  TEST_CASE_ASSERT(flat_map_keys(&map, int)[2] == 4);
+
+  TEST_CASE_ASSERT(flat_map_build(&map, MORE_KEYS, MORE_VALUES, 1));
+  TEST_CASE_ASSERT(flat_map_length(&map) == 1);
+  flat_map_destroy(&map);
+  return true;
+}
+
+bool test_flat_set_build(void) {
+  vector(vec_u32) set = flat_set_new(vec_u32, TEST_LENGTH);
+  vector(tagged_key) tagged = flat_set_new(tagged_key, TEST_LENGTH);
+  unsigned long state = 1;
+  int first_tags[1000];
+
+  size_t distinct = 0;
+  size_t i;
+  for (i = 0; i < ARR_LEN(first_tags); i++) first_tags[i] = -1;
+  for (i = 0; i < TEST_LENGTH; i++) {
+    tagged_key key;
+    key.key = (int)(next_random(&state) % ARR_LEN(first_tags));
+    key.tag = (int)i;
+    vector_push(set, (vec_u32)key.key);
+    vector_push(tagged, key);
+    if (first_tags[key.key] < 0) {
+      first_tags[key.key] = key.tag;
+      distinct++;
+    }
+  }
+  TEST_CASE_ASSERT(flat_set_build(set, flat_set_compare_u32));
+  TEST_CASE_ASSERT(flat_set_build(tagged, compare_tagged));
+  TEST_CASE_ASSERT(vector_length(set) == distinct);
+  TEST_CASE_ASSERT(vector_length(tagged) == distinct);
+  for (i = 0; i < distinct; i++) {
+    TEST_CASE_ASSERT(i == 0 || set[i - 1] < set[i]);
+    TEST_CASE_ASSERT(tagged[i].key == (int)set[i]);
+    /* The first of several equal keys is kept. */
+    TEST_CASE_ASSERT(tagged[i].tag == first_tags[tagged[i].key]);
+  }
+
+  vector_delete(set);
+  vector_delete(tagged);
+  return true;
+}
+
+bool test_flat_set_insert(void) {
+  vector(vec_u64) set = flat_set_new(vec_u64, 0);
+  vector(vec_u64) generic = flat_set_new(vec_u64, 0);
+  vector(vec_u64) batch = vector_new(vec_u64, TEST_LENGTH);
+  unsigned long state = 5;
+  const vec_u64 MISSING = 1;
+
+  size_t inserted;
+  size_t i;
+  for (i = 0; i < TEST_LENGTH / 3; i++) {
+    const vec_u64 KEY = (vec_u64)(next_random(&state) % 5000) * 2;
+    const size_t LENGTH = vector_length(set);
+    const size_t INDEX = flat_set_insert(set, KEY, flat_set_compare_u64);
+    TEST_CASE_ASSERT(INDEX != VEC_BAD_INDEX && set[INDEX] == KEY);
+    TEST_CASE_ASSERT(flat_set_insert(generic, KEY, compare_u64s) == INDEX);
+    TEST_CASE_ASSERT(vector_length(generic) == vector_length(set));
+    TEST_CASE_ASSERT(vector_length(set) - LENGTH <= 1);
+  }
+  for (i = 0; i < TEST_LENGTH; i++)
+    vector_push(batch, (vec_u64)(next_random(&state) % 10000));
+  inserted = flat_set_insert_n(set, batch, TEST_LENGTH, flat_set_compare_u64);
+  TEST_CASE_ASSERT(inserted != VEC_BAD_INDEX);
+  TEST_CASE_ASSERT(flat_set_insert_n(generic, batch, TEST_LENGTH,
+                                     compare_u64s) == inserted);
+  TEST_CASE_ASSERT(vector_length(set) == vector_length(generic));
+  for (i = 0; i < vector_length(set); i++) {
+    TEST_CASE_ASSERT(set[i] == generic[i]);
+    TEST_CASE_ASSERT(i == 0 || set[i - 1] < set[i]);
+  }
+  for (i = 0; i < TEST_LENGTH; i++)
+    TEST_CASE_ASSERT(flat_set_contains(set, batch[i], flat_set_compare_u64));
+
+  inserted = vector_length(set);
+  TEST_CASE_ASSERT(flat_set_erase(set, set[inserted / 2],
+                                  flat_set_compare_u64));
+  TEST_CASE_ASSERT(vector_length(set) == inserted - 1);
+  if (!flat_set_contains(set, MISSING, flat_set_compare_u64)) {
+    TEST_CASE_ASSERT(!flat_set_erase(set, MISSING, flat_set_compare_u64));
+    TEST_CASE_ASSERT(flat_set_find(set, MISSING, flat_set_compare_u64) ==
+                     VEC_BAD_INDEX);
+  }
+  TEST_CASE_ASSERT(flat_set_insert_n(set, batch, 0, flat_set_compare_u64) ==
+                   0);
+
+  vector_delete(set);
+  vector_delete(generic);
+  vector_delete(batch);
+  return true;
+}
+
+bool test_flat_set_lower_bound(void) {
+  vector(vec_i32) set = flat_set_new(vec_i32, 0);
+  vector(int) generic = flat_set_new(int, 0);
+
+  size_t length;
+  for (length = 0; length < 40; length++) {
+    vec_i32 key;
+    vector_reset(set);
+    vector_reset(generic);
+    for (key = 0; key < (vec_i32)length; key++) {
+      const vec_i32 KEY = (key * 3) - 20;
+      const int INT_KEY = (int)KEY;
+      vector_push(set, KEY);
+      vector_push(generic, INT_KEY);
+    }
+    for (key = -25; key < (vec_i32)(length * 3); key++) {
+      const int INT_KEY = (int)key;
+      size_t expected = 0;
+      while (expected < length && set[expected] < key) expected++;
+      TEST_CASE_ASSERT(flat_set_lower_bound(set, key, flat_set_compare_i32) ==
+                       expected);
+      TEST_CASE_ASSERT(flat_set_lower_bound(generic, INT_KEY, compare_ints) ==
+                       expected);
+    }
+  }
+
+  vector_delete(set);
+  vector_delete(generic);
+  return true;
+}
+
+bool test_flat_set_ops(void) {
+  vector(vec_i64) result = flat_set_new(vec_i64, 0);
+  vector(vec_i64) expected = flat_set_new(vec_i64, 0);
+  vector(vec_u32) narrow_a = flat_set_new(vec_u32, 0);
+  vector(vec_u32) narrow_b = flat_set_new(vec_u32, 0);
+  vector(vec_u32) narrow_result = flat_set_new(vec_u32, 0);
+  vector(vec_u32) narrow_expected = flat_set_new(vec_u32, 0);
+  vector(vec_i64) shared;
+  unsigned long state = 9;
+  /* Dense and sparse overlaps, and lengths which are not whole blocks. */
+  const unsigned long RANGES[] = {4000, 40000, 800};
+  const long BASES[] = {-2000, 0, 1000};
+
+  size_t range;
+  for (range = 0; range < ARR_LEN(RANGES); range++) {
+    vector(vec_i64) a =
+        random_set(TEST_LENGTH, RANGES[range], BASES[range], &state);
+    vector(vec_i64) b = random_set(TEST_LENGTH / 2, RANGES[range], 0, &state);
+    size_t i;
+    size_t j;
+
+    /* The generic kernels are checked against membership tests... */
+    TEST_CASE_ASSERT(flat_set_intersection(expected, a, b, compare_i64s));
+    for (i = 0, j = 0; i < vector_length(a); i++) {
+      if (!flat_set_contains(b, a[i], compare_i64s)) continue;
+      TEST_CASE_ASSERT(j < vector_length(expected) && expected[j] == a[i]);
+      j++;
+    }
+    TEST_CASE_ASSERT(j == vector_length(expected));
+    TEST_CASE_ASSERT(flat_set_difference(expected, a, b, compare_i64s));
+    for (i = 0, j = 0; i < vector_length(a); i++) {
+      if (flat_set_contains(b, a[i], compare_i64s)) continue;
+      TEST_CASE_ASSERT(j < vector_length(expected) && expected[j] == a[i]);
+      j++;
+    }
+    TEST_CASE_ASSERT(j == vector_length(expected));
+    TEST_CASE_ASSERT(flat_set_union(expected, a, b, compare_i64s));
+    TEST_CASE_ASSERT(vector_length(expected) == vector_length(b) + j);
+
+    /* ...and the block kernels against the generic ones. */
+    TEST_CASE_ASSERT(flat_set_union(result, a, b, flat_set_compare_i64));
+    TEST_CASE_ASSERT(sets_equal(result, expected, sizeof *result));
+    TEST_CASE_ASSERT(flat_set_intersection(expected, a, b, compare_i64s));
+    TEST_CASE_ASSERT(
+        flat_set_intersection(result, a, b, flat_set_compare_i64));
+    TEST_CASE_ASSERT(sets_equal(result, expected, sizeof *result));
+    TEST_CASE_ASSERT(flat_set_difference(expected, a, b, compare_i64s));
+    TEST_CASE_ASSERT(flat_set_difference(result, a, b, flat_set_compare_i64));
+    TEST_CASE_ASSERT(sets_equal(result, expected, sizeof *result));
+
+    /* Other handles sharing the destination keep their elements. */
+    shared = vector_share(result);
+    TEST_CASE_ASSERT(flat_set_union(result, a, b, flat_set_compare_i64));
+    TEST_CASE_ASSERT(sets_equal(shared, expected, sizeof *shared));
+    vector_delete(shared);
+
+    /* Unsigned 32-bit keys take the other block kernel. */
+    vector_reset(narrow_a);
+    vector_reset(narrow_b);
+    for (i = 0; i < vector_length(a); i++)
+      vector_push(narrow_a, (vec_u32)(a[i] + 2000));
+    for (i = 0; i < vector_length(b); i++)
+      vector_push(narrow_b, (vec_u32)(b[i] + 2000));
+    TEST_CASE_ASSERT(flat_set_union(narrow_result, narrow_a, narrow_b,
+                                    flat_set_compare_u32));
+    TEST_CASE_ASSERT(
+        flat_set_union(narrow_expected, narrow_a, narrow_b, compare_u32s));
+    TEST_CASE_ASSERT(
+        sets_equal(narrow_result, narrow_expected, sizeof *narrow_result));
+    TEST_CASE_ASSERT(flat_set_intersection(narrow_result, narrow_a, narrow_b,
+                                           flat_set_compare_u32));
+    TEST_CASE_ASSERT(flat_set_intersection(narrow_expected, narrow_a, narrow_b,
+                                           compare_u32s));
+    TEST_CASE_ASSERT(
+        sets_equal(narrow_result, narrow_expected, sizeof *narrow_result));
+    TEST_CASE_ASSERT(flat_set_difference(narrow_result, narrow_a, narrow_b,
+                                         flat_set_compare_u32));
+    TEST_CASE_ASSERT(flat_set_difference(narrow_expected, narrow_a, narrow_b,
+                                         compare_u32s));
+    TEST_CASE_ASSERT(
+        sets_equal(narrow_result, narrow_expected, sizeof *narrow_result));
+
+    vector_delete(a);
+    vector_delete(b);
+  }
+
+  vector_delete(result);
+  vector_delete(expected);
+  vector_delete(narrow_a);
+  vector_delete(narrow_b);
+  vector_delete(narrow_result);
+  vector_delete(narrow_expected);
+  return true;
+}
@@ -0,0 +1,16 @@
+#ifndef TEST_FLAT_SET_H
+#define TEST_FLAT_SET_H
+
+#include "../../include/myclib.h"
+
+bool test_flat_map_build(void);
+
+bool test_flat_set_build(void);
+
+bool test_flat_set_insert(void);
+
+bool test_flat_set_lower_bound(void);
+
+bool test_flat_set_ops(void);
+
+#endif
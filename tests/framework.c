@@ -3,6 +3,7 @@
 #include <ctype.h>
 #include <stddef.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <time.h>
 
@@ -10,8 +11,17 @@
 
 /* - TESTING HEADERS - */
 
+#include "arenatests/arenatests.h"
+#include "bitvectests/bitvectests.h"
+#include "dequetests/dequetests.h"
+#include "flatsettests/flatsettests.h"
+#include "hashmaptests/hashmaptests.h"
+#include "queuetests/queuetests.h"
+#include "schedtests/schedtests.h"
+#include "segmentedvectortests/segmentedvectortests.h"
 #include "stacktests/stacktests.h"
 #include "strtests/strtests.h"
+#include "threadpooltests/threadpooltests.h"
 #include "vectortests/vectortests.h"
 
 /* - FUNCTION MACROS - */
@@ -39,14 +49,84 @@
 
 /* - TESTS - */
 
+static test arena_tests[] = {
+    CONSTRUCT_TEST(test_arena_alloc),   CONSTRUCT_TEST(test_arena_containers),
+    CONSTRUCT_TEST(test_arena_realloc), CONSTRUCT_TEST(test_arena_reset),
+    CONSTRUCT_TEST(test_arena_rewind),
+};
+
+static test bitvec_tests[] = {
+    CONSTRUCT_TEST(test_bitvec_bitwise), CONSTRUCT_TEST(test_bitvec_new),
+    CONSTRUCT_TEST(test_bitvec_push),    CONSTRUCT_TEST(test_bitvec_rank),
+    CONSTRUCT_TEST(test_bitvec_select),  CONSTRUCT_TEST(test_bitvec_set),
+};
+
+static test deque_tests[] = {
+    CONSTRUCT_TEST(test_deque_bulk),
+    CONSTRUCT_TEST(test_deque_define),
+    CONSTRUCT_TEST(test_deque_grow),
+    CONSTRUCT_TEST(test_deque_push_pop),
+};
+
+static test flat_set_tests[] = {
+    CONSTRUCT_TEST(test_flat_map_build),
+    CONSTRUCT_TEST(test_flat_set_build),
+    CONSTRUCT_TEST(test_flat_set_insert),
+    CONSTRUCT_TEST(test_flat_set_lower_bound),
+    CONSTRUCT_TEST(test_flat_set_ops),
+};
+
+static test hashmap_tests[] = {
+    CONSTRUCT_TEST(test_concurrent_hashmap_ops),
+    CONSTRUCT_TEST(test_concurrent_hashmap_threads),
+    CONSTRUCT_TEST(test_hashmap_collisions),
+    CONSTRUCT_TEST(test_hashmap_erase),
+    CONSTRUCT_TEST(test_hashmap_iterate),
+    CONSTRUCT_TEST(test_hashmap_put),
+    CONSTRUCT_TEST(test_hashmap_reserve),
+};
+
+static test queue_tests[] = {
+    CONSTRUCT_TEST(test_mpmc_queue_ops),
+    CONSTRUCT_TEST(test_mpmc_queue_threads),
+    CONSTRUCT_TEST(test_spsc_queue_ops),
+    CONSTRUCT_TEST(test_spsc_queue_threads),
+};
+
+static test sched_tests[] = {
+    CONSTRUCT_TEST(test_scheduler_fork_join),
+    CONSTRUCT_TEST(test_scheduler_new),
+    CONSTRUCT_TEST(test_scheduler_parallel_for),
+    CONSTRUCT_TEST(test_scheduler_spawn_many),
+};
+
+static test segmented_vector_tests[] = {
+    CONSTRUCT_TEST(test_concurrent_vector_push),
+    CONSTRUCT_TEST(test_concurrent_vector_snapshot),
+    CONSTRUCT_TEST(test_segmented_vector_for_each),
+    CONSTRUCT_TEST(test_segmented_vector_new),
+    CONSTRUCT_TEST(test_segmented_vector_pop),
+    CONSTRUCT_TEST(test_segmented_vector_push),
+    CONSTRUCT_TEST(test_segmented_vector_reserve),
+};
+
 static test stack_tests[] = {
-    CONSTRUCT_TEST(test_stack_copy),   CONSTRUCT_TEST(test_stack_expand),
-    CONSTRUCT_TEST(test_stack_new),    CONSTRUCT_TEST(test_stack_peek),
-    CONSTRUCT_TEST(test_stack_pop),    CONSTRUCT_TEST(test_stack_push),
-    CONSTRUCT_TEST(test_stack_resize), CONSTRUCT_TEST(test_stack_shrink),
+    CONSTRUCT_TEST(test_concurrent_stack_ops),
+    CONSTRUCT_TEST(test_concurrent_stack_threads),
+    CONSTRUCT_TEST(test_stack_allocator),
+    CONSTRUCT_TEST(test_stack_copy),
+    CONSTRUCT_TEST(test_stack_define),
+    CONSTRUCT_TEST(test_stack_expand),
+    CONSTRUCT_TEST(test_stack_new),
+    CONSTRUCT_TEST(test_stack_peek),
+    CONSTRUCT_TEST(test_stack_pop),
+    CONSTRUCT_TEST(test_stack_push),
+    CONSTRUCT_TEST(test_stack_resize),
+    CONSTRUCT_TEST(test_stack_shrink),
 };
 
 static test str_tests[] = {
+    CONSTRUCT_TEST(test_string_allocator),
     CONSTRUCT_TEST(test_string_append),
     CONSTRUCT_TEST(test_string_clear),
     CONSTRUCT_TEST(test_string_copy),
@@ -60,22 +140,67 @@ static test str_tests[] = {
     CONSTRUCT_TEST(test_string_shrink),
 };
 
+static test threadpool_tests[] = {
+    CONSTRUCT_TEST(test_threadpool_new),
+    CONSTRUCT_TEST(test_threadpool_run),
+};
+
 static test vector_tests[] = {
-    CONSTRUCT_TEST(test_vector_clear),    CONSTRUCT_TEST(test_vector_copy),
-    CONSTRUCT_TEST(test_vector_delete),   CONSTRUCT_TEST(test_vector_expand),
-    CONSTRUCT_TEST(test_vector_for_each), CONSTRUCT_TEST(test_vector_get),
-    CONSTRUCT_TEST(test_vector_new),      CONSTRUCT_TEST(test_vector_index_of),
-    CONSTRUCT_TEST(test_vector_insert),   CONSTRUCT_TEST(test_vector_pop),
-    CONSTRUCT_TEST(test_vector_push),     CONSTRUCT_TEST(test_vector_remove),
-    CONSTRUCT_TEST(test_vector_reset),    CONSTRUCT_TEST(test_vector_resize),
-    CONSTRUCT_TEST(test_vector_set),      CONSTRUCT_TEST(test_vector_shrink),
+    CONSTRUCT_TEST(test_vector_aligned),
+    CONSTRUCT_TEST(test_vector_allocator),
+    CONSTRUCT_TEST(test_vector_append_n),
+    CONSTRUCT_TEST(test_vector_clear),
+    CONSTRUCT_TEST(test_vector_copy),
+    CONSTRUCT_TEST(test_vector_dedup),
+    CONSTRUCT_TEST(test_vector_define),
+    CONSTRUCT_TEST(test_vector_delete),
+    CONSTRUCT_TEST(test_vector_expand),
+    CONSTRUCT_TEST(test_vector_for_each),
+    CONSTRUCT_TEST(test_vector_get),
+    CONSTRUCT_TEST(test_vector_new),
+    CONSTRUCT_TEST(test_vector_index_of),
+    CONSTRUCT_TEST(test_vector_insert),
+    CONSTRUCT_TEST(test_vector_insert_n),
+    CONSTRUCT_TEST(test_vector_mmap),
+    CONSTRUCT_TEST(test_vector_parallel_for_each),
+    CONSTRUCT_TEST(test_vector_parallel_scan),
+    CONSTRUCT_TEST(test_vector_parallel_sort),
+    CONSTRUCT_TEST(test_vector_pop),
+    CONSTRUCT_TEST(test_vector_push),
+    CONSTRUCT_TEST(test_vector_radix_sort),
+    CONSTRUCT_TEST(test_vector_remove),
+    CONSTRUCT_TEST(test_vector_remove_if),
+    CONSTRUCT_TEST(test_vector_remove_range),
+    CONSTRUCT_TEST(test_vector_reserve),
+    CONSTRUCT_TEST(test_vector_reset),
+    CONSTRUCT_TEST(test_vector_resize),
+    CONSTRUCT_TEST(test_vector_retain),
+    CONSTRUCT_TEST(test_vector_search),
+    CONSTRUCT_TEST(test_vector_set),
+    CONSTRUCT_TEST(test_vector_share),
+    CONSTRUCT_TEST(test_vector_shrink),
+    CONSTRUCT_TEST(test_vector_small),
+    CONSTRUCT_TEST(test_vector_soa),
+    CONSTRUCT_TEST(test_vector_sort),
+    CONSTRUCT_TEST(test_vector_sort_stable),
+    CONSTRUCT_TEST(test_vector_splice),
+    CONSTRUCT_TEST(test_vector_swap_remove),
 };
 
 /* - EXTERNAL DEFINITIONS - */
 
 test_suite test_suites[] = {
+    CONSTRUCT_SUITE(arena_tests),
+    CONSTRUCT_SUITE(bitvec_tests),
+    CONSTRUCT_SUITE(deque_tests),
+    CONSTRUCT_SUITE(flat_set_tests),
+    CONSTRUCT_SUITE(hashmap_tests),
+    CONSTRUCT_SUITE(queue_tests),
+    CONSTRUCT_SUITE(sched_tests),
+    CONSTRUCT_SUITE(segmented_vector_tests),
     CONSTRUCT_SUITE(stack_tests),
     CONSTRUCT_SUITE(str_tests),
+    CONSTRUCT_SUITE(threadpool_tests),
     CONSTRUCT_SUITE(vector_tests),
 };
 
@@ -344,6 +469,48 @@ static inline void notify_skipped_all_suite_tests(
   (void)fflush(stdout);
 }
 
+/* - TEST ALLOCATOR - */
+
+static void *counting_alloc(void *const ctx, const size_t size) {
+  counting_allocator_stats *const stats = ctx;
+  void *const block = malloc(size);
+  stats->calls++;
+  if (block != NULL) {
+    stats->live_blocks++;
+    stats->live_bytes += size;
+  }
+  return block;
+}
+
+static void *counting_realloc(void *const ctx, void *const ptr,
+                              const size_t old_size, const size_t new_size) {
+  counting_allocator_stats *const stats = ctx;
+  void *const block = realloc(ptr, new_size);
+  stats->calls++;
+  if (block != NULL) stats->live_bytes += new_size - old_size;
+  return block;
+}
+
+static void counting_free(void *const ctx, void *const ptr, const size_t size) {
+  counting_allocator_stats *const stats = ctx;
+  stats->calls++;
+  stats->live_blocks--;
+  stats->live_bytes -= size;
+  free(ptr);
+}
+
+myclib_allocator counting_allocator(counting_allocator_stats *const stats) {
+  myclib_allocator allocator;
+  allocator.alloc = counting_alloc;
+  allocator.realloc = counting_realloc;
+  allocator.free = counting_free;
+  allocator.ctx = stats;
+  stats->live_blocks = 0;
+  stats->live_bytes = 0;
+  stats->calls = 0;
+  return allocator;
+}
+
 /* - UTILITY - */
 
 inline void for_each_suite(const suite_op op, void *args) {
@@ -47,6 +47,19 @@ typedef struct test_suite {
   bool skip;
 } test_suite;
 
+/*
+ * Statistics gathered by an allocator from `counting_allocator()`.
+ *
+ * `live_blocks` - The number of blocks allocated but not yet freed.
+ * `live_bytes`  - The total size of those blocks.
+ *   `calls`     - The number of calls made through the allocator.
+ */
+typedef struct counting_allocator_stats {
+  size_t live_blocks;
+  size_t live_bytes;
+  size_t calls;
+} counting_allocator_stats;
+
 typedef void (*test_op)(test *, void *);
 typedef void (*test_op_no_arg)(test *);
 
@@ -81,6 +94,15 @@ void for_each_test(const test_suite *suite, test_op, void *args);
 
 input_status parse_input(size_t *index_output);
 
+/* - TEST ALLOCATOR - */
+
+/*
+ * Returns an allocator backed by `malloc()` which records its activity in
+ * `stats`, allowing tests to check that containers route their memory through
+ * the allocators they are given.
+ */
+myclib_allocator counting_allocator(counting_allocator_stats *stats);
+
 /* - CONFIGURATION - */
 
 bool load_config(void);
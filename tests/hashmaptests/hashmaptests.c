@@ -0,0 +1,348 @@
+#include "hashmaptests.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "../../hashmap/concurrenthashmap.h"
+#include "../../hashmap/hashmap.h"
+#include "../../include/myclib.h"
+#include "../../threadpool/threadpool.h"
+#include "../framework.h"
+
+/* Enough keys for the map to grow several times over. */
+#define TEST_LENGTH ((size_t)20011)
+
+#define TEST_THREAD_COUNT ((size_t)4)
+
+/* The number of times each writer task rewrites its keys. */
+#define TEST_ROUNDS ((size_t)4)
+
+DEFINE_HASHMAP(unsigned long, unsigned long, ulmap);
+
+/* A key whose size is not a power of two, hashed with the default hash. */
+typedef struct wide_key {
+  unsigned char bytes[11];
+} wide_key;
+
+static wide_key make_wide_key(const size_t n) {
+  wide_key key;
+  size_t i;
+  for (i = 0; i < sizeof key.bytes; i++)
+    key.bytes[i] = (unsigned char)(n >> ((i % 4) * 8));
+  return key;
+}
+
+/* Sends every key to the same group, so that probes run the whole table. */
+static size_t colliding_hash(const void *const key, const size_t key_size) {
+  (void)key;
+  (void)key_size;
+  return 0;
+}
+
+/* A value spanning two words, so that a torn read shows up as a mismatch. */
+typedef struct checked_value {
+  size_t round;
+  size_t check;
+} checked_value;
+
+typedef struct shared_map {
+  concurrent_hashmap *map;
+  bool failed[TEST_THREAD_COUNT];
+} shared_map;
+
+/*
+ * Even tasks write and erase their own range of keys, while odd tasks read the
+ * range of the task before them, checking that every value they see is whole.
+ */
+static void share_map(void *const ctx, const size_t index) {
+  shared_map *const shared = ctx;
+  const size_t FIRST = (index & ~(size_t)1) * TEST_LENGTH;
+  size_t round;
+  size_t key;
+  shared->failed[index] = false;
+  for (round = 0; round < TEST_ROUNDS; round++) {
+    for (key = FIRST; key < FIRST + TEST_LENGTH; key++) {
+      checked_value value;
+      if (index % 2 == 0) {
+        value.round = round;
+        value.check = key + round;
+        shared->failed[index] |=
+            !concurrent_hashmap_put(shared->map, &key, &value);
+      } else if (concurrent_hashmap_get(shared->map, &key, &value)) {
+        shared->failed[index] |= value.check != key + value.round;
+      }
+    }
+  }
+  if (index % 2 == 0) {
+    for (key = FIRST; key < FIRST + TEST_LENGTH; key += 2)
+      shared->failed[index] |= !concurrent_hashmap_erase(shared->map, &key);
+  }
+}
+
+bool test_concurrent_hashmap_ops(void) {
+  counting_allocator_stats stats;
+  const myclib_allocator ALLOCATOR = counting_allocator(&stats);
+  concurrent_hashmap *map = concurrent_hashmap_new_with(
+      &ALLOCATOR, sizeof(wide_key), sizeof(size_t), 4, NULL);
+  size_t blocks;
+
+  size_t value;
+  size_t i;
+  TEST_CASE_ASSERT(map != NULL);
+  TEST_CASE_ASSERT(concurrent_hashmap_length(map) == 0);
+  for (i = 0; i < TEST_LENGTH; i++) {
+    const wide_key KEY = make_wide_key(i);
+    value = i + 1;
+    TEST_CASE_ASSERT(concurrent_hashmap_put(map, &KEY, &value));
+    /* Keys are found while their shards are partway through resizing. */
+    value = 0;
+    TEST_CASE_ASSERT(concurrent_hashmap_get(map, &KEY, &value));
+    TEST_CASE_ASSERT(value == i + 1);
+  }
+  TEST_CASE_ASSERT(concurrent_hashmap_length(map) == TEST_LENGTH);
+  for (i = 0; i < TEST_LENGTH * 2; i++) {
+    const wide_key KEY = make_wide_key(i);
+    value = 0;
+    if (i < TEST_LENGTH) {
+      TEST_CASE_ASSERT(concurrent_hashmap_get(map, &KEY, &value));
+      TEST_CASE_ASSERT(value == i + 1);
+    } else {
+      TEST_CASE_ASSERT(!concurrent_hashmap_get(map, &KEY, NULL));
+    }
+  }
+  for (i = 0; i < TEST_LENGTH; i += 2) {
+    const wide_key KEY = make_wide_key(i);
+    TEST_CASE_ASSERT(concurrent_hashmap_erase(map, &KEY));
+    TEST_CASE_ASSERT(!concurrent_hashmap_erase(map, &KEY));
+  }
+  for (i = 0; i < TEST_LENGTH; i++) {
+    const wide_key KEY = make_wide_key(i);
+    TEST_CASE_ASSERT(concurrent_hashmap_get(map, &KEY, NULL) == (i % 2 == 1));
+  }
+  /* A `NULL` value keeps an existing one and zeroes a new one. */
+  {
+    const wide_key KEY = make_wide_key(1);
+    TEST_CASE_ASSERT(concurrent_hashmap_put(map, &KEY, NULL));
+    TEST_CASE_ASSERT(concurrent_hashmap_get(map, &KEY, &value) && value == 2);
+  }
+  {
+    const wide_key KEY = make_wide_key(0);
+    TEST_CASE_ASSERT(concurrent_hashmap_put(map, &KEY, NULL));
+    TEST_CASE_ASSERT(concurrent_hashmap_get(map, &KEY, &value) && value == 0);
+  }
+  TEST_CASE_ASSERT(concurrent_hashmap_length(map) == TEST_LENGTH / 2 + 1);
+  /* Only the tables replaced by resizing are freed. */
+  blocks = stats.live_blocks;
+  concurrent_hashmap_reclaim(map);
+  TEST_CASE_ASSERT(stats.live_blocks < blocks);
+  for (i = 1; i < TEST_LENGTH; i += 2) {
+    const wide_key KEY = make_wide_key(i);
+    TEST_CASE_ASSERT(concurrent_hashmap_get(map, &KEY, NULL));
+  }
+
+  concurrent_hashmap_delete(map);
+  TEST_CASE_ASSERT(stats.live_blocks == 0 && stats.live_bytes == 0);
+  return true;
+}
+
+bool test_concurrent_hashmap_threads(void) {
+  threadpool *const pool = threadpool_new(TEST_THREAD_COUNT);
+  static shared_map shared;
+
+  size_t key;
+  size_t i;
+  TEST_CASE_ASSERT(pool != NULL);
+  /* A single shard makes every writer contend for the same lock. */
+  for (i = 0; i < 2; i++) {
+    shared.map = concurrent_hashmap_new(sizeof key, sizeof(checked_value),
+                                        i == 0 ? 1 : 0);
+    TEST_CASE_ASSERT(shared.map != NULL);
+    threadpool_run(pool, share_map, &shared, TEST_THREAD_COUNT);
+    for (key = 0; key < TEST_THREAD_COUNT; key++)
+      TEST_CASE_ASSERT(!shared.failed[key]);
+    TEST_CASE_ASSERT(concurrent_hashmap_length(shared.map) ==
+                     TEST_THREAD_COUNT / 2 * (TEST_LENGTH / 2));
+    for (key = 0; key < TEST_THREAD_COUNT * TEST_LENGTH; key++) {
+      checked_value value;
+      const bool WRITTEN = (key / TEST_LENGTH) % 2 == 0;
+      if (WRITTEN && key % 2 == 1) {
+        TEST_CASE_ASSERT(concurrent_hashmap_get(shared.map, &key, &value));
+        TEST_CASE_ASSERT(value.round == TEST_ROUNDS - 1);
+        TEST_CASE_ASSERT(value.check == key + value.round);
+      } else {
+        TEST_CASE_ASSERT(!concurrent_hashmap_get(shared.map, &key, NULL));
+      }
+    }
+    concurrent_hashmap_delete(shared.map);
+  }
+
+  threadpool_delete(pool);
+  return true;
+}
+
+bool test_hashmap_collisions(void) {
+  /* Enough keys to saturate the overflow count of the first group. */
+  const size_t LENGTH = 300 * HASHMAP_GROUP_WIDTH;
+  ulmap map = ulmap_new_with(NULL, 0, colliding_hash);
+
+  unsigned long key;
+  for (key = 0; key < LENGTH; key++)
+    TEST_CASE_ASSERT(ulmap_put(&map, key, key + 1) != NULL);
+  TEST_CASE_ASSERT(hashmap_length(map) == LENGTH);
+  for (key = 0; key < LENGTH; key++)
+    TEST_CASE_ASSERT(*ulmap_get(map, key) == key + 1);
+  TEST_CASE_ASSERT(ulmap_get(map, LENGTH) == NULL);
+  for (key = 0; key < LENGTH; key += 2) TEST_CASE_ASSERT(ulmap_erase(map, key));
+  for (key = 0; key < LENGTH; key++)
+    TEST_CASE_ASSERT((ulmap_get(map, key) != NULL) == (key % 2 == 1));
+  for (key = 1; key < LENGTH; key += 2) TEST_CASE_ASSERT(ulmap_erase(map, key));
+  TEST_CASE_ASSERT(hashmap_is_empty(map));
+  TEST_CASE_ASSERT(hashmap_next(map, 0) == HASHMAP_BAD_INDEX);
+  TEST_CASE_ASSERT(ulmap_put(&map, LENGTH, 0) != NULL);
+  TEST_CASE_ASSERT(ulmap_get(map, LENGTH) != NULL);
+
+  ulmap_delete(&map);
+  return true;
+}
+
+bool test_hashmap_erase(void) {
+  const unsigned long WINDOW = TEST_LENGTH / 4;
+  /* The window holds one key more than its width between put and erase. */
+  ulmap map = ulmap_new(WINDOW + 1);
+  const size_t CAPACITY = hashmap_capacity(map);
+
+  /*
+   * A sliding window of keys churns through the table many times over. As
+   * erasing leaves no tombstones, the table never needs rebuilding.
+   */
+  unsigned long key;
+  for (key = 0; key < TEST_LENGTH * 4; key++) {
+    TEST_CASE_ASSERT(ulmap_put(&map, key, key) != NULL);
+    if (key >= WINDOW) {
+      TEST_CASE_ASSERT(ulmap_erase(map, key - WINDOW));
+      TEST_CASE_ASSERT(!ulmap_erase(map, key - WINDOW));
+    }
+  }
+  TEST_CASE_ASSERT(hashmap_capacity(map) == CAPACITY);
+  TEST_CASE_ASSERT(hashmap_length(map) == WINDOW);
+  for (key = 0; key < TEST_LENGTH * 4; key++) {
+    const unsigned long *const VALUE = ulmap_get(map, key);
+    if (key + WINDOW < TEST_LENGTH * 4) {
+      TEST_CASE_ASSERT(VALUE == NULL);
+    } else {
+      TEST_CASE_ASSERT(VALUE != NULL && *VALUE == key);
+    }
+  }
+  hashmap_clear(map);
+  TEST_CASE_ASSERT(hashmap_is_empty(map));
+  TEST_CASE_ASSERT(ulmap_get(map, TEST_LENGTH * 4 - 1) == NULL);
+
+  ulmap_delete(&map);
+  return true;
+}
+
+bool test_hashmap_iterate(void) {
+  hashmap map = hashmap_new(wide_key, size_t, 0);
+  size_t seen = 0;
+  size_t erased = 0;
+
+  size_t slot;
+  size_t i;
+  for (i = 0; i < TEST_LENGTH; i++) {
+    const wide_key KEY = make_wide_key(i);
+    TEST_CASE_ASSERT(hashmap_put(map, KEY, i) != NULL);
+  }
+  /* Every key is visited once, even while keys are erased along the way. */
+  hashmap_for_each_slot(map, slot, {
+    const size_t VALUE = *(size_t *)hashmap_value_at(map, slot);
+    const wide_key KEY = make_wide_key(VALUE);
+    TEST_CASE_ASSERT(memcmp(hashmap_key_at(map, slot), &KEY, sizeof KEY) == 0);
+    seen += VALUE + 1;
+    if (VALUE % 3 == 0) {
+      TEST_CASE_ASSERT(hashmap_erase(map, KEY));
+      erased++;
+    }
+  });
+  TEST_CASE_ASSERT(seen == TEST_LENGTH * (TEST_LENGTH + 1) / 2);
+  TEST_CASE_ASSERT(hashmap_length(map) == TEST_LENGTH - erased);
+  for (i = 0; i < TEST_LENGTH; i++) {
+    const wide_key KEY = make_wide_key(i);
+    TEST_CASE_ASSERT(hashmap_contains(map, KEY) == (i % 3 != 0));
+  }
+
+  hashmap_delete(map);
+  return true;
+}
+
+bool test_hashmap_put(void) {
+  ulmap map = ulmap_new(0);
+
+  size_t length = 0;
+  unsigned long i;
+  for (i = 0; i < TEST_LENGTH; i++) {
+    const unsigned long KEY = i * 2654435761UL;
+    const unsigned long *const VALUE = ulmap_put(&map, KEY, i);
+    TEST_CASE_ASSERT(VALUE != NULL && *VALUE == i);
+    TEST_CASE_ASSERT(*ulmap_get(map, KEY) == i);
+    length++;
+  }
+  TEST_CASE_ASSERT(hashmap_length(map) == length);
+  TEST_CASE_ASSERT(hashmap_length(map) <=
+                   HASHMAP_MAX_LOAD(hashmap_capacity(map)));
+  /* Putting an existing key replaces its value. */
+  for (i = 0; i < TEST_LENGTH; i += 7)
+    TEST_CASE_ASSERT(ulmap_put(&map, i * 2654435761UL, ~i) != NULL);
+  TEST_CASE_ASSERT(hashmap_length(map) == length);
+  for (i = 0; i < TEST_LENGTH; i++) {
+    const unsigned long *const VALUE = ulmap_get(map, i * 2654435761UL);
+    TEST_CASE_ASSERT(VALUE != NULL && *VALUE == (i % 7 == 0 ? ~i : i));
+    /* The multiplier is odd, so no other multiple of it collides. */
+    TEST_CASE_ASSERT(ulmap_get(map, (TEST_LENGTH + i) * 2654435761UL) == NULL);
+  }
+  /* A `NULL` value keeps an existing value and zeroes a new one. */
+  i = TEST_LENGTH;
+  TEST_CASE_ASSERT(*(unsigned long *)hashmap_untyped_put(&map, &i, NULL) == 0);
+  i = 7 * 2654435761UL;
+  TEST_CASE_ASSERT(*(unsigned long *)hashmap_untyped_put(&map, &i, NULL) ==
+                   ~7UL);
+
+  ulmap_delete(&map);
+  return true;
+}
+
+bool test_hashmap_reserve(void) {
+  counting_allocator_stats stats;
+  const myclib_allocator ALLOCATOR = counting_allocator(&stats);
+  const size_t COUNT = 1000;
+  /* Without values, the map is a set. */
+  hashmap set =
+      hashmap_untyped_new_with(&ALLOCATOR, sizeof(wide_key), 0, 0, NULL);
+  size_t capacity;
+
+  size_t i;
+  TEST_CASE_ASSERT(set != NULL);
+  TEST_CASE_ASSERT(hashmap_capacity(set) == HASHMAP_GROUP_WIDTH);
+  TEST_CASE_ASSERT(hashmap_reserve(set, COUNT) != NULL);
+  capacity = hashmap_capacity(set);
+  TEST_CASE_ASSERT(HASHMAP_MAX_LOAD(capacity) >= COUNT);
+  TEST_CASE_ASSERT(stats.live_blocks == 1);
+  for (i = 0; i < COUNT; i++) {
+    const wide_key KEY = make_wide_key(i);
+    TEST_CASE_ASSERT(hashmap_untyped_put(&set, &KEY, NULL) != NULL);
+  }
+  /* Nothing was reallocated while filling the reserved room. */
+  TEST_CASE_ASSERT(hashmap_capacity(set) == capacity);
+  TEST_CASE_ASSERT(hashmap_reserve(set, COUNT / 2) == set);
+  TEST_CASE_ASSERT(hashmap_capacity(set) == capacity);
+  TEST_CASE_ASSERT(hashmap_reserve(set, COUNT * 4) != NULL);
+  TEST_CASE_ASSERT(hashmap_length(set) == COUNT);
+  for (i = 0; i < COUNT * 2; i++) {
+    const wide_key KEY = make_wide_key(i);
+    TEST_CASE_ASSERT(hashmap_contains(set, KEY) == (i < COUNT));
+  }
+  TEST_CASE_ASSERT(stats.live_blocks == 1);
+
+  hashmap_delete(set);
+  TEST_CASE_ASSERT(stats.live_blocks == 0 && stats.live_bytes == 0);
+  return true;
+}
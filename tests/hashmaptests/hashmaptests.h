@@ -0,0 +1,20 @@
+#ifndef TEST_HASHMAP_H
+#define TEST_HASHMAP_H
+
+#include "../../include/myclib.h"
+
+bool test_concurrent_hashmap_ops(void);
+
+bool test_concurrent_hashmap_threads(void);
+
+bool test_hashmap_collisions(void);
+
+bool test_hashmap_erase(void);
+
+bool test_hashmap_iterate(void);
+
+bool test_hashmap_put(void);
+
+bool test_hashmap_reserve(void);
+
+#endif
@@ -0,0 +1,255 @@
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE (200112L)
+#endif
+
+#include "queuetests.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stddef.h>
+
+#include "../../include/myclib.h"
+#include "../../queue/mpmcqueue.h"
+#include "../../queue/spscqueue.h"
+#include "../framework.h"
+
+/* Enough elements to lap the rings many times over. */
+#define TEST_LENGTH ((size_t)100000)
+
+#define TEST_CAPACITY ((size_t)64)
+
+/* The number of producers, and of consumers, sharing an MPMC queue. */
+#define TEST_PAIRS ((size_t)2)
+
+/* Elements are moved in batches of up to this many, and sometimes singly. */
+#define TEST_BATCH ((size_t)7)
+
+DEFINE_MPMC_QUEUE(size_t, smpmc);
+DEFINE_SPSC_QUEUE(size_t, sspsc);
+
+/* - INTERNAL - */
+
+typedef struct producer_ctx {
+  void *queue;
+  size_t first;
+} producer_ctx;
+
+/*
+ * Pushes `TEST_LENGTH` consecutive values from `first` to either kind of
+ * queue, yielding while the queue is full, which keeps single-core machines
+ * moving.
+ */
+static void produce(void *const queue, const size_t first, const bool spsc) {
+  size_t batch[TEST_BATCH];
+  size_t next = first;
+  while (next < first + TEST_LENGTH) {
+    const size_t LEFT = first + TEST_LENGTH - next;
+    const size_t COUNT =
+        next % 3 == 0 ? 1 : LEFT < TEST_BATCH ? LEFT : TEST_BATCH;
+    size_t pushed;
+    size_t i;
+    for (i = 0; i < COUNT; i++) batch[i] = next + i;
+    pushed = spsc ? spsc_queue_untyped_push_n(queue, batch, COUNT,
+                                              sizeof(size_t))
+                  : mpmc_queue_untyped_push_n(queue, batch, COUNT,
+                                              sizeof(size_t));
+    if (pushed == 0) sched_yield();
+    next += pushed;
+  }
+}
+
+static void *produce_spsc(void *const ctx) {
+  const producer_ctx *const PRODUCER = ctx;
+  produce(PRODUCER->queue, PRODUCER->first, true);
+  return NULL;
+}
+
+static void *produce_mpmc(void *const ctx) {
+  const producer_ctx *const PRODUCER = ctx;
+  produce(PRODUCER->queue, PRODUCER->first, false);
+  return NULL;
+}
+
+/*
+ * Each consumer pops `TEST_LENGTH` values, counting each in `seen` and checking
+ * that the values of each producer arrive in the order they were pushed.
+ */
+typedef struct consumer_ctx {
+  void *queue;
+  size_t *seen;
+  bool ordered;
+} consumer_ctx;
+
+static void *consume_mpmc(void *const ctx) {
+  consumer_ctx *const consumer = ctx;
+  size_t last[TEST_PAIRS];
+  size_t batch[TEST_BATCH];
+  size_t popped = 0;
+  size_t i;
+  for (i = 0; i < TEST_PAIRS; i++) last[i] = 0;
+  consumer->ordered = true;
+  while (popped < TEST_LENGTH) {
+    const size_t COUNT = TEST_LENGTH - popped < TEST_BATCH
+                             ? TEST_LENGTH - popped
+                             : TEST_BATCH;
+    const size_t GOT =
+        mpmc_queue_untyped_pop_n(consumer->queue, batch, COUNT, sizeof(size_t));
+    if (GOT == 0) sched_yield();
+    for (i = 0; i < GOT; i++) {
+      const size_t PRODUCER = batch[i] / TEST_LENGTH;
+      consumer->seen[batch[i]]++;
+      if (batch[i] + 1 <= last[PRODUCER]) consumer->ordered = false;
+      last[PRODUCER] = batch[i] + 1;
+    }
+    popped += GOT;
+  }
+  return NULL;
+}
+
+/* - TESTS - */
+
+bool test_mpmc_queue_ops(void) {
+  counting_allocator_stats stats;
+  const myclib_allocator ALLOCATOR = counting_allocator(&stats);
+  smpmc q = smpmc_new_with(&ALLOCATOR, 5);
+  /* An element whose size is not a multiple of the word size. */
+  mpmc_queue(char) chars = mpmc_queue_new(char, 3);
+  size_t batch[10];
+  char c;
+
+  size_t value;
+  size_t i;
+  TEST_CASE_ASSERT(q != NULL && chars != NULL);
+  TEST_CASE_ASSERT(mpmc_queue_capacity(q) == 8);
+  TEST_CASE_ASSERT(!smpmc_pop(q, &value));
+  for (i = 0; i < 8; i++) TEST_CASE_ASSERT(smpmc_push(q, i));
+  TEST_CASE_ASSERT(!smpmc_push(q, i));
+  TEST_CASE_ASSERT(smpmc_pop(q, &value) && value == 0);
+  TEST_CASE_ASSERT(mpmc_queue_pop_n(q, batch, 3) == 3);
+  for (i = 0; i < 3; i++) TEST_CASE_ASSERT(batch[i] == i + 1);
+  /* A batch takes only the room there is, wrapping around the ring. */
+  for (i = 0; i < ARR_LEN(batch); i++) batch[i] = 100 + i;
+  TEST_CASE_ASSERT(mpmc_queue_push_n(q, batch, ARR_LEN(batch)) == 4);
+  TEST_CASE_ASSERT(mpmc_queue_pop_n(q, batch, ARR_LEN(batch)) == 8);
+  for (i = 0; i < 4; i++) TEST_CASE_ASSERT(batch[i] == i + 4);
+  for (i = 4; i < 8; i++) TEST_CASE_ASSERT(batch[i] == 100 + i - 4);
+  TEST_CASE_ASSERT(mpmc_queue_pop_n(q, batch, 1) == 0);
+
+  for (i = 0; i < TEST_LENGTH; i++) {
+    c = (char)i;
+    TEST_CASE_ASSERT(mpmc_queue_push(chars, c));
+    c = 0;
+    TEST_CASE_ASSERT(mpmc_queue_pop(chars, c) && c == (char)i);
+  }
+
+  mpmc_queue_delete(chars);
+  TEST_CASE_ASSERT(chars == NULL);
+  smpmc_delete(&q);
+  TEST_CASE_ASSERT(stats.live_blocks == 0 && stats.live_bytes == 0);
+  return true;
+}
+
+bool test_mpmc_queue_threads(void) {
+  static size_t seen[TEST_PAIRS][TEST_PAIRS * TEST_LENGTH];
+  pthread_t producers[TEST_PAIRS];
+  pthread_t consumers[TEST_PAIRS];
+  producer_ctx producer_ctxs[TEST_PAIRS];
+  consumer_ctx consumer_ctxs[TEST_PAIRS];
+  mpmc_queue(size_t) q = mpmc_queue_new(size_t, TEST_CAPACITY);
+
+  size_t i;
+  size_t j;
+  TEST_CASE_ASSERT(q != NULL);
+  for (i = 0; i < TEST_PAIRS; i++) {
+    for (j = 0; j < TEST_PAIRS * TEST_LENGTH; j++) seen[i][j] = 0;
+    producer_ctxs[i].queue = q;
+    producer_ctxs[i].first = i * TEST_LENGTH;
+    consumer_ctxs[i].queue = q;
+    consumer_ctxs[i].seen = seen[i];
+    TEST_CASE_ASSERT(pthread_create(&consumers[i], NULL, consume_mpmc,
+                                    &consumer_ctxs[i]) == 0);
+    TEST_CASE_ASSERT(pthread_create(&producers[i], NULL, produce_mpmc,
+                                    &producer_ctxs[i]) == 0);
+  }
+  for (i = 0; i < TEST_PAIRS; i++) {
+    pthread_join(producers[i], NULL);
+    pthread_join(consumers[i], NULL);
+  }
+  /* Every value was popped exactly once, by one consumer or another. */
+  for (i = 0; i < TEST_PAIRS; i++) TEST_CASE_ASSERT(consumer_ctxs[i].ordered);
+  for (j = 0; j < TEST_PAIRS * TEST_LENGTH; j++) {
+    size_t count = 0;
+    for (i = 0; i < TEST_PAIRS; i++) count += seen[i][j];
+    TEST_CASE_ASSERT(count == 1);
+  }
+  TEST_CASE_ASSERT(mpmc_queue_pop_n(q, &i, 1) == 0);
+
+  mpmc_queue_delete(q);
+  return true;
+}
+
+bool test_spsc_queue_ops(void) {
+  counting_allocator_stats stats;
+  const myclib_allocator ALLOCATOR = counting_allocator(&stats);
+  sspsc q = sspsc_new_with(&ALLOCATOR, 6);
+  spsc_queue(char) chars = spsc_queue_new(char, 0);
+  size_t batch[10];
+  char c = 'a';
+
+  size_t value;
+  size_t i;
+  TEST_CASE_ASSERT(q != NULL && chars != NULL);
+  TEST_CASE_ASSERT(spsc_queue_capacity(q) == 8);
+  TEST_CASE_ASSERT(spsc_queue_capacity(chars) == 1);
+  TEST_CASE_ASSERT(!sspsc_pop(q, &value));
+  for (i = 0; i < 8; i++) TEST_CASE_ASSERT(sspsc_push(q, i));
+  TEST_CASE_ASSERT(!sspsc_push(q, i));
+  TEST_CASE_ASSERT(sspsc_pop(q, &value) && value == 0);
+  TEST_CASE_ASSERT(spsc_queue_pop_n(q, batch, 3) == 3);
+  for (i = 0; i < 3; i++) TEST_CASE_ASSERT(batch[i] == i + 1);
+  for (i = 0; i < ARR_LEN(batch); i++) batch[i] = 100 + i;
+  TEST_CASE_ASSERT(spsc_queue_push_n(q, batch, ARR_LEN(batch)) == 4);
+  TEST_CASE_ASSERT(spsc_queue_pop_n(q, batch, ARR_LEN(batch)) == 8);
+  for (i = 0; i < 4; i++) TEST_CASE_ASSERT(batch[i] == i + 4);
+  for (i = 4; i < 8; i++) TEST_CASE_ASSERT(batch[i] == 100 + i - 4);
+  TEST_CASE_ASSERT(spsc_queue_pop_n(q, batch, 1) == 0);
+
+  TEST_CASE_ASSERT(spsc_queue_push(chars, c));
+  TEST_CASE_ASSERT(!spsc_queue_push(chars, c));
+  c = 0;
+  TEST_CASE_ASSERT(spsc_queue_pop(chars, c) && c == 'a');
+
+  spsc_queue_delete(chars);
+  sspsc_delete(&q);
+  TEST_CASE_ASSERT(q == NULL);
+  TEST_CASE_ASSERT(stats.live_blocks == 0 && stats.live_bytes == 0);
+  return true;
+}
+
+bool test_spsc_queue_threads(void) {
+  spsc_queue(size_t) q = spsc_queue_new(size_t, TEST_CAPACITY);
+  pthread_t producer;
+  producer_ctx ctx;
+  size_t batch[TEST_BATCH];
+  size_t popped = 0;
+  bool ordered = true;
+
+  size_t i;
+  TEST_CASE_ASSERT(q != NULL);
+  ctx.queue = q;
+  ctx.first = 0;
+  TEST_CASE_ASSERT(pthread_create(&producer, NULL, produce_spsc, &ctx) == 0);
+  /* The values arrive in order, each exactly once. */
+  while (popped < TEST_LENGTH) {
+    const size_t GOT = spsc_queue_pop_n(q, batch, TEST_BATCH);
+    if (GOT == 0) sched_yield();
+    for (i = 0; i < GOT; i++) ordered &= batch[i] == popped + i;
+    popped += GOT;
+  }
+  pthread_join(producer, NULL);
+  TEST_CASE_ASSERT(ordered);
+  TEST_CASE_ASSERT(spsc_queue_pop_n(q, batch, 1) == 0);
+
+  spsc_queue_delete(q);
+  return true;
+}
@@ -0,0 +1,14 @@
+#ifndef TEST_QUEUE_H
+#define TEST_QUEUE_H
+
+#include "../../include/myclib.h"
+
+bool test_mpmc_queue_ops(void);
+
+bool test_mpmc_queue_threads(void);
+
+bool test_spsc_queue_ops(void);
+
+bool test_spsc_queue_threads(void);
+
+#endif
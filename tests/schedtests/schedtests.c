@@ -0,0 +1,165 @@
+#include "schedtests.h"
+
+#include <stddef.h>
+
+#include "../../include/myclib.h"
+#include "../../sched/scheduler.h"
+#include "../../threadpool/threadpool.h"
+#include "../framework.h"
+
+#define TEST_THREAD_COUNT ((size_t)4)
+
+/* Large enough to fork tens of thousands of tasks. */
+#define TEST_FIB_N ((size_t)20)
+
+/* The 20th Fibonacci number. */
+#define TEST_FIB_RESULT ((size_t)6765)
+
+#define TEST_LENGTH ((size_t)100000)
+
+/* More than a deque holds before it first grows. */
+#define TEST_SPAWN_COUNT ((size_t)1000)
+
+/* - INTERNAL - */
+
+typedef struct fib_ctx {
+  size_t n;
+  size_t result;
+} fib_ctx;
+
+static void fib(scheduler_worker *const worker, void *const arg) {
+  fib_ctx *const ctx = arg;
+  fib_ctx left;
+  fib_ctx right;
+  scheduler_group group;
+  scheduler_job job;
+  if (ctx->n < 2) {
+    ctx->result = ctx->n;
+    return;
+  }
+  left.n = ctx->n - 1;
+  right.n = ctx->n - 2;
+  scheduler_group_init(&group);
+  scheduler_spawn(worker, &group, &job, fib, &left);
+  fib(worker, &right);
+  scheduler_wait(worker, &group);
+  ctx->result = left.result + right.result;
+}
+
+/* Every iteration counts its own visits, and every chunk its length. */
+typedef struct visit_ctx {
+  size_t *visits;
+  size_t total;
+} visit_ctx;
+
+static void visit(void *const arg, const size_t begin, const size_t end) {
+  visit_ctx *const ctx = arg;
+  size_t i;
+  for (i = begin; i < end; i++)
+    __atomic_fetch_add(&ctx->visits[i], 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&ctx->total, end - begin, __ATOMIC_RELAXED);
+}
+
+static void visit_nested(scheduler_worker *const worker, void *const arg) {
+  scheduler_parallel_for(worker, 0, TEST_LENGTH, 0, visit, arg);
+}
+
+static void count_spawned(scheduler_worker *const worker, void *const arg) {
+  __atomic_fetch_add((size_t *)arg, scheduler_worker_index(worker) + 1,
+                     __ATOMIC_RELAXED);
+}
+
+typedef struct spawn_ctx {
+  size_t indices;
+  scheduler_job jobs[TEST_SPAWN_COUNT];
+} spawn_ctx;
+
+static void spawn_many(scheduler_worker *const worker, void *const arg) {
+  spawn_ctx *const ctx = arg;
+  scheduler_group group;
+  size_t i;
+  scheduler_group_init(&group);
+  for (i = 0; i < TEST_SPAWN_COUNT; i++)
+    scheduler_spawn(worker, &group, &ctx->jobs[i], count_spawned,
+                    &ctx->indices);
+  scheduler_wait(worker, &group);
+}
+
+/* - TESTS - */
+
+bool test_scheduler_fork_join(void) {
+  size_t threads;
+  for (threads = 1; threads <= TEST_THREAD_COUNT; threads++) {
+    scheduler *const sched = scheduler_new(threads);
+    fib_ctx ctx;
+    TEST_CASE_ASSERT(sched != NULL);
+    ctx.n = TEST_FIB_N;
+    scheduler_run(sched, fib, &ctx);
+    TEST_CASE_ASSERT(ctx.result == TEST_FIB_RESULT);
+    scheduler_delete(sched);
+  }
+  return true;
+}
+
+bool test_scheduler_new(void) {
+  scheduler *sched = scheduler_new(TEST_THREAD_COUNT);
+
+  TEST_CASE_ASSERT(sched != NULL);
+  TEST_CASE_ASSERT(scheduler_size(sched) == TEST_THREAD_COUNT);
+  scheduler_delete(sched);
+
+  sched = scheduler_new(0);
+  TEST_CASE_ASSERT(sched != NULL);
+  TEST_CASE_ASSERT(scheduler_size(sched) == threadpool_cpu_count());
+  scheduler_delete(sched);
+
+  scheduler_delete(NULL);
+  return true;
+}
+
+bool test_scheduler_parallel_for(void) {
+  scheduler *const sched = scheduler_new(TEST_THREAD_COUNT);
+  static size_t visits[TEST_LENGTH];
+  const size_t GRAINS[] = {0, 1, 7, 1000, TEST_LENGTH * 2};
+
+  visit_ctx ctx;
+  size_t g;
+  size_t i;
+  TEST_CASE_ASSERT(sched != NULL);
+  ctx.visits = visits;
+  ctx.total = 0;
+  for (i = 0; i < TEST_LENGTH; i++) visits[i] = 0;
+  for (g = 0; g < ARR_LEN(GRAINS); g++)
+    scheduler_run_for(sched, 0, TEST_LENGTH, GRAINS[g], visit, &ctx);
+  scheduler_run(sched, visit_nested, &ctx);
+  /* Empty and offset ranges. */
+  scheduler_run_for(sched, 5, 5, 1, visit, &ctx);
+  scheduler_run_for(sched, TEST_LENGTH / 2, TEST_LENGTH, 3, visit, &ctx);
+  for (i = 0; i < TEST_LENGTH; i++) {
+    const size_t EXPECTED = ARR_LEN(GRAINS) + 1 + (i >= TEST_LENGTH / 2);
+    TEST_CASE_ASSERT(visits[i] == EXPECTED);
+  }
+  TEST_CASE_ASSERT(ctx.total ==
+                   (ARR_LEN(GRAINS) + 1) * TEST_LENGTH + TEST_LENGTH / 2);
+
+  scheduler_delete(sched);
+  return true;
+}
+
+bool test_scheduler_spawn_many(void) {
+  scheduler *const sched = scheduler_new(TEST_THREAD_COUNT);
+  static spawn_ctx ctx;
+
+  size_t round;
+  TEST_CASE_ASSERT(sched != NULL);
+  /* Every spawned task runs exactly once, on a worker with a valid index. */
+  for (round = 0; round < 3; round++) {
+    ctx.indices = 0;
+    scheduler_run(sched, spawn_many, &ctx);
+    TEST_CASE_ASSERT(ctx.indices >= TEST_SPAWN_COUNT);
+    TEST_CASE_ASSERT(ctx.indices <= TEST_SPAWN_COUNT * TEST_THREAD_COUNT);
+  }
+
+  scheduler_delete(sched);
+  return true;
+}
@@ -0,0 +1,14 @@
+#ifndef TEST_SCHED_H
+#define TEST_SCHED_H
+
+#include "../../include/myclib.h"
+
+bool test_scheduler_fork_join(void);
+
+bool test_scheduler_new(void);
+
+bool test_scheduler_parallel_for(void);
+
+bool test_scheduler_spawn_many(void);
+
+#endif
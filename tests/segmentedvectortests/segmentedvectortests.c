@@ -0,0 +1,177 @@
+#include "segmentedvectortests.h"
+
+#include <stddef.h>
+
+#include "../../include/myclib.h"
+#include "../../segmentedvector/concurrentvector.h"
+#include "../../segmentedvector/segmentedvector.h"
+#include "../../threadpool/threadpool.h"
+#include "../framework.h"
+
+/* Enough elements to fill several chunks. */
+#define TEST_LENGTH ((size_t)1000)
+
+#define TEST_THREAD_COUNT ((size_t)4)
+
+static void add_to_elem(void *args[]) {
+  *(size_t *)args[1] += *(const size_t *)args[2];
+}
+
+static void sum_chunk(void *const chunk, const size_t count, void *const args) {
+  const size_t *const elems = chunk;
+  size_t i;
+  for (i = 0; i < count; i++) *(size_t *)args += elems[i];
+}
+
+/* Each task pushes its own range of `TEST_LENGTH` values. */
+static void push_range(void *const ctx, const size_t index) {
+  concurrent_vector(size_t) vec = ctx;
+  size_t i;
+  for (i = index * TEST_LENGTH; i < (index + 1) * TEST_LENGTH; i++)
+    concurrent_vector_push(vec, i);
+}
+
+bool test_concurrent_vector_push(void) {
+  threadpool *const pool = threadpool_new(TEST_THREAD_COUNT);
+  concurrent_vector(size_t) vec = concurrent_vector_new(size_t);
+  static bool seen[TEST_THREAD_COUNT * TEST_LENGTH];
+
+  size_t i;
+  TEST_CASE_ASSERT(pool != NULL);
+  TEST_CASE_ASSERT(vec != NULL);
+  threadpool_run(pool, push_range, vec, TEST_THREAD_COUNT);
+  TEST_CASE_ASSERT(concurrent_vector_snapshot(vec) ==
+                   TEST_THREAD_COUNT * TEST_LENGTH);
+  /* Every value must land in exactly one slot. */
+  for (i = 0; i < TEST_THREAD_COUNT * TEST_LENGTH; i++) seen[i] = false;
+  for (i = 0; i < TEST_THREAD_COUNT * TEST_LENGTH; i++) {
+    const size_t VALUE = concurrent_vector_get(vec, i);
+    TEST_CASE_ASSERT(VALUE < TEST_THREAD_COUNT * TEST_LENGTH);
+    TEST_CASE_ASSERT(!seen[VALUE]);
+    seen[VALUE] = true;
+  }
+
+  concurrent_vector_delete(vec);
+  threadpool_delete(pool);
+  return true;
+}
+
+bool test_concurrent_vector_snapshot(void) {
+  counting_allocator_stats stats;
+  const myclib_allocator ALLOCATOR = counting_allocator(&stats);
+  concurrent_vector(size_t) vec =
+      concurrent_vector_new_with(&ALLOCATOR, size_t);
+  const size_t *first;
+
+  size_t sum = 0;
+  size_t i;
+  TEST_CASE_ASSERT(vec != NULL);
+  TEST_CASE_ASSERT(concurrent_vector_allocator(vec) == &ALLOCATOR);
+  TEST_CASE_ASSERT(concurrent_vector_snapshot(vec) == 0);
+  TEST_CASE_ASSERT(concurrent_vector_reserve(vec, TEST_LENGTH) == vec);
+  for (i = 0; i < TEST_LENGTH; i++)
+    TEST_CASE_ASSERT(concurrent_vector_push(vec, i) == i);
+  first = &concurrent_vector_get(vec, 0);
+  TEST_CASE_ASSERT(concurrent_vector_for_each_chunk(vec, sum_chunk, &sum) ==
+                   TEST_LENGTH);
+  TEST_CASE_ASSERT(sum == TEST_LENGTH * (TEST_LENGTH - 1) / 2);
+  /* A slot claimed but not yet filled ends every snapshot before it. */
+  convec_header(vec)->claimed++;
+  for (i = 0; i < TEST_LENGTH; i++) concurrent_vector_push(vec, i);
+  TEST_CASE_ASSERT(concurrent_vector_snapshot(vec) == TEST_LENGTH);
+  TEST_CASE_ASSERT(first == &concurrent_vector_get(vec, 0));
+  concurrent_vector_delete(vec);
+  TEST_CASE_ASSERT(vec == NULL);
+  TEST_CASE_ASSERT(stats.live_blocks == 0);
+  TEST_CASE_ASSERT(stats.live_bytes == 0);
+  return true;
+}
+
+bool test_segmented_vector_for_each(void) {
+  segmented_vector(size_t) vec = segmented_vector_new(size_t);
+
+  size_t increment = 1;
+  size_t sum = 0;
+  size_t i;
+  for (i = 0; i < TEST_LENGTH; i++) segmented_vector_push(vec, i);
+  segmented_vector_for_each_s(vec, add_to_elem, &increment);
+  segmented_vector_for_each_chunk(vec, sum_chunk, &sum);
+  TEST_CASE_ASSERT(sum == TEST_LENGTH * (TEST_LENGTH + 1) / 2);
+
+  segmented_vector_delete(vec);
+  return true;
+}
+
+bool test_segmented_vector_new(void) {
+  counting_allocator_stats stats;
+  const myclib_allocator ALLOCATOR = counting_allocator(&stats);
+  segmented_vector(int) vec = segmented_vector_new_with(&ALLOCATOR, int);
+
+  size_t i;
+  TEST_CASE_ASSERT(vec != NULL);
+  TEST_CASE_ASSERT(segmented_vector_allocator(vec) == &ALLOCATOR);
+  TEST_CASE_ASSERT(segmented_vector_is_empty(vec));
+  TEST_CASE_ASSERT(segmented_vector_capacity(vec) == 0);
+  for (i = 0; i < TEST_LENGTH; i++) segmented_vector_push(vec, (int)i);
+  segmented_vector_delete(vec);
+  TEST_CASE_ASSERT(vec == NULL);
+  TEST_CASE_ASSERT(stats.live_blocks == 0);
+  TEST_CASE_ASSERT(stats.live_bytes == 0);
+  return true;
+}
+
+bool test_segmented_vector_pop(void) {
+  segmented_vector(size_t) vec = segmented_vector_new(size_t);
+
+  size_t i;
+  for (i = 0; i < TEST_LENGTH; i++) segmented_vector_push_s(vec, i);
+  for (i = TEST_LENGTH; i > TEST_LENGTH / 2; i--)
+    TEST_CASE_ASSERT(segmented_vector_pop(vec) == i - 1);
+  for (; i > 0; i--)
+    TEST_CASE_ASSERT(*(size_t *)segmented_vector_pop_s(vec) == i - 1);
+  TEST_CASE_ASSERT(segmented_vector_is_empty(vec));
+
+  segmented_vector_delete(vec);
+  return true;
+}
+
+bool test_segmented_vector_push(void) {
+  segmented_vector(size_t) vec = segmented_vector_new(size_t);
+  const size_t *first;
+
+  size_t i;
+  segmented_vector_push(vec, 0);
+  first = &segmented_vector_get(vec, 0);
+  for (i = 1; i < TEST_LENGTH; i++) {
+    if (i % 2 == 0)
+      segmented_vector_push(vec, i);
+    else
+      TEST_CASE_ASSERT(*(size_t *)segmented_vector_push_s(vec, i) == i);
+  }
+  TEST_CASE_ASSERT(segmented_vector_length(vec) == TEST_LENGTH);
+  /* Growth must not move existing elements. */
+  TEST_CASE_ASSERT(first == &segmented_vector_get(vec, 0));
+  for (i = 0; i < TEST_LENGTH; i++) {
+    TEST_CASE_ASSERT(segmented_vector_get(vec, i) == i);
+    TEST_CASE_ASSERT(*(size_t *)segmented_vector_get_s(vec, i) == i);
+  }
+
+  segmented_vector_delete(vec);
+  return true;
+}
+
+bool test_segmented_vector_reserve(void) {
+  segmented_vector(char) vec = segmented_vector_new(char);
+
+  TEST_CASE_ASSERT(segmented_vector_reserve(vec, 1) == vec);
+  TEST_CASE_ASSERT(segmented_vector_capacity(vec) ==
+                   (size_t)1 << SEGVEC_FIRST_CHUNK_SHIFT);
+  TEST_CASE_ASSERT(segmented_vector_reserve(vec, TEST_LENGTH) == vec);
+  TEST_CASE_ASSERT(segmented_vector_capacity(vec) >= TEST_LENGTH);
+  TEST_CASE_ASSERT(segmented_vector_capacity(vec) < 2 * TEST_LENGTH + 16);
+  TEST_CASE_ASSERT(segmented_vector_is_empty(vec));
+  TEST_CASE_ASSERT(segmented_vector_reserve(vec, (size_t)-1) == NULL);
+
+  segmented_vector_delete(vec);
+  return true;
+}
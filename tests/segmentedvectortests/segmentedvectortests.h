@@ -0,0 +1,20 @@
+#ifndef TEST_SEGMENTED_VECTOR_H
+#define TEST_SEGMENTED_VECTOR_H
+
+#include "../../include/myclib.h"
+
+bool test_concurrent_vector_push(void);
+
+bool test_concurrent_vector_snapshot(void);
+
+bool test_segmented_vector_for_each(void);
+
+bool test_segmented_vector_new(void);
+
+bool test_segmented_vector_pop(void);
+
+bool test_segmented_vector_push(void);
+
+bool test_segmented_vector_reserve(void);
+
+#endif
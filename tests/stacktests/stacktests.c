@@ -3,9 +3,163 @@
 #include <stddef.h>
 
 #include "../../include/myclib.h"
+#include "../../stack/concurrentstack.h"
 #include "../../stack/stack.h"
+#include "../../threadpool/threadpool.h"
 #include "../framework.h"
 
+#define TEST_THREAD_COUNT ((size_t)4)
+
+/* Few enough nodes that the threads keep running out of them. */
+#define TEST_NODE_COUNT ((size_t)16)
+
+#define TEST_ROUNDS ((size_t)20000)
+
+DEFINE_STACK(size_t, sstack);
+
+static void double_value(size_t *const value, void *const args) {
+  (void)args;
+  *value *= 2;
+}
+
+typedef struct test_node {
+  size_t id;
+  size_t holders;
+  concurrent_stack_node link;
+} test_node;
+
+/*
+ * Repeatedly pops a few nodes, checking that no other thread holds them, and
+ * pushes them back either singly or as one chain.
+ */
+static void churn_nodes(void *const ctx, const size_t index) {
+  concurrent_stack *const stk = ctx;
+  concurrent_stack_node *held[3];
+  size_t round;
+  for (round = 0; round < TEST_ROUNDS; round++) {
+    const size_t WANTED = 1 + ((round + index) % ARR_LEN(held));
+    size_t count;
+    size_t i;
+    for (count = 0; count < WANTED; count++) {
+      held[count] = concurrent_stack_pop(stk);
+      if (held[count] == NULL) break;
+      if (__atomic_fetch_add(&concurrent_stack_entry(held[count], test_node,
+                                                     link)->holders,
+                             1, __ATOMIC_RELAXED) != 0)
+        return;
+    }
+    for (i = 0; i < count; i++) {
+      __atomic_fetch_sub(&concurrent_stack_entry(held[i], test_node, link)
+                              ->holders,
+                         1, __ATOMIC_RELAXED);
+    }
+    if (count == 0) continue;
+    if (round % 2 == 0) {
+      for (i = 0; i < count; i++) concurrent_stack_push(stk, held[i]);
+    } else {
+      for (i = 0; i + 1 < count; i++)
+        concurrent_stack_link(held[i], held[i + 1]);
+      concurrent_stack_push_chain(stk, held[0], held[count - 1]);
+    }
+  }
+}
+
+bool test_concurrent_stack_ops(void) {
+  counting_allocator_stats stats;
+  const myclib_allocator ALLOCATOR = counting_allocator(&stats);
+  concurrent_stack *stk = concurrent_stack_new_with(&ALLOCATOR);
+  test_node nodes[5];
+  concurrent_stack_node *node;
+
+  size_t i;
+  TEST_CASE_ASSERT(stk != NULL);
+  TEST_CASE_ASSERT(stats.live_blocks == 1);
+  TEST_CASE_ASSERT(concurrent_stack_is_empty(stk));
+  TEST_CASE_ASSERT(concurrent_stack_pop(stk) == NULL);
+  TEST_CASE_ASSERT(concurrent_stack_pop_all(stk) == NULL);
+  for (i = 0; i < ARR_LEN(nodes); i++) nodes[i].id = i;
+  for (i = 0; i < 2; i++) concurrent_stack_push(stk, &nodes[i].link);
+  TEST_CASE_ASSERT(!concurrent_stack_is_empty(stk));
+  /* A chain lands on top in one piece, leaving its first node on top. */
+  concurrent_stack_link(&nodes[2].link, &nodes[3].link);
+  concurrent_stack_link(&nodes[3].link, &nodes[4].link);
+  concurrent_stack_push_chain(stk, &nodes[2].link, &nodes[4].link);
+  for (i = 2; i < ARR_LEN(nodes); i++) {
+    node = concurrent_stack_pop(stk);
+    TEST_CASE_ASSERT(node != NULL);
+    TEST_CASE_ASSERT(concurrent_stack_entry(node, test_node, link)->id == i);
+  }
+  /* The rest come off last in, first out. */
+  node = concurrent_stack_pop_all(stk);
+  TEST_CASE_ASSERT(concurrent_stack_is_empty(stk));
+  TEST_CASE_ASSERT(node == &nodes[1].link);
+  TEST_CASE_ASSERT(node->next == &nodes[0].link);
+  TEST_CASE_ASSERT(node->next->next == NULL);
+
+  concurrent_stack_delete(stk);
+  TEST_CASE_ASSERT(stats.live_blocks == 0);
+  TEST_CASE_ASSERT(stats.live_bytes == 0);
+  return true;
+}
+
+bool test_concurrent_stack_threads(void) {
+  threadpool *const pool = threadpool_new(TEST_THREAD_COUNT);
+  concurrent_stack *const stk = concurrent_stack_new();
+  static test_node nodes[TEST_NODE_COUNT];
+  static bool seen[TEST_NODE_COUNT];
+  concurrent_stack_node *node;
+
+  size_t count = 0;
+  size_t i;
+  TEST_CASE_ASSERT(pool != NULL);
+  TEST_CASE_ASSERT(stk != NULL);
+  for (i = 0; i < TEST_NODE_COUNT; i++) {
+    nodes[i].holders = 0;
+    seen[i] = false;
+    concurrent_stack_push(stk, &nodes[i].link);
+  }
+  threadpool_run(pool, churn_nodes, stk, TEST_THREAD_COUNT);
+  /* Every node must be back exactly once, and never have been shared. */
+  for (node = concurrent_stack_pop_all(stk); node != NULL; node = node->next) {
+    const test_node *const OWNER =
+        concurrent_stack_entry(node, test_node, link);
+    TEST_CASE_ASSERT(OWNER->holders == 0);
+    TEST_CASE_ASSERT(!seen[OWNER - nodes]);
+    seen[OWNER - nodes] = true;
+    count++;
+  }
+  TEST_CASE_ASSERT(count == TEST_NODE_COUNT);
+
+  concurrent_stack_delete(stk);
+  threadpool_delete(pool);
+  return true;
+}
+
+bool test_stack_allocator(void) {
+  counting_allocator_stats stats;
+  const myclib_allocator ALLOCATOR = counting_allocator(&stats);
+  stack(int) stk = stack_new_with(&ALLOCATOR, int, 0);
+  stack(int) copy;
+
+  size_t i;
+  for (i = 0; i < 100; i++) stack_push(stk, (int)i);
+  for (i = 0; i < 100; i++) stack_push_s(stk, i);
+  stack_shrink_s(stk);
+  TEST_CASE_ASSERT(stats.live_blocks == 1);
+  TEST_CASE_ASSERT(stats.live_bytes ==
+                   stack_allocation_size(sizeof *stk, stack_capacity(stk)));
+
+  copy = stack_copy(stk);
+  TEST_CASE_ASSERT(stack_allocator(copy) == &ALLOCATOR);
+  TEST_CASE_ASSERT(stats.live_blocks == 2);
+
+  stack_delete(stk);
+  stack_delete_s(copy);
+  TEST_CASE_ASSERT(stats.live_blocks == 0);
+  TEST_CASE_ASSERT(stats.live_bytes == 0);
+  return true;
+}
+
 bool test_stack_copy(void) {
   stack(int) stk1;
   stack(int) stk2;
@@ -35,6 +189,26 @@ bool test_stack_copy(void) {
   return true;
 }
 
+bool test_stack_define(void) {
+  sstack stk = sstack_new(0);
+
+  size_t i;
+  for (i = 0; i < 100; i++) TEST_CASE_ASSERT(*sstack_push(&stk, i) == i);
+  TEST_CASE_ASSERT(stack_height(stk) == 100);
+  TEST_CASE_ASSERT(sstack_peek(stk) == 99);
+  sstack_for_each(stk, double_value, NULL);
+  /* Generated and macro operations share the same stack. */
+  TEST_CASE_ASSERT(stack_pop(stk) == 198);
+  TEST_CASE_ASSERT(sstack_pop(stk) == 196);
+  stack_push_s(stk, i);
+  TEST_CASE_ASSERT(sstack_pop(stk) == 100);
+  for (i = 98; i-- > 0;) TEST_CASE_ASSERT(sstack_pop(stk) == 2 * i);
+  TEST_CASE_ASSERT(stack_is_empty(stk));
+
+  sstack_delete(stk);
+  return true;
+}
+
 bool test_stack_expand(void) {
   const size_t INITIAL_CAPACITY = 0;
   stack(int) stk1 = stack_new(int, INITIAL_CAPACITY);
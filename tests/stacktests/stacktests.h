@@ -10,8 +10,16 @@
  * included in the test.
  */
 
+bool test_concurrent_stack_ops(void);
+
+bool test_concurrent_stack_threads(void);
+
+bool test_stack_allocator(void);
+
 bool test_stack_copy(void);
 
+bool test_stack_define(void);
+
 bool test_stack_expand(void);
 
 bool test_stack_new(void);
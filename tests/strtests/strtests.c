@@ -242,6 +242,29 @@ static bool test_string_insert_uint(void) {
 
 /* - EXTERNAL - */
 
+bool test_string_allocator(void) {
+  counting_allocator_stats stats;
+  const myclib_allocator ALLOCATOR = counting_allocator(&stats);
+  string str = string_init_with(&ALLOCATOR, 0);
+  string copy;
+
+  size_t i;
+  for (i = 0; i < ARR_LEN(TEST_STRINGS); i++)
+    TEST_CASE_ASSERT(string_append_raw_str(str, TEST_STRINGS[i]));
+  TEST_CASE_ASSERT(string_shrink(str));
+  TEST_CASE_ASSERT(stats.live_blocks == 1);
+
+  copy = string_copy(str);
+  TEST_CASE_ASSERT(string_equals(str, copy));
+  TEST_CASE_ASSERT(stats.live_blocks == 2);
+
+  string_delete(str);
+  string_delete(copy);
+  TEST_CASE_ASSERT(stats.live_blocks == 0);
+  TEST_CASE_ASSERT(stats.live_bytes == 0);
+  return true;
+}
+
 bool test_string_append(void) {
   TEST_CASE_ASSERT(test_string_append_char());
   TEST_CASE_ASSERT(test_string_append_int());
@@ -3,6 +3,8 @@
 
 #include "../../include/myclib.h"
 
+bool test_string_allocator(void);
+
 bool test_string_append(void);
 
 bool test_string_clear(void);
@@ -0,0 +1,52 @@
+#include "threadpooltests.h"
+
+#include <stddef.h>
+
+#include "../../include/myclib.h"
+#include "../../threadpool/threadpool.h"
+#include "../framework.h"
+
+#define TEST_THREAD_COUNT ((size_t)4)
+#define TEST_TASK_COUNT ((size_t)1000)
+
+/* Every task records its index in the slot it owns. */
+static void record_index(void *const ctx, const size_t index) {
+  size_t *const slots = ctx;
+  slots[index] += index + 1;
+}
+
+bool test_threadpool_new(void) {
+  threadpool *pool = threadpool_new(TEST_THREAD_COUNT);
+
+  TEST_CASE_ASSERT(pool != NULL);
+  TEST_CASE_ASSERT(threadpool_size(pool) == TEST_THREAD_COUNT);
+  threadpool_delete(pool);
+
+  pool = threadpool_new(0);
+  TEST_CASE_ASSERT(pool != NULL);
+  TEST_CASE_ASSERT(threadpool_size(pool) == threadpool_cpu_count());
+  threadpool_delete(pool);
+
+  TEST_CASE_ASSERT(threadpool_size(NULL) == 1);
+  return true;
+}
+
+bool test_threadpool_run(void) {
+  threadpool *const pool = threadpool_new(TEST_THREAD_COUNT);
+  static size_t slots[TEST_TASK_COUNT];
+
+  size_t batch;
+  size_t i;
+  TEST_CASE_ASSERT(pool != NULL);
+  for (i = 0; i < TEST_TASK_COUNT; i++) slots[i] = 0;
+  /* Consecutive batches must neither lose nor repeat tasks. */
+  for (batch = 0; batch < 3; batch++)
+    threadpool_run(pool, record_index, slots, TEST_TASK_COUNT);
+  threadpool_run(NULL, record_index, slots, TEST_TASK_COUNT);
+  threadpool_run(pool, record_index, slots, 0);
+  for (i = 0; i < TEST_TASK_COUNT; i++)
+    TEST_CASE_ASSERT(slots[i] == 4 * (i + 1));
+
+  threadpool_delete(pool);
+  return true;
+}
@@ -0,0 +1,10 @@
+#ifndef TEST_THREADPOOL_H
+#define TEST_THREADPOOL_H
+
+#include "../../include/myclib.h"
+
+bool test_threadpool_new(void);
+
+bool test_threadpool_run(void);
+
+#endif
@@ -1,15 +1,214 @@
 #include "vectortests.h"
 
 #include <stddef.h>
+#include <stdio.h>
+#include <string.h>
 
 #include "../../include/myclib.h"
+#include "../../sched/scheduler.h"
+#include "../../vector/soavector.h"
 #include "../../vector/vector.h"
 #include "../framework.h"
 
+DEFINE_VECTOR(int, ivec);
+
+typedef struct sample {
+  char tag;
+  double value;
+  int id;
+} sample;
+
+/* `tag` is left out so that conversions must zero it. */
+#define SAMPLE_FIELDS(X) X(double, value) X(int, id)
+
+DEFINE_SOA_VECTOR(samples, sample, SAMPLE_FIELDS);
+
 #define TEST_DATA_LEN (sizeof(TEST_DATA) / sizeof *(TEST_DATA))
 
 static const int TEST_DATA[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
 
+/*
+ * `chunk_sizes` receives the size of each chunk at the index of the chunk's
+ * first element.
+ */
+typedef struct chunk_record {
+  const int *vec;
+  size_t *chunk_sizes;
+} chunk_record;
+
+static void add_to_elem(void *args[]) {
+  *(int *)args[1] += *(const int *)args[2];
+}
+
+static void add_to_chunk(void *const chunk, const size_t count,
+                         void *const args) {
+  int *const elems = chunk;
+  size_t i;
+  for (i = 0; i < count; i++) elems[i] += *(const int *)args;
+}
+
+static void negate_elem(int *const elem, void *const args) {
+  (void)args;
+  *elem = -*elem;
+}
+
+static void copy_elem(const void *args[]) {
+  const int *const elem = args[1];
+  int *const copy = *(int *const *)args[2];
+  copy[elem - (const int *)args[0]] = *elem;
+}
+
+static bool is_multiple_of(const void *args[]) {
+  return *(const int *)args[1] % *(const int *)args[2] == 0;
+}
+
+static void record_chunk(const void *const chunk, const size_t count,
+                         const void *const args) {
+  const chunk_record *const record = args;
+  record->chunk_sizes[(const int *)chunk - record->vec] = count;
+}
+
+/* Long enough for the sorts to partition and merge several times over. */
+#define SORT_TEST_LENGTH ((size_t)5000)
+
+typedef enum sort_pattern {
+  PATTERN_RANDOM,
+  PATTERN_SORTED,
+  PATTERN_REVERSED,
+  PATTERN_FEW_DISTINCT,
+  PATTERN_ORGAN_PIPE,
+  PATTERN_COUNT
+} sort_pattern;
+
+/* An element wider than any the sorts specialize for. */
+typedef struct sort_record {
+  int key;
+  int seq;
+  int padding;
+} sort_record;
+
+static unsigned long next_random(unsigned long *const state) {
+  *state = (*state * 1103515245UL + 12345UL) & 0x7FFFFFFFUL;
+  return *state;
+}
+
+static int pattern_value(const sort_pattern pattern, const size_t i,
+                         unsigned long *const state) {
+  switch (pattern) {
+    case PATTERN_SORTED:
+      return (int)i;
+    case PATTERN_REVERSED:
+      return (int)(SORT_TEST_LENGTH - i);
+    case PATTERN_FEW_DISTINCT:
+      return (int)(next_random(state) % 4);
+    case PATTERN_ORGAN_PIPE:
+      return (int)(i < SORT_TEST_LENGTH / 2 ? i : SORT_TEST_LENGTH - i);
+    default:
+      return (int)(next_random(state) % 100000) - 50000;
+  }
+}
+
+static int compare_ints(const void *const a, const void *const b) {
+  const int A = *(const int *)a;
+  const int B = *(const int *)b;
+  return (A > B) - (A < B);
+}
+
+static int compare_u64s(const void *const a, const void *const b) {
+  const vec_u64 A = *(const vec_u64 *)a;
+  const vec_u64 B = *(const vec_u64 *)b;
+  return (A > B) - (A < B);
+}
+
+static int compare_records(const void *const a, const void *const b) {
+  return compare_ints(&((const sort_record *)a)->key,
+                      &((const sort_record *)b)->key);
+}
+
+bool test_vector_aligned(void) {
+  const size_t ALIGNMENTS[] = {1, 16, 32, 64, 128, VEC_MAX_ALIGNMENT};
+  vector(int) huge;
+
+  size_t i;
+  for (i = 0; i < ARR_LEN(ALIGNMENTS); i++) {
+    const size_t ALIGNMENT = ALIGNMENTS[i];
+    vector(int) vec = vector_new_aligned(int, 1, ALIGNMENT);
+    vector(int) copy;
+    int n;
+    TEST_CASE_ASSERT(vec != NULL && vector_is_aligned(vec, ALIGNMENT));
+    for (n = 0; n < 10000; n++) {
+      vector_push(vec, n);
+      TEST_CASE_ASSERT(vector_is_aligned(vec, ALIGNMENT));
+    }
+    vector_resize(vec, 100);
+    vector_shrink(vec);
+    TEST_CASE_ASSERT(vector_is_aligned(vec, ALIGNMENT));
+    TEST_CASE_ASSERT(vector_capacity(vec) == 100);
+    TEST_CASE_ASSERT(vector_get(vec, 99) == 99);
+    copy = vector_copy_s(vec);
+    TEST_CASE_ASSERT(vector_is_aligned(copy, ALIGNMENT));
+    TEST_CASE_ASSERT(memcmp(copy, vec, 100 * sizeof *vec) == 0);
+    vector_delete(copy);
+    vector_delete(vec);
+  }
+  TEST_CASE_ASSERT(vector_new_aligned(int, 1, 48) == NULL);
+  TEST_CASE_ASSERT(vector_new_aligned(int, 1, VEC_MAX_ALIGNMENT * 2) == NULL);
+
+  huge = vector_new_huge(int, 0, VEC_CACHE_LINE_SIZE);
+  TEST_CASE_ASSERT(huge != NULL);
+  vector_resize(huge, (VEC_HUGE_PAGE_SIZE * 2) / sizeof *huge);
+  TEST_CASE_ASSERT(vector_is_aligned(huge, VEC_CACHE_LINE_SIZE));
+  vector_set(huge, 7, vector_length(huge) - 1);
+  TEST_CASE_ASSERT(vector_get(huge, vector_length(huge) - 1) == 7);
+  vector_delete(huge);
+  return true;
+}
+
+bool test_vector_allocator(void) {
+  counting_allocator_stats stats;
+  const myclib_allocator ALLOCATOR = counting_allocator(&stats);
+  vector(int) vec = vector_new_with(&ALLOCATOR, int, 0);
+
+  size_t i;
+  TEST_CASE_ASSERT(vector_allocator(vec) == &ALLOCATOR);
+  for (i = 0; i < TEST_DATA_LEN; i++) vector_push(vec, TEST_DATA[i]);
+  for (i = 0; i < TEST_DATA_LEN; i++) vector_push_s(vec, TEST_DATA[i]);
+  vector_shrink(vec);
+  TEST_CASE_ASSERT(stats.live_blocks == 1);
+  TEST_CASE_ASSERT(stats.live_bytes ==
+                   vector_allocation_size(sizeof *vec, vector_capacity(vec)));
+  {
+    vector(int) copy = vector_copy_s(vec);
+    TEST_CASE_ASSERT(vector_allocator(copy) == &ALLOCATOR);
+    TEST_CASE_ASSERT(stats.live_blocks == 2);
+    vector_delete_s(copy);
+  }
+  vector_delete(vec);
+  TEST_CASE_ASSERT(stats.live_blocks == 0);
+  TEST_CASE_ASSERT(stats.live_bytes == 0);
+  return true;
+}
+
+bool test_vector_append_n(void) {
+  vector(int) vec = vector_new(int, 0);
+  vector(int) other = vector_new(int, 0);
+
+  size_t i;
+  vector_append_n(vec, TEST_DATA, TEST_DATA_LEN);
+  TEST_CASE_ASSERT(vector_length(vec) == TEST_DATA_LEN);
+  vector_append_n_s(other, vec, vector_length(vec));
+  TEST_CASE_ASSERT(vector_append_n_s(other, TEST_DATA, 0) != NULL);
+  TEST_CASE_ASSERT(vector_length(other) == TEST_DATA_LEN);
+  vector_append_n(vec, other, vector_length(other));
+  TEST_CASE_ASSERT(vector_length(vec) == 2 * TEST_DATA_LEN);
+  for (i = 0; i < vector_length(vec); i++)
+    TEST_CASE_ASSERT(vec[i] == TEST_DATA[i % TEST_DATA_LEN]);
+
+  vector_delete(vec);
+  vector_delete(other);
+  return true;
+}
+
 bool test_vector_clear(void) {
   vector(int) vec = vector_new(int, 3);
 
@@ -47,7 +246,6 @@ bool test_vector_copy(void) {
   const int ELEM = vector_push(base, 2);
 
   const size_t BASE_LENGTH = vector_length(base);
-  const size_t BASE_CAPACITY = vector_capacity(base);
 
   size_t i;
   for (i = 0; i < TEST_DATA_LEN; i++) {
@@ -55,14 +253,14 @@ bool test_vector_copy(void) {
       const vector(int) vec = vector_push(vec_holder, vector_copy(base));
 
       TEST_CASE_ASSERT(vector_length(vec) == BASE_LENGTH);
-      TEST_CASE_ASSERT(vector_capacity(vec) == BASE_CAPACITY);
+      TEST_CASE_ASSERT(vector_capacity(vec) == BASE_LENGTH);
       TEST_CASE_ASSERT(vector_get(vec, 0) == ELEM);
     }
     {
       const vector(int) vec = vector_push(vec_holder, vector_copy_s(base));
 
       TEST_CASE_ASSERT(vector_length(vec) == BASE_LENGTH);
-      TEST_CASE_ASSERT(vector_capacity(vec) == BASE_CAPACITY);
+      TEST_CASE_ASSERT(vector_capacity(vec) == BASE_LENGTH);
       TEST_CASE_ASSERT(vector_get(vec, 0) == ELEM);
     }
   }
@@ -75,6 +273,78 @@ bool test_vector_copy(void) {
   return true;
 }
 
+bool test_vector_dedup(void) {
+  vector(int) vec = vector_new(int, 0);
+
+  const int SORTED[] = {1, 1, 2, 3, 3, 3, 4, 5, 5, 6};
+  const int DISTINCT[] = {1, 2, 3, 4, 5, 6};
+  const size_t SORTED_LEN = sizeof SORTED / sizeof *SORTED;
+
+  TEST_CASE_ASSERT(vector_dedup(vec) == 0);
+  vector_append_n(vec, SORTED, SORTED_LEN);
+  TEST_CASE_ASSERT(vector_dedup(vec) == SORTED_LEN - 6);
+  TEST_CASE_ASSERT(vector_length(vec) == 6);
+  TEST_CASE_ASSERT(memcmp(vec, DISTINCT, sizeof DISTINCT) == 0);
+  TEST_CASE_ASSERT(vector_dedup(vec) == 0);
+
+  vector_delete(vec);
+  return true;
+}
+
+bool test_vector_define(void) {
+  counting_allocator_stats stats;
+  const myclib_allocator ALLOCATOR = counting_allocator(&stats);
+  ivec vec = ivec_new_with(&ALLOCATOR, 0);
+
+  const int MISSING = 11;
+  size_t i;
+  for (i = 0; i < TEST_DATA_LEN; i++)
+    TEST_CASE_ASSERT(*ivec_push(&vec, TEST_DATA[i]) == TEST_DATA[i]);
+  TEST_CASE_ASSERT(vector_length(vec) == TEST_DATA_LEN);
+  TEST_CASE_ASSERT(ivec_get(vec, 4) == 5);
+  TEST_CASE_ASSERT(ivec_index_of(vec, 7) == 6);
+  TEST_CASE_ASSERT(ivec_index_of(vec, MISSING) == VEC_BAD_INDEX);
+
+  TEST_CASE_ASSERT(*ivec_insert(&vec, 0, 0) == 0);
+  TEST_CASE_ASSERT(*ivec_insert(&vec, MISSING, TEST_DATA_LEN + 3) == MISSING);
+  TEST_CASE_ASSERT(vector_length(vec) == TEST_DATA_LEN + 4);
+  TEST_CASE_ASSERT(ivec_get(vec, 1) == 1);
+  TEST_CASE_ASSERT(ivec_get(vec, TEST_DATA_LEN + 1) == 0);
+  TEST_CASE_ASSERT(*ivec_pop(&vec) == MISSING);
+
+  /* Generated and macro operations share the same vector. */
+  vector_push(vec, MISSING);
+  TEST_CASE_ASSERT(*ivec_pop(&vec) == MISSING);
+  ivec_for_each(vec, negate_elem, NULL);
+  TEST_CASE_ASSERT(vector_get(vec, 10) == -10);
+
+  /* Generated operations which modify a shared vector unshare it first. */
+  {
+    const size_t LENGTH = vector_length(vec);
+    ivec other = vector_share(vec);
+    TEST_CASE_ASSERT(ivec_reserve_for(&other, LENGTH) != NULL);
+    TEST_CASE_ASSERT(other != vec && !vector_is_shared(vec));
+    ivec_delete(&other);
+    other = vector_share(vec);
+    TEST_CASE_ASSERT(*ivec_push(&other, MISSING) == MISSING);
+    TEST_CASE_ASSERT(*ivec_insert(&other, MISSING, 0) == MISSING);
+    TEST_CASE_ASSERT(vector_length(vec) == LENGTH);
+    TEST_CASE_ASSERT(vector_length(other) == LENGTH + 2);
+    TEST_CASE_ASSERT(ivec_get(vec, 0) == 0);
+    ivec_delete(&other);
+    other = vector_share(vec);
+    TEST_CASE_ASSERT(*ivec_pop(&other) == ivec_get(vec, LENGTH - 1));
+    TEST_CASE_ASSERT(vector_length(vec) == LENGTH);
+    TEST_CASE_ASSERT(vector_length(other) == LENGTH - 1);
+    ivec_delete(&other);
+  }
+
+  ivec_delete(&vec);
+  TEST_CASE_ASSERT(vec == NULL);
+  TEST_CASE_ASSERT(stats.live_blocks == 0);
+  return true;
+}
+
 bool test_vector_delete(void) {
   vector(int) vec_1 = vector_new(int, 0);
   vector(int) vec_2 = vector_new(int, 0);
@@ -209,6 +479,78 @@ bool test_vector_insert(void) {
   return true;
 }
 
+bool test_vector_insert_n(void) {
+  counting_allocator_stats stats;
+  const myclib_allocator ALLOCATOR = counting_allocator(&stats);
+  vector(int) vec = vector_new_with(&ALLOCATOR, int, 0);
+
+  const int EXPECTED[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 1, 2, 3, 4, 5,
+                          1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 6, 7, 8, 9, 10};
+  const size_t EXPECTED_LEN = sizeof EXPECTED / sizeof *EXPECTED;
+  size_t calls;
+
+  vector_insert_n(vec, TEST_DATA, TEST_DATA_LEN, 0);
+  vector_insert_n_s(vec, TEST_DATA, TEST_DATA_LEN, TEST_DATA_LEN / 2);
+  calls = stats.calls;
+  vector_insert_n(vec, TEST_DATA, TEST_DATA_LEN, 0);
+  TEST_CASE_ASSERT(stats.calls - calls <= 1);
+  TEST_CASE_ASSERT(vector_length(vec) == EXPECTED_LEN);
+  TEST_CASE_ASSERT(memcmp(vec, EXPECTED, sizeof EXPECTED) == 0);
+
+  vector_delete(vec);
+  TEST_CASE_ASSERT(stats.live_blocks == 0);
+  return true;
+}
+
+bool test_vector_mmap(void) {
+  const char *const PATH = "vectortests_mmap.vec";
+  vector(int) vec = vector_mmap_open(PATH, sizeof(int), VEC_MMAP_TRUNCATE |
+                                                            VEC_MMAP_CREATE);
+  vector(int) reader;
+  vector(int) copy;
+
+  size_t i;
+  TEST_CASE_ASSERT(vec != NULL);
+  TEST_CASE_ASSERT(vector_is_empty(vec));
+  for (i = 0; i < 1000; i++) vector_push(vec, (int)i);
+  TEST_CASE_ASSERT(vector_mmap_sync(vec));
+  vector_delete(vec);
+
+  reader = vector_mmap_open(PATH, sizeof(int), VEC_MMAP_READ_ONLY);
+  TEST_CASE_ASSERT(reader != NULL);
+  TEST_CASE_ASSERT(vector_length(reader) == 1000);
+  TEST_CASE_ASSERT(vector_capacity(reader) == 1000);
+  for (i = 0; i < 1000; i++) TEST_CASE_ASSERT(vector_get(reader, i) == (int)i);
+  TEST_CASE_ASSERT(vector_reserve(reader, 2000) == NULL);
+  copy = vector_copy_s(reader);
+  TEST_CASE_ASSERT(memcmp(copy, reader, 1000 * sizeof(int)) == 0);
+  vector_delete(copy);
+
+  vec = vector_mmap_open(PATH, sizeof(int), VEC_MMAP_WRITE);
+  TEST_CASE_ASSERT(vec != NULL);
+  vector_append_n(vec, TEST_DATA, TEST_DATA_LEN);
+  vector_set(vec, -1, 0);
+  TEST_CASE_ASSERT(vector_length(vec) == 1000 + TEST_DATA_LEN);
+  /* The reader's length was captured when it was opened. */
+  TEST_CASE_ASSERT(vector_length(reader) == 1000);
+  vector_delete(reader);
+  vector_delete(vec);
+
+  vec = vector_mmap_open(PATH, sizeof(int), VEC_MMAP_READ_ONLY);
+  TEST_CASE_ASSERT(vector_length(vec) == 1000 + TEST_DATA_LEN);
+  TEST_CASE_ASSERT(vector_get(vec, 0) == -1);
+  TEST_CASE_ASSERT(memcmp(&vec[1000], TEST_DATA, sizeof TEST_DATA) == 0);
+  vector_delete(vec);
+
+  vec = vector_mmap_open(PATH, sizeof(int), VEC_MMAP_TRUNCATE);
+  TEST_CASE_ASSERT(vec != NULL && vector_is_empty(vec));
+  vector_delete(vec);
+  TEST_CASE_ASSERT(remove(PATH) == 0);
+  TEST_CASE_ASSERT(vector_mmap_open(PATH, sizeof(int), VEC_MMAP_WRITE) ==
+                   NULL);
+  return true;
+}
+
 bool test_vector_new(void) {
   const size_t CAPACITY = 3;
   vector(int) vec = vector_new(int, CAPACITY);
@@ -220,6 +562,173 @@ bool test_vector_new(void) {
   return true;
 }
 
+bool test_vector_parallel_for_each(void) {
+  scheduler *const sched = scheduler_new(4);
+  vector(int) vec = vector_new(int, 0);
+  vector(int) copy = vector_new(int, 0);
+  vector(size_t) chunk_sizes = vector_new(size_t, 0);
+
+  const size_t LENGTH = 10000;
+  const size_t GRAIN_SIZE = 100;
+  int increment = 1;
+  chunk_record record;
+  size_t total;
+  size_t i;
+  TEST_CASE_ASSERT(sched != NULL);
+  vector_resize(vec, LENGTH);
+  vector_resize(copy, LENGTH);
+  vector_resize(chunk_sizes, LENGTH);
+  for (i = 0; i < LENGTH; i++) vec[i] = (int)i;
+
+  vector_parallel_for_each(vec, add_to_elem, &increment, sched, GRAIN_SIZE);
+  vector_parallel_for_each_chunk(vec, add_to_chunk, &increment, sched, 0);
+  vector_parallel_for_each_chunk(vec, add_to_chunk, &increment, NULL, 1);
+  vector_parallel_for_each_c(vec, copy_elem, &copy, sched, GRAIN_SIZE);
+  for (i = 0; i < LENGTH; i++) TEST_CASE_ASSERT(copy[i] == (int)i + 3);
+
+  record.vec = vec;
+  record.chunk_sizes = chunk_sizes;
+  vector_parallel_for_each_chunk_c(vec, record_chunk, &record, sched,
+                                   GRAIN_SIZE);
+  for (i = 0, total = 0; i < LENGTH; i++) {
+    if (chunk_sizes[i] == 0) continue;
+    TEST_CASE_ASSERT(chunk_sizes[i] >= GRAIN_SIZE ||
+                     i + chunk_sizes[i] == LENGTH);
+    total += chunk_sizes[i];
+  }
+  TEST_CASE_ASSERT(total == LENGTH);
+
+  vector_reset(vec);
+  vector_parallel_for_each(vec, add_to_elem, &increment, sched, GRAIN_SIZE);
+
+  scheduler_delete(sched);
+  vector_delete(vec);
+  vector_delete(copy);
+  vector_delete(chunk_sizes);
+  return true;
+}
+
+bool test_vector_parallel_scan(void) {
+  scheduler *const sched = scheduler_new(4);
+  scheduler *const odd_sched = scheduler_new(3);
+  const size_t LENGTH = (3 * VEC_SCAN_BLOCK_LENGTH) + 5;
+  vector(double) inclusive = vector_new(double, LENGTH);
+  vector(double) exclusive = vector_new(double, LENGTH);
+  vector(double) serial = vector_new(double, LENGTH);
+  vector(vec_i32) ints = vector_new(vec_i32, LENGTH);
+  vector(vec_u64) wide = vector_new(vec_u64, LENGTH);
+  unsigned long state = 3;
+  vec_i32 int_sum = 0;
+  vec_u64 wide_sum = 0;
+
+  size_t i;
+  TEST_CASE_ASSERT(sched != NULL && odd_sched != NULL);
+  for (i = 0; i < LENGTH; i++) {
+    /* Mixed magnitudes make the rounding depend on the order of addition. */
+    const double VALUE = (double)next_random(&state) / (double)(i % 7 + 1);
+    vector_push(inclusive, i % 3 == 0 ? VALUE * 1e12 : VALUE);
+    vector_push(ints, (vec_i32)(next_random(&state) % 2001) - 1000);
+    vector_push(wide, (vec_u64)next_random(&state));
+  }
+  vector_resize(exclusive, LENGTH);
+  vector_resize(serial, LENGTH);
+  memcpy(exclusive, inclusive, LENGTH * sizeof *inclusive);
+  memcpy(serial, inclusive, LENGTH * sizeof *inclusive);
+  TEST_CASE_ASSERT(vector_parallel_scan_f64(inclusive, LENGTH,
+                                            VEC_SCAN_INCLUSIVE, sched));
+  TEST_CASE_ASSERT(vector_parallel_scan_f64(exclusive, LENGTH,
+                                            VEC_SCAN_EXCLUSIVE, odd_sched));
+  TEST_CASE_ASSERT(vector_parallel_scan_f64(serial, LENGTH,
+                                            VEC_SCAN_INCLUSIVE, NULL));
+  /* The sums are rounded identically whatever the number of threads. */
+  TEST_CASE_ASSERT(memcmp(inclusive, serial, LENGTH * sizeof *serial) == 0);
+  TEST_CASE_ASSERT(exclusive[0] == 0.0);
+  /* Blocks start from their offsets, which are rounded differently. */
+  for (i = 1; i < LENGTH; i++)
+    if (i % VEC_SCAN_BLOCK_LENGTH != 0)
+      TEST_CASE_ASSERT(memcmp(&exclusive[i], &inclusive[i - 1],
+                              sizeof *inclusive) == 0);
+
+  TEST_CASE_ASSERT(
+      vector_parallel_scan_i32(ints, LENGTH, VEC_SCAN_EXCLUSIVE, sched));
+  TEST_CASE_ASSERT(
+      vector_parallel_scan_u64(wide, LENGTH, VEC_SCAN_INCLUSIVE, sched));
+  state = 3;
+  for (i = 0; i < LENGTH; i++) {
+    (void)next_random(&state);
+    TEST_CASE_ASSERT(ints[i] == int_sum);
+    int_sum += (vec_i32)(next_random(&state) % 2001) - 1000;
+    wide_sum += (vec_u64)next_random(&state);
+    TEST_CASE_ASSERT(wide[i] == wide_sum);
+  }
+  TEST_CASE_ASSERT(
+      vector_parallel_scan_u32(NULL, 0, VEC_SCAN_INCLUSIVE, sched));
+
+  scheduler_delete(sched);
+  scheduler_delete(odd_sched);
+  vector_delete(inclusive);
+  vector_delete(exclusive);
+  vector_delete(serial);
+  vector_delete(ints);
+  vector_delete(wide);
+  return true;
+}
+
+bool test_vector_parallel_sort(void) {
+  scheduler *const sched = scheduler_new(4);
+  scheduler *const odd_sched = scheduler_new(3);
+  const size_t LENGTH = 20 * VEC_PARALLEL_DEFAULT_GRAIN + 123;
+  vector(sort_record) records = vector_new(sort_record, LENGTH);
+  vector(sort_record) odd = vector_new(sort_record, LENGTH);
+  vector(sort_record) serial = vector_new(sort_record, LENGTH);
+  vector(int) ints = vector_new(int, LENGTH);
+  vector(sort_record) unsorted;
+  unsigned long state = 11;
+
+  size_t i;
+  TEST_CASE_ASSERT(sched != NULL && odd_sched != NULL);
+  for (i = 0; i < LENGTH; i++) {
+    sort_record record;
+    record.key = (int)(next_random(&state) % 100);
+    record.seq = (int)i;
+    record.padding = 0;
+    vector_push(records, record);
+    vector_push(ints, (int)next_random(&state));
+  }
+  vector_resize(odd, LENGTH);
+  vector_resize(serial, LENGTH);
+  memcpy(odd, records, LENGTH * sizeof *records);
+  memcpy(serial, records, LENGTH * sizeof *records);
+  /* Handles sharing the vector keep its elements in their original order. */
+  unsorted = vector_share(records);
+  TEST_CASE_ASSERT(vector_parallel_sort_s(records, compare_records, sched));
+  TEST_CASE_ASSERT(memcmp(unsorted, odd, LENGTH * sizeof *odd) == 0);
+  vector_delete(unsorted);
+  TEST_CASE_ASSERT(vector_parallel_sort_s(odd, compare_records, odd_sched));
+  TEST_CASE_ASSERT(vector_sort_stable_s(serial, compare_records));
+  /* Being stable, the result is the same whatever the number of threads. */
+  TEST_CASE_ASSERT(memcmp(records, serial, LENGTH * sizeof *serial) == 0);
+  TEST_CASE_ASSERT(memcmp(odd, serial, LENGTH * sizeof *serial) == 0);
+  for (i = 1; i < LENGTH; i++) {
+    TEST_CASE_ASSERT(records[i - 1].key <= records[i].key);
+    if (records[i - 1].key == records[i].key)
+      TEST_CASE_ASSERT(records[i - 1].seq < records[i].seq);
+  }
+
+  TEST_CASE_ASSERT(vector_parallel_sort_s(ints, compare_ints, sched));
+  for (i = 1; i < LENGTH; i++) TEST_CASE_ASSERT(ints[i - 1] <= ints[i]);
+  TEST_CASE_ASSERT(vector_parallel_sort(ints, 1, sizeof *ints, compare_ints,
+                                        NULL));
+
+  scheduler_delete(sched);
+  scheduler_delete(odd_sched);
+  vector_delete(records);
+  vector_delete(odd);
+  vector_delete(serial);
+  vector_delete(ints);
+  return true;
+}
+
 bool test_vector_pop(void) {
   vector(int) vec = vector_new(int, 3);
 
@@ -249,6 +758,60 @@ bool test_vector_push(void) {
   return true;
 }
 
+bool test_vector_radix_sort(void) {
+  vector(vec_u32) u32s = vector_new(vec_u32, SORT_TEST_LENGTH);
+  vector(vec_i32) i32s = vector_new(vec_i32, SORT_TEST_LENGTH);
+  vector(vec_u64) u64s = vector_new(vec_u64, SORT_TEST_LENGTH);
+  vector(vec_i64) i64s = vector_new(vec_i64, SORT_TEST_LENGTH);
+  vector(float) f32s = vector_new(float, SORT_TEST_LENGTH);
+  vector(double) f64s = vector_new(double, SORT_TEST_LENGTH);
+  unsigned long state = 1;
+
+  size_t i;
+  for (i = 0; i < SORT_TEST_LENGTH; i++) {
+    const long VALUE = (long)next_random(&state) - 0x40000000L;
+    vector_push(u32s, (vec_u32)next_random(&state));
+    vector_push(i32s, (vec_i32)VALUE);
+    vector_push(u64s, ((vec_u64)next_random(&state) << 33) ^ (vec_u64)VALUE);
+    vector_push(i64s, (vec_i64)VALUE * (vec_i64)VALUE * (VALUE < 0 ? -1 : 1));
+    vector_push(f32s, (float)VALUE / 7.0f);
+    vector_push(f64s, (double)VALUE / 3.0);
+  }
+  /* Only the sign bit tells these apart. */
+  f64s[0] = -0.0;
+  f64s[1] = 0.0;
+  TEST_CASE_ASSERT(vector_radix_sort_u32(u32s, vector_length(u32s)));
+  TEST_CASE_ASSERT(vector_radix_sort_i32(i32s, vector_length(i32s)));
+  TEST_CASE_ASSERT(vector_radix_sort_u64(u64s, vector_length(u64s)));
+  TEST_CASE_ASSERT(vector_radix_sort_i64(i64s, vector_length(i64s)));
+  TEST_CASE_ASSERT(vector_radix_sort_f32(f32s, vector_length(f32s)));
+  TEST_CASE_ASSERT(vector_radix_sort_f64(f64s, vector_length(f64s)));
+  for (i = 1; i < SORT_TEST_LENGTH; i++) {
+    TEST_CASE_ASSERT(u32s[i - 1] <= u32s[i]);
+    TEST_CASE_ASSERT(i32s[i - 1] <= i32s[i]);
+    TEST_CASE_ASSERT(u64s[i - 1] <= u64s[i]);
+    TEST_CASE_ASSERT(i64s[i - 1] <= i64s[i]);
+    TEST_CASE_ASSERT(f32s[i - 1] <= f32s[i]);
+    TEST_CASE_ASSERT(f64s[i - 1] <= f64s[i]);
+  }
+  TEST_CASE_ASSERT(i32s[0] < 0 && i64s[0] < 0 && f32s[0] < 0.0f);
+  for (i = 0; f64s[i] < 0.0; i++) continue;
+  TEST_CASE_ASSERT(1.0 / f64s[i] < 0.0 && 1.0 / f64s[i + 1] > 0.0);
+  /* Keys all sharing their upper bytes skip those passes. */
+  for (i = 0; i < SORT_TEST_LENGTH; i++) u64s[i] = SORT_TEST_LENGTH - i;
+  TEST_CASE_ASSERT(vector_radix_sort_u64(u64s, vector_length(u64s)));
+  for (i = 0; i < SORT_TEST_LENGTH; i++) TEST_CASE_ASSERT(u64s[i] == i + 1);
+  TEST_CASE_ASSERT(vector_radix_sort_u32(u32s, 0));
+
+  vector_delete(u32s);
+  vector_delete(i32s);
+  vector_delete(u64s);
+  vector_delete(i64s);
+  vector_delete(f32s);
+  vector_delete(f64s);
+  return true;
+}
+
 bool test_vector_remove(void) {
   vector(int) vec = vector_new(int, 0);
 
@@ -278,6 +841,78 @@ bool test_vector_remove(void) {
   return true;
 }
 
+bool test_vector_remove_if(void) {
+  vector(int) vec = vector_new(int, 0);
+
+  const int DIVISOR = 3;
+  const int REMAINING[] = {1, 2, 4, 5, 7, 8, 10};
+
+  vector_append_n(vec, TEST_DATA, TEST_DATA_LEN);
+  TEST_CASE_ASSERT(vector_remove_if(vec, is_multiple_of, &DIVISOR) == 3);
+  TEST_CASE_ASSERT(vector_length(vec) == TEST_DATA_LEN - 3);
+  TEST_CASE_ASSERT(memcmp(vec, REMAINING, sizeof REMAINING) == 0);
+  TEST_CASE_ASSERT(vector_remove_if(vec, is_multiple_of, &DIVISOR) == 0);
+
+  vector_delete(vec);
+  return true;
+}
+
+bool test_vector_remove_range(void) {
+  vector(int) vec = vector_new(int, 0);
+
+  vector_append_n(vec, TEST_DATA, TEST_DATA_LEN);
+  vector_remove_range(vec, 2, 3);
+  TEST_CASE_ASSERT(vector_length(vec) == TEST_DATA_LEN - 3);
+  TEST_CASE_ASSERT(vector_get(vec, 1) == 2);
+  TEST_CASE_ASSERT(vector_get(vec, 2) == 6);
+
+  vector_remove_range_s(vec, 0, 0);
+  TEST_CASE_ASSERT(vector_length(vec) == TEST_DATA_LEN - 3);
+  vector_remove_range_s(vec, 4, vector_length(vec) - 4);
+  TEST_CASE_ASSERT(vector_length(vec) == 4);
+  TEST_CASE_ASSERT(vector_get(vec, 3) == 7);
+  vector_remove_range_s(vec, 0, vector_length(vec));
+  TEST_CASE_ASSERT(vector_is_empty(vec));
+
+  vector_delete(vec);
+  return true;
+}
+
+bool test_vector_reserve(void) {
+  const size_t PUSHES = 1 << 12;
+  vector(int) vec = vector_new(int, 0);
+  size_t growths = 0;
+
+  size_t i;
+  for (i = 0; i < PUSHES; i++) {
+    const size_t CAPACITY = vector_capacity(vec);
+    vector_push(vec, TEST_DATA[i % TEST_DATA_LEN]);
+    if (vector_capacity(vec) != CAPACITY) growths++;
+  }
+  /* Geometric growth should need far fewer reallocations than pushes. */
+  TEST_CASE_ASSERT(growths < 2 * 12 + 2);
+  for (i = 0; i < PUSHES; i++)
+    TEST_CASE_ASSERT(vector_get(vec, i) == TEST_DATA[i % TEST_DATA_LEN]);
+
+  TEST_CASE_ASSERT(vector_reserve_exact(vec, PUSHES * 3) != NULL);
+  TEST_CASE_ASSERT(vector_capacity(vec) == PUSHES * 3);
+  TEST_CASE_ASSERT(vector_length(vec) == PUSHES);
+
+  TEST_CASE_ASSERT(vector_reserve(vec, PUSHES * 3 + 1) != NULL);
+  TEST_CASE_ASSERT(vector_capacity(vec) > PUSHES * 3 + 1);
+
+  /* Reserving no more than the current capacity must not shrink the vector. */
+  {
+    const size_t CAPACITY = vector_capacity(vec);
+    TEST_CASE_ASSERT(vector_reserve(vec, 1) != NULL);
+    TEST_CASE_ASSERT(vector_reserve_exact(vec, 1) != NULL);
+    TEST_CASE_ASSERT(vector_capacity(vec) == CAPACITY);
+  }
+
+  vector_delete(vec);
+  return true;
+}
+
 bool test_vector_reset(void) {
   vector(int) vec = vector_new(int, 3);
 
@@ -316,6 +951,96 @@ bool test_vector_resize(void) {
   return true;
 }
 
+/*
+ * Checks the search engine against a naive search for each element width it
+ * specializes, plus one it does not, with lengths exercising both the SIMD
+ * blocks and the scalar tail.
+ */
+bool test_vector_retain(void) {
+  vector(int) vec = vector_new(int, 0);
+
+  const int DIVISOR = 2;
+  const int NONE = 11;
+  const int RETAINED[] = {2, 4, 6, 8, 10};
+
+  vector_append_n(vec, TEST_DATA, TEST_DATA_LEN);
+  TEST_CASE_ASSERT(vector_retain(vec, is_multiple_of, &DIVISOR) == 5);
+  TEST_CASE_ASSERT(vector_length(vec) == 5);
+  TEST_CASE_ASSERT(memcmp(vec, RETAINED, sizeof RETAINED) == 0);
+  TEST_CASE_ASSERT(vector_retain(vec, is_multiple_of, &DIVISOR) == 0);
+  TEST_CASE_ASSERT(vector_retain(vec, is_multiple_of, &NONE) == 5);
+  TEST_CASE_ASSERT(vector_is_empty(vec));
+
+  vector_delete(vec);
+  return true;
+}
+
+static bool test_vector_search_width(const size_t elem_size) {
+  const size_t MAX_LENGTH = 131;
+  byte needle[16];
+  vector(size_t) positions = vector_new(size_t, 0);
+  size_t length;
+  memset(needle, 1, sizeof needle);
+  for (length = 0; length <= MAX_LENGTH; length++) {
+    void *vec = vector_untyped_new(elem_size, length);
+    size_t first = VEC_BAD_INDEX;
+    size_t last = VEC_BAD_INDEX;
+    size_t count = 0;
+    size_t i;
+    vector_untyped_resize(&vec, length, elem_size);
+    /* Some elements only partially match the needle. */
+    for (i = 0; i < length * elem_size; i++)
+      ((byte *)vec)[i] = ((i / elem_size) % 5 == 2 || i % 3 == 0) ? 1 : 0;
+    for (i = 0; i < length; i++) {
+      if (memcmp((byte *)vec + (i * elem_size), needle, elem_size) != 0)
+        continue;
+      if (first == VEC_BAD_INDEX) first = i;
+      last = i;
+      count++;
+    }
+    vector_reset(positions);
+    TEST_CASE_ASSERT(vector_untyped_index_of(vec, needle, elem_size) == first);
+    TEST_CASE_ASSERT(vector_untyped_last_index_of(vec, needle, elem_size) ==
+                     last);
+    TEST_CASE_ASSERT(vector_untyped_count_of(vec, needle, elem_size) == count);
+    TEST_CASE_ASSERT(vector_untyped_find_all(vec, needle, &positions,
+                                             elem_size) == count);
+    TEST_CASE_ASSERT(vector_length(positions) == count);
+    for (i = 0; i < count; i++) {
+      const size_t POSITION = vector_get(positions, i);
+      TEST_CASE_ASSERT(memcmp((byte *)vec + (POSITION * elem_size), needle,
+                              elem_size) == 0);
+      TEST_CASE_ASSERT(i == 0 || POSITION > vector_get(positions, i - 1));
+    }
+    vector_untyped_delete(&vec, elem_size);
+  }
+  vector_delete(positions);
+  return true;
+}
+
+bool test_vector_search(void) {
+  const size_t WIDTHS[] = {1, 2, 3, 4, 8, 16};
+  vector(int) vec = vector_new(int, 0);
+  vector(size_t) positions = vector_new(size_t, 0);
+  const int NEEDLE = 7;
+
+  size_t i;
+  for (i = 0; i < ARR_LEN(WIDTHS); i++)
+    TEST_CASE_ASSERT(test_vector_search_width(WIDTHS[i]));
+
+  for (i = 0; i < 100; i++) vector_push(vec, (int)(i % 10));
+  TEST_CASE_ASSERT(vector_index_of(vec, NEEDLE) == 7);
+  TEST_CASE_ASSERT(vector_last_index_of(vec, NEEDLE) == 97);
+  TEST_CASE_ASSERT(vector_count_of(vec, NEEDLE) == 10);
+  TEST_CASE_ASSERT(vector_find_all(vec, NEEDLE, positions) == 10);
+  for (i = 0; i < vector_length(positions); i++)
+    TEST_CASE_ASSERT(vector_get(positions, i) == (i * 10) + 7);
+
+  vector_delete(vec);
+  vector_delete(positions);
+  return true;
+}
+
 bool test_vector_set(void) {
   vector(int) vec = vector_new(int, 5);
   const size_t POS_1 = 0;
@@ -339,6 +1064,79 @@ bool test_vector_set(void) {
   return true;
 }
 
+bool test_vector_share(void) {
+  counting_allocator_stats stats;
+  const myclib_allocator ALLOCATOR = counting_allocator(&stats);
+  vector(int) vec = vector_new_with(&ALLOCATOR, int, TEST_DATA_LEN);
+  vector(int) snapshot;
+  vector(int) other;
+  const int ELEM = -1;
+
+  vector_append_n(vec, TEST_DATA, TEST_DATA_LEN);
+  snapshot = vector_share(vec);
+  other = vector_share(vec);
+  TEST_CASE_ASSERT(snapshot == vec && other == vec);
+  TEST_CASE_ASSERT(vector_is_shared(vec));
+  TEST_CASE_ASSERT(stats.live_blocks == 1);
+
+  TEST_CASE_ASSERT(vector_set_s(vec, ELEM, 0) != NULL);
+  TEST_CASE_ASSERT(vec != snapshot && !vector_is_shared(vec));
+  TEST_CASE_ASSERT(vector_get(vec, 0) == ELEM);
+  TEST_CASE_ASSERT(memcmp(snapshot, TEST_DATA, sizeof TEST_DATA) == 0);
+  TEST_CASE_ASSERT(vector_is_shared(snapshot));
+  TEST_CASE_ASSERT(stats.live_blocks == 2);
+
+  vector_push_s(other, ELEM);
+  TEST_CASE_ASSERT(vector_length(other) == TEST_DATA_LEN + 1);
+  TEST_CASE_ASSERT(vector_length(snapshot) == TEST_DATA_LEN);
+  TEST_CASE_ASSERT(!vector_is_shared(snapshot));
+  TEST_CASE_ASSERT(vector_remove_s(snapshot, 0) == snapshot);
+  TEST_CASE_ASSERT(stats.live_blocks == 3);
+  TEST_CASE_ASSERT(vector_get(snapshot, 0) == 2);
+  vector_delete(other);
+  vector_delete(snapshot);
+
+  /* The last handle to a shared vector detaches without copying twice. */
+  snapshot = vector_share(vec);
+  vector_delete(snapshot);
+  TEST_CASE_ASSERT(!vector_is_shared(vec));
+  snapshot = vector_share(vec);
+  TEST_CASE_ASSERT(vector_remove_range_s(vec, 0, 5) == vec);
+  TEST_CASE_ASSERT(vector_swap_remove_s(snapshot, 0) != vec);
+  vector_delete(snapshot);
+
+  /* Sorting a vector in place unshares it as well. */
+  vector_push_s(vec, ELEM);
+  snapshot = vector_share(vec);
+  TEST_CASE_ASSERT(vector_sort_s(vec, compare_ints));
+  TEST_CASE_ASSERT(vector_get(vec, 0) == ELEM);
+  TEST_CASE_ASSERT(vector_get(snapshot, vector_length(snapshot) - 1) == ELEM);
+  other = vector_share(snapshot);
+  TEST_CASE_ASSERT(vector_sort_stable_s(snapshot, compare_ints));
+  TEST_CASE_ASSERT(vector_get(snapshot, 0) == ELEM);
+  TEST_CASE_ASSERT(vector_get(other, vector_length(other) - 1) == ELEM);
+  vector_delete(other);
+  vector_delete(snapshot);
+
+  /* So do the macros which reserve room before writing. */
+  vector_reserve(vec, vector_length(vec) + 2);
+  snapshot = vector_share(vec);
+  TEST_CASE_ASSERT(vector_reserve(vec, vector_length(vec)) != NULL);
+  TEST_CASE_ASSERT(vec != snapshot && !vector_is_shared(snapshot));
+  vector_delete(snapshot);
+  snapshot = vector_share(vec);
+  vector_splice(vec, 0, 1, TEST_DATA, 1);
+  vector_append_n(vec, TEST_DATA, 1);
+  TEST_CASE_ASSERT(vector_get(vec, 0) == TEST_DATA[0]);
+  TEST_CASE_ASSERT(vector_get(snapshot, 0) == ELEM);
+  TEST_CASE_ASSERT(vector_length(snapshot) + 1 == vector_length(vec));
+  vector_delete(snapshot);
+  vector_delete(vec);
+  TEST_CASE_ASSERT(stats.live_blocks == 0);
+  TEST_CASE_ASSERT(stats.live_bytes == 0);
+  return true;
+}
+
 bool test_vector_shrink(void) {
   vector(int) vec = vector_new(int, 430);
 
@@ -355,3 +1153,216 @@ bool test_vector_shrink(void) {
   vector_delete(vec);
   return true;
 }
+
+bool test_vector_small(void) {
+  counting_allocator_stats stats;
+  const myclib_allocator ALLOCATOR = counting_allocator(&stats);
+  small_vector(int, 4) storage;
+  small_vector(int, 4) unused_storage;
+  vector(int) vec = small_vector_init_with(&storage, &ALLOCATOR);
+  vector(int) unused = small_vector_init(&unused_storage);
+
+  size_t i;
+  TEST_CASE_ASSERT(vector_capacity(vec) == 4);
+  for (i = 0; i < 4; i++) vector_push(vec, TEST_DATA[i]);
+  TEST_CASE_ASSERT(small_vector_is_inline(vec));
+  TEST_CASE_ASSERT(stats.calls == 0);
+  TEST_CASE_ASSERT(vector_get(vec, 3) == 4);
+
+  for (i = 4; i < TEST_DATA_LEN; i++) vector_push_s(vec, TEST_DATA[i]);
+  TEST_CASE_ASSERT(!small_vector_is_inline(vec));
+  TEST_CASE_ASSERT(stats.live_blocks == 1);
+  TEST_CASE_ASSERT(memcmp(vec, TEST_DATA, sizeof TEST_DATA) == 0);
+  {
+    vector(int) copy = vector_copy_s(vec);
+    TEST_CASE_ASSERT(stats.live_blocks == 2);
+    vector_delete(copy);
+  }
+  vector_delete(vec);
+  TEST_CASE_ASSERT(stats.live_blocks == 0);
+  TEST_CASE_ASSERT(stats.live_bytes == 0);
+
+  vector_delete(unused);
+  return true;
+}
+
+bool test_vector_soa(void) {
+  counting_allocator_stats stats;
+  const myclib_allocator ALLOCATOR = counting_allocator(&stats);
+  samples vec = samples_new_with(&ALLOCATOR, 1);
+  vector(sample) records;
+  samples_columns columns;
+
+  size_t i;
+  TEST_CASE_ASSERT(vec != NULL);
+  TEST_CASE_ASSERT(soa_vector_is_empty(vec));
+  for (i = 0; i < TEST_DATA_LEN; i++) {
+    sample record;
+    record.tag = 'x';
+    record.value = TEST_DATA[i] * 0.5;
+    record.id = TEST_DATA[i];
+    TEST_CASE_ASSERT(samples_push(&vec, &record) != NULL);
+  }
+  TEST_CASE_ASSERT(soa_vector_length(vec) == TEST_DATA_LEN);
+  TEST_CASE_ASSERT(soa_vector_capacity(vec) >= TEST_DATA_LEN);
+  TEST_CASE_ASSERT(stats.live_blocks == 1);
+
+  columns = samples_columns_of(vec);
+  TEST_CASE_ASSERT(columns.id == soa_vector_column(vec, int, 1));
+  TEST_CASE_ASSERT(memcmp(columns.id, TEST_DATA, sizeof TEST_DATA) == 0);
+  for (i = 0; i < TEST_DATA_LEN; i++) {
+    const sample RECORD = samples_get(vec, i);
+    TEST_CASE_ASSERT(RECORD.tag == 0);
+    TEST_CASE_ASSERT(RECORD.value == columns.value[i]);
+    TEST_CASE_ASSERT(RECORD.id == TEST_DATA[i]);
+  }
+  {
+    sample record = samples_get(vec, 3);
+    record.id = -1;
+    samples_set(vec, 3, &record);
+    TEST_CASE_ASSERT(columns.id[3] == -1);
+    TEST_CASE_ASSERT(samples_get(vec, 3).value == columns.value[3]);
+  }
+
+  records = samples_to_vector(vec);
+  TEST_CASE_ASSERT(vector_length(records) == TEST_DATA_LEN);
+  TEST_CASE_ASSERT(vector_allocator(records) == &ALLOCATOR);
+  TEST_CASE_ASSERT(vector_get(records, 3).id == -1);
+  TEST_CASE_ASSERT(vector_get(records, 9).value == 5.0);
+  samples_delete(&vec);
+  TEST_CASE_ASSERT(vec == NULL);
+  TEST_CASE_ASSERT(stats.live_blocks == 1);
+
+  vector_get(records, 0).id = 100;
+  vec = samples_from_vector(records);
+  TEST_CASE_ASSERT(soa_vector_length(vec) == TEST_DATA_LEN);
+  TEST_CASE_ASSERT(samples_columns_of(vec).id[0] == 100);
+  TEST_CASE_ASSERT(samples_columns_of(vec).value[9] == 5.0);
+  TEST_CASE_ASSERT(soa_vector_reserve(vec, 1000) != NULL);
+  TEST_CASE_ASSERT(samples_get(vec, 9).id == 10);
+  TEST_CASE_ASSERT(soa_vector_reserve(vec, (size_t)-1) == NULL);
+  TEST_CASE_ASSERT(soa_vector_length(vec) == TEST_DATA_LEN);
+  samples_delete(&vec);
+  vector_delete(records);
+  TEST_CASE_ASSERT(stats.live_blocks == 0);
+  TEST_CASE_ASSERT(stats.live_bytes == 0);
+  return true;
+}
+
+bool test_vector_sort(void) {
+  vector(int) ints = vector_new(int, SORT_TEST_LENGTH);
+  vector(int) expected = vector_new(int, SORT_TEST_LENGTH);
+  vector(vec_u64) u64s = vector_new(vec_u64, SORT_TEST_LENGTH);
+  vector(sort_record) records = vector_new(sort_record, SORT_TEST_LENGTH);
+  const size_t LENGTHS[] = {0, 1, 2, 23, 24, 129, SORT_TEST_LENGTH};
+
+  size_t pattern;
+  size_t length;
+  size_t i;
+  for (pattern = 0; pattern < PATTERN_COUNT; pattern++) {
+    for (length = 0; length < ARR_LEN(LENGTHS); length++) {
+      const size_t N = LENGTHS[length];
+      unsigned long state = (unsigned long)(pattern + 1);
+      vector_reset(ints);
+      vector_reset(u64s);
+      vector_reset(records);
+      for (i = 0; i < N; i++) {
+        const int VALUE = pattern_value((sort_pattern)pattern, i, &state);
+        const vec_u64 WIDE = (vec_u64)VALUE;
+        sort_record record;
+        record.key = VALUE;
+        record.seq = (int)i;
+        record.padding = 0;
+        vector_push(ints, VALUE);
+        vector_push(u64s, WIDE);
+        vector_push(records, record);
+      }
+      vector_resize(expected, N);
+      if (N != 0) memcpy(expected, ints, N * sizeof *ints);
+      qsort(expected, N, sizeof *expected, compare_ints);
+      vector_sort_s(ints, compare_ints);
+      vector_sort_s(u64s, compare_u64s);
+      vector_sort_s(records, compare_records);
+      for (i = 0; i < N; i++) {
+        TEST_CASE_ASSERT(ints[i] == expected[i]);
+        TEST_CASE_ASSERT(records[i].key == expected[i]);
+        TEST_CASE_ASSERT(i == 0 || u64s[i - 1] <= u64s[i]);
+      }
+    }
+  }
+
+  vector_delete(ints);
+  vector_delete(expected);
+  vector_delete(u64s);
+  vector_delete(records);
+  return true;
+}
+
+bool test_vector_sort_stable(void) {
+  vector(sort_record) records = vector_new(sort_record, SORT_TEST_LENGTH);
+  vector(int) ints = vector_new(int, SORT_TEST_LENGTH);
+  unsigned long state = 7;
+
+  size_t i;
+  for (i = 0; i < SORT_TEST_LENGTH; i++) {
+    sort_record record;
+    record.key = (int)(next_random(&state) % 10);
+    record.seq = (int)i;
+    record.padding = 0;
+    vector_push(records, record);
+    vector_push(ints, record.key);
+  }
+  TEST_CASE_ASSERT(vector_sort_stable_s(records, compare_records));
+  TEST_CASE_ASSERT(vector_sort_stable_s(ints, compare_ints));
+  for (i = 1; i < SORT_TEST_LENGTH; i++) {
+    TEST_CASE_ASSERT(records[i - 1].key <= records[i].key);
+    /* Equal keys keep the order they were pushed in. */
+    if (records[i - 1].key == records[i].key)
+      TEST_CASE_ASSERT(records[i - 1].seq < records[i].seq);
+    TEST_CASE_ASSERT(ints[i] == records[i].key);
+  }
+  TEST_CASE_ASSERT(vector_sort_stable(records, 1, sizeof *records,
+                                      compare_records));
+
+  vector_delete(records);
+  vector_delete(ints);
+  return true;
+}
+
+bool test_vector_splice(void) {
+  vector(int) vec = vector_new(int, 0);
+
+  const int SHRUNK[] = {1, 2, 9, 10, 9, 10};
+  const int GROWN[] = {1, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 10};
+
+  vector_append_n(vec, TEST_DATA, TEST_DATA_LEN);
+  vector_splice(vec, 2, 6, &TEST_DATA[8], 2);
+  TEST_CASE_ASSERT(vector_length(vec) == sizeof SHRUNK / sizeof *SHRUNK);
+  TEST_CASE_ASSERT(memcmp(vec, SHRUNK, sizeof SHRUNK) == 0);
+
+  TEST_CASE_ASSERT(vector_splice_s(vec, 1, 4, TEST_DATA, TEST_DATA_LEN) !=
+                   NULL);
+  TEST_CASE_ASSERT(vector_length(vec) == sizeof GROWN / sizeof *GROWN);
+  TEST_CASE_ASSERT(memcmp(vec, GROWN, sizeof GROWN) == 0);
+
+  vector_delete(vec);
+  return true;
+}
+
+bool test_vector_swap_remove(void) {
+  vector(int) vec = vector_new(int, 0);
+
+  vector_append_n(vec, TEST_DATA, TEST_DATA_LEN);
+  vector_swap_remove(vec, 0);
+  TEST_CASE_ASSERT(vector_length(vec) == TEST_DATA_LEN - 1);
+  TEST_CASE_ASSERT(vector_get(vec, 0) == 10);
+  vector_swap_remove_s(vec, 3);
+  TEST_CASE_ASSERT(vector_length(vec) == TEST_DATA_LEN - 2);
+  TEST_CASE_ASSERT(vector_get(vec, 3) == 9);
+  vector_swap_remove_s(vec, vector_length(vec) - 1);
+  TEST_CASE_ASSERT(vector_length(vec) == TEST_DATA_LEN - 3);
+  TEST_CASE_ASSERT(vector_get(vec, vector_length(vec) - 1) == 7);
+
+  vector_delete(vec);
+  return true;
+}
@@ -3,10 +3,20 @@
 
 #include "../../include/myclib.h"
 
+bool test_vector_aligned(void);
+
+bool test_vector_allocator(void);
+
+bool test_vector_append_n(void);
+
 bool test_vector_clear(void);
 
 bool test_vector_copy(void);
 
+bool test_vector_dedup(void);
+
+bool test_vector_define(void);
+
 bool test_vector_delete(void);
 
 bool test_vector_expand(void);
@@ -19,20 +29,56 @@ bool test_vector_index_of(void);
 
 bool test_vector_insert(void);
 
+bool test_vector_insert_n(void);
+
+bool test_vector_mmap(void);
+
 bool test_vector_new(void);
 
+bool test_vector_parallel_for_each(void);
+
+bool test_vector_parallel_scan(void);
+
+bool test_vector_parallel_sort(void);
+
 bool test_vector_pop(void);
 
 bool test_vector_push(void);
 
+bool test_vector_radix_sort(void);
+
 bool test_vector_remove(void);
 
+bool test_vector_remove_if(void);
+
+bool test_vector_remove_range(void);
+
+bool test_vector_reserve(void);
+
 bool test_vector_reset(void);
 
 bool test_vector_resize(void);
 
+bool test_vector_retain(void);
+
+bool test_vector_search(void);
+
 bool test_vector_set(void);
 
+bool test_vector_share(void);
+
 bool test_vector_shrink(void);
 
+bool test_vector_small(void);
+
+bool test_vector_soa(void);
+
+bool test_vector_sort(void);
+
+bool test_vector_sort_stable(void);
+
+bool test_vector_splice(void);
+
+bool test_vector_swap_remove(void);
+
 #endif
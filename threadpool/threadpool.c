@@ -0,0 +1,169 @@
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE (200112L)
+#endif
+
+#include "threadpool.h"
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "../include/myclib.h"
+
+/* - DEFINITIONS - */
+
+/*
+ *     `lock`     - Guards every other member besides `workers`.
+ *  `work_ready`  - Signalled when a batch is submitted or the pool stops.
+ *  `work_done`   - Signalled when the last task of a batch completes.
+ *   `workers`    - The `thread_count - 1` worker threads.
+ * `thread_count` - The number of threads executing each batch.
+ *  `generation`  - Incremented for every batch so that workers can tell a
+ *                  new batch from one they already finished.
+ *   `stopping`   - Set once the workers are to exit.
+ *     `task`     - The current batch's task function.
+ *     `ctx`      - The current batch's context.
+ *  `task_count`  - The number of tasks in the current batch.
+ *  `next_task`   - The index of the next task to hand out.
+ *   `pending`    - The number of tasks in the current batch which have not
+ *                  completed yet.
+ */
+struct threadpool {
+  pthread_mutex_t lock;
+  pthread_cond_t work_ready;
+  pthread_cond_t work_done;
+  pthread_t *workers;
+  size_t thread_count;
+  unsigned long generation;
+  bool stopping;
+  threadpool_task task;
+  void *ctx;
+  size_t task_count;
+  size_t next_task;
+  size_t pending;
+};
+
+/* - INTERNAL - */
+
+/*
+ * Executes tasks from the current batch until none are left to hand out.
+ * `pool->lock` must be held on entry and is held on return.
+ */
+static void drain_tasks(threadpool *const pool) {
+  while (pool->next_task < pool->task_count) {
+    const threadpool_task TASK = pool->task;
+    void *const ctx = pool->ctx;
+    const size_t INDEX = pool->next_task++;
+    pthread_mutex_unlock(&pool->lock);
+    TASK(ctx, INDEX);
+    pthread_mutex_lock(&pool->lock);
+    if (--pool->pending == 0) pthread_cond_signal(&pool->work_done);
+  }
+}
+
+static void *worker_main(void *const arg) {
+  threadpool *const pool = arg;
+  unsigned long seen_generation;
+  pthread_mutex_lock(&pool->lock);
+  seen_generation = pool->generation;
+  for (;;) {
+    while (!pool->stopping && pool->generation == seen_generation)
+      pthread_cond_wait(&pool->work_ready, &pool->lock);
+    if (pool->stopping) break;
+    seen_generation = pool->generation;
+    drain_tasks(pool);
+  }
+  pthread_mutex_unlock(&pool->lock);
+  return NULL;
+}
+
+/* Stops and joins the first `count` workers of `pool`. */
+static void stop_workers(threadpool *const pool, const size_t count) {
+  size_t i;
+  pthread_mutex_lock(&pool->lock);
+  pool->stopping = true;
+  pthread_cond_broadcast(&pool->work_ready);
+  pthread_mutex_unlock(&pool->lock);
+  for (i = 0; i < count; i++) pthread_join(pool->workers[i], NULL);
+}
+
+static void destroy_pool(threadpool *const pool) {
+  pthread_cond_destroy(&pool->work_done);
+  pthread_cond_destroy(&pool->work_ready);
+  pthread_mutex_destroy(&pool->lock);
+  free(pool->workers);
+  free(pool);
+}
+
+/* - FUNCTIONS - */
+
+size_t threadpool_cpu_count(void) {
+#ifdef _SC_NPROCESSORS_ONLN
+  const long COUNT = sysconf(_SC_NPROCESSORS_ONLN);
+  if (COUNT > 0) return (size_t)COUNT;
+#endif
+  return 1;
+}
+
+void threadpool_delete(threadpool *const pool) {
+  if (pool == NULL) return;
+  stop_workers(pool, pool->thread_count - 1);
+  destroy_pool(pool);
+}
+
+threadpool *threadpool_new(size_t thread_count) {
+  threadpool *const pool = malloc(sizeof *pool);
+  size_t i;
+  if (pool == NULL) return NULL;
+  if (thread_count == 0) thread_count = threadpool_cpu_count();
+  pool->workers = malloc(sizeof *pool->workers * (thread_count - 1) + 1);
+  if (pool->workers == NULL) {
+    free(pool);
+    return NULL;
+  }
+  pool->thread_count = thread_count;
+  pool->generation = 0;
+  pool->stopping = false;
+  pool->task = NULL;
+  pool->ctx = NULL;
+  pool->task_count = 0;
+  pool->next_task = 0;
+  pool->pending = 0;
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->work_ready, NULL);
+  pthread_cond_init(&pool->work_done, NULL);
+  for (i = 0; i < thread_count - 1; i++) {
+    if (pthread_create(&pool->workers[i], NULL, worker_main, pool) != 0) {
+      stop_workers(pool, i);
+      destroy_pool(pool);
+      return NULL;
+    }
+  }
+  return pool;
+}
+
+void threadpool_run(threadpool *const pool, const threadpool_task task,
+                    void *const ctx, const size_t task_count) {
+  size_t i;
+  if (task_count == 0) return;
+  if (pool == NULL || pool->thread_count == 1 || task_count == 1) {
+    for (i = 0; i < task_count; i++) task(ctx, i);
+    return;
+  }
+  pthread_mutex_lock(&pool->lock);
+  pool->task = task;
+  pool->ctx = ctx;
+  pool->task_count = task_count;
+  pool->next_task = 0;
+  pool->pending = task_count;
+  pool->generation++;
+  pthread_cond_broadcast(&pool->work_ready);
+  drain_tasks(pool);
+  while (pool->pending != 0) pthread_cond_wait(&pool->work_done, &pool->lock);
+  pthread_mutex_unlock(&pool->lock);
+}
+
+size_t threadpool_size(const threadpool *const pool) {
+  return pool == NULL ? 1 : pool->thread_count;
+}
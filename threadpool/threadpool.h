@@ -0,0 +1,78 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <stddef.h>
+
+#include "../include/myclib.h"
+
+/* - DEFINITIONS - */
+
+/*
+ * A fixed set of worker threads which execute batches of indexed tasks. The
+ * thread submitting a batch works on it alongside the workers, so a pool of
+ * `n` threads spawns `n - 1` workers.
+ *
+ * The library's parallel algorithms run on `scheduler` instead, which new
+ * parallel code should use as well. A pool suits running a handful of
+ * independent tasks on threads of their own, as stress tests do.
+ */
+typedef struct threadpool threadpool;
+
+/*
+ * Executes the task numbered `index` of a batch. `ctx` is the pointer the
+ * batch was submitted with and is shared by all of its tasks.
+ */
+typedef void (*threadpool_task)(void *ctx, size_t index);
+
+/* - FUNCTIONS - */
+
+/**
+ * @brief Determines the number of processors currently online.
+ *
+ * @return The number of online processors, or `1` if it cannot be determined.
+ */
+size_t threadpool_cpu_count(void);
+
+/**
+ * @brief Stops and joins a pool's workers, then deallocates the pool.
+ *
+ * @param pool The pool to delete, which must not be running a batch.
+ */
+void threadpool_delete(threadpool *pool);
+
+/**
+ * @brief Creates a pool and starts its workers.
+ *
+ * @param thread_count The number of threads executing each batch, including
+ * the submitting thread, or `0` for `threadpool_cpu_count()`.
+ * @return The new pool, or `NULL` if it or any of its workers could not be
+ * created.
+ */
+threadpool *threadpool_new(size_t thread_count);
+
+/**
+ * @brief Executes tasks `0` through `task_count - 1` across a pool, returning
+ * once all of them have completed.
+ *
+ * Tasks are handed out one at a time in increasing order to whichever thread
+ * is idle, so batches should hold several tasks per thread to balance uneven
+ * work. Tasks must not submit batches to the pool executing them.
+ *
+ * @param pool The pool to execute the tasks on, or `NULL` to execute them all
+ * on the calling thread.
+ * @param task The function executing each task.
+ * @param ctx The pointer passed to each task.
+ * @param task_count The number of tasks in the batch.
+ */
+void threadpool_run(threadpool *pool, threadpool_task task, void *ctx,
+                    size_t task_count);
+
+/**
+ * @brief Retrieves the number of threads executing a pool's batches.
+ *
+ * @param pool The pool to query, or `NULL`.
+ * @return The pool's thread count, or `1` if `pool` is `NULL`.
+ */
+size_t threadpool_size(const threadpool *pool);
+
+#endif
@@ -146,7 +146,7 @@ bt_node bt_untyped_node_add(void **const tree, bt_node parent,
 inline void bt_untyped_delete(void **const tree) {
   bt_header header = bt_header_from_ref(tree);
   stack_delete(header->deleted_nodes);
-  free(header);
+  myclib_free(header->allocator, header, header->allocation);
   *tree = NULL;
 }
 
@@ -176,16 +176,27 @@ bt_linkage bt_untyped_link_type(void *const tree, const_bt_node child,
   return NO_LINK;
 }
 
-void *bt_untyped_new(const size_t capacity, const size_t value_size) {
+inline void *bt_untyped_new(const size_t capacity, const size_t value_size) {
+  return bt_untyped_new_with(NULL, capacity, value_size);
+}
+
+void *bt_untyped_new_with(const myclib_allocator *const allocator,
+                          const size_t capacity, const size_t value_size) {
   const size_t PADDING = bt_calc_padding_init(capacity, value_size);
   const size_t ALLOCATION = (bt_untyped_nv_pair_size(value_size) * capacity) +
                             PADDING + sizeof(struct bt_header);
-  bt_header tree = malloc(ALLOCATION);
+  bt_header tree = myclib_alloc(allocator, ALLOCATION);
   if (tree == NULL) return NULL;
-  tree->deleted_nodes = stack_new(size_t, 3);
+  tree->deleted_nodes = stack_new_with(allocator, size_t, 3);
+  if (tree->deleted_nodes == NULL) {
+    myclib_free(allocator, tree, ALLOCATION);
+    return NULL;
+  }
   tree->active_nodes = 0;
   tree->allocation = ALLOCATION;
   tree->root = NULL_INDEX;
+  tree->allocator = allocator;
+  tree->padding = 0;
   return tree + 1;
 }
 
@@ -214,7 +225,8 @@ void *bt_untyped_set_value(void *const tree, const_bt_node node,
 void bt_untyped_traverse(void **const tree_ref, bt_op op,
                          const size_t value_size, void *args) {
   void *tree = *tree_ref;
-  stack(size_t) branches = stack_new(size_t, bt_header(tree)->active_nodes / 3);
+  stack(size_t) branches = stack_new_with(
+      bt_header(tree)->allocator, size_t, bt_header(tree)->active_nodes / 3);
 
   bt_node cur_node = bt_untyped_root(tree, value_size);
   while (cur_node != NULL) {
@@ -13,17 +13,29 @@
 #define binary_tree_new(type, capacity) \
   ((type *)bt_untyped_new(capacity, sizeof(type)))
 
+#define binary_tree_new_with(allocator, type, capacity) \
+  ((type *)bt_untyped_new_with(allocator, capacity, sizeof(type)))
+
 struct bt_node {
   size_t left;
   size_t right;
   size_t parent;
 };
 
+/*
+ * `allocator` - The allocator owning the tree's memory, including its
+ *               `deleted_nodes` stack, or `NULL` if the standard library's
+ *               allocation functions are used.
+ *  `padding`  - Unused. Keeps the header's size a multiple of 16 bytes so that
+ *               values are as aligned as the block holding them.
+ */
 struct bt_header {
   stack(size_t) deleted_nodes;
   size_t active_nodes;
   size_t allocation;
   size_t root;
+  const myclib_allocator *allocator;
+  size_t padding;
 };
 
 typedef struct bt_node *bt_node;
@@ -116,6 +128,9 @@ void bt_untyped_node_delete(binary_tree(void), bt_node, size_t value_size);
 
 binary_tree(void) bt_untyped_new(size_t capacity, size_t value_size);
 
+binary_tree(void) bt_untyped_new_with(const myclib_allocator *allocator,
+                                      size_t capacity, size_t value_size);
+
 bt_node bt_untyped_parent(binary_tree(void), const_bt_node, size_t value_size);
 
 bt_node bt_untyped_right(binary_tree(void), const_bt_node, size_t value_size);
@@ -0,0 +1,207 @@
+#include "soavector.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "../include/myclib.h"
+#include "vector.h"
+
+/* - INTERNAL - */
+
+/* The alignment every column starts on within a SoA vector's block. */
+#define COLUMN_ALIGNMENT ((size_t)16)
+
+#define align_up(size) \
+  (((size) + COLUMN_ALIGNMENT - 1) / COLUMN_ALIGNMENT * COLUMN_ALIGNMENT)
+
+/* The offset of the first column from the start of the block. */
+#define columns_offset(layout) \
+  align_up(sizeof(soa_header) + (sizeof(void *) * (layout)->field_count))
+
+/* The largest capacity whose allocation size does not overflow a `size_t`. */
+static size_t max_capacity(const soa_layout *const layout) {
+  const size_t OVERHEAD =
+      columns_offset(layout) + (COLUMN_ALIGNMENT * layout->field_count);
+  size_t record_bytes = 0;
+  size_t field;
+  for (field = 0; field < layout->field_count; field++)
+    record_bytes += layout->sizes[field];
+  return record_bytes == 0 ? (size_t)-1 - OVERHEAD
+                           : ((size_t)-1 - OVERHEAD) / record_bytes;
+}
+
+/* The offset of column `field` from the start of the block. */
+static size_t column_offset(const soa_layout *const layout, const size_t field,
+                            const size_t capacity) {
+  size_t offset = columns_offset(layout);
+  size_t i;
+  for (i = 0; i < field; i++) offset += align_up(layout->sizes[i] * capacity);
+  return offset;
+}
+
+static size_t allocation_size(const soa_layout *const layout,
+                              const size_t capacity) {
+  return column_offset(layout, layout->field_count, capacity);
+}
+
+/* Points every column pointer of the block at `header` at its column. */
+static soa_vector place_columns(soa_header *const header) {
+  const soa_layout *const layout = header->layout;
+  soa_vector vec = (void **)(header + 1);
+  size_t offset = columns_offset(layout);
+  size_t field;
+  for (field = 0; field < layout->field_count; field++) {
+    vec[field] = (byte *)header + offset;
+    offset += align_up(layout->sizes[field] * header->capacity);
+  }
+  return vec;
+}
+
+/* Copies the fields of `record` into row `index` of every column. */
+static void scatter(const soa_vector vec, const size_t index,
+                    const void *const record) {
+  const soa_layout *const layout = soa_header_const(vec)->layout;
+  size_t field;
+  for (field = 0; field < layout->field_count; field++) {
+    const size_t SIZE = layout->sizes[field];
+    memcpy((byte *)vec[field] + (index * SIZE),
+           (const byte *)record + layout->offsets[field], SIZE);
+  }
+}
+
+/*
+ * Grows the block of `*vec` to hold `capacity` records. Columns are moved from
+ * last to first since each only ever moves towards the end of the block, past
+ * where the following column used to be.
+ */
+static soa_vector reallocate(soa_vector *const vec, const size_t capacity) {
+  soa_header *const old_header = soa_header(*vec);
+  const soa_layout *const layout = old_header->layout;
+  const size_t OLD_CAPACITY = old_header->capacity;
+  const size_t LENGTH = old_header->length;
+  soa_header *new_header;
+  size_t field;
+  if (capacity > max_capacity(layout)) return NULL;
+  new_header = myclib_realloc(old_header->allocator, old_header,
+                              allocation_size(layout, OLD_CAPACITY),
+                              allocation_size(layout, capacity));
+  if (new_header == NULL) return NULL;
+  new_header->capacity = capacity;
+  for (field = layout->field_count; field-- > 0;) {
+    byte *const base = (byte *)new_header;
+    memmove(base + column_offset(layout, field, capacity),
+            base + column_offset(layout, field, OLD_CAPACITY),
+            layout->sizes[field] * LENGTH);
+  }
+  *vec = place_columns(new_header);
+  return *vec;
+}
+
+/* - FUNCTIONS - */
+
+void soa_vector_untyped_delete(soa_vector *const vec) {
+  soa_header *const header = soa_header(*vec);
+  myclib_free(header->allocator, header,
+              allocation_size(header->layout, header->capacity));
+  *vec = NULL;
+}
+
+soa_vector soa_vector_untyped_from_vector(const vector(void) records,
+                                          const soa_layout *const layout) {
+  const size_t LENGTH = vector_length(records);
+  soa_vector vec =
+      soa_vector_untyped_new_with(vector_allocator(records), layout, LENGTH);
+  size_t field;
+  if (vec == NULL) return NULL;
+  /* Filling one column at a time keeps each write stream sequential. */
+  for (field = 0; field < layout->field_count; field++) {
+    const size_t SIZE = layout->sizes[field];
+    const byte *src = (const byte *)records + layout->offsets[field];
+    byte *dst = vec[field];
+    size_t i;
+    for (i = 0; i < LENGTH; i++) {
+      memcpy(dst, src, SIZE);
+      dst += SIZE;
+      src += layout->record_size;
+    }
+  }
+  soa_header(vec)->length = LENGTH;
+  return vec;
+}
+
+void soa_vector_untyped_get(const soa_vector vec, const size_t index,
+                            void *const record) {
+  const soa_layout *const layout = soa_header_const(vec)->layout;
+  size_t field;
+  util_assert(index < soa_vector_length(vec));
+  memset(record, 0, layout->record_size);
+  for (field = 0; field < layout->field_count; field++) {
+    const size_t SIZE = layout->sizes[field];
+    memcpy((byte *)record + layout->offsets[field],
+           (const byte *)vec[field] + (index * SIZE), SIZE);
+  }
+}
+
+soa_vector soa_vector_untyped_new_with(const myclib_allocator *const allocator,
+                                       const soa_layout *const layout,
+                                       const size_t capacity) {
+  soa_header *header;
+  if (capacity > max_capacity(layout)) return NULL;
+  header = myclib_alloc(allocator, allocation_size(layout, capacity));
+  if (header == NULL) return NULL;
+  header->capacity = capacity;
+  header->length = 0;
+  header->allocator = allocator;
+  header->layout = layout;
+  return place_columns(header);
+}
+
+soa_vector soa_vector_untyped_push(soa_vector *const vec,
+                                   const void *const record) {
+  const size_t LENGTH = soa_vector_length(*vec);
+  if (soa_vector_untyped_reserve(vec, LENGTH + 1) == NULL) return NULL;
+  scatter(*vec, LENGTH, record);
+  soa_header(*vec)->length++;
+  return *vec;
+}
+
+soa_vector soa_vector_untyped_reserve(soa_vector *const vec,
+                                      const size_t capacity) {
+  const soa_header *const header = soa_header_const(*vec);
+  const size_t MAX_CAPACITY = max_capacity(header->layout);
+  size_t grown;
+  if (capacity <= header->capacity) return *vec;
+  grown = vector_untyped_grow_capacity(header->capacity, capacity,
+                                       header->layout->record_size);
+  if (grown > MAX_CAPACITY && capacity <= MAX_CAPACITY) grown = MAX_CAPACITY;
+  return reallocate(vec, grown);
+}
+
+void soa_vector_untyped_set(const soa_vector vec, const size_t index,
+                            const void *const record) {
+  util_assert(index < soa_vector_length(vec));
+  scatter(vec, index, record);
+}
+
+vector(void) soa_vector_untyped_to_vector(const soa_vector vec) {
+  const soa_header *const header = soa_header_const(vec);
+  const soa_layout *const layout = header->layout;
+  byte *const records = vector_untyped_new_with(
+      header->allocator, layout->record_size, header->length);
+  size_t field;
+  if (records == NULL) return NULL;
+  memset(records, 0, layout->record_size * header->length);
+  for (field = 0; field < layout->field_count; field++) {
+    const size_t SIZE = layout->sizes[field];
+    const byte *src = vec[field];
+    byte *dst = records + layout->offsets[field];
+    size_t i;
+    for (i = 0; i < header->length; i++) {
+      memcpy(dst, src, SIZE);
+      src += SIZE;
+      dst += layout->record_size;
+    }
+  }
+  vector_header(records)->length = header->length;
+  return records;
+}
@@ -0,0 +1,216 @@
+#ifndef SOA_VECTOR_H
+#define SOA_VECTOR_H
+
+#include <stddef.h>
+
+#include "../include/myclib.h"
+#include "vector.h"
+
+/* - DEFINITIONS - */
+
+/*
+ * A structure-of-arrays vector stores each field of its records in a separate
+ * contiguous column, so that scanning one field only reads that field's
+ * memory. All columns share one allocation and one length and capacity.
+ *
+ * A `soa_vector` points at an array of column pointers, with column `i`
+ * holding field `i` of every record. The column pointers change whenever the
+ * vector grows.
+ */
+typedef void **soa_vector;
+
+/*
+ * Describes the record type stored by a SoA vector.
+ *
+ * `field_count` - The number of fields, and so the number of columns.
+ *    `sizes`    - The size of each field.
+ *   `offsets`   - The offset of each field within a record.
+ * `record_size` - The size of a whole record.
+ */
+typedef struct soa_layout {
+  size_t field_count;
+  const size_t *sizes;
+  const size_t *offsets;
+  size_t record_size;
+} soa_layout;
+
+/* - INTERNAL USE ONLY - */
+
+/*
+ * `capacity`  - The number of records every column has room for.
+ *  `length`   - The number of records currently held.
+ * `allocator` - The allocator owning the vector's memory, or `NULL` if the
+ *               standard library's allocation functions are used.
+ *  `layout`   - The layout of the vector's records.
+ */
+typedef struct soa_header {
+  size_t capacity;
+  size_t length;
+  const myclib_allocator *allocator;
+  const soa_layout *layout;
+} soa_header;
+
+#define soa_header(vec) ((soa_header *)(vec) - 1)
+
+#define soa_header_const(vec) ((const soa_header *)(vec) - 1)
+
+#define SOA_COLUMN_MEMBER_(type, field) type *field;
+
+#define SOA_COLUMN_ASSIGN_(type, field) columns.field = (type *)vec[column++];
+
+#define SOA_FIELD_SIZE_(type, field) sizeof(type),
+
+#define SOA_FIELD_OFFSET_(type, field) offsetof(soa_record_, field),
+
+/* - CONVENIENCE MACROS - */
+
+#define soa_vector_capacity(vec) (+soa_header_const(vec)->capacity)
+
+/* Returns column `index` of `vec` as a `type *`. */
+#define soa_vector_column(vec, type, index) ((type *)(vec)[index])
+
+#define soa_vector_is_empty(vec) (soa_vector_length(vec) == 0)
+
+#define soa_vector_length(vec) (+soa_header_const(vec)->length)
+
+#define soa_vector_reserve(vec, capacity) \
+  soa_vector_untyped_reserve(&(vec), capacity)
+
+/* - TYPED GENERATORS - */
+
+/*
+ * `DEFINE_SOA_VECTOR(name, record_type, FIELDS)` defines `name` as a SoA
+ * vector of `record_type`, whose fields are listed by the macro `FIELDS`.
+ * `FIELDS(X)` must expand to `X(type, field)` for every field to be stored, in
+ * column order, e.g.
+ *
+ * `struct particle { float x; float y; int id; };`
+ * `#define PARTICLE_FIELDS(X) X(float, x) X(float, y) X(int, id)`
+ * `DEFINE_SOA_VECTOR(particles, struct particle, PARTICLE_FIELDS);`
+ *
+ * defines the following functions:
+ *
+ * `particles particles_new(size_t capacity)`
+ * `particles particles_new_with(const myclib_allocator *allocator,
+ *                               size_t capacity)`
+ * `void particles_delete(particles *vec)`
+ * `particles particles_push(particles *vec, const struct particle *record)`
+ * `struct particle particles_get(const particles vec, size_t index)`
+ * `void particles_set(particles vec, size_t index,
+ *                     const struct particle *record)`
+ * `particles_columns particles_columns_of(particles vec)`
+ * `particles particles_from_vector(const vector(struct particle) records)`
+ * `vector(struct particle) particles_to_vector(const particles vec)`
+ *
+ * where `particles_columns` holds a typed pointer to each column, named after
+ * its field, so that `particles_columns_of(vec).x[i]` is the `x` of record
+ * `i`. Fields left out of `FIELDS` are not stored and read back as zero.
+ */
+#define DEFINE_SOA_VECTOR(name, record_type, FIELDS)                          \
+  typedef soa_vector name;                                                    \
+                                                                              \
+  typedef struct name##_columns {                                             \
+    FIELDS(SOA_COLUMN_MEMBER_)                                                \
+  } name##_columns;                                                           \
+                                                                              \
+  static inline const soa_layout *name##_layout(void) {                      \
+    typedef record_type soa_record_;                                          \
+    static const size_t SIZES[] = {FIELDS(SOA_FIELD_SIZE_)};                  \
+    static const size_t OFFSETS[] = {FIELDS(SOA_FIELD_OFFSET_)};              \
+    static const soa_layout LAYOUT = {ARR_LEN(SIZES), SIZES, OFFSETS,         \
+                                      sizeof(record_type)};                   \
+    return &LAYOUT;                                                           \
+  }                                                                           \
+                                                                              \
+  static inline name name##_new_with(const myclib_allocator *const allocator, \
+                                     const size_t capacity) {                 \
+    return soa_vector_untyped_new_with(allocator, name##_layout(), capacity); \
+  }                                                                           \
+                                                                              \
+  static inline name name##_new(const size_t capacity) {                      \
+    return name##_new_with(NULL, capacity);                                   \
+  }                                                                           \
+                                                                              \
+  static inline void name##_delete(name *const vec) {                         \
+    soa_vector_untyped_delete(vec);                                           \
+  }                                                                           \
+                                                                              \
+  static inline name name##_push(name *const vec,                             \
+                                 const record_type *const record) {           \
+    return soa_vector_untyped_push(vec, record);                              \
+  }                                                                           \
+                                                                              \
+  static inline record_type name##_get(const name vec, const size_t index) {  \
+    record_type record;                                                       \
+    soa_vector_untyped_get(vec, index, &record);                              \
+    return record;                                                            \
+  }                                                                           \
+                                                                              \
+  static inline void name##_set(const name vec, const size_t index,           \
+                                const record_type *const record) {            \
+    soa_vector_untyped_set(vec, index, record);                               \
+  }                                                                           \
+                                                                              \
+  static inline name##_columns name##_columns_of(const name vec) {            \
+    name##_columns columns;                                                   \
+    size_t column = 0;                                                        \
+    FIELDS(SOA_COLUMN_ASSIGN_)                                                \
+    return columns;                                                           \
+  }                                                                           \
+                                                                              \
+  static inline name name##_from_vector(const record_type *const records) {   \
+    return soa_vector_untyped_from_vector(records, name##_layout());          \
+  }                                                                           \
+                                                                              \
+  static inline record_type *name##_to_vector(const name vec) {               \
+    return soa_vector_untyped_to_vector(vec);                                 \
+  }                                                                           \
+                                                                              \
+  typedef int name##_require_semicolon
+
+/* - FUNCTIONS - */
+
+void soa_vector_untyped_delete(soa_vector *vec);
+
+/*
+ * Creates a SoA vector holding the records of `records`, a `vector` of records
+ * laid out as `layout` describes. Returns `NULL` if it could not be allocated.
+ */
+soa_vector soa_vector_untyped_from_vector(const vector(void) records,
+                                          const soa_layout *layout);
+
+/* Gathers the fields of record `index` into `*record`. */
+void soa_vector_untyped_get(const soa_vector vec, size_t index, void *record);
+
+/*
+ * Creates a SoA vector with room for `capacity` records laid out as `layout`
+ * describes, which must outlive it. Returns `NULL` if it could not be
+ * allocated.
+ */
+soa_vector soa_vector_untyped_new_with(const myclib_allocator *allocator,
+                                       const soa_layout *layout,
+                                       size_t capacity);
+
+/*
+ * Scatters the fields of `*record` into a new last record, returning the
+ * vector, or `NULL` if it could not be expanded.
+ */
+soa_vector soa_vector_untyped_push(soa_vector *vec, const void *record);
+
+/*
+ * Ensures `*vec` can hold at least `capacity` records, growing it as directed
+ * by `VEC_GROWTH_POLICY` if it cannot. Returns the vector, or `NULL` if it
+ * could not be expanded.
+ */
+soa_vector soa_vector_untyped_reserve(soa_vector *vec, size_t capacity);
+
+/* Scatters the fields of `*record` into record `index`. */
+void soa_vector_untyped_set(soa_vector vec, size_t index, const void *record);
+
+/*
+ * Creates a `vector` holding every record of `vec`, or returns `NULL` if it
+ * could not be allocated.
+ */
+vector(void) soa_vector_untyped_to_vector(const soa_vector vec);
+
+#endif
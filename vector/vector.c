@@ -0,0 +1,338 @@
+#include "vector.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "../cpu/cpu.h"
+#include "../include/myclib.h"
+
+/* - SIMD AVAILABILITY - */
+
+#define TARGET_DEFAULT
+
+/* - DEFINITIONS - */
+
+typedef enum search_mode {
+  SEARCH_FIRST,
+  SEARCH_LAST,
+  SEARCH_COUNT,
+  SEARCH_ALL
+} search_mode;
+
+/*
+ * A bit mask over the bytes of a SIMD block, where the lowest bit of each
+ * matching element's bytes is set.
+ */
+typedef unsigned long block_mask;
+
+/* - BIT MANIPULATION - */
+
+static inline size_t lowest_bit(const block_mask mask) {
+#if defined(__GNUC__) || defined(__clang__)
+  return (size_t)__builtin_ctzl(mask);
+#else
+  size_t i = 0;
+  while (((mask >> i) & 1) == 0) i++;
+  return i;
+#endif
+}
+
+static inline size_t highest_bit(const block_mask mask) {
+#if defined(__GNUC__) || defined(__clang__)
+  return (sizeof(mask) * CHAR_BIT) - 1 - (size_t)__builtin_clzl(mask);
+#else
+  size_t i = (sizeof(mask) * CHAR_BIT) - 1;
+  while (((mask >> i) & 1) == 0) i--;
+  return i;
+#endif
+}
+
+static inline size_t popcount(block_mask mask) {
+#if defined(__GNUC__) || defined(__clang__)
+  return (size_t)__builtin_popcountl(mask);
+#else
+  size_t cnt = 0;
+  for (; mask != 0; mask &= mask - 1) cnt++;
+  return cnt;
+#endif
+}
+
+/* - SCALAR KERNEL - */
+
+static inline bool elem_equals(const byte *const a, const byte *const b,
+                               const size_t elem_size) {
+  /* Constant sizes let the compiler replace `memcmp()` with a single load. */
+  switch (elem_size) {
+    case 1:
+      return *a == *b;
+    case 2:
+      return memcmp(a, b, 2) == 0;
+    case 4:
+      return memcmp(a, b, 4) == 0;
+    case 8:
+      return memcmp(a, b, 8) == 0;
+    case 16:
+      return memcmp(a, b, 16) == 0;
+    default:
+      return memcmp(a, b, elem_size) == 0;
+  }
+}
+
+/*
+ * Searches `length` elements at `data`. For `SEARCH_FIRST` and `SEARCH_LAST`,
+ * the index of the match is returned; otherwise the number of matches is.
+ * `base` is added to every index reported. `VEC_BAD_INDEX` is returned if no
+ * match was found or a position could not be recorded.
+ */
+static size_t scalar_search(const byte *const data, const size_t length,
+                            const byte *const elem, const size_t elem_size,
+                            const search_mode mode, const size_t base,
+                            vector(size_t) *const positions) {
+  size_t count = 0;
+  size_t i;
+  if (mode == SEARCH_LAST) {
+    for (i = length; i-- > 0;)
+      if (elem_equals(data + (i * elem_size), elem, elem_size)) return base + i;
+    return VEC_BAD_INDEX;
+  }
+  for (i = 0; i < length; i++) {
+    if (!elem_equals(data + (i * elem_size), elem, elem_size)) continue;
+    if (mode == SEARCH_FIRST) return base + i;
+    if (mode == SEARCH_ALL) {
+      const size_t POSITION = base + i;
+      if (vector_untyped_push((void **)positions, &POSITION, sizeof POSITION) ==
+          NULL)
+        return VEC_BAD_INDEX;
+    }
+    count++;
+  }
+  return mode == SEARCH_FIRST ? VEC_BAD_INDEX : count;
+}
+
+/* - SIMD KERNELS - */
+
+/*
+ * Defines a search over whole SIMD blocks of `BLOCK_SIZE` bytes, deferring any
+ * trailing elements to `scalar_search()`. `block_mask_fn` compares one block
+ * against a broadcast needle and returns a `block_mask`.
+ */
+#define DEFINE_SIMD_SEARCH(name, attributes, simd_type, BLOCK_SIZE, load_fn, \
+                           block_mask_fn)                                    \
+  static attributes size_t name(const byte *const data, const size_t length, \
+                                const byte *const elem,                      \
+                                const size_t elem_size,                      \
+                                const search_mode mode,                      \
+                                vector(size_t) *const positions) {           \
+    const size_t PER_BLOCK = (BLOCK_SIZE) / elem_size;                       \
+    const size_t BLOCKS = length / PER_BLOCK;                                \
+    const size_t TAIL = BLOCKS * PER_BLOCK;                                  \
+    byte needle_bytes[BLOCK_SIZE];                                           \
+    simd_type needle;                                                        \
+    size_t count = 0;                                                        \
+    size_t block;                                                            \
+    for (block = 0; block < PER_BLOCK; block++)                              \
+      memcpy(needle_bytes + (block * elem_size), elem, elem_size);           \
+    needle = load_fn((const simd_type *)needle_bytes);                       \
+    if (mode == SEARCH_LAST) {                                               \
+      const size_t FOUND =                                                   \
+          scalar_search(data + (TAIL * elem_size), length - TAIL, elem,      \
+                        elem_size, SEARCH_LAST, TAIL, NULL);                 \
+      if (FOUND != VEC_BAD_INDEX) return FOUND;                              \
+      for (block = BLOCKS; block-- > 0;) {                                   \
+        const block_mask MASK =                                              \
+            block_mask_fn(data + (block * (BLOCK_SIZE)), needle, elem_size); \
+        if (MASK != 0)                                                       \
+          return (block * PER_BLOCK) + (highest_bit(MASK) / elem_size);      \
+      }                                                                      \
+      return VEC_BAD_INDEX;                                                  \
+    }                                                                        \
+    for (block = 0; block < BLOCKS; block++) {                               \
+      block_mask mask =                                                      \
+          block_mask_fn(data + (block * (BLOCK_SIZE)), needle, elem_size);   \
+      if (mask == 0) continue;                                               \
+      switch (mode) {                                                        \
+        case SEARCH_FIRST:                                                   \
+          return (block * PER_BLOCK) + (lowest_bit(mask) / elem_size);       \
+        case SEARCH_ALL:                                                     \
+          for (; mask != 0; mask &= mask - 1) {                              \
+            const size_t POSITION =                                          \
+                (block * PER_BLOCK) + (lowest_bit(mask) / elem_size);        \
+            if (vector_untyped_push((void **)positions, &POSITION,           \
+                                    sizeof POSITION) == NULL)                \
+              return VEC_BAD_INDEX;                                          \
+            count++;                                                         \
+          }                                                                  \
+          break;                                                             \
+        default:                                                             \
+          count += popcount(mask);                                           \
+          break;                                                             \
+      }                                                                      \
+    }                                                                        \
+    {                                                                        \
+      const size_t TAIL_RESULT =                                             \
+          scalar_search(data + (TAIL * elem_size), length - TAIL, elem,      \
+                        elem_size, mode, TAIL, positions);                   \
+      if (mode == SEARCH_FIRST || TAIL_RESULT == VEC_BAD_INDEX)              \
+        return TAIL_RESULT;                                                  \
+      return count + TAIL_RESULT;                                            \
+    }                                                                        \
+  }
+
+#if (MYCLIB_HAS_SSE2)
+/*
+ * Elements are compared at their own width where SSE2 allows it, so that every
+ * byte of an element shares its comparison result; the mask is then thinned
+ * out to one bit per element. Wider elements fold their narrower results
+ * together first.
+ */
+static inline block_mask sse2_block_mask(const byte *const block,
+                                         const __m128i needle,
+                                         const size_t elem_size) {
+  const __m128i DATA = _mm_loadu_si128((const __m128i *)block);
+  block_mask mask;
+  switch (elem_size) {
+    case 1:
+      return (block_mask)_mm_movemask_epi8(_mm_cmpeq_epi8(DATA, needle));
+    case 2:
+      mask = (block_mask)_mm_movemask_epi8(_mm_cmpeq_epi16(DATA, needle));
+      return mask & 0x5555;
+    case 4:
+      mask = (block_mask)_mm_movemask_epi8(_mm_cmpeq_epi32(DATA, needle));
+      return mask & 0x1111;
+    case 8:
+      mask = (block_mask)_mm_movemask_epi8(_mm_cmpeq_epi32(DATA, needle));
+      return mask & (mask >> 4) & 0x0101;
+    default:
+      mask = (block_mask)_mm_movemask_epi8(_mm_cmpeq_epi32(DATA, needle));
+      return mask == 0xFFFF;
+  }
+}
+
+DEFINE_SIMD_SEARCH(sse2_search, TARGET_DEFAULT, __m128i, 16,
+                   _mm_loadu_si128, sse2_block_mask)
+#endif
+
+#if (MYCLIB_HAS_AVX2)
+static inline MYCLIB_TARGET_AVX2 block_mask avx2_block_mask(
+    const byte *const block, const __m256i needle, const size_t elem_size) {
+  const __m256i DATA = _mm256_loadu_si256((const __m256i *)block);
+  block_mask mask;
+  switch (elem_size) {
+    case 1:
+      return (block_mask)(unsigned int)_mm256_movemask_epi8(
+          _mm256_cmpeq_epi8(DATA, needle));
+    case 2:
+      mask = (block_mask)(unsigned int)_mm256_movemask_epi8(
+          _mm256_cmpeq_epi16(DATA, needle));
+      return mask & 0x55555555UL;
+    case 4:
+      mask = (block_mask)(unsigned int)_mm256_movemask_epi8(
+          _mm256_cmpeq_epi32(DATA, needle));
+      return mask & 0x11111111UL;
+    case 8:
+      mask = (block_mask)(unsigned int)_mm256_movemask_epi8(
+          _mm256_cmpeq_epi64(DATA, needle));
+      return mask & 0x01010101UL;
+    default:
+      mask = (block_mask)(unsigned int)_mm256_movemask_epi8(
+          _mm256_cmpeq_epi64(DATA, needle));
+      return mask & (mask >> 8) & 0x00010001UL;
+  }
+}
+
+DEFINE_SIMD_SEARCH(avx2_search, MYCLIB_TARGET_AVX2, __m256i, 32,
+                   _mm256_loadu_si256, avx2_block_mask)
+#endif
+
+/* - DISPATCH - */
+
+static size_t search(const void *const data, const size_t length,
+                     const void *const elem, const size_t elem_size,
+                     const search_mode mode, vector(size_t) *const positions) {
+  switch (elem_size) {
+    case 1:
+    case 2:
+    case 4:
+    case 8:
+    case 16:
+      switch (cpu_simd_support()) {
+#if (MYCLIB_HAS_AVX2)
+        case CPU_SIMD_AVX2:
+          return avx2_search(data, length, elem, elem_size, mode, positions);
+#endif
+#if (MYCLIB_HAS_SSE2)
+        case CPU_SIMD_SSE2:
+          return sse2_search(data, length, elem, elem_size, mode, positions);
+#endif
+        default:
+          break;
+      }
+      break;
+    default:
+      break;
+  }
+  return scalar_search(data, length, elem, elem_size, mode, 0, positions);
+}
+
+/* - SMALL VECTOR ALLOCATOR - */
+
+static void *small_alloc(void *const ctx, const size_t size) {
+  const small_vector_prefix *const prefix = ctx;
+  return myclib_alloc(prefix->spill, size);
+}
+
+static void *small_realloc(void *const ctx, void *const ptr,
+                           const size_t old_size, const size_t new_size) {
+  const small_vector_prefix *const prefix = ctx;
+  void *spilled;
+  if (ptr != prefix->inline_block)
+    return myclib_realloc(prefix->spill, ptr, old_size, new_size);
+  spilled = myclib_alloc(prefix->spill, new_size);
+  if (spilled != NULL)
+    memcpy(spilled, ptr, old_size < new_size ? old_size : new_size);
+  return spilled;
+}
+
+static void small_free(void *const ctx, void *const ptr, const size_t size) {
+  const small_vector_prefix *const prefix = ctx;
+  if (ptr != prefix->inline_block) myclib_free(prefix->spill, ptr, size);
+}
+
+/* - LIBRARY FUNCTIONS - */
+
+size_t vector_search_count(const void *const data, const size_t length,
+                           const void *const elem, const size_t elem_size) {
+  return search(data, length, elem, elem_size, SEARCH_COUNT, NULL);
+}
+
+size_t vector_search_first(const void *const data, const size_t length,
+                           const void *const elem, const size_t elem_size) {
+  return search(data, length, elem, elem_size, SEARCH_FIRST, NULL);
+}
+
+size_t vector_search_last(const void *const data, const size_t length,
+                          const void *const elem, const size_t elem_size) {
+  return search(data, length, elem, elem_size, SEARCH_LAST, NULL);
+}
+
+size_t vector_search_all(const void *const data, const size_t length,
+                         const void *const elem, const size_t elem_size,
+                         vector(size_t) *const positions) {
+  return search(data, length, elem, elem_size, SEARCH_ALL, positions);
+}
+
+void vector_untyped_small_init(small_vector_prefix *const prefix,
+                               vector_header *const header,
+                               const myclib_allocator *const spill,
+                               const size_t capacity) {
+  prefix->allocator.alloc = small_alloc;
+  prefix->allocator.realloc = small_realloc;
+  prefix->allocator.free = small_free;
+  prefix->allocator.ctx = prefix;
+  prefix->spill = spill;
+  prefix->inline_block = header;
+  header->capacity = capacity;
+  header->length = 0;
+  header->allocator = &prefix->allocator;
+  header->shares = 0;
+}
@@ -6,6 +6,7 @@
 #include <string.h>
 
 #include "../include/myclib.h"
+#include "../sched/scheduler.h"
 
 /* - DEFINITIONS - */
 
@@ -27,23 +28,112 @@ typedef void (*vec_for_each_op)(void *args[]);
 
 typedef void (*vec_for_each_op_const)(const void *args[]);
 
+/*
+ * Receives the `count` consecutive elements starting at `chunk`, along with a
+ * pointer to any additional arguments that were specified, which may be `NULL`.
+ */
+typedef void (*vec_chunk_op)(void *chunk, size_t count, void *args);
+
+typedef void (*vec_chunk_op_const)(const void *chunk, size_t count,
+                                   const void *args);
+
+/*
+ * Decides whether an element satisfies some condition. The single parameter is
+ * laid out as it is for `vec_for_each_op_const`.
+ */
+typedef bool (*vec_predicate)(const void *args[]);
+
 /* - INTERNAL USE ONLY - */
 
 #define VEC_EXPANSION_FACTOR (2)
 
 /*
- * `capacity` - The total number of elements a vector has allocated for.
- *  `length`  - The number of elements currently held by a vector.
+ * `capacity`  - The total number of elements a vector has allocated for.
+ *  `length`   - The number of elements currently held by a vector.
+ * `allocator` - The allocator owning the vector's memory, or `NULL` if the
+ *               standard library's allocation functions are used.
+ *   `shares`  - The number of handles sharing the vector besides the first,
+ *               as counted by `vector_share()`. Also keeps the header's size a
+ *               multiple of 16 bytes so that elements are as aligned as the
+ *               block holding them.
  */
 typedef struct {
   size_t capacity;
   size_t length;
+  const myclib_allocator *allocator;
+  size_t shares;
 } vector_header;
 
 #define vector_header(vec) ((vector_header *)(vec) - 1)
 
 #define vector_header_const(vec) ((const vector_header *)(vec) - 1)
 
+/* The size of the block holding a vector of `capacity` elements. */
+#define vector_allocation_size(elem_size, capacity) \
+  (((elem_size) * (capacity)) + sizeof(vector_header))
+
+/*
+ * Share counts are updated atomically where the compiler supports it, so that
+ * handles to one vector may be released from different threads.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define vec_shares_load(header) \
+  __atomic_load_n(&(header)->shares, __ATOMIC_ACQUIRE)
+#define vec_shares_acquire(header) \
+  ((void)__atomic_add_fetch(&(header)->shares, 1, __ATOMIC_RELAXED))
+/* Evaluates to the share count from before it was decremented. */
+#define vec_shares_release(header) \
+  __atomic_fetch_sub(&(header)->shares, 1, __ATOMIC_ACQ_REL)
+#else
+#define vec_shares_load(header) ((header)->shares)
+#define vec_shares_acquire(header) ((void)(header)->shares++)
+#define vec_shares_release(header) ((header)->shares--)
+#endif
+
+/* - CAPACITY POLICY - */
+
+/*
+ * A growth policy maps a vector's current capacity to the capacity it should
+ * have after its next expansion. Whenever an operation needs more room than a
+ * vector has, the vector grows to the larger of the policy's suggestion and
+ * the room actually required, so a run of single-element insertions costs
+ * amortized O(1) reallocations instead of one per insertion.
+ *
+ * The policy is selected at compile time by defining `VEC_GROWTH_POLICY`
+ * before including this header. Any function-like macro or function of the
+ * form `size_t policy(size_t capacity, size_t elem_size)` may be used; the
+ * policies below are provided.
+ */
+
+/* Multiplies the capacity by `VEC_EXPANSION_FACTOR`. */
+#define vec_growth_doubling(capacity, elem_size) \
+  ((void)(elem_size), VEC_EXPANSION_FACTOR * (capacity))
+
+/* Grows the capacity by half, which lets freed blocks be reused sooner. */
+#define vec_growth_one_and_half(capacity, elem_size) \
+  ((void)(elem_size), (capacity) + ((capacity) / 2))
+
+/*
+ * Doubles the capacity, then rounds the whole allocation (header included)
+ * up to a multiple of `VEC_PAGE_SIZE` once it spans at least a page, so that
+ * large vectors never leave a partially used page at their tail.
+ */
+#define vec_growth_page_rounded(capacity, elem_size) \
+  vector_untyped_page_rounded_capacity(              \
+      VEC_EXPANSION_FACTOR * (capacity), elem_size)
+
+#ifndef VEC_PAGE_SIZE
+#define VEC_PAGE_SIZE ((size_t)4096)
+#endif
+
+#ifndef VEC_GROWTH_POLICY
+#define VEC_GROWTH_POLICY vec_growth_doubling
+#endif
+
+/* The largest capacity whose allocation size does not overflow a `size_t`. */
+#define VEC_MAX_CAPACITY(elem_size) \
+  (((size_t)-1 - sizeof(vector_header)) / (elem_size))
+
 /* - CONVENIENCE MACROS - */
 
 /*
@@ -51,26 +141,54 @@ typedef struct {
  * than once.
  */
 
+#define vector_allocator(vec) (vector_header_const(vec)->allocator)
+
+/*
+ * Appends the `count` elements at `src`, which may be an array or another
+ * vector but must not overlap `vec`.
+ */
+#define vector_append_n(vec, src, count) \
+  vector_insert_n(vec, src, count, vector_length(vec))
+
+#define vector_append_n_s(vec, src, count) \
+  vector_untyped_append_n((void **)&(vec), src, count, sizeof *(vec))
+
 #define vector_capacity(vec) (+vector_header_const(vec)->capacity)
 
 #define vector_clear(vec) \
   ((void)(memset(vec, 0, sizeof *(vec) * vector_length(vec))))
 
-#define vector_clear_s(vec) vector_untyped_clear(vec, sizeof *(vec))
+#define vector_clear_s(vec) \
+  vector_untyped_clear((void **)&(vec), sizeof *(vec))
 
-#define vector_copy(vec)                                                       \
-  ((void *)((vector_header *)memcpy(                                              \
-                malloc((sizeof *(vec) * vector_capacity(vec)) +                \
-                       sizeof(vector_header)),                                    \
-                vector_header_const(vec),                                      \
-                (sizeof *(vec) * vector_capacity(vec)) + sizeof(vector_header)) + \
-            1))
+#define vector_count_of(vec, elem) \
+  vector_untyped_count_of(vec, &(elem), sizeof *(vec))
+
+/*
+ * Copies the elements of `vec` into a new, unshared vector whose capacity is
+ * the length of `vec`.
+ */
+#define vector_copy(vec) vector_untyped_copy(vec, sizeof *(vec))
 
 #define vector_copy_s(vec) vector_untyped_copy(vec, sizeof *(vec))
 
-#define vector_delete(vec) ((void)(free(vector_header(vec)), (vec) = NULL))
+/*
+ * Releases the vector, which is only deallocated once no other handle shares
+ * it.
+ */
+#define vector_delete(vec) \
+  vector_untyped_delete((void **)&(vec), sizeof *(vec))
 
-#define vector_delete_s(vec) vector_untyped_delete((void **)&(vec))
+#define vector_delete_s(vec) \
+  vector_untyped_delete((void **)&(vec), sizeof *(vec))
+
+/*
+ * Removes all but the first of each run of bytewise equal elements, leaving a
+ * sorted vector with only distinct elements. Returns the number of elements
+ * removed, or `VEC_BAD_INDEX` if the vector could not be unshared.
+ */
+#define vector_dedup(vec) \
+  vector_untyped_dedup((void **)&(vec), sizeof *(vec))
 
 #define vector_expand(vec)                                            \
   (vector_resize(vec, vector_length(vec) != 0                         \
@@ -126,6 +244,13 @@ typedef struct {
   (void)0
 #endif
 
+/*
+ * Appends the index of every element equal to `elem` to `positions`, a
+ * `vector(size_t)`, returning the number of indices appended.
+ */
+#define vector_find_all(vec, elem, positions) \
+  vector_untyped_find_all(vec, &(elem), &(positions), sizeof *(vec))
+
 #define vector_for_each_c_s(vec, op, args) \
   vector_untyped_for_each_c(vec, op, args, sizeof *(vec))
 
@@ -151,18 +276,37 @@ typedef struct {
 #define vector_insert_s(vec, elem, index) \
   vector_untyped_insert((void **)&(vec), &(elem), index, sizeof *(vec))
 
+/*
+ * Inserts the `count` elements at `src` before the element at `index`, which
+ * may be at most the vector's length. `src` may be an array or another vector
+ * but must not overlap `vec`.
+ */
+#define vector_insert_n(vec, src, count, index) \
+  vector_splice(vec, index, 0, src, count)
+
+#define vector_insert_n_s(vec, src, count, index) \
+  vector_untyped_insert_n((void **)&(vec), src, count, index, sizeof *(vec))
+
 #define vector_is_empty(vec) (vector_length(vec) == 0)
 
+#define vector_is_shared(vec) (vec_shares_load(vector_header(vec)) != 0)
+
+#define vector_last_index_of(vec, elem) \
+  vector_untyped_last_index_of(vec, &(elem), sizeof *(vec))
+
 #define vector_length(vec) (+vector_header_const(vec)->length)
 
 #define vector_new(type, capacity) \
   ((type *)vector_untyped_new(sizeof(type), capacity))
 
+#define vector_new_with(allocator, type, capacity) \
+  ((type *)vector_untyped_new_with(allocator, sizeof(type), capacity))
+
 #define vector_pop(vec)                                                        \
   (inline_if(!vector_is_empty(vec), (void)vector_header(vec)->length--, NULL), \
    (vec)[vector_length(vec)])
 
-#define vector_pop_s(vec) vector_untyped_pop(vec, sizeof *(vec))
+#define vector_pop_s(vec) vector_untyped_pop((void **)&(vec), sizeof *(vec))
 
 #define vector_push(vec, elem)                       \
   ((void)vector_resize(vec, vector_length(vec) + 1), \
@@ -178,11 +322,46 @@ typedef struct {
                   sizeof *(vec) * (vector_length(vec) - (index) - 1)), \
           vector_header(vec)->length--))
 
+/*
+ * Removes every element for which `pred` returns `true` in a single pass,
+ * preserving the order of those that remain. Returns the number of elements
+ * removed, or `VEC_BAD_INDEX` if the vector could not be unshared.
+ */
+#define vector_remove_if(vec, pred, args) \
+  vector_untyped_remove_if((void **)&(vec), pred, args, sizeof *(vec))
+
 #define vector_remove_s(vec, index) \
-  vector_untyped_remove(vec, index, sizeof *(vec))
+  vector_untyped_remove((void **)&(vec), index, sizeof *(vec))
+
+/* Removes the `count` elements starting at `index`. */
+#define vector_remove_range(vec, index, count)                           \
+  (util_assert((size_t)(index) <= vector_length(vec) &&                  \
+               (size_t)(count) <= vector_length(vec) - (size_t)(index)), \
+   (void)(memmove((void *)((vec) + (index)),                             \
+                  (const void *)((vec) + (index) + (count)),             \
+                  sizeof *(vec) *                                        \
+                      (vector_length(vec) - (index) - (count))),         \
+          vector_header(vec)->length -= (count)))
+
+#define vector_remove_range_s(vec, index, count) \
+  vector_untyped_remove_range((void **)&(vec), index, count, sizeof *(vec))
+
+#define vector_reserve(vec, capacity) \
+  vector_untyped_reserve((void **)&(vec), capacity, sizeof *(vec))
+
+#define vector_reserve_exact(vec, capacity) \
+  vector_untyped_reserve_exact((void **)&(vec), capacity, sizeof *(vec))
 
 #define vector_reset(vec) ((void)(vector_header(vec)->length = 0))
 
+/*
+ * Keeps only the elements for which `pred` returns `true`, compacting them in
+ * a single pass and preserving their order. Returns the number of elements
+ * removed, or `VEC_BAD_INDEX` if the vector could not be unshared.
+ */
+#define vector_retain(vec, pred, args) \
+  vector_untyped_retain((void **)&(vec), pred, args, sizeof *(vec))
+
 /* clang-format off */
 
 #define vector_resize(vec, new_length)                                        \
@@ -195,16 +374,9 @@ typedef struct {
           ( /* Condition (depth 2) - Is there enough capacity? */             \
             vector_capacity(vec) < (new_length),                              \
             ( /* True branch (depth 2) - Add enough capacity. */              \
-              (vec) = (void *)                                                \
-                (                                                             \
-                  1 + (vector_header *)realloc                                   \
-                  (                                                           \
-                    vector_header(vec),                                       \
-                    sizeof(vector_header) + (sizeof *(vec) * (new_length))       \
-                  )                                                           \
-                ),                                                            \
-              util_assert((vec) != NULL),                                     \
-              vector_header(vec)->capacity = (new_length)                     \
+              (void)vector_untyped_reserve((void **)&(vec), (new_length),     \
+                                           sizeof *(vec)),                    \
+              util_assert(vector_capacity(vec) >= (size_t)(new_length))       \
             ),                                                                \
             ( /* False branch (depth 2) */                                    \
               NULL                                                            \
@@ -229,23 +401,575 @@ typedef struct {
 #define vector_set_s(vec, elem, index) \
   vector_untyped_set((void **)&(vec), &(elem), index, sizeof *(vec))
 
-#define vector_shrink(vec)                                            \
-  ((void)((vec) = (void *)((vector_header *)(realloc(                    \
-                               vector_header(vec),                    \
-                               (sizeof *(vec) * vector_length(vec)) + \
-                                   sizeof(vector_header))) +             \
-                           1)),                                       \
-   (void)(vector_header(vec)->capacity = vector_length(vec)), (vec))
+/*
+ * Returns another handle to `vec` in O(1) time, without copying it. Handles
+ * sharing a vector are copied on write: the first call through a handle that
+ * could modify the vector (`vector_set_s()`, `vector_push_s()`,
+ * `vector_remove_s()`, `vector_reserve()` and every other function-backed
+ * macro which modifies it) first gives that handle a private copy, returning
+ * `NULL`, `false` or `VEC_BAD_INDEX` as its result type allows if the copy
+ * could not be allocated. `vector_splice()` and the macros built on it abort
+ * instead, as they do when they cannot grow the vector. Macros which modify a
+ * vector in place without calling a function, such as `vector_set()` or
+ * `vector_push()` within the vector's capacity, do not unshare it, and
+ * neither do those handing out mutable pointers to the elements:
+ * `vector_get_s()`, `vector_for_each_s()`, `vector_parallel_for_each()` and
+ * `vector_parallel_for_each_chunk()`. Handles must be unshared with
+ * `vector_unshare()` before being modified through any of these.
+ *
+ * Every handle must be deleted, and the vector is deallocated along with the
+ * last one. Handles may be shared and deleted from different threads.
+ */
+#define vector_share(vec) \
+  (vec_shares_acquire(vector_header(vec)), (vec))
+
+#define vector_shrink(vec) \
+  ((void)vector_untyped_shrink((void **)&(vec), sizeof *(vec)), (vec))
 
 #define vector_shrink_s(vec) \
   vector_untyped_shrink((void **)&(vec), sizeof *(vec))
 
+/*
+ * Replaces the `remove_count` elements starting at `index` with the
+ * `insert_count` elements at `src`, which must not overlap `vec`. At most one
+ * reallocation and one move of the vector's tail take place.
+ */
+#define vector_splice(vec, index, remove_count, src, insert_count)     \
+  (util_assert((size_t)(index) <= vector_length(vec) &&                \
+               (size_t)(remove_count) <=                               \
+                   vector_length(vec) - (size_t)(index)),              \
+   util_assert(vector_reserve(vec, vector_length(vec) -                \
+                                       (remove_count) +                \
+                                       (insert_count)) != NULL),       \
+   (void)memmove((void *)((vec) + (index) + (insert_count)),           \
+                 (const void *)((vec) + (index) + (remove_count)),     \
+                 sizeof *(vec) *                                       \
+                     (vector_length(vec) - (index) - (remove_count))), \
+   (void)memcpy((void *)((vec) + (index)), (const void *)(src),        \
+                sizeof *(vec) * (insert_count)),                       \
+   (void)(vector_header(vec)->length =                                 \
+              vector_length(vec) - (remove_count) + (insert_count)),   \
+   (vec))
+
+#define vector_splice_s(vec, index, remove_count, src, insert_count) \
+  vector_untyped_splice((void **)&(vec), index, remove_count, src,   \
+                        insert_count, sizeof *(vec))
+
+/*
+ * Removes the element at `index` in O(1) time by moving the last element into
+ * its place. The order of the remaining elements is not preserved.
+ */
+#define vector_swap_remove(vec, index)                  \
+  (util_assert((size_t)(index) < vector_length(vec)),   \
+   (void)((vec)[index] = (vec)[vector_length(vec) - 1], \
+          vector_header(vec)->length--))
+
+#define vector_swap_remove_s(vec, index) \
+  vector_untyped_swap_remove((void **)&(vec), index, sizeof *(vec))
+
+/*
+ * Gives `vec` a private copy of its elements if it shares them with another
+ * handle. Returns the vector, or `NULL` if the copy could not be allocated.
+ */
+#define vector_unshare(vec) \
+  vector_untyped_unshare((void **)&(vec), sizeof *(vec))
+
+/* - SEARCH ENGINE - */
+
+/*
+ * These search the `length` elements at `data` for those bytewise equal to
+ * `elem`. Elements of 1, 2, 4, 8 or 16 bytes are compared a SIMD register at a
+ * time, using the widest instruction set the CPU supports at runtime.
+ *
+ * `vector_search_first()` and `vector_search_last()` return the index of the
+ * first and last match respectively, or `VEC_BAD_INDEX` if there is none.
+ *
+ * `vector_search_all()` appends the index of every match to `*positions`, a
+ * `vector(size_t)`, and returns the number of matches, or `VEC_BAD_INDEX` if
+ * `*positions` could not be expanded.
+ */
+
+size_t vector_search_count(const void *data, size_t length, const void *elem,
+                           size_t elem_size);
+size_t vector_search_first(const void *data, size_t length, const void *elem,
+                           size_t elem_size);
+size_t vector_search_last(const void *data, size_t length, const void *elem,
+                          size_t elem_size);
+size_t vector_search_all(const void *data, size_t length, const void *elem,
+                         size_t elem_size, vector(size_t) *positions);
+
+/* - SORT ENGINE - */
+
+/*
+ * `vector_sort()` sorts the `length` elements at `data` in place with
+ * pattern-defeating quicksort, which runs in O(n log n) time on any input and
+ * in O(n) time on inputs which are already sorted, reversed or made of few
+ * distinct values. Elements of 4 and 8 bytes are moved as integers rather than
+ * byte by byte. `cmp` is called as it is by `qsort()`.
+ *
+ * `vector_sort_stable()` keeps elements comparing equal in their original
+ * order by merge sorting through a buffer as large as the elements, returning
+ * `false` if the buffer could not be allocated, in which case the elements are
+ * left unchanged.
+ *
+ * The radix sorts order integer and IEEE 754 floating-point keys without any
+ * comparisons, a byte at a time, and skip bytes which all keys share. They
+ * also need a buffer as large as the keys and return `false` if it could not
+ * be allocated. Floating-point keys are ordered by sign and magnitude, with
+ * `-0.0` before `+0.0` and NaNs at the ends.
+ */
+
+typedef int (*vec_comparator)(const void *a, const void *b);
+
+#if UINT_MAX == 4294967295UL
+typedef int vec_i32;
+typedef unsigned int vec_u32;
+#else
+typedef long vec_i32;
+typedef unsigned long vec_u32;
+#endif
+
+#if ULONG_MAX / 4294967295UL > 4294967295UL
+typedef long vec_i64;
+typedef unsigned long vec_u64;
+#elif defined(__GNUC__) || defined(__clang__)
+__extension__ typedef long long vec_i64;
+__extension__ typedef unsigned long long vec_u64;
+#else
+typedef long long vec_i64;
+typedef unsigned long long vec_u64;
+#endif
+
+/*
+ * These sort `vec` as a whole, unsharing it first. They return `false` if it
+ * could not be unshared or, for the stable sort, if its buffer could not be
+ * allocated, in which case the elements are left unchanged.
+ */
+#define vector_sort_s(vec, cmp) \
+  vector_untyped_sort((void **)&(vec), cmp, sizeof *(vec))
+
+#define vector_sort_stable_s(vec, cmp) \
+  vector_untyped_sort_stable((void **)&(vec), cmp, sizeof *(vec))
+
+void vector_sort(void *data, size_t length, size_t elem_size,
+                 vec_comparator cmp);
+bool vector_sort_stable(void *data, size_t length, size_t elem_size,
+                        vec_comparator cmp);
+
+bool vector_radix_sort_u32(vec_u32 *data, size_t length);
+bool vector_radix_sort_u64(vec_u64 *data, size_t length);
+bool vector_radix_sort_i32(vec_i32 *data, size_t length);
+bool vector_radix_sort_i64(vec_i64 *data, size_t length);
+bool vector_radix_sort_f32(float *data, size_t length);
+bool vector_radix_sort_f64(double *data, size_t length);
+
+/*
+ * The stable merge kernels, shared with the parallel sort. `vec_merge()` merges
+ * the sorted ranges `[left, left_end)` and `[right, right_end)` into `dst`,
+ * taking from the left on ties. `vec_merge_sort()` sorts as
+ * `vector_sort_stable()` does through a caller's buffer of `length` elements.
+ */
+void vec_merge(const void *left, const void *left_end, const void *right,
+               const void *right_end, void *dst, size_t elem_size,
+               vec_comparator cmp);
+void vec_merge_sort(void *data, void *buffer, size_t length, size_t elem_size,
+                    vec_comparator cmp);
+
+/* - PARALLEL ITERATION - */
+
+/*
+ * These apply an operation to every element of a vector across the threads of
+ * `sched`, or on the calling thread alone if `sched` is `NULL`. The vector is
+ * split into chunks of at least `grain_size` elements (or
+ * `VEC_PARALLEL_DEFAULT_GRAIN` if `0`) whose boundaries fall on cache lines
+ * wherever the element size allows, so that threads writing to neighbouring
+ * chunks do not contend for the same lines.
+ *
+ * The operation may be invoked concurrently on different elements and must not
+ * resize the vector. The `_chunk` variants invoke it once per chunk rather than
+ * once per element.
+ *
+ * Like the parallel algorithms below, these run through `scheduler_run_for()`
+ * and so must not be called from a task running on `sched`.
+ */
+
+#ifndef VEC_CACHE_LINE_SIZE
+#define VEC_CACHE_LINE_SIZE ((size_t)64)
+#endif
+
+#ifndef VEC_PARALLEL_DEFAULT_GRAIN
+#define VEC_PARALLEL_DEFAULT_GRAIN ((size_t)4096)
+#endif
+
+#define vector_parallel_for_each(vec, op, args, sched, grain_size)   \
+  vector_untyped_parallel_for_each(vec, op, args, sched, grain_size, \
+                                   sizeof *(vec))
+
+#define vector_parallel_for_each_c(vec, op, args, sched, grain_size)   \
+  vector_untyped_parallel_for_each_c(vec, op, args, sched, grain_size, \
+                                     sizeof *(vec))
+
+#define vector_parallel_for_each_chunk(vec, op, args, sched, grain_size)   \
+  vector_untyped_parallel_for_each_chunk(vec, op, args, sched, grain_size, \
+                                         sizeof *(vec))
+
+#define vector_parallel_for_each_chunk_c(vec, op, args, sched, grain_size)   \
+  vector_untyped_parallel_for_each_chunk_c(vec, op, args, sched, grain_size, \
+                                           sizeof *(vec))
+
+void vector_untyped_parallel_for_each(vector(void) vec, vec_for_each_op op,
+                                      void *args, scheduler *sched,
+                                      size_t grain_size, size_t elem_size);
+void vector_untyped_parallel_for_each_c(const vector(void) vec,
+                                        vec_for_each_op_const op,
+                                        const void *args, scheduler *sched,
+                                        size_t grain_size, size_t elem_size);
+void vector_untyped_parallel_for_each_chunk(vector(void) vec, vec_chunk_op op,
+                                            void *args, scheduler *sched,
+                                            size_t grain_size,
+                                            size_t elem_size);
+void vector_untyped_parallel_for_each_chunk_c(const vector(void) vec,
+                                              vec_chunk_op_const op,
+                                              const void *args,
+                                              scheduler *sched,
+                                              size_t grain_size,
+                                              size_t elem_size);
+
+/* - PARALLEL ALGORITHMS - */
+
+/*
+ * `vector_parallel_sort()` stably sorts the `length` elements at `data` across
+ * the threads of `sched`, or on the calling thread alone if `sched` is `NULL`.
+ * Blocks are sorted by different threads, then merged pairwise, with each
+ * merge split at evenly spaced output positions so that every thread has work
+ * until the last round. A stable sort has exactly one result, so it is the
+ * same whatever the number of threads. Like `vector_sort_stable()`, it needs a
+ * buffer as large as the elements and returns `false` if it could not be
+ * allocated, in which case the elements are left unchanged.
+ *
+ * The scans replace each of the `length` values at `data` with the sum of the
+ * values before it, and of the value itself if `kind` is `VEC_SCAN_INCLUSIVE`.
+ * Values are summed in blocks of `VEC_SCAN_BLOCK_LENGTH` whatever the number
+ * of threads, so floating-point sums are rounded identically on every run.
+ * Integer sums wrap around on overflow. The scans return `false` if the block
+ * totals could not be allocated, in which case the values are left unchanged.
+ */
+
+#ifndef VEC_SCAN_BLOCK_LENGTH
+#define VEC_SCAN_BLOCK_LENGTH ((size_t)16384)
+#endif
+
+typedef enum vec_scan_kind {
+  VEC_SCAN_INCLUSIVE,
+  VEC_SCAN_EXCLUSIVE
+} vec_scan_kind;
+
+/* Sorts `vec` as a whole, unsharing it first, as `vector_sort_stable_s()`. */
+#define vector_parallel_sort_s(vec, cmp, sched) \
+  vector_untyped_parallel_sort((void **)&(vec), cmp, sched, sizeof *(vec))
+
+bool vector_parallel_sort(void *data, size_t length, size_t elem_size,
+                          vec_comparator cmp, scheduler *sched);
+
+bool vector_parallel_scan_u32(vec_u32 *data, size_t length, vec_scan_kind kind,
+                              scheduler *sched);
+bool vector_parallel_scan_u64(vec_u64 *data, size_t length, vec_scan_kind kind,
+                              scheduler *sched);
+bool vector_parallel_scan_i32(vec_i32 *data, size_t length, vec_scan_kind kind,
+                              scheduler *sched);
+bool vector_parallel_scan_i64(vec_i64 *data, size_t length, vec_scan_kind kind,
+                              scheduler *sched);
+bool vector_parallel_scan_f32(float *data, size_t length, vec_scan_kind kind,
+                              scheduler *sched);
+bool vector_parallel_scan_f64(double *data, size_t length, vec_scan_kind kind,
+                              scheduler *sched);
+
+/* - SMALL VECTORS - */
+
+/*
+ * A small vector keeps its first `capacity` elements inline, inside storage
+ * declared on the stack or embedded in another structure, and only moves to
+ * the heap once it outgrows them, e.g.
+ *
+ * `small_vector(int, 16) storage;`
+ * `vector(int) vec = small_vector_init(&storage);`
+ *
+ * `vec` is an ordinary vector and works with every vector macro. Once spilled,
+ * its elements are allocated from the allocator given to
+ * `small_vector_init_with()`, or with `malloc()` by default.
+ *
+ * The storage must not be moved while `vec`, or any copy of it, is in use,
+ * since the vector's allocator lives inside it. Deleting `vec` is only
+ * necessary once it may have spilled, but is always safe.
+ */
+
+/*
+ *   `allocator`   - The allocator of the vector, which recognizes the inline
+ *                   block and never releases it.
+ *     `spill`     - The allocator that blocks beyond the inline one come from.
+ * `inline_block`  - The vector's header within its inline storage.
+ */
+typedef struct small_vector_prefix {
+  myclib_allocator allocator;
+  const myclib_allocator *spill;
+  void *inline_block;
+} small_vector_prefix;
+
+#define small_vector(type, capacity) \
+  struct {                           \
+    small_vector_prefix prefix;      \
+    vector_header header;            \
+    type data[capacity];             \
+  }
+
+#define small_vector_init(storage) small_vector_init_with(storage, NULL)
+
+#define small_vector_init_with(storage, allocator)                           \
+  (util_assert((void *)(storage)->data == (void *)(&(storage)->header + 1)), \
+   vector_untyped_small_init(&(storage)->prefix, &(storage)->header,         \
+                             allocator, ARR_LEN((storage)->data)),           \
+   (storage)->data)
+
+/* Determines whether a small vector's elements still reside inline. */
+#define small_vector_is_inline(vec)          \
+  ((const void *)vector_header_const(vec) == \
+   ((const small_vector_prefix *)vector_allocator(vec)->ctx)->inline_block)
+
+void vector_untyped_small_init(small_vector_prefix *prefix,
+                               vector_header *header,
+                               const myclib_allocator *spill, size_t capacity);
+
+/* - MEMORY-MAPPED VECTORS - */
+
+/*
+ * A memory-mapped vector lives in a file holding its `vector_header` followed
+ * by its elements, and is accessed through a mapping of that file rather than
+ * copies made with `read()` and `write()`, e.g.
+ *
+ * `vector(double) vec = vector_mmap_open("data.vec", sizeof(double),`
+ * `                                      VEC_MMAP_CREATE);`
+ *
+ * `vec` is an ordinary vector and works with every vector macro. Growing it
+ * extends the file and remaps it, so its address may change as usual.
+ * Deleting it unmaps the file, first trimming the file to the vector's length.
+ *
+ * Vectors opened read-only share their elements with the page cache, so that
+ * any number of processes may map one file without copying it. Each process
+ * only copies the page holding the header, which captures the vector's length
+ * when it was opened. Read-only vectors must not be modified.
+ *
+ * Only a single process may open a file for writing at a time. Files store
+ * elements in the native representation and do not record their size, so
+ * they must be opened with the size they were created with.
+ *
+ * Copies of a memory-mapped vector are allocated with `malloc()`, and must be
+ * deleted before the vector they were copied from.
+ */
+
+/* Opens the file for reading only. */
+#define VEC_MMAP_READ_ONLY (0)
+/* Opens the file for reading and writing. */
+#define VEC_MMAP_WRITE (1)
+/* Creates the file if it does not exist. Implies `VEC_MMAP_WRITE`. */
+#define VEC_MMAP_CREATE (2)
+/* Empties the file if it exists. Implies `VEC_MMAP_WRITE`. */
+#define VEC_MMAP_TRUNCATE (4)
+
+/*
+ * Maps the vector stored by the file at `path`, whose elements are
+ * `elem_size` bytes each, as directed by `flags`. Empty files opened for
+ * writing are initialized as empty vectors. Returns `NULL` if the file could
+ * not be opened or mapped, or does not hold a valid vector.
+ */
+vector(void) vector_mmap_open(const char *path, size_t elem_size, int flags);
+
+/*
+ * Blocks until the changes made to a memory-mapped vector have been written to
+ * its file. Returns `false` if they could not be written.
+ */
+bool vector_mmap_sync(const vector(void) vec);
+
+/* - ALIGNED VECTORS - */
+
+/*
+ * An aligned vector keeps its header immediately before its elements, as any
+ * other vector does, but places the pair so that its elements start on a
+ * multiple of the requested alignment, e.g.
+ *
+ * `vector(float) vec = vector_new_aligned(float, 1024, 32);`
+ *
+ * lets AVX kernels use aligned loads, and an alignment of
+ * `VEC_CACHE_LINE_SIZE` keeps threads working on adjacent chunks from sharing
+ * cache lines. The alignment is kept by every operation which reallocates the
+ * vector, and by its copies. Aligned vectors are allocated with `malloc()`.
+ *
+ * Vectors created with `vector_new_huge()` are additionally advised to be
+ * backed by transparent huge pages once they span `VEC_HUGE_PAGE_SIZE` bytes,
+ * which cuts TLB misses when scanning them. The advice is ignored on systems
+ * without transparent huge pages.
+ */
+
+/* The largest alignment an aligned vector can be created with. */
+#define VEC_MAX_ALIGNMENT ((size_t)4096)
+
+#ifndef VEC_HUGE_PAGE_SIZE
+#define VEC_HUGE_PAGE_SIZE ((size_t)2 << 20)
+#endif
+
+#define vector_is_aligned(vec, alignment) \
+  ((size_t)(const void *)(vec) % (alignment) == 0)
+
+#define vector_new_aligned(type, capacity, alignment)                    \
+  ((type *)vector_untyped_new_aligned(sizeof(type), capacity, alignment, \
+                                      false))
+
+#define vector_new_huge(type, capacity, alignment)                       \
+  ((type *)vector_untyped_new_aligned(sizeof(type), capacity, alignment, \
+                                      true))
+
+/*
+ * Creates a vector whose elements are aligned to `alignment`, a power of two
+ * no greater than `VEC_MAX_ALIGNMENT`. Alignments below that of any other
+ * vector are raised to it. Returns `NULL` if `alignment` is invalid or the
+ * vector could not be allocated.
+ */
+vector(void) vector_untyped_new_aligned(size_t elem_size, size_t capacity,
+                                        size_t alignment, bool huge);
+
+/* - TYPED GENERATORS - */
+
+/*
+ * `DEFINE_VECTOR(type, name)` defines `name` as a `vector(type)` along with the
+ * following functions, each of which evaluates its arguments once and works
+ * on `type` directly instead of through `memcpy()` and `void *`:
+ *
+ * `name name_new(size_t capacity)`
+ * `name name_new_with(const myclib_allocator *allocator, size_t capacity)`
+ * `void name_delete(name *vec)`
+ * `name name_reserve_for(name *vec, size_t length)`
+ * `type *name_push(name *vec, type elem)`
+ * `type *name_pop(name *vec)`
+ * `type name_get(const type *vec, size_t index)`
+ * `type *name_insert(name *vec, type elem, size_t index)`
+ * `size_t name_index_of(const type *vec, type elem)`
+ * `void name_for_each(name vec, name_for_each_op op, void *args)`
+ *
+ * They behave as the macros of the same name do, except that `push`, `insert`,
+ * `pop` and `reserve_for` unshare the vector first and return `NULL` if it
+ * could not be unshared or expanded. `pop` returns a pointer to the removed
+ * element, which remains valid until the vector is next modified. Vectors
+ * created either way share the same layout, so a `name` may be passed to any
+ * other vector macro and vice versa.
+ *
+ * For example, `DEFINE_VECTOR(int, ivec)` at file scope defines `ivec_push()`
+ * and so on.
+ */
+#define DEFINE_VECTOR(type, name)                                             \
+  typedef type *name;                                                         \
+                                                                              \
+  typedef void (*name##_for_each_op)(type *elem, void *args);                 \
+                                                                              \
+  static inline name name##_new_with(const myclib_allocator *const allocator, \
+                                     const size_t capacity) {                 \
+    return (name)vector_untyped_new_with(allocator, sizeof(type), capacity);  \
+  }                                                                           \
+                                                                              \
+  static inline name name##_new(const size_t capacity) {                      \
+    return name##_new_with(NULL, capacity);                                   \
+  }                                                                           \
+                                                                              \
+  static inline void name##_delete(name *const vec) {                         \
+    void *vec_actual = *vec;                                                  \
+    vector_untyped_delete(&vec_actual, sizeof(type));                         \
+    *vec = NULL;                                                              \
+  }                                                                           \
+                                                                              \
+  /* Ensures `*vec` is unshared and can hold `length` elements. */          \
+  static inline name name##_reserve_for(name *const vec,                      \
+                                        const size_t length) {                \
+    void *vec_actual = *vec;                                                  \
+    if (vector_untyped_unshare(&vec_actual, sizeof(type)) == NULL)            \
+      return NULL;                                                            \
+    *vec = (name)vec_actual;                                                  \
+    if (length <= vector_capacity(vec_actual)) return *vec;                   \
+    if (vector_untyped_reserve(&vec_actual, length, sizeof(type)) == NULL)    \
+      return NULL;                                                            \
+    *vec = (name)vec_actual;                                                  \
+    return *vec;                                                              \
+  }                                                                           \
+                                                                              \
+  static inline type *name##_push(name *const vec, const type elem) {         \
+    const size_t LENGTH = vector_length(*vec);                                \
+    name vec_actual = name##_reserve_for(vec, LENGTH + 1);                    \
+    if (vec_actual == NULL) return NULL;                                      \
+    vec_actual[LENGTH] = elem;                                                \
+    vector_header(vec_actual)->length = LENGTH + 1;                           \
+    return vec_actual + LENGTH;                                               \
+  }                                                                           \
+                                                                              \
+  static inline type *name##_pop(name *const vec) {                          \
+    void *vec_actual = *vec;                                                  \
+    util_assert(!vector_is_empty(vec_actual));                                \
+    if (vector_untyped_unshare(&vec_actual, sizeof(type)) == NULL)            \
+      return NULL;                                                            \
+    *vec = (name)vec_actual;                                                  \
+    return *vec + --vector_header(vec_actual)->length;                        \
+  }                                                                           \
+                                                                              \
+  static inline type name##_get(const type *const vec, const size_t index) {  \
+    util_assert(index < vector_length(vec));                                  \
+    return vec[index];                                                        \
+  }                                                                           \
+                                                                              \
+  static inline type *name##_insert(name *const vec, const type elem,         \
+                                    const size_t index) {                     \
+    const size_t LENGTH = vector_length(*vec);                                \
+    const size_t NEW_LENGTH = (index < LENGTH ? LENGTH : index) + 1;          \
+    name vec_actual = name##_reserve_for(vec, NEW_LENGTH);                    \
+    if (vec_actual == NULL) return NULL;                                      \
+    if (index < LENGTH)                                                       \
+      memmove(vec_actual + index + 1, vec_actual + index,                     \
+              sizeof(type) * (LENGTH - index));                               \
+    else                                                                      \
+      memset(vec_actual + LENGTH, 0, sizeof(type) * (index - LENGTH));        \
+    vec_actual[index] = elem;                                                 \
+    vector_header(vec_actual)->length = NEW_LENGTH;                           \
+    return vec_actual + index;                                                \
+  }                                                                           \
+                                                                              \
+  static inline size_t name##_index_of(const type *const vec,                 \
+                                       const type elem) {                     \
+    return vector_search_first(vec, vector_length(vec), &elem, sizeof(type)); \
+  }                                                                           \
+                                                                              \
+  static inline void name##_for_each(const name vec, name##_for_each_op op,   \
+                                     void *const args) {                      \
+    const size_t LENGTH = vector_length(vec);                                 \
+    size_t i;                                                                 \
+    for (i = 0; i < LENGTH; i++) op(vec + i, args);                           \
+  }                                                                           \
+                                                                              \
+  typedef int name##_require_semicolon
+
 /* - FUNCTION DECLARATIONS - */
 
-static void vector_untyped_clear(vector(void) vec, size_t elem_size);
+static void *vector_untyped_append_n(vector(void) * vec, const void *src,
+                                     size_t count, size_t elem_size);
+static void *vector_untyped_clear(vector(void) * vec, size_t elem_size);
+static size_t vector_untyped_compact(vector(void) * vec, vec_predicate pred,
+                                     const void *args, bool keep,
+                                     size_t elem_size);
 static void *vector_untyped_copy(const vector(void) vec, size_t elem_size);
-static void vector_untyped_delete(vector(void) * vec);
+static size_t vector_untyped_count_of(const vector(void) vec, const void *elem,
+                                      size_t elem_size);
+static size_t vector_untyped_dedup(vector(void) * vec, size_t elem_size);
+static void vector_untyped_delete(vector(void) * vec, size_t elem_size);
+static void *vector_untyped_detach(vector(void) * vec, size_t capacity,
+                                   size_t elem_size);
 static void *vector_untyped_expand(vector(void) * vec, size_t elem_size);
+static size_t vector_untyped_find_all(const vector(void) vec, const void *elem,
+                                      vector(size_t) *positions,
+                                      size_t elem_size);
 static void vector_untyped_for_each(vector(void) vec, vec_for_each_op op,
                                     void *args, size_t elem_size);
 static void vector_untyped_for_each_c(const vector(void) vec,
@@ -257,42 +981,181 @@ static size_t vector_untyped_index_of(const vector(void) vec, const void *elem,
                                       size_t elem_size);
 static void *vector_untyped_insert(vector(void) * vec, const void *elem,
                                    size_t index, size_t elem_size);
+static void *vector_untyped_insert_n(vector(void) * vec, const void *src,
+                                     size_t count, size_t index,
+                                     size_t elem_size);
+static bool vector_untyped_is_distinct(const void *args[]);
+static size_t vector_untyped_last_index_of(const vector(void) vec,
+                                           const void *elem, size_t elem_size);
 static void *vector_untyped_new(size_t elem_size, size_t capacity);
-static void *vector_untyped_pop(vector(void) vec, size_t elem_size);
+static void *vector_untyped_new_with(const myclib_allocator *allocator,
+                                     size_t elem_size, size_t capacity);
+static void *vector_untyped_pop(vector(void) * vec, size_t elem_size);
 static void *vector_untyped_push(vector(void) * vec, const void *elem,
                                  size_t elem_size);
-static void vector_untyped_remove(vector(void) vec, size_t index,
-                                  size_t elem_size);
+static void *vector_untyped_remove(vector(void) * vec, size_t index,
+                                   size_t elem_size);
+static size_t vector_untyped_remove_if(vector(void) * vec, vec_predicate pred,
+                                       const void *args, size_t elem_size);
+static void *vector_untyped_remove_range(vector(void) * vec, size_t index,
+                                         size_t count, size_t elem_size);
+static size_t vector_untyped_grow_capacity(size_t capacity, size_t required,
+                                           size_t elem_size);
+static size_t vector_untyped_page_rounded_capacity(size_t capacity,
+                                                   size_t elem_size);
+static bool vector_untyped_parallel_sort(vector(void) * vec,
+                                         vec_comparator cmp, scheduler *sched,
+                                         size_t elem_size);
+static void *vector_untyped_reserve(vector(void) * vec, size_t capacity,
+                                    size_t elem_size);
+static void *vector_untyped_reserve_exact(vector(void) * vec, size_t capacity,
+                                          size_t elem_size);
 static void *vector_untyped_resize(vector(void) * vec, size_t new_length,
                                    size_t elem_size);
+static size_t vector_untyped_retain(vector(void) * vec, vec_predicate pred,
+                                    const void *args, size_t elem_size);
 static void *vector_untyped_set(vector(void) * vec, const void *elem,
                                 size_t index, size_t elem_size);
 static void *vector_untyped_shrink(vector(void) * vec, size_t elem_size);
+static bool vector_untyped_sort(vector(void) * vec, vec_comparator cmp,
+                                size_t elem_size);
+static bool vector_untyped_sort_stable(vector(void) * vec, vec_comparator cmp,
+                                       size_t elem_size);
+static void *vector_untyped_splice(vector(void) * vec, size_t index,
+                                   size_t remove_count, const void *src,
+                                   size_t insert_count, size_t elem_size);
+static void *vector_untyped_swap_remove(vector(void) * vec, size_t index,
+                                        size_t elem_size);
+static void *vector_untyped_unshare(vector(void) * vec, size_t elem_size);
 
 /* - FUNCTION DEFINITIONS - */
 
-static inline void vector_untyped_clear(void *const vec,
-                                        const size_t elem_size) {
-  memset(vec, 0, elem_size * vector_length(vec));
+static inline void *vector_untyped_append_n(void **const vec,
+                                            const void *const src,
+                                            const size_t count,
+                                            const size_t elem_size) {
+  return vector_untyped_splice(vec, vector_length(*vec), 0, src, count,
+                               elem_size);
+}
+
+static inline void *vector_untyped_clear(void **const vec,
+                                         const size_t elem_size) {
+  if (vector_untyped_unshare(vec, elem_size) == NULL) return NULL;
+  memset(*vec, 0, elem_size * vector_length(*vec));
+  return *vec;
+}
+
+/*
+ * Compacts `vec` in place, keeping each element for which `pred` returns
+ * `keep`. Every run of kept elements is moved at most once. Returns the number
+ * of elements removed, or `VEC_BAD_INDEX` if `vec` could not be unshared.
+ */
+static inline size_t vector_untyped_compact(void **const vec,
+                                            const vec_predicate pred,
+                                            const void *const args,
+                                            const bool keep,
+                                            const size_t elem_size) {
+  const size_t LENGTH = vector_length(*vec);
+  byte *data;
+  const void *arg_list[3];
+  size_t kept = 0;
+  size_t run_start = 0;
+  size_t i;
+  if (vector_untyped_unshare(vec, elem_size) == NULL) return VEC_BAD_INDEX;
+  data = *vec;
+  arg_list[0] = data;
+  arg_list[2] = args;
+  for (i = 0; i < LENGTH; i++) {
+    arg_list[1] = data + (i * elem_size);
+    if (!pred(arg_list) == !keep) continue;
+    if (kept != run_start)
+      memmove(data + (kept * elem_size), data + (run_start * elem_size),
+              elem_size * (i - run_start));
+    kept += i - run_start;
+    run_start = i + 1;
+  }
+  if (kept != run_start)
+    memmove(data + (kept * elem_size), data + (run_start * elem_size),
+            elem_size * (LENGTH - run_start));
+  kept += LENGTH - run_start;
+  vector_header(data)->length = kept;
+  return LENGTH - kept;
 }
 
 static inline void *vector_untyped_copy(const void *const vec,
                                         const size_t elem_size) {
   const size_t ALLOCATION =
-      (elem_size * vector_capacity(vec)) + sizeof(vector_header);
-  void *vec_copy = malloc(ALLOCATION);
-  if (vec_copy != NULL) {
-    memcpy(vec_copy, vector_header_const(vec), ALLOCATION);
-    vec_copy = (vector_header *)vec_copy + 1;
-  }
-  return vec_copy;
+      vector_allocation_size(elem_size, vector_length(vec));
+  vector_header *const vec_copy =
+      myclib_alloc(vector_allocator(vec), ALLOCATION);
+  if (vec_copy == NULL) return NULL;
+  memcpy(vec_copy, vector_header_const(vec), ALLOCATION);
+  vec_copy->capacity = vec_copy->length;
+  vec_copy->shares = 0;
+  return vec_copy + 1;
+}
+
+static inline size_t vector_untyped_count_of(const void *const vec,
+                                             const void *const elem,
+                                             const size_t elem_size) {
+  return vector_search_count(vec, vector_length(vec), elem, elem_size);
+}
+
+/*
+ * Determines whether an element differs from the one preceding it. The
+ * additional argument is the size of the vector's elements.
+ *
+ * This only ever compares an element with its predecessor before either has
+ * been moved by `vector_untyped_compact()`.
+ */
+static inline bool vector_untyped_is_distinct(const void *args[]) {
+  const size_t ELEM_SIZE = *(const size_t *)args[2];
+  const byte *const elem = args[1];
+  if (elem == args[0]) return true;
+  return memcmp(elem - ELEM_SIZE, elem, ELEM_SIZE) != 0;
+}
+
+static inline size_t vector_untyped_dedup(void **const vec,
+                                          const size_t elem_size) {
+  return vector_untyped_compact(vec, vector_untyped_is_distinct, &elem_size,
+                                true, elem_size);
 }
 
-static inline void vector_untyped_delete(void **const vec) {
-  free(vector_header(*vec));
+static inline void vector_untyped_delete(void **const vec,
+                                         const size_t elem_size) {
+  vector_header *const header = vector_header(*vec);
+  if (vec_shares_load(header) == 0 || vec_shares_release(header) == 0)
+    myclib_free(header->allocator, header,
+                vector_allocation_size(elem_size, header->capacity));
   *vec = NULL;
 }
 
+/*
+ * Moves `*vec` into a private block with room for `capacity` elements,
+ * releasing its share of the block it came from. If every other handle was
+ * released in the meantime, that block is deallocated.
+ */
+static inline void *vector_untyped_detach(void **const vec,
+                                          const size_t capacity,
+                                          const size_t elem_size) {
+  vector_header *const header = vector_header(*vec);
+  vector_header *detached;
+  util_assert(capacity >= header->length);
+  if (capacity > VEC_MAX_CAPACITY(elem_size)) return NULL;
+  detached = myclib_alloc(header->allocator,
+                          vector_allocation_size(elem_size, capacity));
+  if (detached == NULL) return NULL;
+  memcpy(detached, header,
+         vector_allocation_size(elem_size, header->length));
+  detached->capacity = capacity;
+  detached->shares = 0;
+  if (vec_shares_release(header) == 0)
+    myclib_free(header->allocator, header,
+                vector_allocation_size(elem_size, header->capacity));
+  *vec = detached + 1;
+  return *vec;
+}
+
 static inline void *vector_untyped_expand(void **const vec,
                                           const size_t elem_size) {
   const size_t LENGTH = vector_length(*vec);
@@ -306,6 +1169,14 @@ static inline void *vector_untyped_expand(void **const vec,
   return attempt;
 }
 
+static inline size_t vector_untyped_find_all(const void *const vec,
+                                             const void *const elem,
+                                             size_t **const positions,
+                                             const size_t elem_size) {
+  return vector_search_all(vec, vector_length(vec), elem, elem_size,
+                           positions);
+}
+
 static inline void vector_untyped_for_each(void *const vec, vec_for_each_op op,
                                            void *const args,
                                            const size_t elem_size) {
@@ -356,13 +1227,7 @@ static inline void *vector_untyped_get(void *const vec, const size_t index,
 static inline size_t vector_untyped_index_of(const void *vec,
                                              const void *const elem,
                                              const size_t elem_size) {
-  const size_t LEN = vector_length(vec);
-  size_t i;
-  for (i = 0; i < LEN; i++) {
-    if (memcmp((const byte *)vec + (i * elem_size), elem, elem_size) == 0)
-      return i;
-  }
-  return VEC_BAD_INDEX;
+  return vector_search_first(vec, vector_length(vec), elem, elem_size);
 }
 
 static void *vector_untyped_insert(void **const vec, const void *elem,
@@ -377,17 +1242,76 @@ static void *vector_untyped_insert(void **const vec, const void *elem,
   return vector_untyped_set(vec, elem, index, elem_size);
 }
 
+static inline void *vector_untyped_insert_n(void **const vec,
+                                            const void *const src,
+                                            const size_t count,
+                                            const size_t index,
+                                            const size_t elem_size) {
+  return vector_untyped_splice(vec, index, 0, src, count, elem_size);
+}
+
+/*
+ * Returns the capacity a vector holding `capacity` elements should grow to so
+ * that it may hold at least `required` elements, as directed by
+ * `VEC_GROWTH_POLICY`. Returns `required` as-is if it cannot be allocated.
+ */
+static inline size_t vector_untyped_grow_capacity(const size_t capacity,
+                                                  const size_t required,
+                                                  const size_t elem_size) {
+  const size_t MAX_CAPACITY = VEC_MAX_CAPACITY(elem_size);
+  size_t grown;
+  if (required >= MAX_CAPACITY) return required;
+  grown = capacity > MAX_CAPACITY / VEC_EXPANSION_FACTOR
+              ? MAX_CAPACITY
+              : (size_t)VEC_GROWTH_POLICY(capacity, elem_size);
+  if (grown > MAX_CAPACITY) grown = MAX_CAPACITY;
+  return grown < required ? required : grown;
+}
+
+static inline size_t vector_untyped_last_index_of(const void *const vec,
+                                                  const void *const elem,
+                                                  const size_t elem_size) {
+  return vector_search_last(vec, vector_length(vec), elem, elem_size);
+}
+
 static inline void *vector_untyped_new(const size_t elem_size,
                                        const size_t capacity) {
-  vector_header *const vec = malloc((elem_size * capacity) + sizeof(vector_header));
+  return vector_untyped_new_with(NULL, elem_size, capacity);
+}
+
+static inline void *vector_untyped_new_with(
+    const myclib_allocator *const allocator, const size_t elem_size,
+    const size_t capacity) {
+  vector_header *const vec =
+      myclib_alloc(allocator, vector_allocation_size(elem_size, capacity));
   if (vec == NULL) return NULL;
   vec->capacity = capacity;
   vec->length = 0;
+  vec->allocator = allocator;
+  vec->shares = 0;
   return vec + 1;
 }
 
-static inline void *vector_untyped_pop(void *const vec, size_t elem_size) {
-  return (byte *)vec + (--vector_header(vec)->length * elem_size);
+static inline size_t vector_untyped_page_rounded_capacity(
+    const size_t capacity, const size_t elem_size) {
+  const size_t ALLOCATION = vector_allocation_size(elem_size, capacity);
+  size_t rounded;
+  if (ALLOCATION < VEC_PAGE_SIZE) return capacity;
+  rounded = ((ALLOCATION + VEC_PAGE_SIZE - 1) / VEC_PAGE_SIZE) * VEC_PAGE_SIZE;
+  return (rounded - sizeof(vector_header)) / elem_size;
+}
+
+static inline bool vector_untyped_parallel_sort(void **const vec,
+                                                const vec_comparator cmp,
+                                                scheduler *const sched,
+                                                const size_t elem_size) {
+  return vector_untyped_unshare(vec, elem_size) != NULL &&
+         vector_parallel_sort(*vec, vector_length(*vec), elem_size, cmp, sched);
+}
+
+static inline void *vector_untyped_pop(void **const vec, size_t elem_size) {
+  if (vector_untyped_unshare(vec, elem_size) == NULL) return NULL;
+  return (byte *)*vec + (--vector_header(*vec)->length * elem_size);
 }
 
 static inline void *vector_untyped_push(void **const vec,
@@ -396,32 +1320,92 @@ static inline void *vector_untyped_push(void **const vec,
   return vector_untyped_set(vec, elem, vector_length(*vec), elem_size);
 }
 
-static inline void vector_untyped_remove(void *const vec, const size_t index,
-                                         const size_t elem_size) {
-  byte *const dst = (byte *)vec + (index * elem_size);
-  byte *const src = dst + elem_size;
-  const size_t SHIFT_SIZE = elem_size * (vector_length(vec) - index - 1);
-  util_assert(index < vector_length(vec));
-  memmove(dst, src, SHIFT_SIZE);
-  vector_header(vec)->length--;
+static inline void *vector_untyped_remove(void **const vec,
+                                          const size_t index,
+                                          const size_t elem_size) {
+  byte *dst;
+  util_assert(index < vector_length(*vec));
+  if (vector_untyped_unshare(vec, elem_size) == NULL) return NULL;
+  dst = (byte *)*vec + (index * elem_size);
+  memmove(dst, dst + elem_size,
+          elem_size * (vector_length(*vec) - index - 1));
+  vector_header(*vec)->length--;
+  return *vec;
+}
+
+static inline size_t vector_untyped_remove_if(void **const vec,
+                                              const vec_predicate pred,
+                                              const void *const args,
+                                              const size_t elem_size) {
+  return vector_untyped_compact(vec, pred, args, false, elem_size);
+}
+
+static inline void *vector_untyped_remove_range(void **const vec,
+                                                const size_t index,
+                                                const size_t count,
+                                                const size_t elem_size) {
+  const size_t LENGTH = vector_length(*vec);
+  byte *dst;
+  util_assert(index <= LENGTH && count <= LENGTH - index);
+  if (vector_untyped_unshare(vec, elem_size) == NULL) return NULL;
+  dst = (byte *)*vec + (index * elem_size);
+  memmove(dst, dst + (count * elem_size),
+          elem_size * (LENGTH - index - count));
+  vector_header(*vec)->length -= count;
+  return *vec;
+}
+
+/*
+ * Ensures `*vec` can hold at least `capacity` elements, growing it as directed
+ * by `VEC_GROWTH_POLICY` if it cannot. A shared vector is unshared either way.
+ */
+static inline void *vector_untyped_reserve(void **const vec,
+                                           const size_t capacity,
+                                           const size_t elem_size) {
+  const size_t CUR_CAPACITY = vector_capacity(*vec);
+  if (capacity <= CUR_CAPACITY) return vector_untyped_unshare(vec, elem_size);
+  return vector_untyped_reserve_exact(
+      vec, vector_untyped_grow_capacity(CUR_CAPACITY, capacity, elem_size),
+      elem_size);
+}
+
+/*
+ * Ensures `*vec` can hold exactly `capacity` elements if it cannot already. A
+ * shared vector is unshared either way, and is detached into a block of that
+ * capacity instead of being reallocated if it must grow.
+ */
+static inline void *vector_untyped_reserve_exact(void **const vec,
+                                                 const size_t capacity,
+                                                 const size_t elem_size) {
+  vector_header *new_header;
+  if (capacity <= vector_capacity(*vec))
+    return vector_untyped_unshare(vec, elem_size);
+  if (capacity > VEC_MAX_CAPACITY(elem_size)) return NULL;
+  if (vector_is_shared(*vec))
+    return vector_untyped_detach(vec, capacity, elem_size);
+  new_header = myclib_realloc(
+      vector_allocator(*vec), vector_header(*vec),
+      vector_allocation_size(elem_size, vector_capacity(*vec)),
+      vector_allocation_size(elem_size, capacity));
+  if (new_header == NULL) return NULL;
+  new_header->capacity = capacity;
+  *vec = new_header + 1;
+  return *vec;
 }
 
 static inline void *vector_untyped_resize(void **const vec,
                                           const size_t new_length,
                                           const size_t elem_size) {
-  vector_header *header = vector_header(*vec);
-  if (new_length <= header->capacity) {
-    header->length = new_length;
-  } else {
-    const size_t ALLOCATION = (elem_size * new_length) + sizeof(vector_header);
-    vector_header *const new_header = realloc(header, ALLOCATION);
-    if (new_header == NULL) return NULL;
-    header = new_header;
-    header->capacity = new_length;
-    header->length = new_length;
-    *vec = header + 1;
-  }
-  return header + 1;
+  if (vector_untyped_reserve(vec, new_length, elem_size) == NULL) return NULL;
+  vector_header(*vec)->length = new_length;
+  return *vec;
+}
+
+static inline size_t vector_untyped_retain(void **const vec,
+                                           const vec_predicate pred,
+                                           const void *const args,
+                                           const size_t elem_size) {
+  return vector_untyped_compact(vec, pred, args, true, elem_size);
 }
 
 static inline void *vector_untyped_set(void **const vec, const void *const elem,
@@ -429,7 +1413,10 @@ static inline void *vector_untyped_set(void **const vec, const void *const elem,
                                        const size_t elem_size) {
   void *vec_actual = *vec;
   const size_t LENGTH = vector_length(vec_actual);
-  if (index >= LENGTH) {
+  if (index < LENGTH) {
+    if (vector_untyped_unshare(&vec_actual, elem_size) == NULL) return NULL;
+    *vec = vec_actual;
+  } else {
     if (vector_untyped_resize(&vec_actual, index + 1, elem_size) != NULL) {
       void *const clearance_start = (byte *)vec_actual + (elem_size * LENGTH);
       const size_t CLEARANCE_EXTENT = elem_size * (index - LENGTH);
@@ -448,13 +1435,73 @@ static inline void *vector_untyped_set(void **const vec, const void *const elem,
 
 static inline void *vector_untyped_shrink(void **const vec,
                                           const size_t elem_size) {
-  const size_t ALLOCATION =
-      (elem_size * vector_length(*vec)) + sizeof(vector_header);
-  vector_header *shrunk_vec = realloc(vector_header(*vec), ALLOCATION);
+  vector_header *shrunk_vec;
+  if (vector_is_shared(*vec))
+    return vector_untyped_detach(vec, vector_length(*vec), elem_size);
+  shrunk_vec = myclib_realloc(
+      vector_allocator(*vec), vector_header(*vec),
+      vector_allocation_size(elem_size, vector_capacity(*vec)),
+      vector_allocation_size(elem_size, vector_length(*vec)));
   if (shrunk_vec != NULL) {
     shrunk_vec->capacity = shrunk_vec->length;
     *vec = shrunk_vec + 1;
   }
   return shrunk_vec;
 }
+
+static inline bool vector_untyped_sort(void **const vec,
+                                       const vec_comparator cmp,
+                                       const size_t elem_size) {
+  if (vector_untyped_unshare(vec, elem_size) == NULL) return false;
+  vector_sort(*vec, vector_length(*vec), elem_size, cmp);
+  return true;
+}
+
+static inline bool vector_untyped_sort_stable(void **const vec,
+                                              const vec_comparator cmp,
+                                              const size_t elem_size) {
+  return vector_untyped_unshare(vec, elem_size) != NULL &&
+         vector_sort_stable(*vec, vector_length(*vec), elem_size, cmp);
+}
+
+static inline void *vector_untyped_splice(void **const vec, const size_t index,
+                                          const size_t remove_count,
+                                          const void *const src,
+                                          const size_t insert_count,
+                                          const size_t elem_size) {
+  const size_t LENGTH = vector_length(*vec);
+  size_t new_length;
+  byte *dst;
+  util_assert(index <= LENGTH && remove_count <= LENGTH - index);
+  if (insert_count > (size_t)-1 - (LENGTH - remove_count)) return NULL;
+  new_length = LENGTH - remove_count + insert_count;
+  if (vector_untyped_reserve(vec, new_length, elem_size) == NULL) return NULL;
+  dst = (byte *)*vec + (elem_size * index);
+  if (insert_count != remove_count)
+    memmove(dst + (elem_size * insert_count), dst + (elem_size * remove_count),
+            elem_size * (LENGTH - index - remove_count));
+  if (insert_count != 0) memcpy(dst, src, elem_size * insert_count);
+  vector_header(*vec)->length = new_length;
+  return *vec;
+}
+
+static inline void *vector_untyped_swap_remove(void **const vec,
+                                               const size_t index,
+                                               const size_t elem_size) {
+  const size_t LAST = vector_length(*vec) - 1;
+  byte *data;
+  util_assert(index < vector_length(*vec));
+  if (vector_untyped_unshare(vec, elem_size) == NULL) return NULL;
+  data = *vec;
+  if (index != LAST)
+    memcpy(data + (index * elem_size), data + (LAST * elem_size), elem_size);
+  vector_header(data)->length--;
+  return data;
+}
+
+static inline void *vector_untyped_unshare(void **const vec,
+                                           const size_t elem_size) {
+  if (!vector_is_shared(*vec)) return *vec;
+  return vector_untyped_detach(vec, vector_capacity(*vec), elem_size);
+}
 #endif
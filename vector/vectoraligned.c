@@ -0,0 +1,154 @@
+#if defined(__linux__) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE
+#endif
+
+#include "vector.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#include "../include/myclib.h"
+
+/* - DEFINITIONS - */
+
+/*
+ * The alignment `malloc()` gives blocks, and so the elements of other vectors,
+ * on common platforms.
+ */
+#define MIN_ALIGNMENT_SHIFT (4)
+
+/* The number of alignments supported, from `1 << MIN_ALIGNMENT_SHIFT` up. */
+#define ALIGNMENT_COUNT (9)
+
+/*
+ * Aligned blocks are carved out of larger blocks from `malloc()`, with the
+ * offset of the header within the larger block stored just before it.
+ */
+#define slack(alignment) ((alignment) + sizeof(size_t))
+
+#define header_offset_of(header) (((size_t *)(header))[-1])
+
+/* - INTERNAL - */
+
+static void *aligned_alloc_block(void *ctx, size_t size);
+static void *aligned_realloc_block(void *ctx, void *ptr, size_t old_size,
+                                   size_t new_size);
+static void aligned_free_block(void *ctx, void *ptr, size_t size);
+
+/*
+ * Every aligned vector shares one of these allocators, selected by its
+ * alignment and whether it uses huge pages, so that copies and reallocations
+ * know how to place their blocks. An allocator's context is its entry in
+ * `allocator_tags`, from which both are recovered.
+ */
+static byte allocator_tags[2 * ALIGNMENT_COUNT];
+
+#define ALIGNED_ALLOCATOR(index)                                   \
+  {aligned_alloc_block, aligned_realloc_block, aligned_free_block, \
+   &allocator_tags[index]}
+
+static const myclib_allocator ALIGNED_ALLOCATORS[] = {
+    ALIGNED_ALLOCATOR(0),  ALIGNED_ALLOCATOR(1),  ALIGNED_ALLOCATOR(2),
+    ALIGNED_ALLOCATOR(3),  ALIGNED_ALLOCATOR(4),  ALIGNED_ALLOCATOR(5),
+    ALIGNED_ALLOCATOR(6),  ALIGNED_ALLOCATOR(7),  ALIGNED_ALLOCATOR(8),
+    ALIGNED_ALLOCATOR(9),  ALIGNED_ALLOCATOR(10), ALIGNED_ALLOCATOR(11),
+    ALIGNED_ALLOCATOR(12), ALIGNED_ALLOCATOR(13), ALIGNED_ALLOCATOR(14),
+    ALIGNED_ALLOCATOR(15), ALIGNED_ALLOCATOR(16), ALIGNED_ALLOCATOR(17)};
+
+static size_t alignment_of(const void *const ctx) {
+  const size_t INDEX = (size_t)((const byte *)ctx - allocator_tags);
+  return (size_t)1 << (MIN_ALIGNMENT_SHIFT + (INDEX % ALIGNMENT_COUNT));
+}
+
+static bool is_huge(const void *const ctx) {
+  return (size_t)((const byte *)ctx - allocator_tags) >= ALIGNMENT_COUNT;
+}
+
+/* The offset of the header within a raw block starting at address `raw`. */
+static size_t header_offset(const size_t raw, const size_t alignment) {
+  const size_t UNALIGNED_DATA = raw + sizeof(size_t) + sizeof(vector_header);
+  return sizeof(size_t) +
+         ((alignment - (UNALIGNED_DATA % alignment)) % alignment);
+}
+
+/*
+ * Advises that the whole pages within the `size` byte block at `raw` be
+ * backed by huge pages.
+ */
+static void advise_huge_pages(void *const raw, const size_t size) {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  const size_t START = ((size_t)raw + VEC_PAGE_SIZE - 1) / VEC_PAGE_SIZE;
+  const size_t END = ((size_t)raw + size) / VEC_PAGE_SIZE;
+  if (size < VEC_HUGE_PAGE_SIZE || END <= START) return;
+  (void)madvise((byte *)raw + ((START * VEC_PAGE_SIZE) - (size_t)raw),
+                (END - START) * VEC_PAGE_SIZE, MADV_HUGEPAGE);
+#else
+  (void)raw;
+  (void)size;
+#endif
+}
+
+static void *aligned_alloc_block(void *const ctx, const size_t size) {
+  const size_t ALIGNMENT = alignment_of(ctx);
+  byte *raw;
+  byte *header;
+  if (size > (size_t)-1 - slack(ALIGNMENT)) return NULL;
+  raw = malloc(size + slack(ALIGNMENT));
+  if (raw == NULL) return NULL;
+  header = raw + header_offset((size_t)raw, ALIGNMENT);
+  header_offset_of(header) = (size_t)(header - raw);
+  if (is_huge(ctx)) advise_huge_pages(raw, size + slack(ALIGNMENT));
+  return header;
+}
+
+/*
+ * `realloc()` may move the block to an address with a different alignment, in
+ * which case the header and elements are shifted into place afterwards.
+ */
+static void *aligned_realloc_block(void *const ctx, void *const ptr,
+                                   const size_t old_size,
+                                   const size_t new_size) {
+  const size_t ALIGNMENT = alignment_of(ctx);
+  const size_t OLD_OFFSET = header_offset_of(ptr);
+  size_t new_offset;
+  byte *raw;
+  if (new_size > (size_t)-1 - slack(ALIGNMENT)) return NULL;
+  raw = realloc((byte *)ptr - OLD_OFFSET, new_size + slack(ALIGNMENT));
+  if (raw == NULL) return NULL;
+  new_offset = header_offset((size_t)raw, ALIGNMENT);
+  if (new_offset != OLD_OFFSET)
+    memmove(raw + new_offset, raw + OLD_OFFSET,
+            old_size < new_size ? old_size : new_size);
+  header_offset_of(raw + new_offset) = new_offset;
+  if (is_huge(ctx)) advise_huge_pages(raw, new_size + slack(ALIGNMENT));
+  return raw + new_offset;
+}
+
+static void aligned_free_block(void *const ctx, void *const ptr,
+                               const size_t size) {
+  (void)ctx;
+  (void)size;
+  free((byte *)ptr - header_offset_of(ptr));
+}
+
+/* - FUNCTIONS - */
+
+vector(void) vector_untyped_new_aligned(const size_t elem_size,
+                                        const size_t capacity,
+                                        const size_t alignment,
+                                        const bool huge) {
+  size_t shift = 0;
+  if (alignment == 0 || (alignment & (alignment - 1)) != 0 ||
+      alignment > VEC_MAX_ALIGNMENT)
+    return NULL;
+  while (((size_t)1 << (MIN_ALIGNMENT_SHIFT + shift)) < alignment) shift++;
+  if (capacity > VEC_MAX_CAPACITY(elem_size)) return NULL;
+  return vector_untyped_new_with(
+      &ALIGNED_ALLOCATORS[(huge ? ALIGNMENT_COUNT : 0) + shift], elem_size,
+      capacity);
+}
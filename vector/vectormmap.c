@@ -0,0 +1,190 @@
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE (200112L)
+#endif
+
+#include "vector.h"
+
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "../include/myclib.h"
+
+/* - DEFINITIONS - */
+
+/*
+ *  `allocator`   - The allocator of the vector, which recognizes the mapping
+ *                  and remaps or unmaps it instead of reallocating or freeing
+ *                  it.
+ *   `mapping`    - The vector's header within the mapping.
+ * `mapped_size`  - The size of the mapping, which may exceed the size of the
+ *                  vector's block if its file did.
+ *  `elem_size`   - The size of the vector's elements.
+ *     `fd`       - The file descriptor of the vector's file, or `-1` if the
+ *                  vector is read-only.
+ */
+typedef struct mmap_state {
+  myclib_allocator allocator;
+  void *mapping;
+  size_t mapped_size;
+  size_t elem_size;
+  int fd;
+} mmap_state;
+
+/* - INTERNAL - */
+
+/*
+ * Maps the first `size` bytes of the vector's file in place of its current
+ * mapping, extending the file if it is shorter. The file is only shortened
+ * once the vector is deleted.
+ */
+static void *remap(mmap_state *const state, const size_t size) {
+  void *mapping;
+  if (size > state->mapped_size && ftruncate(state->fd, (off_t)size) != 0)
+    return NULL;
+  mapping =
+      mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, state->fd, 0);
+  if (mapping == MAP_FAILED) return NULL;
+  munmap(state->mapping, state->mapped_size);
+  state->mapping = mapping;
+  state->mapped_size = size;
+  return mapping;
+}
+
+/*
+ * Unmaps the vector and releases its state. Writable vectors have their file
+ * trimmed to their length, and the process-local allocator pointer cleared, so
+ * that the file only holds what it needs.
+ */
+static void close_mapping(mmap_state *const state) {
+  if (state->fd >= 0) {
+    vector_header *const header = state->mapping;
+    const size_t TRIMMED =
+        vector_allocation_size(state->elem_size, header->length);
+    header->allocator = NULL;
+    if (ftruncate(state->fd, (off_t)TRIMMED) == 0)
+      header->capacity = header->length;
+    close(state->fd);
+  }
+  munmap(state->mapping, state->mapped_size);
+  free(state);
+}
+
+/* Copies of the vector are allocated on the heap. */
+static void *mmap_alloc(void *const ctx, const size_t size) {
+  (void)ctx;
+  return malloc(size);
+}
+
+static void *mmap_realloc(void *const ctx, void *const ptr,
+                          const size_t old_size, const size_t new_size) {
+  mmap_state *const state = ctx;
+  (void)old_size;
+  if (ptr != state->mapping) return realloc(ptr, new_size);
+  if (state->fd < 0) return NULL;
+  return remap(state, new_size);
+}
+
+static void mmap_free(void *const ctx, void *const ptr, const size_t size) {
+  mmap_state *const state = ctx;
+  (void)size;
+  if (ptr != state->mapping) {
+    free(ptr);
+    return;
+  }
+  close_mapping(state);
+}
+
+/* Determines whether `header` describes a vector fitting in its mapping. */
+static bool is_valid(const vector_header *const header,
+                     const size_t mapped_size, const size_t elem_size) {
+  return header->length <= header->capacity &&
+         header->capacity <= VEC_MAX_CAPACITY(elem_size) &&
+         vector_allocation_size(elem_size, header->capacity) <= mapped_size;
+}
+
+/*
+ * Determines the size of the file open as `fd`, initializing it as an empty
+ * vector first if it is empty and `writable`. Returns `0` on failure.
+ */
+static size_t file_size(const int fd, const bool writable) {
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size < 0) return 0;
+  if (info.st_size == 0 && writable) {
+    vector_header header;
+    header.capacity = 0;
+    header.length = 0;
+    header.allocator = NULL;
+    header.shares = 0;
+    if (write(fd, &header, sizeof header) != (ssize_t)sizeof header) return 0;
+    return sizeof header;
+  }
+  if ((off_t)(size_t)info.st_size != info.st_size) return 0;
+  return (size_t)info.st_size;
+}
+
+/* - FUNCTIONS - */
+
+vector(void) vector_mmap_open(const char *const path, const size_t elem_size,
+                              const int flags) {
+  const bool WRITABLE =
+      (flags & (VEC_MMAP_WRITE | VEC_MMAP_CREATE | VEC_MMAP_TRUNCATE)) != 0;
+  const int OPEN_FLAGS = (WRITABLE ? O_RDWR : O_RDONLY) |
+                         (flags & VEC_MMAP_CREATE ? O_CREAT : 0) |
+                         (flags & VEC_MMAP_TRUNCATE ? O_TRUNC : 0);
+  mmap_state *state;
+  vector_header *header;
+  size_t size;
+  int fd;
+  if (elem_size == 0) return NULL;
+  fd = open(path, OPEN_FLAGS, 0666);
+  if (fd < 0) return NULL;
+  size = file_size(fd, WRITABLE);
+  state = malloc(sizeof *state);
+  if (size < sizeof(vector_header) || state == NULL) {
+    free(state);
+    close(fd);
+    return NULL;
+  }
+  /*
+   * Read-only vectors are mapped privately so that the header can point at
+   * this process's allocator. Only the page holding it is ever copied.
+   */
+  header = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                WRITABLE ? MAP_SHARED : MAP_PRIVATE, fd, 0);
+  if (header == MAP_FAILED || !is_valid(header, size, elem_size)) {
+    if (header != MAP_FAILED) munmap(header, size);
+    free(state);
+    close(fd);
+    return NULL;
+  }
+  state->allocator.alloc = mmap_alloc;
+  state->allocator.realloc = mmap_realloc;
+  state->allocator.free = mmap_free;
+  state->allocator.ctx = state;
+  state->mapping = header;
+  state->mapped_size = size;
+  state->elem_size = elem_size;
+  state->fd = fd;
+  if (!WRITABLE) {
+    close(fd);
+    state->fd = -1;
+  }
+  /* Neither allocators nor shares carry over from other processes. */
+  header->allocator = &state->allocator;
+  header->shares = 0;
+  return header + 1;
+}
+
+bool vector_mmap_sync(const vector(void) vec) {
+  const myclib_allocator *const allocator = vector_allocator(vec);
+  const mmap_state *state;
+  util_assert(allocator != NULL && allocator->free == mmap_free);
+  state = allocator->ctx;
+  if (state->fd < 0) return true;
+  return msync(state->mapping, state->mapped_size, MS_SYNC) == 0;
+}
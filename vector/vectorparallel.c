@@ -0,0 +1,502 @@
+#include "vector.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/myclib.h"
+#include "../sched/scheduler.h"
+
+/* - DEFINITIONS - */
+
+/*
+ * Vectors are split into about this many chunks per thread, so that threads
+ * finishing early can pick up the work of slower ones.
+ */
+#define CHUNKS_PER_THREAD ((size_t)4)
+
+typedef enum parallel_mode {
+  PARALLEL_ELEMENT,
+  PARALLEL_ELEMENT_CONST,
+  PARALLEL_CHUNK,
+  PARALLEL_CHUNK_CONST
+} parallel_mode;
+
+/*
+ *    `data`    - The vector being iterated over.
+ *   `length`   - The vector's length.
+ * `elem_size`  - The size of the vector's elements.
+ *    `head`    - The number of elements preceding the first cache line
+ *                boundary that chunks are aligned to. The first chunk is
+ *                extended by this many elements.
+ *   `chunk`    - The number of elements in every chunk but the first and last.
+ *    `mode`    - Which member of `op` and of `args` is in use.
+ */
+typedef struct parallel_job {
+  byte *data;
+  size_t length;
+  size_t elem_size;
+  size_t head;
+  size_t chunk;
+  parallel_mode mode;
+  union {
+    vec_for_each_op element;
+    vec_for_each_op_const element_const;
+    vec_chunk_op chunk;
+    vec_chunk_op_const chunk_const;
+  } op;
+  union {
+    void *mutable_args;
+    const void *const_args;
+  } args;
+} parallel_job;
+
+/*
+ *    `data`    - The elements being sorted.
+ *   `buffer`   - Scratch space as large as the elements.
+ *   `length`   - The number of elements.
+ * `elem_size`  - The size of the elements.
+ *    `cmp`     - The comparator ordering the elements.
+ *   `block`    - The number of elements in each block sorted by a single task.
+ *   `width`    - The length of the sorted runs being merged in this round.
+ *  `segments`  - The number of tasks each merge of this round is split into.
+ *    `src`     - The runs being merged in this round.
+ *    `dst`     - Where this round's merged runs are written.
+ */
+typedef struct sort_job {
+  byte *data;
+  byte *buffer;
+  size_t length;
+  size_t elem_size;
+  vec_comparator cmp;
+  size_t block;
+  size_t width;
+  size_t segments;
+  byte *src;
+  byte *dst;
+} sort_job;
+
+/* Executes the task numbered `index` of a batch sharing `ctx`. */
+typedef void (*indexed_task)(void *ctx, size_t index);
+
+/*
+ *  `task` - The task executed for every index of the batch.
+ *  `ctx`  - The pointer passed to `task`.
+ */
+typedef struct task_batch {
+  indexed_task task;
+  void *ctx;
+} task_batch;
+
+/* - INTERNAL - */
+
+static void run_task_range(void *const ctx, const size_t begin,
+                           const size_t end) {
+  const task_batch *const batch = ctx;
+  size_t i;
+  for (i = begin; i < end; i++) batch->task(batch->ctx, i);
+}
+
+/*
+ * Executes `task` for every index below `task_count` across the threads of
+ * `sched`, or on the calling thread alone if `sched` is `NULL`.
+ */
+static void run_tasks(scheduler *const sched, const indexed_task task,
+                      void *const ctx, const size_t task_count) {
+  task_batch batch;
+  batch.task = task;
+  batch.ctx = ctx;
+  scheduler_run_for(sched, 0, task_count, 1, run_task_range, &batch);
+}
+
+
+static size_t gcd(size_t a, size_t b) {
+  while (b != 0) {
+    const size_t REMAINDER = a % b;
+    a = b;
+    b = REMAINDER;
+  }
+  return a;
+}
+
+/* Divides the job's vector into chunks, returning the number of chunks. */
+static size_t plan_chunks(parallel_job *const job, size_t grain_size,
+                          const size_t thread_count) {
+  /* The smallest number of elements spanning a whole number of lines. */
+  const size_t STEP =
+      VEC_CACHE_LINE_SIZE / gcd(job->elem_size, VEC_CACHE_LINE_SIZE);
+  const size_t MISALIGNMENT = (size_t)job->data % VEC_CACHE_LINE_SIZE;
+  const size_t TARGET_CHUNK_COUNT = thread_count * CHUNKS_PER_THREAD;
+  size_t chunk;
+  if (grain_size == 0) grain_size = VEC_PARALLEL_DEFAULT_GRAIN;
+  chunk = (job->length + TARGET_CHUNK_COUNT - 1) / TARGET_CHUNK_COUNT;
+  if (chunk < grain_size) chunk = grain_size;
+  if (chunk >= job->length) {
+    job->head = 0;
+    job->chunk = job->length;
+    return 1;
+  }
+  chunk = ((chunk + STEP - 1) / STEP) * STEP;
+  job->head = MISALIGNMENT != 0 && MISALIGNMENT % job->elem_size == 0
+                  ? (VEC_CACHE_LINE_SIZE - MISALIGNMENT) / job->elem_size
+                  : 0;
+  job->chunk = chunk;
+  if (job->length <= job->head + chunk) return 1;
+  return (job->length - job->head + chunk - 1) / chunk;
+}
+
+static void run_chunk(void *const ctx, const size_t index) {
+  const parallel_job *const job = ctx;
+  const size_t START = index == 0 ? 0 : job->head + (index * job->chunk);
+  size_t end = job->head + ((index + 1) * job->chunk);
+  byte *const chunk_start = job->data + (START * job->elem_size);
+  size_t i;
+  if (end > job->length) end = job->length;
+  switch (job->mode) {
+    case PARALLEL_ELEMENT: {
+      void *arg_list[3];
+      arg_list[0] = job->data;
+      arg_list[2] = job->args.mutable_args;
+      for (i = START; i < end; i++) {
+        arg_list[1] = job->data + (i * job->elem_size);
+        job->op.element(arg_list);
+      }
+      break;
+    }
+    case PARALLEL_ELEMENT_CONST: {
+      const void *arg_list[3];
+      arg_list[0] = job->data;
+      arg_list[2] = job->args.const_args;
+      for (i = START; i < end; i++) {
+        arg_list[1] = job->data + (i * job->elem_size);
+        job->op.element_const(arg_list);
+      }
+      break;
+    }
+    case PARALLEL_CHUNK:
+      job->op.chunk(chunk_start, end - START, job->args.mutable_args);
+      break;
+    case PARALLEL_CHUNK_CONST:
+      job->op.chunk_const(chunk_start, end - START, job->args.const_args);
+      break;
+    default:
+      break;
+  }
+}
+
+static void run_job(parallel_job *const job, scheduler *const sched,
+                    const size_t grain_size) {
+  size_t chunk_count;
+  if (job->length == 0) return;
+  chunk_count = plan_chunks(job, grain_size, scheduler_size(sched));
+  run_tasks(sched, run_chunk, job, chunk_count);
+}
+
+/* - PARALLEL SORT - */
+
+static void sort_block(void *const ctx, const size_t index) {
+  const sort_job *const job = ctx;
+  const size_t START = index * job->block;
+  const size_t COUNT =
+      job->length - START < job->block ? job->length - START : job->block;
+  const size_t OFFSET = START * job->elem_size;
+  vec_merge_sort(job->data + OFFSET, job->buffer + OFFSET, COUNT,
+                 job->elem_size, job->cmp);
+}
+
+/*
+ * Returns how many of the first `rank` elements of the stable merge of the
+ * `left_length` elements at `left` and the `right_length` elements at `right`
+ * come from `left`.
+ */
+static size_t co_rank(const byte *const left, const size_t left_length,
+                      const byte *const right, const size_t right_length,
+                      const size_t rank, const sort_job *const job) {
+  size_t low = rank > right_length ? rank - right_length : 0;
+  size_t high = rank < left_length ? rank : left_length;
+  while (low < high) {
+    const size_t TAKEN = low + ((high - low) / 2);
+    /* Ties are taken from the left, so an equal left element comes first. */
+    if (job->cmp(right + ((rank - TAKEN - 1) * job->elem_size),
+                 left + (TAKEN * job->elem_size)) >= 0)
+      low = TAKEN + 1;
+    else
+      high = TAKEN;
+  }
+  return low;
+}
+
+/*
+ * Writes one segment of one merge of the current round. Each segment covers an
+ * equal share of the merged run, found in both inputs by `co_rank()`.
+ */
+static void merge_segment(void *const ctx, const size_t index) {
+  const sort_job *const job = ctx;
+  const size_t SIZE = job->elem_size;
+  const size_t START = (index / job->segments) * 2 * job->width;
+  const size_t MIDDLE =
+      job->length - START < job->width ? job->length : START + job->width;
+  const size_t END =
+      job->length - MIDDLE < job->width ? job->length : MIDDLE + job->width;
+  const size_t STEP = (END - START + job->segments - 1) / job->segments;
+  const size_t SEGMENT = index % job->segments;
+  const size_t FIRST =
+      STEP * SEGMENT < END - START ? STEP * SEGMENT : END - START;
+  const size_t LAST = END - START - FIRST < STEP ? END - START : FIRST + STEP;
+  const byte *const left = job->src + (START * SIZE);
+  const byte *const right = job->src + (MIDDLE * SIZE);
+  const size_t LEFT_FIRST =
+      co_rank(left, MIDDLE - START, right, END - MIDDLE, FIRST, job);
+  const size_t LEFT_LAST =
+      co_rank(left, MIDDLE - START, right, END - MIDDLE, LAST, job);
+  vec_merge(left + (LEFT_FIRST * SIZE), left + (LEFT_LAST * SIZE),
+            right + ((FIRST - LEFT_FIRST) * SIZE),
+            right + ((LAST - LEFT_LAST) * SIZE),
+            job->dst + ((START + FIRST) * SIZE), SIZE, job->cmp);
+}
+
+/* Copies one block of a result left in the buffer back into the elements. */
+static void copy_block(void *const ctx, const size_t index) {
+  const sort_job *const job = ctx;
+  const size_t START = index * job->block;
+  const size_t COUNT =
+      job->length - START < job->block ? job->length - START : job->block;
+  memcpy(job->data + (START * job->elem_size),
+         job->buffer + (START * job->elem_size), COUNT * job->elem_size);
+}
+
+/* - PARALLEL SCAN - */
+
+/*
+ * Defines a scan over values of type `word`. Each block's total is summed by a
+ * single task, the totals are scanned serially, then each block is scanned
+ * from its offset by a single task, so every sum is formed in the same order
+ * whatever the number of threads.
+ */
+#define DEFINE_PARALLEL_SCAN(name, word)                               \
+  typedef struct name##_job {                                          \
+    word *data;                                                        \
+    size_t length;                                                     \
+    vec_scan_kind kind;                                                \
+    word *totals;                                                      \
+  } name##_job;                                                        \
+                                                                       \
+  static void name##_total(void *const ctx, const size_t index) {      \
+    const name##_job *const job = ctx;                                 \
+    const size_t START = index * VEC_SCAN_BLOCK_LENGTH;                \
+    const size_t END = job->length - START < VEC_SCAN_BLOCK_LENGTH     \
+                           ? job->length                               \
+                           : START + VEC_SCAN_BLOCK_LENGTH;            \
+    word total = 0;                                                    \
+    size_t i;                                                          \
+    for (i = START; i < END; i++) total += job->data[i];               \
+    job->totals[index] = total;                                        \
+  }                                                                    \
+                                                                       \
+  static void name##_apply(void *const ctx, const size_t index) {      \
+    const name##_job *const job = ctx;                                 \
+    const size_t START = index * VEC_SCAN_BLOCK_LENGTH;                \
+    const size_t END = job->length - START < VEC_SCAN_BLOCK_LENGTH     \
+                           ? job->length                               \
+                           : START + VEC_SCAN_BLOCK_LENGTH;            \
+    word running = job->totals[index];                                 \
+    size_t i;                                                          \
+    if (job->kind == VEC_SCAN_INCLUSIVE) {                             \
+      for (i = START; i < END; i++) {                                  \
+        running += job->data[i];                                       \
+        job->data[i] = running;                                        \
+      }                                                                \
+    } else {                                                           \
+      for (i = START; i < END; i++) {                                  \
+        const word VALUE = job->data[i];                               \
+        job->data[i] = running;                                        \
+        running += VALUE;                                              \
+      }                                                                \
+    }                                                                  \
+  }                                                                    \
+                                                                       \
+  static bool name(void *const data, const size_t length,              \
+                   const vec_scan_kind kind, scheduler *const sched) { \
+    const size_t BLOCK_COUNT =                                         \
+        (length + VEC_SCAN_BLOCK_LENGTH - 1) / VEC_SCAN_BLOCK_LENGTH;  \
+    word running = 0;                                                  \
+    name##_job job;                                                    \
+    size_t block;                                                      \
+    if (length == 0) return true;                                      \
+    job.data = data;                                                   \
+    job.length = length;                                               \
+    job.kind = kind;                                                   \
+    job.totals = malloc(BLOCK_COUNT * sizeof *job.totals);             \
+    if (job.totals == NULL) return false;                              \
+    run_tasks(sched, name##_total, &job, BLOCK_COUNT);                 \
+    for (block = 0; block < BLOCK_COUNT; block++) {                    \
+      const word TOTAL = job.totals[block];                            \
+      job.totals[block] = running;                                     \
+      running += TOTAL;                                                \
+    }                                                                  \
+    run_tasks(sched, name##_apply, &job, BLOCK_COUNT);                 \
+    free(job.totals);                                                  \
+    return true;                                                       \
+  }
+
+/*
+ * Signed values are summed through their unsigned counterparts, which share
+ * their representation, so that overflow wraps around rather than being
+ * undefined.
+ */
+DEFINE_PARALLEL_SCAN(scan_32, vec_u32)
+DEFINE_PARALLEL_SCAN(scan_64, vec_u64)
+DEFINE_PARALLEL_SCAN(scan_f32, float)
+DEFINE_PARALLEL_SCAN(scan_f64, double)
+
+/*
+ * The vector is only ever read through `const` operations, so casting away
+ * its qualifier to share a job layout with the mutable variants is safe.
+ */
+static byte *unqualify(const void *const vec) {
+  union {
+    const void *const_ptr;
+    byte *ptr;
+  } conversion;
+  conversion.const_ptr = vec;
+  return conversion.ptr;
+}
+
+/* - FUNCTIONS - */
+
+void vector_untyped_parallel_for_each(void *const vec,
+                                      const vec_for_each_op op,
+                                      void *const args, scheduler *const sched,
+                                      const size_t grain_size,
+                                      const size_t elem_size) {
+  parallel_job job;
+  job.data = vec;
+  job.length = vector_length(vec);
+  job.elem_size = elem_size;
+  job.mode = PARALLEL_ELEMENT;
+  job.op.element = op;
+  job.args.mutable_args = args;
+  run_job(&job, sched, grain_size);
+}
+
+void vector_untyped_parallel_for_each_c(const void *const vec,
+                                        const vec_for_each_op_const op,
+                                        const void *const args,
+                                        scheduler *const sched,
+                                        const size_t grain_size,
+                                        const size_t elem_size) {
+  parallel_job job;
+  job.data = unqualify(vec);
+  job.length = vector_length(vec);
+  job.elem_size = elem_size;
+  job.mode = PARALLEL_ELEMENT_CONST;
+  job.op.element_const = op;
+  job.args.const_args = args;
+  run_job(&job, sched, grain_size);
+}
+
+void vector_untyped_parallel_for_each_chunk(void *const vec,
+                                            const vec_chunk_op op,
+                                            void *const args,
+                                            scheduler *const sched,
+                                            const size_t grain_size,
+                                            const size_t elem_size) {
+  parallel_job job;
+  job.data = vec;
+  job.length = vector_length(vec);
+  job.elem_size = elem_size;
+  job.mode = PARALLEL_CHUNK;
+  job.op.chunk = op;
+  job.args.mutable_args = args;
+  run_job(&job, sched, grain_size);
+}
+
+void vector_untyped_parallel_for_each_chunk_c(const void *const vec,
+                                              const vec_chunk_op_const op,
+                                              const void *const args,
+                                              scheduler *const sched,
+                                              const size_t grain_size,
+                                              const size_t elem_size) {
+  parallel_job job;
+  job.data = unqualify(vec);
+  job.length = vector_length(vec);
+  job.elem_size = elem_size;
+  job.mode = PARALLEL_CHUNK_CONST;
+  job.op.chunk_const = op;
+  job.args.const_args = args;
+  run_job(&job, sched, grain_size);
+}
+
+bool vector_parallel_sort(void *const data, const size_t length,
+                          const size_t elem_size, const vec_comparator cmp,
+                          scheduler *const sched) {
+  const size_t TARGET_TASK_COUNT = scheduler_size(sched) * CHUNKS_PER_THREAD;
+  sort_job job;
+  size_t block_count;
+  if (length < 2 || elem_size == 0) return true;
+  if (length > (size_t)-1 / elem_size) return false;
+  job.data = data;
+  job.buffer = malloc(length * elem_size);
+  if (job.buffer == NULL) return false;
+  job.length = length;
+  job.elem_size = elem_size;
+  job.cmp = cmp;
+  job.block = (length + TARGET_TASK_COUNT - 1) / TARGET_TASK_COUNT;
+  if (job.block < VEC_PARALLEL_DEFAULT_GRAIN)
+    job.block = VEC_PARALLEL_DEFAULT_GRAIN;
+  block_count = (length + job.block - 1) / job.block;
+  run_tasks(sched, sort_block, &job, block_count);
+  job.src = job.data;
+  job.dst = job.buffer;
+  for (job.width = job.block; job.width < length; job.width *= 2) {
+    const size_t MERGE_COUNT = (length + (2 * job.width) - 1) / (2 * job.width);
+    /* Splits merges evenly until every thread has work, down to a grain. */
+    const size_t MAX_SEGMENTS = 2 * job.width / VEC_PARALLEL_DEFAULT_GRAIN;
+    byte *const swapped = job.src;
+    job.segments = (TARGET_TASK_COUNT + MERGE_COUNT - 1) / MERGE_COUNT;
+    if (job.segments > MAX_SEGMENTS) job.segments = MAX_SEGMENTS;
+    if (job.segments == 0) job.segments = 1;
+    run_tasks(sched, merge_segment, &job, MERGE_COUNT * job.segments);
+    job.src = job.dst;
+    job.dst = swapped;
+  }
+  if (job.src != job.data) run_tasks(sched, copy_block, &job, block_count);
+  free(job.buffer);
+  return true;
+}
+
+bool vector_parallel_scan_u32(vec_u32 *const data, const size_t length,
+                              const vec_scan_kind kind,
+                              scheduler *const sched) {
+  return scan_32(data, length, kind, sched);
+}
+
+bool vector_parallel_scan_u64(vec_u64 *const data, const size_t length,
+                              const vec_scan_kind kind,
+                              scheduler *const sched) {
+  return scan_64(data, length, kind, sched);
+}
+
+bool vector_parallel_scan_i32(vec_i32 *const data, const size_t length,
+                              const vec_scan_kind kind,
+                              scheduler *const sched) {
+  return scan_32(data, length, kind, sched);
+}
+
+bool vector_parallel_scan_i64(vec_i64 *const data, const size_t length,
+                              const vec_scan_kind kind,
+                              scheduler *const sched) {
+  return scan_64(data, length, kind, sched);
+}
+
+bool vector_parallel_scan_f32(float *const data, const size_t length,
+                              const vec_scan_kind kind,
+                              scheduler *const sched) {
+  return scan_f32(data, length, kind, sched);
+}
+
+bool vector_parallel_scan_f64(double *const data, const size_t length,
+                              const vec_scan_kind kind,
+                              scheduler *const sched) {
+  return scan_f64(data, length, kind, sched);
+}
@@ -0,0 +1,575 @@
+#include <limits.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/myclib.h"
+#include "vector.h"
+
+/* - DEFINITIONS - */
+
+/* Ranges shorter than this are insertion sorted. */
+#define INSERTION_SORT_THRESHOLD ((size_t)24)
+
+/* Ranges longer than this take their pivot from a median of three medians. */
+#define NINTHER_THRESHOLD ((size_t)128)
+
+/*
+ * The number of elements a partial insertion sort may move before giving up on
+ * a range which looked sorted.
+ */
+#define PARTIAL_INSERTION_SORT_LIMIT ((size_t)8)
+
+/* Runs of this many elements are insertion sorted before merging starts. */
+#define MERGE_RUN_LENGTH ((size_t)16)
+
+#define RADIX_BITS (8)
+#define RADIX_BUCKETS ((size_t)1 << RADIX_BITS)
+
+typedef enum key_kind { KEY_UNSIGNED, KEY_SIGNED, KEY_FLOAT } key_kind;
+
+/* - ELEMENT MOVEMENT - */
+
+/*
+ * Constant sizes let the compiler replace `memcpy()` with a single load and
+ * store, which is what the kernels specialized for 4 and 8 byte elements rely
+ * on.
+ */
+static inline void swap_elems(byte *const a, byte *const b,
+                              const size_t elem_size) {
+  byte tmp[64];
+  size_t offset;
+  switch (elem_size) {
+    case 4:
+      memcpy(tmp, a, 4);
+      memcpy(a, b, 4);
+      memcpy(b, tmp, 4);
+      return;
+    case 8:
+      memcpy(tmp, a, 8);
+      memcpy(a, b, 8);
+      memcpy(b, tmp, 8);
+      return;
+    default:
+      for (offset = 0; offset < elem_size; offset += sizeof tmp) {
+        const size_t COUNT = elem_size - offset < sizeof tmp
+                                 ? elem_size - offset
+                                 : sizeof tmp;
+        memcpy(tmp, a + offset, COUNT);
+        memcpy(a + offset, b + offset, COUNT);
+        memcpy(b + offset, tmp, COUNT);
+      }
+      return;
+  }
+}
+
+static inline void copy_elem(byte *const dst, const byte *const src,
+                             const size_t elem_size) {
+  switch (elem_size) {
+    case 4:
+      memcpy(dst, src, 4);
+      return;
+    case 8:
+      memcpy(dst, src, 8);
+      return;
+    default:
+      memcpy(dst, src, elem_size);
+      return;
+  }
+}
+
+/* - PATTERN-DEFEATING QUICKSORT - */
+
+/*
+ * Defines pattern-defeating quicksort over elements of `SIZE` bytes, where
+ * `SIZE` is either a constant or the `elem_size` each function receives.
+ * Ranges are given as `begin` and `end` pointers, and `leftmost` tells whether
+ * the element before `begin` may be relied on to be no greater than any in
+ * the range.
+ */
+#define DEFINE_PDQSORT(prefix, SIZE)                                           \
+  static void prefix##_insertion_sort(byte *const begin, byte *const end,      \
+                                      const size_t elem_size,                  \
+                                      const vec_comparator cmp,                \
+                                      const bool guarded) {                    \
+    byte *cur;                                                                 \
+    (void)elem_size;                                                           \
+    for (cur = begin + (SIZE); cur < end; cur += (SIZE)) {                     \
+      byte *sift = cur;                                                        \
+      while ((!guarded || sift > begin) && cmp(sift, sift - (SIZE)) < 0) {     \
+        swap_elems(sift, sift - (SIZE), SIZE);                                 \
+        sift -= (SIZE);                                                        \
+      }                                                                        \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  /* Gives up once more than `PARTIAL_INSERTION_SORT_LIMIT` elements moved. */ \
+  static bool prefix##_partial_insertion_sort(                                 \
+      byte *const begin, byte *const end, const size_t elem_size,              \
+      const vec_comparator cmp) {                                              \
+    size_t moved = 0;                                                          \
+    byte *cur;                                                                 \
+    (void)elem_size;                                                           \
+    for (cur = begin + (SIZE); cur < end; cur += (SIZE)) {                     \
+      byte *sift = cur;                                                        \
+      while (sift > begin && cmp(sift, sift - (SIZE)) < 0) {                   \
+        swap_elems(sift, sift - (SIZE), SIZE);                                 \
+        sift -= (SIZE);                                                        \
+        if (++moved > PARTIAL_INSERTION_SORT_LIMIT) return false;              \
+      }                                                                        \
+    }                                                                          \
+    return true;                                                               \
+  }                                                                            \
+                                                                               \
+  static void prefix##_sort2(byte *const a, byte *const b,                     \
+                             const size_t elem_size,                           \
+                             const vec_comparator cmp) {                       \
+    (void)elem_size;                                                           \
+    if (cmp(b, a) < 0) swap_elems(a, b, SIZE);                                 \
+  }                                                                            \
+                                                                               \
+  static void prefix##_sort3(byte *const a, byte *const b, byte *const c,      \
+                             const size_t elem_size,                           \
+                             const vec_comparator cmp) {                       \
+    prefix##_sort2(a, b, elem_size, cmp);                                      \
+    prefix##_sort2(b, c, elem_size, cmp);                                      \
+    prefix##_sort2(a, b, elem_size, cmp);                                      \
+  }                                                                            \
+                                                                               \
+  static void prefix##_heapsort(byte *const begin, const size_t length,        \
+                                const size_t elem_size,                        \
+                                const vec_comparator cmp) {                    \
+    size_t end = length;                                                       \
+    size_t start = length / 2;                                                 \
+    (void)elem_size;                                                           \
+    while (end > 1) {                                                          \
+      size_t root;                                                             \
+      if (start > 0) {                                                         \
+        start--;                                                               \
+      } else {                                                                 \
+        end--;                                                                 \
+        swap_elems(begin, begin + (end * (SIZE)), SIZE);                       \
+      }                                                                        \
+      for (root = start; 2 * root + 1 < end;) {                                \
+        size_t child = 2 * root + 1;                                           \
+        if (child + 1 < end && cmp(begin + (child * (SIZE)),                   \
+                                   begin + ((child + 1) * (SIZE))) < 0)        \
+          child++;                                                             \
+        if (cmp(begin + (root * (SIZE)), begin + (child * (SIZE))) >= 0)       \
+          break;                                                               \
+        swap_elems(begin + (root * (SIZE)), begin + (child * (SIZE)), SIZE);   \
+        root = child;                                                          \
+      }                                                                        \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  /*                                                                           \
+   * Partitions around the pivot at `begin`, placing elements equal to it on   \
+   * its right. Returns the pivot's final position and records whether no      \
+   * elements had to be swapped.                                               \
+   */                                                                          \
+  static byte *prefix##_partition_right(byte *const begin, byte *const end,    \
+                                        const size_t elem_size,                \
+                                        const vec_comparator cmp,              \
+                                        bool *const already_partitioned) {     \
+    byte *first = begin;                                                       \
+    byte *last = end;                                                          \
+    (void)elem_size;                                                           \
+    do first += (SIZE);                                                        \
+    while (cmp(first, begin) < 0);                                             \
+    if (first - (SIZE) == begin) {                                             \
+      while (first < last) {                                                   \
+        last -= (SIZE);                                                        \
+        if (cmp(last, begin) < 0) break;                                       \
+      }                                                                        \
+    } else {                                                                   \
+      do last -= (SIZE);                                                       \
+      while (cmp(last, begin) >= 0);                                           \
+    }                                                                          \
+    *already_partitioned = first >= last;                                      \
+    while (first < last) {                                                     \
+      swap_elems(first, last, SIZE);                                           \
+      do first += (SIZE);                                                      \
+      while (cmp(first, begin) < 0);                                           \
+      do last -= (SIZE);                                                       \
+      while (cmp(last, begin) >= 0);                                           \
+    }                                                                          \
+    swap_elems(begin, first - (SIZE), SIZE);                                   \
+    return first - (SIZE);                                                     \
+  }                                                                            \
+                                                                               \
+  /*                                                                           \
+   * Partitions around the pivot at `begin`, placing elements equal to it on   \
+   * its left. Used once the pivot is known to equal its predecessor, so that  \
+   * runs of equal elements are sorted in one step.                            \
+   */                                                                          \
+  static byte *prefix##_partition_left(byte *const begin, byte *const end,     \
+                                       const size_t elem_size,                 \
+                                       const vec_comparator cmp) {             \
+    byte *first = begin;                                                       \
+    byte *last = end;                                                          \
+    (void)elem_size;                                                           \
+    do last -= (SIZE);                                                         \
+    while (cmp(begin, last) < 0);                                              \
+    if (last + (SIZE) == end) {                                                \
+      while (first < last) {                                                   \
+        first += (SIZE);                                                       \
+        if (cmp(begin, first) < 0) break;                                      \
+      }                                                                        \
+    } else {                                                                   \
+      do first += (SIZE);                                                      \
+      while (cmp(begin, first) >= 0);                                          \
+    }                                                                          \
+    while (first < last) {                                                     \
+      swap_elems(first, last, SIZE);                                           \
+      do last -= (SIZE);                                                       \
+      while (cmp(begin, last) < 0);                                            \
+      do first += (SIZE);                                                      \
+      while (cmp(begin, first) >= 0);                                          \
+    }                                                                          \
+    swap_elems(begin, last, SIZE);                                             \
+    return last;                                                               \
+  }                                                                            \
+                                                                               \
+  /* Swaps a few elements of an unbalanced side to break up its pattern. */    \
+  static void prefix##_shuffle(byte *const begin, byte *const end,             \
+                               const size_t elem_size) {                       \
+    const size_t LENGTH = (size_t)(end - begin) / (SIZE);                      \
+    const size_t QUARTER = LENGTH / 4;                                         \
+    (void)elem_size;                                                           \
+    if (LENGTH < INSERTION_SORT_THRESHOLD) return;                             \
+    swap_elems(begin, begin + (QUARTER * (SIZE)), SIZE);                       \
+    swap_elems(end - (SIZE), end - (QUARTER * (SIZE)), SIZE);                  \
+    if (LENGTH <= NINTHER_THRESHOLD) return;                                   \
+    swap_elems(begin + (SIZE), begin + ((QUARTER + 1) * (SIZE)), SIZE);        \
+    swap_elems(begin + (2 * (SIZE)), begin + ((QUARTER + 2) * (SIZE)), SIZE);  \
+    swap_elems(end - (2 * (SIZE)), end - ((QUARTER + 1) * (SIZE)), SIZE);      \
+    swap_elems(end - (3 * (SIZE)), end - ((QUARTER + 2) * (SIZE)), SIZE);      \
+  }                                                                            \
+                                                                               \
+  /*                                                                           \
+   * Recurses into the shorter side of each partition and loops on the         \
+   * longer, so the stack depth stays logarithmic. `bad_allowed` counts the    \
+   * unbalanced partitions tolerated before switching to heapsort.             \
+   */                                                                          \
+  static void prefix##_loop(byte *begin, byte *end, const size_t elem_size,    \
+                            const vec_comparator cmp, size_t bad_allowed,      \
+                            bool leftmost) {                                   \
+    for (;;) {                                                                 \
+      const size_t LENGTH = (size_t)(end - begin) / (SIZE);                    \
+      const size_t HALF = LENGTH / 2;                                          \
+      bool already_partitioned;                                                \
+      byte *pivot;                                                             \
+      size_t left_length;                                                      \
+      size_t right_length;                                                     \
+      if (LENGTH < INSERTION_SORT_THRESHOLD) {                                 \
+        prefix##_insertion_sort(begin, end, elem_size, cmp, leftmost);         \
+        return;                                                                \
+      }                                                                        \
+      /* Moves the median of the samples to `begin` to serve as the pivot. */  \
+      if (LENGTH > NINTHER_THRESHOLD) {                                        \
+        byte *const MIDDLE = begin + (HALF * (SIZE));                          \
+        prefix##_sort3(begin, MIDDLE, end - (SIZE), elem_size, cmp);           \
+        prefix##_sort3(begin + (SIZE), MIDDLE - (SIZE), end - (2 * (SIZE)),    \
+                       elem_size, cmp);                                        \
+        prefix##_sort3(begin + (2 * (SIZE)), MIDDLE + (SIZE),                  \
+                       end - (3 * (SIZE)), elem_size, cmp);                    \
+        prefix##_sort3(MIDDLE - (SIZE), MIDDLE, MIDDLE + (SIZE), elem_size,    \
+                       cmp);                                                   \
+        swap_elems(begin, MIDDLE, SIZE);                                       \
+      } else {                                                                 \
+        prefix##_sort3(begin + (HALF * (SIZE)), begin, end - (SIZE),           \
+                       elem_size, cmp);                                        \
+      }                                                                        \
+      if (!leftmost && cmp(begin - (SIZE), begin) >= 0) {                      \
+        begin =                                                                \
+            prefix##_partition_left(begin, end, elem_size, cmp) + (SIZE);      \
+        continue;                                                              \
+      }                                                                        \
+      pivot = prefix##_partition_right(begin, end, elem_size, cmp,             \
+                                       &already_partitioned);                  \
+      left_length = (size_t)(pivot - begin) / (SIZE);                          \
+      right_length = (size_t)(end - pivot) / (SIZE) - 1;                       \
+      if (left_length < LENGTH / 8 || right_length < LENGTH / 8) {             \
+        if (--bad_allowed == 0) {                                              \
+          prefix##_heapsort(begin, LENGTH, elem_size, cmp);                    \
+          return;                                                              \
+        }                                                                      \
+        prefix##_shuffle(begin, pivot, elem_size);                             \
+        prefix##_shuffle(pivot + (SIZE), end, elem_size);                      \
+      } else if (already_partitioned &&                                        \
+                 prefix##_partial_insertion_sort(begin, pivot, elem_size,      \
+                                                 cmp) &&                       \
+                 prefix##_partial_insertion_sort(pivot + (SIZE), end,          \
+                                                 elem_size, cmp)) {            \
+        return;                                                                \
+      }                                                                        \
+      if (left_length < right_length) {                                        \
+        prefix##_loop(begin, pivot, elem_size, cmp, bad_allowed, leftmost);    \
+        begin = pivot + (SIZE);                                                \
+        leftmost = false;                                                      \
+      } else {                                                                 \
+        prefix##_loop(pivot + (SIZE), end, elem_size, cmp, bad_allowed,        \
+                      false);                                                  \
+        end = pivot;                                                           \
+      }                                                                        \
+    }                                                                          \
+  }
+
+DEFINE_PDQSORT(pdqsort_4, 4)
+DEFINE_PDQSORT(pdqsort_8, 8)
+DEFINE_PDQSORT(pdqsort_n, elem_size)
+
+/* - MERGE SORT - */
+
+/*
+ * Defines a stable merge sort over elements of `SIZE` bytes, as for
+ * `DEFINE_PDQSORT()`. Runs are sorted in place with `insertion_sort`, then
+ * merged back and forth between `data` and `buffer`, with the result left in
+ * `data`.
+ */
+#define DEFINE_MERGE_SORT(prefix, SIZE, insertion_sort)                      \
+  static void prefix##_merge(const byte *left, const byte *const left_end,   \
+                             const byte *right, const byte *const right_end, \
+                             byte *dst, const size_t elem_size,              \
+                             const vec_comparator cmp) {                     \
+    (void)elem_size;                                                         \
+    while (left < left_end && right < right_end) {                           \
+      /* Taking from the left on ties is what keeps the sort stable. */      \
+      if (cmp(right, left) < 0) {                                            \
+        copy_elem(dst, right, SIZE);                                         \
+        right += (SIZE);                                                     \
+      } else {                                                               \
+        copy_elem(dst, left, SIZE);                                          \
+        left += (SIZE);                                                      \
+      }                                                                      \
+      dst += (SIZE);                                                         \
+    }                                                                        \
+    memcpy(dst, left, (size_t)(left_end - left));                            \
+    memcpy(dst + (left_end - left), right, (size_t)(right_end - right));     \
+  }                                                                          \
+                                                                             \
+  static void prefix##_merge_sort(byte *const data, byte *const buffer,      \
+                                  const size_t length,                       \
+                                  const size_t elem_size,                    \
+                                  const vec_comparator cmp) {                \
+    const size_t BYTES = length * (SIZE);                                    \
+    byte *src = data;                                                        \
+    byte *dst = buffer;                                                      \
+    size_t width;                                                            \
+    size_t start;                                                            \
+    for (start = 0; start < length; start += MERGE_RUN_LENGTH) {             \
+      const size_t STOP = length - start < MERGE_RUN_LENGTH                  \
+                              ? length                                       \
+                              : start + MERGE_RUN_LENGTH;                    \
+      insertion_sort(data + (start * (SIZE)), data + (STOP * (SIZE)),        \
+                     elem_size, cmp, true);                                  \
+    }                                                                        \
+    for (width = MERGE_RUN_LENGTH * (SIZE); width < BYTES; width *= 2) {     \
+      byte *const swapped = src;                                             \
+      size_t offset;                                                         \
+      for (offset = 0; offset < BYTES; offset += 2 * width) {                \
+        const size_t MIDDLE =                                                \
+            BYTES - offset < width ? BYTES : offset + width;                 \
+        const size_t END =                                                   \
+            BYTES - MIDDLE < width ? BYTES : MIDDLE + width;                 \
+        prefix##_merge(src + offset, src + MIDDLE, src + MIDDLE, src + END,  \
+                       dst + offset, elem_size, cmp);                        \
+      }                                                                      \
+      src = dst;                                                             \
+      dst = swapped;                                                         \
+    }                                                                        \
+    if (src != data) memcpy(data, src, BYTES);                               \
+  }
+
+DEFINE_MERGE_SORT(merge_4, 4, pdqsort_4_insertion_sort)
+DEFINE_MERGE_SORT(merge_8, 8, pdqsort_8_insertion_sort)
+DEFINE_MERGE_SORT(merge_n, elem_size, pdqsort_n_insertion_sort)
+
+/* - RADIX SORT - */
+
+/*
+ * Defines an LSD radix sort over `length` keys of type `word`, stored at `data`
+ * in the representation `kind` describes. Keys are first mapped to unsigned
+ * integers ordered as the keys are, then mapped back once sorted.
+ */
+#define DEFINE_RADIX_SORT(name, word)                                    \
+  static word name##_to_ordered(word key, const key_kind kind) {         \
+    const word SIGN = (word)1 << (sizeof(word) * CHAR_BIT - 1);          \
+    switch (kind) {                                                      \
+      case KEY_SIGNED:                                                   \
+        return key ^ SIGN;                                               \
+      case KEY_FLOAT:                                                    \
+        return (key & SIGN) != 0 ? (word)~key : (word)(key | SIGN);      \
+      default:                                                           \
+        return key;                                                      \
+    }                                                                    \
+  }                                                                      \
+                                                                         \
+  static word name##_from_ordered(word key, const key_kind kind) {       \
+    const word SIGN = (word)1 << (sizeof(word) * CHAR_BIT - 1);          \
+    switch (kind) {                                                      \
+      case KEY_SIGNED:                                                   \
+        return key ^ SIGN;                                               \
+      case KEY_FLOAT:                                                    \
+        return (key & SIGN) != 0 ? (word)(key ^ SIGN) : (word)~key;      \
+      default:                                                           \
+        return key;                                                      \
+    }                                                                    \
+  }                                                                      \
+                                                                         \
+  static bool name(void *const data, const size_t length,                \
+                   const key_kind kind) {                                \
+    enum { DIGITS = sizeof(word) * CHAR_BIT / RADIX_BITS };              \
+    static const word DIGIT_MASK = (word)(RADIX_BUCKETS - 1);            \
+    size_t counts[DIGITS][RADIX_BUCKETS];                                \
+    word *keys = data;                                                   \
+    word *scratch;                                                       \
+    size_t digit;                                                        \
+    size_t i;                                                            \
+    if (length < 2) return true;                                         \
+    scratch = malloc(length * sizeof(word));                             \
+    if (scratch == NULL) return false;                                   \
+    memset(counts, 0, sizeof counts);                                    \
+    /* Every digit's histogram is gathered in one pass over the keys. */ \
+    for (i = 0; i < length; i++) {                                       \
+      word key;                                                          \
+      memcpy(&key, keys + i, sizeof key);                                \
+      key = name##_to_ordered(key, kind);                                \
+      memcpy(keys + i, &key, sizeof key);                                \
+      for (digit = 0; digit < DIGITS; digit++)                           \
+        counts[digit][(key >> (digit * RADIX_BITS)) & DIGIT_MASK]++;     \
+    }                                                                    \
+    for (digit = 0; digit < DIGITS; digit++) {                           \
+      const size_t SHIFT = digit * RADIX_BITS;                           \
+      size_t *const count = counts[digit];                               \
+      size_t offset = 0;                                                 \
+      size_t bucket;                                                     \
+      word first;                                                        \
+      memcpy(&first, keys, sizeof first);                                \
+      /* A digit every key shares cannot reorder anything. */            \
+      if (count[(first >> SHIFT) & DIGIT_MASK] == length) continue;      \
+      for (bucket = 0; bucket < RADIX_BUCKETS; bucket++) {               \
+        const size_t COUNT = count[bucket];                              \
+        count[bucket] = offset;                                          \
+        offset += COUNT;                                                 \
+      }                                                                  \
+      for (i = 0; i < length; i++) {                                     \
+        word key;                                                        \
+        memcpy(&key, keys + i, sizeof key);                              \
+        memcpy(scratch + count[(key >> SHIFT) & DIGIT_MASK]++, &key,     \
+               sizeof key);                                              \
+      }                                                                  \
+      {                                                                  \
+        word *const swapped = keys;                                      \
+        keys = scratch;                                                  \
+        scratch = swapped;                                               \
+      }                                                                  \
+    }                                                                    \
+    for (i = 0; i < length; i++) {                                       \
+      word key;                                                          \
+      memcpy(&key, keys + i, sizeof key);                                \
+      key = name##_from_ordered(key, kind);                              \
+      memcpy((word *)data + i, &key, sizeof key);                        \
+    }                                                                    \
+    free(keys == data ? scratch : keys);                                 \
+    return true;                                                         \
+  }
+
+DEFINE_RADIX_SORT(radix_sort_32, vec_u32)
+DEFINE_RADIX_SORT(radix_sort_64, vec_u64)
+
+/* - FUNCTIONS - */
+
+void vector_sort(void *const data, const size_t length, const size_t elem_size,
+                 const vec_comparator cmp) {
+  byte *const begin = data;
+  byte *const end = begin + (length * elem_size);
+  size_t bad_allowed = 1;
+  size_t remaining;
+  /* Allows as many unbalanced partitions as there are bits in `length`. */
+  for (remaining = length; remaining > 1; remaining >>= 1) bad_allowed++;
+  if (length < 2 || elem_size == 0) return;
+  switch (elem_size) {
+    case 4:
+      pdqsort_4_loop(begin, end, elem_size, cmp, bad_allowed, true);
+      break;
+    case 8:
+      pdqsort_8_loop(begin, end, elem_size, cmp, bad_allowed, true);
+      break;
+    default:
+      pdqsort_n_loop(begin, end, elem_size, cmp, bad_allowed, true);
+      break;
+  }
+}
+
+bool vector_sort_stable(void *const data, const size_t length,
+                        const size_t elem_size, const vec_comparator cmp) {
+  byte *buffer;
+  if (length < 2 || elem_size == 0) return true;
+  if (length > (size_t)-1 / elem_size) return false;
+  buffer = malloc(length * elem_size);
+  if (buffer == NULL) return false;
+  vec_merge_sort(data, buffer, length, elem_size, cmp);
+  free(buffer);
+  return true;
+}
+
+void vec_merge(const void *const left, const void *const left_end,
+               const void *const right, const void *const right_end,
+               void *const dst, const size_t elem_size,
+               const vec_comparator cmp) {
+  switch (elem_size) {
+    case 4:
+      merge_4_merge(left, left_end, right, right_end, dst, elem_size, cmp);
+      break;
+    case 8:
+      merge_8_merge(left, left_end, right, right_end, dst, elem_size, cmp);
+      break;
+    default:
+      merge_n_merge(left, left_end, right, right_end, dst, elem_size, cmp);
+      break;
+  }
+}
+
+void vec_merge_sort(void *const data, void *const buffer, const size_t length,
+                    const size_t elem_size, const vec_comparator cmp) {
+  if (length < 2 || elem_size == 0) return;
+  switch (elem_size) {
+    case 4:
+      merge_4_merge_sort(data, buffer, length, elem_size, cmp);
+      break;
+    case 8:
+      merge_8_merge_sort(data, buffer, length, elem_size, cmp);
+      break;
+    default:
+      merge_n_merge_sort(data, buffer, length, elem_size, cmp);
+      break;
+  }
+}
+
+bool vector_radix_sort_u32(vec_u32 *const data, const size_t length) {
+  return radix_sort_32(data, length, KEY_UNSIGNED);
+}
+
+bool vector_radix_sort_u64(vec_u64 *const data, const size_t length) {
+  return radix_sort_64(data, length, KEY_UNSIGNED);
+}
+
+bool vector_radix_sort_i32(vec_i32 *const data, const size_t length) {
+  return radix_sort_32(data, length, KEY_SIGNED);
+}
+
+bool vector_radix_sort_i64(vec_i64 *const data, const size_t length) {
+  return radix_sort_64(data, length, KEY_SIGNED);
+}
+
+bool vector_radix_sort_f32(float *const data, const size_t length) {
+  util_assert(sizeof(float) == sizeof(vec_u32));
+  return radix_sort_32(data, length, KEY_FLOAT);
+}
+
+bool vector_radix_sort_f64(double *const data, const size_t length) {
+  util_assert(sizeof(double) == sizeof(vec_u64));
+  return radix_sort_64(data, length, KEY_FLOAT);
+}